@@ -0,0 +1,81 @@
+################################################################################
+################################# Host build ###################################
+# Builds the kernel as a Linux program, with the VEX SDK replaced by the
+# simulator in host/sim and the RTOS running on the POSIX port in host/rtos.
+#
+#   make host        builds $(HOST_BINDIR)/pros, a simulator running src/main
+#   make host-bench  builds and runs $(HOST_BINDIR)/bench, the benchmark suite in
+#                    src/tests/benchmarks, saving the results to
+#                    $(HOST_BINDIR)/bench.jsonl. Set BENCH_BASELINE to a previous
+#                    run's results to compare against it.
+#   make host-clean  removes everything the host build produced
+
+HOSTDIR=$(ROOT)/host
+HOST_BINDIR=$(patsubst $(ROOT)/%,%,$(BINDIR))/host
+
+HOST_CC?=gcc
+HOST_CXX?=g++
+
+HOST_CPPFLAGS=-DPROS_HOST -include $(HOSTDIR)/include/newlib_compat.h
+HOST_CPPFLAGS+=-iquote$(ROOT) -iquote$(INCDIR) -I$(HOSTDIR)/include
+HOST_GCCFLAGS=-O2 -g -pthread -fno-strict-aliasing
+HOST_WARNFLAGS=-Wall -Wno-unused-variable -Wno-unused-but-set-variable -Wno-unused-function -Wno-stringop-truncation
+# The kernel assumes 32-bit pointers and that int32_t is a long, neither of
+# which hold on a 64-bit host
+HOST_WARNFLAGS+=-Wno-format -Wno-int-to-pointer-cast -Wno-address-of-packed-member
+HOST_CFLAGS=$(HOST_CPPFLAGS) $(HOST_GCCFLAGS) $(HOST_WARNFLAGS) -Wno-pointer-to-int-cast --std=gnu11
+HOST_CXXFLAGS=$(HOST_CPPFLAGS) $(HOST_GCCFLAGS) $(HOST_WARNFLAGS) --std=gnu++20 -fcoroutines
+HOST_LDFLAGS=-pthread -lm
+
+# Sources that only make sense on the V5: the ARM port, the startup code, and
+# the newlib system calls and locks, which glibc and host/sim provide instead
+HOST_EXCLUDE_SRC=$(SRCDIR)/rtos/port.c $(SRCDIR)/system/startup.c $(SRCDIR)/system/newlib_stubs.c
+HOST_EXCLUDE_SRC+=$(SRCDIR)/system/envlock.c $(SRCDIR)/system/mlock.c $(SRCDIR)/system/hot.c
+HOST_EXCLUDE_SRC+=$(SRCDIR)/system/unwind.c $(SRCDIR)/system/dev/file_system_stubs.c
+HOST_EXCLUDE_SRC+=$(foreach cext,$(CEXTS),$(SRCDIR)/main.$(cext)) $(foreach cxxext,$(CXXEXTS),$(SRCDIR)/main.$(cxxext))
+
+HOST_SRC=$(filter-out $(HOST_EXCLUDE_SRC),$(call CSRC,$(EXCLUDE_SRCDIRS)) $(call CXXSRC,$(EXCLUDE_SRCDIRS)))
+HOST_SRC+=$(wildcard $(HOSTDIR)/rtos/*.c) $(wildcard $(HOSTDIR)/sim/*.c)
+HOST_OBJ=$(addprefix $(HOST_BINDIR)/,$(addsuffix .o,$(patsubst $(ROOT)/%,%,$(HOST_SRC))))
+
+HOST_MAIN_SRC=$(filter $(foreach ext,$(CEXTS) $(CXXEXTS),$(SRCDIR)/main.$(ext)),$(call CSRC) $(call CXXSRC))
+HOST_MAIN_OBJ=$(addprefix $(HOST_BINDIR)/,$(addsuffix .o,$(patsubst $(ROOT)/%,%,$(HOST_MAIN_SRC))))
+HOST_BENCH_SRC=$(wildcard $(SRCDIR)/tests/benchmarks/*.c $(SRCDIR)/tests/benchmarks/*.cpp)
+HOST_BENCH_OBJ=$(addprefix $(HOST_BINDIR)/,$(addsuffix .o,$(patsubst $(ROOT)/%,%,$(HOST_BENCH_SRC))))
+
+HOST_DEPS=$(patsubst %.o,%.d,$(HOST_OBJ) $(HOST_MAIN_OBJ) $(HOST_BENCH_OBJ))
+
+.PHONY: host host-bench host-clean
+
+host: $(HOST_BINDIR)/pros $(HOST_BINDIR)/bench
+
+host-bench: $(HOST_BINDIR)/bench
+	$(VV)$(HOST_BINDIR)/bench > $(HOST_BINDIR)/bench.jsonl
+	@echo Results saved to $(HOST_BINDIR)/bench.jsonl
+ifdef BENCH_BASELINE
+	$(VV)python3 $(SRCDIR)/tests/benchmarks/compare.py $(BENCH_BASELINE) $(HOST_BINDIR)/bench.jsonl
+endif
+
+host-clean:
+	@echo Cleaning host build
+	-$Drm -rf $(HOST_BINDIR)
+
+$(HOST_BINDIR)/pros: $(HOST_OBJ) $(HOST_MAIN_OBJ)
+	$(call test_output_2,Linking $@ ,$(HOST_CXX) -o $@ $^ $(HOST_LDFLAGS),$(OK_STRING))
+
+$(HOST_BINDIR)/bench: $(HOST_OBJ) $(HOST_BENCH_OBJ)
+	$(call test_output_2,Linking $@ ,$(HOST_CXX) -o $@ $^ $(HOST_LDFLAGS),$(OK_STRING))
+
+# Some sources include their headers by name alone, and expect the matching
+# directory under include/ to be searched
+HOST_SRC_INCLUDE=-iquote$(patsubst src/%,$(INCDIR)/%,$(dir $<))
+
+$(HOST_BINDIR)/%.c.o: %.c
+	$(VV)mkdir -p $(dir $@)
+	$(call test_output_2,Compiling $< ,$(HOST_CC) -c $(HOST_CFLAGS) $(HOST_SRC_INCLUDE) -MMD -MP -o $@ $<,$(OK_STRING))
+
+$(HOST_BINDIR)/%.cpp.o: %.cpp
+	$(VV)mkdir -p $(dir $@)
+	$(call test_output_2,Compiling $< ,$(HOST_CXX) -c $(HOST_CXXFLAGS) $(HOST_SRC_INCLUDE) -MMD -MP -o $@ $<,$(OK_STRING))
+
+-include $(HOST_DEPS)
@@ -0,0 +1,56 @@
+/**
+ * \file newlib_compat.h
+ *
+ * Newlib definitions that the kernel relies on, for the host build
+ *
+ * The kernel's file drivers report errors through newlib's reentrancy
+ * structure, which glibc doesn't have. This header is included ahead of every
+ * source file in the host build and provides a struct _reent whose errno is
+ * the calling thread's glibc errno, so r->_errno behaves the same as it does
+ * on the V5.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _NEWLIB_COMPAT_H_
+#define _NEWLIB_COMPAT_H_
+
+#include <errno.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct _reent {
+	int* _errno_location;  // the owning thread's errno
+	int __sdidinit;        // always set, since glibc initializes stdio itself
+};
+
+// r->_errno becomes r->_errno_location[0]
+#define _errno _errno_location[0]
+
+struct _reent* __host_getreent(void);
+void __sinit(struct _reent* s);
+
+#define _REENT (__host_getreent())
+#define _GLOBAL_REENT (__host_getreent())
+
+// newlib's integer-only printf
+#define iprintf printf
+
+#ifndef __cplusplus
+// newlib declares this whether or not _GNU_SOURCE is set
+int vasprintf(char** strp, const char* fmt, va_list ap);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _NEWLIB_COMPAT_H_
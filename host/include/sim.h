@@ -0,0 +1,138 @@
+/**
+ * \file sim.h
+ *
+ * Controls for the simulated V5 in the host build
+ *
+ * The simulator implements the VEX SDK on Linux so that the kernel can run as
+ * an ordinary process. Smart devices can be plugged into ports either with the
+ * PROS_HOST_DEVICES environment variable, e.g. PROS_HOST_DEVICES=1:motor,2:imu
+ * (see sim_parse_devices()), or from code with sim_set_device().
+ *
+ * Debug output that the kernel writes to kdbg is discarded unless the
+ * PROS_HOST_KDBG environment variable is set, in which case it goes to stderr.
+ * If PROS_HOST_USD names a directory, it stands in for the microSD card.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _SIM_H_
+#define _SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "v5_apitypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The command line that the program was started with
+ */
+extern int sim_argc;
+extern char** sim_argv;
+
+/**
+ * Sets up the simulator. Called by the host startup code before the kernel is
+ * initialized.
+ *
+ * \param argc
+ *        The number of command line arguments
+ * \param argv
+ *        The command line arguments
+ */
+void sim_initialize(int argc, char** argv);
+
+/**
+ * Plugs a device into a smart port, or unplugs it if type is
+ * kDeviceTypeNoSensor.
+ *
+ * \param port
+ *        The smart port number from 1-21
+ * \param type
+ *        The type of device to plug in
+ *
+ * \return true if the port was valid, false otherwise
+ */
+bool sim_set_device(uint8_t port, V5_DeviceType type);
+
+/**
+ * Plugs in the devices described by spec, a comma separated list of port:type
+ * pairs. The types are motor, rotation, imu, distance, vision, optical, gps,
+ * adi, serial and radio.
+ *
+ * \param spec
+ *        The devices to plug in
+ *
+ * \return true if the whole list was understood, false otherwise
+ */
+bool sim_parse_devices(const char* spec);
+
+/**
+ * Sets the value reported by competition_get_status().
+ *
+ * \param status
+ *        A combination of COMPETITION_DISABLED, COMPETITION_AUTONOMOUS and
+ *        COMPETITION_CONNECTED
+ */
+void sim_set_competition_status(uint32_t status);
+
+/**
+ * Sets the value of a controller's analog channel or button.
+ *
+ * \param id
+ *        The controller
+ * \param index
+ *        The channel or button
+ * \param value
+ *        The value to report
+ */
+void sim_set_controller(V5_ControllerId id, V5_ControllerIndex index, int32_t value);
+
+/**
+ * Gets the text that VEXos accepted for a line of a controller's screen.
+ *
+ * \param id
+ *        The controller
+ * \param line
+ *        The line, from 1-3, or 4 for the last rumble pattern
+ *
+ * \return The text, or NULL if the controller or line doesn't exist
+ */
+const char* sim_get_controller_text(V5_ControllerId id, uint32_t line);
+
+/**
+ * Sets the objects that a simulated vision sensor sees, from largest to
+ * smallest. Every frame reports the same objects until they are set again.
+ *
+ * \param port
+ *        The smart port number from 1-21
+ * \param objects
+ *        The objects, of which only the first 16 are kept
+ * \param count
+ *        The number of objects
+ */
+void sim_set_vision_objects(uint8_t port, const V5_DeviceVisionObject* objects, uint32_t count);
+
+/**
+ * Gets the number of objects that have been read from a simulated vision
+ * sensor.
+ *
+ * \param port
+ *        The smart port number from 1-21
+ *
+ * \return The number of objects read, or 0 if the port doesn't exist
+ */
+uint32_t sim_get_vision_reads(uint8_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _SIM_H_
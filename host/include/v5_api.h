@@ -0,0 +1,261 @@
+/**
+ * \file v5_api.h
+ *
+ * Functions from the VEX SDK, for the host build
+ *
+ * These are the SDK functions that the kernel calls. In the host build they
+ * are implemented by the simulator in host/sim rather than by vexOS.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _V5_API_H_
+#define _V5_API_H_
+
+#include <stdarg.h>
+
+#include "v5_apitypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* System */
+void vexBackgroundProcessing(void);
+uint32_t vexSystemTimeGet(void);
+uint64_t vexSystemHighResTimeGet(void);
+uint32_t vexSystemWatchdogGet(void);
+uint32_t vexSystemVersion(void);
+uint32_t vexSystemLinkAddrGet(void);
+void vexSystemExitRequest(void);
+void vexSystemTimerStop(void);
+void vexSystemTimerClearInterrupt(void);
+int32_t vexSystemTimerReinitForRtos(uint32_t priority, void (*handler)(void* data));
+void vexSystemWatchdogReinitRtos(void);
+uint32_t vexCompetitionStatus(void);
+
+/* Serial */
+int32_t vexSerialWriteBuffer(uint32_t channel, uint8_t* data, uint32_t data_len);
+int32_t vexSerialWriteFree(uint32_t channel);
+int32_t vexSerialReadChar(uint32_t channel);
+
+/* Devices */
+V5_DeviceT vexDeviceGetByIndex(uint32_t index);
+int32_t vexDeviceGetStatus(V5_DeviceType* buffer);
+uint32_t vexDeviceGetTimestamp(V5_DeviceT device);
+
+/* Motors */
+void vexDeviceMotorVelocitySet(V5_DeviceT device, int32_t velocity);
+void vexDeviceMotorVelocityUpdate(V5_DeviceT device, int32_t velocity);
+void vexDeviceMotorVoltageSet(V5_DeviceT device, int32_t value);
+int32_t vexDeviceMotorVelocityGet(V5_DeviceT device);
+double vexDeviceMotorActualVelocityGet(V5_DeviceT device);
+int32_t vexDeviceMotorDirectionGet(V5_DeviceT device);
+void vexDeviceMotorModeSet(V5_DeviceT device, int32_t mode);
+void vexDeviceMotorPwmSet(V5_DeviceT device, int32_t value);
+void vexDeviceMotorCurrentLimitSet(V5_DeviceT device, int32_t value);
+int32_t vexDeviceMotorCurrentLimitGet(V5_DeviceT device);
+int32_t vexDeviceMotorVoltageGet(V5_DeviceT device);
+int32_t vexDeviceMotorCurrentGet(V5_DeviceT device);
+double vexDeviceMotorPowerGet(V5_DeviceT device);
+double vexDeviceMotorTorqueGet(V5_DeviceT device);
+double vexDeviceMotorEfficiencyGet(V5_DeviceT device);
+double vexDeviceMotorTemperatureGet(V5_DeviceT device);
+bool vexDeviceMotorOverTempFlagGet(V5_DeviceT device);
+bool vexDeviceMotorCurrentLimitFlagGet(V5_DeviceT device);
+uint32_t vexDeviceMotorFaultsGet(V5_DeviceT device);
+bool vexDeviceMotorZeroVelocityFlagGet(V5_DeviceT device);
+bool vexDeviceMotorZeroPositionFlagGet(V5_DeviceT device);
+uint32_t vexDeviceMotorFlagsGet(V5_DeviceT device);
+void vexDeviceMotorReverseFlagSet(V5_DeviceT device, bool value);
+bool vexDeviceMotorReverseFlagGet(V5_DeviceT device);
+void vexDeviceMotorEncoderUnitsSet(V5_DeviceT device, V5MotorEncoderUnits units);
+V5MotorEncoderUnits vexDeviceMotorEncoderUnitsGet(V5_DeviceT device);
+void vexDeviceMotorBrakeModeSet(V5_DeviceT device, V5MotorBrakeMode mode);
+V5MotorBrakeMode vexDeviceMotorBrakeModeGet(V5_DeviceT device);
+void vexDeviceMotorPositionSet(V5_DeviceT device, double position);
+double vexDeviceMotorPositionGet(V5_DeviceT device);
+int32_t vexDeviceMotorPositionRawGet(V5_DeviceT device, uint32_t* timestamp);
+void vexDeviceMotorPositionReset(V5_DeviceT device);
+double vexDeviceMotorTargetGet(V5_DeviceT device);
+void vexDeviceMotorServoTargetSet(V5_DeviceT device, double position);
+void vexDeviceMotorAbsoluteTargetSet(V5_DeviceT device, double position, int32_t veloctiy);
+void vexDeviceMotorRelativeTargetSet(V5_DeviceT device, double position, int32_t velocity);
+void vexDeviceMotorGearingSet(V5_DeviceT device, V5MotorGearset value);
+V5MotorGearset vexDeviceMotorGearingGet(V5_DeviceT device);
+void vexDeviceMotorExternalProfileSet(V5_DeviceT device, double position, int32_t velocity);
+void vexDeviceMotorPositionPidSet(V5_DeviceT device, V5_DeviceMotorPid* pid);
+void vexDeviceMotorVelocityPidSet(V5_DeviceT device, V5_DeviceMotorPid* pid);
+void vexDeviceMotorVoltageLimitSet(V5_DeviceT device, int32_t value);
+int32_t vexDeviceMotorVoltageLimitGet(V5_DeviceT device);
+
+/* ADI */
+void vexDeviceAdiPortConfigSet(V5_DeviceT device, uint32_t port, V5_AdiPortConfiguration type);
+V5_AdiPortConfiguration vexDeviceAdiPortConfigGet(V5_DeviceT device, uint32_t port);
+void vexDeviceAdiValueSet(V5_DeviceT device, uint32_t port, int32_t value);
+int32_t vexDeviceAdiValueGet(V5_DeviceT device, uint32_t port);
+int32_t vexDeviceAdiAddrLedSet(V5_DeviceT device, uint32_t port, uint32_t* pData, uint32_t nOffset, uint32_t nLength, uint32_t options);
+
+/* IMU */
+void vexDeviceImuReset(V5_DeviceT device);
+double vexDeviceImuHeadingGet(V5_DeviceT device);
+double vexDeviceImuDegreesGet(V5_DeviceT device);
+void vexDeviceImuQuaternionGet(V5_DeviceT device, V5_DeviceImuQuaternion* data);
+void vexDeviceImuAttitudeGet(V5_DeviceT device, V5_DeviceImuAttitude* data);
+void vexDeviceImuRawGyroGet(V5_DeviceT device, V5_DeviceImuRaw* data);
+void vexDeviceImuRawAccelGet(V5_DeviceT device, V5_DeviceImuRaw* data);
+uint32_t vexDeviceImuStatusGet(V5_DeviceT device);
+void vexDeviceImuDataRateSet(V5_DeviceT device, uint32_t rate);
+
+/* Rotation */
+void vexDeviceAbsEncReset(V5_DeviceT device);
+void vexDeviceAbsEncPositionSet(V5_DeviceT device, int32_t position);
+int32_t vexDeviceAbsEncPositionGet(V5_DeviceT device);
+int32_t vexDeviceAbsEncVelocityGet(V5_DeviceT device);
+int32_t vexDeviceAbsEncAngleGet(V5_DeviceT device);
+void vexDeviceAbsEncReverseFlagSet(V5_DeviceT device, bool value);
+bool vexDeviceAbsEncReverseFlagGet(V5_DeviceT device);
+uint32_t vexDeviceAbsEncStatusGet(V5_DeviceT device);
+void vexDeviceAbsEncDataRateSet(V5_DeviceT device, uint32_t rate);
+void vexAbsEncReverseFlagSet(uint32_t index, bool value);
+
+/* Distance */
+uint32_t vexDeviceDistanceDistanceGet(V5_DeviceT device);
+uint32_t vexDeviceDistanceConfidenceGet(V5_DeviceT device);
+int32_t vexDeviceDistanceObjectSizeGet(V5_DeviceT device);
+double vexDeviceDistanceObjectVelocityGet(V5_DeviceT device);
+uint32_t vexDeviceDistanceStatusGet(V5_DeviceT device);
+
+/* Optical */
+double vexDeviceOpticalHueGet(V5_DeviceT device);
+double vexDeviceOpticalSatGet(V5_DeviceT device);
+double vexDeviceOpticalBrightnessGet(V5_DeviceT device);
+int32_t vexDeviceOpticalProximityGet(V5_DeviceT device);
+void vexDeviceOpticalRgbGet(V5_DeviceT device, V5_DeviceOpticalRgb* data);
+void vexDeviceOpticalLedPwmSet(V5_DeviceT device, int32_t value);
+int32_t vexDeviceOpticalLedPwmGet(V5_DeviceT device);
+void vexDeviceOpticalRawGet(V5_DeviceT device, V5_DeviceOpticalRaw* data);
+void vexDeviceOpticalGestureEnable(V5_DeviceT device);
+void vexDeviceOpticalGestureDisable(V5_DeviceT device);
+int32_t vexDeviceOpticalGestureGet(V5_DeviceT device, V5_DeviceOpticalGesture* pData);
+
+/* GPS */
+void vexDeviceGpsReset(V5_DeviceT device);
+double vexDeviceGpsHeadingGet(V5_DeviceT device);
+double vexDeviceGpsDegreesGet(V5_DeviceT device);
+void vexDeviceGpsAttitudeGet(V5_DeviceT device, V5_DeviceGpsAttitude* data, bool bRaw);
+void vexDeviceGpsRawGyroGet(V5_DeviceT device, V5_DeviceGpsRaw* data);
+void vexDeviceGpsRawAccelGet(V5_DeviceT device, V5_DeviceGpsRaw* data);
+uint32_t vexDeviceGpsStatusGet(V5_DeviceT device);
+void vexDeviceGpsOriginSet(V5_DeviceT device, double ox, double oy);
+void vexDeviceGpsOriginGet(V5_DeviceT device, double* ox, double* oy);
+void vexDeviceGpsRotationSet(V5_DeviceT device, double value);
+double vexDeviceGpsRotationGet(V5_DeviceT device);
+void vexDeviceGpsInitialPositionSet(V5_DeviceT device, double initial_x, double initial_y, double initial_rotation);
+double vexDeviceGpsErrorGet(V5_DeviceT device);
+void vexDeviceGpsDataRateSet(V5_DeviceT device, uint32_t rate);
+
+/* Vision */
+void vexDeviceVisionModeSet(V5_DeviceT device, uint32_t mode);
+int32_t vexDeviceVisionObjectCountGet(V5_DeviceT device);
+int32_t vexDeviceVisionObjectGet(V5_DeviceT device, uint32_t indexObj, V5_DeviceVisionObject* pObject);
+void vexDeviceVisionSignatureSet(V5_DeviceT device, V5_DeviceVisionSignature* pSignature);
+bool vexDeviceVisionSignatureGet(V5_DeviceT device, uint32_t id, V5_DeviceVisionSignature* pSignature);
+void vexDeviceVisionBrightnessSet(V5_DeviceT device, uint8_t value);
+uint8_t vexDeviceVisionBrightnessGet(V5_DeviceT device);
+void vexDeviceVisionWhiteBalanceModeSet(V5_DeviceT device, uint32_t mode);
+void vexDeviceVisionWhiteBalanceSet(V5_DeviceT device, V5_DeviceVisionRgb color);
+V5_DeviceVisionRgb vexDeviceVisionWhiteBalanceGet(V5_DeviceT device);
+void vexDeviceVisionLedModeSet(V5_DeviceT device, uint32_t mode);
+void vexDeviceVisionLedColorSet(V5_DeviceT device, V5_DeviceVisionRgb color);
+void vexDeviceVisionWifiModeSet(V5_DeviceT device, uint32_t mode);
+
+/* Serial / radio */
+void vexDeviceGenericSerialEnable(V5_DeviceT device, int32_t options);
+void vexDeviceGenericSerialBaudrate(V5_DeviceT device, int32_t baudrate);
+int32_t vexDeviceGenericSerialWriteChar(V5_DeviceT device, uint8_t c);
+int32_t vexDeviceGenericSerialWriteFree(V5_DeviceT device);
+int32_t vexDeviceGenericSerialTransmit(V5_DeviceT device, uint8_t* buffer, int32_t length);
+int32_t vexDeviceGenericSerialReadChar(V5_DeviceT device);
+int32_t vexDeviceGenericSerialPeekChar(V5_DeviceT device);
+int32_t vexDeviceGenericSerialReceiveAvail(V5_DeviceT device);
+int32_t vexDeviceGenericSerialReceive(V5_DeviceT device, uint8_t* buffer, int32_t length);
+void vexDeviceGenericSerialFlush(V5_DeviceT device);
+void vexDeviceGenericRadioConnection(V5_DeviceT device, char* link_id, int type, bool ov);
+int32_t vexDeviceGenericRadioWriteFree(V5_DeviceT device);
+int32_t vexDeviceGenericRadioTransmit(V5_DeviceT device, uint8_t* data, uint16_t size);
+int32_t vexDeviceGenericRadioReceiveAvail(V5_DeviceT device);
+int32_t vexDeviceGenericRadioReceive(V5_DeviceT device, uint8_t* data, uint16_t size);
+bool vexDeviceGenericRadioLinkStatus(V5_DeviceT device);
+
+/* Controller */
+int32_t vexControllerGet(V5_ControllerId id, V5_ControllerIndex index);
+int32_t vexControllerConnectionStatusGet(V5_ControllerId id);
+uint32_t vexControllerTextSet(uint32_t id, uint32_t line, uint32_t col, const char* buf);
+
+/* Battery */
+int32_t vexBatteryVoltageGet(void);
+int32_t vexBatteryCurrentGet(void);
+double vexBatteryTemperatureGet(void);
+double vexBatteryCapacityGet(void);
+
+/* Display */
+void vexDisplayForegroundColor(uint32_t col);
+void vexDisplayBackgroundColor(uint32_t col);
+uint32_t vexDisplayForegroundColorGet(void);
+uint32_t vexDisplayBackgroundColorGet(void);
+void vexDisplayErase(void);
+void vexDisplayScroll(int32_t nStartLine, int32_t nLines);
+void vexDisplayScrollRect(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t nLines);
+void vexDisplayCopyRect(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t* pSrc, int32_t srcStride);
+void vexDisplayPixelSet(uint32_t x, uint32_t y);
+void vexDisplayPixelClear(uint32_t x, uint32_t y);
+void vexDisplayLineDraw(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void vexDisplayLineClear(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void vexDisplayRectDraw(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void vexDisplayRectClear(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void vexDisplayRectFill(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void vexDisplayCircleDraw(int32_t xc, int32_t yc, int32_t radius);
+void vexDisplayCircleClear(int32_t xc, int32_t yc, int32_t radius);
+void vexDisplayCircleFill(int32_t xc, int32_t yc, int32_t radius);
+void vexDisplayPrintf(int32_t xpos, int32_t ypos, uint32_t bOpaque, const char* format, ...);
+void vexDisplayString(const int32_t nLineNumber, const char* format, ...);
+void vexDisplayStringAt(int32_t xpos, int32_t ypos, const char* format, ...);
+void vexDisplayBigString(const int32_t nLineNumber, const char* format, ...);
+void vexDisplayBigStringAt(int32_t xpos, int32_t ypos, const char* format, ...);
+void vexDisplaySmallStringAt(int32_t xpos, int32_t ypos, const char* format, ...);
+void vexDisplayCenteredString(const int32_t nLineNumber, const char* format, ...);
+void vexDisplayBigCenteredString(const int32_t nLineNumber, const char* format, ...);
+void vexDisplayVPrintf(int32_t xpos, int32_t ypos, uint32_t bOpaque, const char* format, va_list args);
+void vexDisplayVString(const int32_t nLineNumber, const char* format, va_list args);
+void vexDisplayVStringAt(int32_t xpos, int32_t ypos, const char* format, va_list args);
+void vexDisplayVBigString(const int32_t nLineNumber, const char* format, va_list args);
+void vexDisplayVBigStringAt(int32_t xpos, int32_t ypos, const char* format, va_list args);
+void vexDisplayVSmallStringAt(int32_t xpos, int32_t ypos, const char* format, va_list args);
+void vexDisplayVCenteredString(const int32_t nLineNumber, const char* format, va_list args);
+void vexDisplayVBigCenteredString(const int32_t nLineNumber, const char* format, va_list args);
+void vexTouchDataGet(V5_TouchStatus* status);
+
+/* Files */
+FRESULT vexFileMountSD(void);
+FIL* vexFileOpen(const char* filename, const char* mode);
+FIL* vexFileOpenWrite(const char* filename);
+FIL* vexFileOpenCreate(const char* filename);
+void vexFileClose(FIL* fdp);
+int32_t vexFileWrite(char* buf, uint32_t size, uint32_t nItems, FIL* fdp);
+int32_t vexFileSize(FIL* fdp);
+FRESULT vexFileSeek(FIL* fdp, uint32_t offset, int32_t whence);
+int32_t vexFileRead(char* buf, uint32_t size, uint32_t nItems, FIL* fdp);
+int32_t vexFileTell(FIL* fdp);
+uint32_t vexFileDriveStatus(uint32_t drive);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _V5_API_H_
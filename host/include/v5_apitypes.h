@@ -0,0 +1,253 @@
+/**
+ * \file v5_apitypes.h
+ *
+ * Types from the VEX SDK, for the host build
+ *
+ * Only the types that the kernel uses are declared here. They mirror the
+ * layouts in the real SDK closely enough for the kernel to compile against
+ * them, but the simulator is the only thing that ever looks inside them.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _V5_APITYPES_H_
+#define _V5_APITYPES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define V5_MAX_DEVICE_PORTS 32
+
+typedef struct _V5_Device* V5_DeviceT;
+
+typedef enum {
+	kDeviceTypeNoSensor = 0,
+	kDeviceTypeMotorSensor = 2,
+	kDeviceTypeLedSensor = 3,
+	kDeviceTypeAbsEncSensor = 4,
+	kDeviceTypeCrMotorSensor = 5,
+	kDeviceTypeImuSensor = 6,
+	kDeviceTypeDistanceSensor = 7,
+	kDeviceTypeRadioSensor = 8,
+	kDeviceTypeTetherSensor = 9,
+	kDeviceTypeBrainSensor = 10,
+	kDeviceTypeVisionSensor = 11,
+	kDeviceTypeAdiSensor = 12,
+	kDeviceTypeOpticalSensor = 16,
+	kDeviceTypeMagnetSensor = 17,
+	kDeviceTypeGpsSensor = 20,
+	kDeviceTypeGenericSensor = 128,
+	kDeviceTypeGenericSerial = 129,
+	kDeviceTypeUndefinedSensor = 255
+} V5_DeviceType;
+
+typedef enum { kMotorBrakeModeCoast = 0, kMotorBrakeModeBrake, kMotorBrakeModeHold } V5MotorBrakeMode;
+typedef enum { kMotorEncoderDegrees = 0, kMotorEncoderRotations, kMotorEncoderCounts } V5MotorEncoderUnits;
+typedef enum { kMotorGearSet_36 = 0, kMotorGearSet_18, kMotorGearSet_06 } V5MotorGearset;
+
+typedef struct __attribute__((packed)) {
+	uint8_t kf;
+	uint8_t kp;
+	uint8_t ki;
+	uint8_t kd;
+	uint8_t filter;
+	uint8_t pad1;
+	uint16_t limit;
+	uint8_t threshold;
+	uint8_t loopspeed;
+	uint8_t pad2[2];
+} V5_DeviceMotorPid;
+
+typedef enum { kAdiPortTypeAnalogIn = 0, kAdiPortTypeUndefined = 255 } V5_AdiPortConfiguration;
+
+typedef struct {
+	double pitch;
+	double roll;
+	double yaw;
+} V5_DeviceImuAttitude;
+
+typedef struct {
+	double x;
+	double y;
+	double z;
+	double w;
+} V5_DeviceImuRaw;
+
+typedef struct {
+	double a;
+	double b;
+	double c;
+	double d;
+} V5_DeviceImuQuaternion;
+
+typedef enum { kVisionTypeNormal = 0, kVisionTypeColorCode = 1, kVisionTypeLineDetect = 2 } V5VisionBlockType;
+
+typedef struct __attribute__((packed)) {
+	uint16_t signature;
+	V5VisionBlockType type;
+	uint16_t xoffset;
+	uint16_t yoffset;
+	uint16_t width;
+	uint16_t height;
+	uint16_t angle;
+} V5_DeviceVisionObject;
+
+typedef struct __attribute__((packed)) {
+	uint8_t id;
+	uint8_t flags;
+	uint8_t pad[2];
+	float range;
+	int32_t uMin;
+	int32_t uMax;
+	int32_t uMean;
+	int32_t vMin;
+	int32_t vMax;
+	int32_t vMean;
+	uint32_t mRgb;
+	uint32_t mType;
+} V5_DeviceVisionSignature;
+
+typedef struct {
+	uint8_t red;
+	uint8_t green;
+	uint8_t blue;
+	uint8_t brightness;
+} V5_DeviceVisionRgb;
+
+typedef struct {
+	double pitch;
+	double roll;
+	double yaw;
+	double position_x;
+	double position_y;
+	double position_z;
+	double az;
+	double el;
+	double rot;
+} V5_DeviceGpsAttitude;
+
+typedef struct {
+	double x;
+	double y;
+	double z;
+	double w;
+} V5_DeviceGpsRaw;
+
+typedef struct {
+	double red;
+	double green;
+	double blue;
+	double brightness;
+} V5_DeviceOpticalRgb;
+
+typedef struct {
+	uint16_t clear;
+	uint16_t red;
+	uint16_t green;
+	uint16_t blue;
+} V5_DeviceOpticalRaw;
+
+typedef struct {
+	uint8_t udata;
+	uint8_t ddata;
+	uint8_t ldata;
+	uint8_t rdata;
+	uint8_t type;
+	uint8_t pad;
+	uint16_t count;
+	uint32_t time;
+} V5_DeviceOpticalGesture;
+
+typedef enum { kTouchEventRelease, kTouchEventPress, kTouchEventPressAuto } V5_TouchEvent;
+
+typedef struct {
+	V5_TouchEvent lastEvent;
+	int16_t lastXpos;
+	int16_t lastYpos;
+	int32_t pressCount;
+	int32_t releaseCount;
+} V5_TouchStatus;
+
+typedef enum { kControllerMaster = 0, kControllerPartner } V5_ControllerId;
+
+typedef enum {
+	AnaLeftX = 0,
+	AnaLeftY,
+	AnaRightX,
+	AnaRightY,
+	AnaSpare1,
+	AnaSpare2,
+	Button5U,
+	Button5D,
+	Button6U,
+	Button6D,
+	Button7U,
+	Button7D,
+	Button7L,
+	Button7R,
+	Button8U,
+	Button8D,
+	Button8L,
+	Button8R,
+	ButtonSEL,
+	BatteryLevel,
+	ButtonAll,
+	Flags,
+	BatteryCapacity,
+	Axis1 = AnaRightX,
+	Axis2 = AnaRightY,
+	Axis3 = AnaLeftY,
+	Axis4 = AnaLeftX,
+	ButtonL1 = Button5U,
+	ButtonL2 = Button5D,
+	ButtonR1 = Button6U,
+	ButtonR2 = Button6D,
+	ButtonUp = Button7U,
+	ButtonDown = Button7D,
+	ButtonLeft = Button7L,
+	ButtonRight = Button7R,
+	ButtonX = Button8U,
+	ButtonB = Button8D,
+	ButtonY = Button8L,
+	ButtonA = Button8R
+} V5_ControllerIndex;
+
+typedef enum {
+	FR_OK = 0,
+	FR_DISK_ERR,
+	FR_INT_ERR,
+	FR_NOT_READY,
+	FR_NO_FILE,
+	FR_NO_PATH,
+	FR_INVALID_NAME,
+	FR_DENIED,
+	FR_EXIST,
+	FR_INVALID_OBJECT,
+	FR_WRITE_PROTECTED,
+	FR_INVALID_DRIVE,
+	FR_NOT_ENABLED,
+	FR_NO_FILESYSTEM,
+	FR_MKFS_ABORTED,
+	FR_TIMEOUT,
+	FR_LOCKED,
+	FR_NOT_ENOUGH_CORE,
+	FR_TOO_MANY_OPEN_FILES,
+	FR_INVALID_PARAMETER
+} FRESULT;
+
+typedef struct _FIL FIL;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _V5_APITYPES_H_
@@ -0,0 +1,23 @@
+/**
+ * \file v5_color.h
+ *
+ * Color constants from the VEX SDK, for the host build
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _V5_COLOR_H_
+#define _V5_COLOR_H_
+
+#define ClrBlack 0x00000000
+#define ClrWhite 0x00FFFFFF
+#define ClrRed 0x00FF0000
+#define ClrGreen 0x0000FF00
+#define ClrBlue 0x000000FF
+
+#endif  // _V5_COLOR_H_
@@ -0,0 +1,436 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*-----------------------------------------------------------
+ * Implementation of functions defined in portable.h for the POSIX (host) port.
+ *
+ * Each task runs on its own pthread.  A thread only runs while its task is the
+ * running task: every other thread is parked on its own event.  A context
+ * switch wakes the thread of the task that is switched to and then parks the
+ * thread that was running, so exactly one task thread makes progress at a
+ * time, just as on the V5.
+ *
+ * The tick interrupt is SIGALRM.  The signal is blocked on every thread except
+ * the running task's thread outside of critical sections, so the tick handler
+ * always runs on the thread of the task that it interrupts.
+ *----------------------------------------------------------*/
+
+/* Standard includes. */
+#include <pthread.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Scheduler includes. */
+#include "rtos/FreeRTOS.h"
+#include "rtos/task.h"
+#include "system/profiler.h"
+
+/*-----------------------------------------------------------*/
+
+/* A binary event that a thread can park itself on. */
+typedef struct EVENT
+{
+	pthread_mutex_t xMutex;
+	pthread_cond_t xCond;
+	int32_t xSignaled;
+} Event_t;
+
+/* The bookkeeping for a task's thread, stored at the top of the task's
+FreeRTOS stack. */
+typedef struct THREAD
+{
+	pthread_t xThread;
+	task_fn_t pxCode;
+	void *pvParams;
+	volatile int32_t xDying;
+	Event_t xEvent;
+	jmp_buf xExit;
+} Thread_t;
+
+/* The critical nesting depth of the running task.  It is saved and restored
+around every switch, so each thread sees its own value. */
+static volatile uint32_t uxCriticalNesting = 0;
+
+/* The address that the latest tick interrupted and the return address of the
+function it interrupted, for the profiler.  The simulator's tick signal handler
+saves them relative to the start of the executable, so that they fit in 32 bits
+and match the symbols in its ELF. */
+volatile uint32_t ulPortInterruptedContext[ 2 ] = { 0UL, 0UL };
+volatile uint32_t ulPortProfilerEnabled = pdFALSE;
+
+/* The bookkeeping of the calling thread, or NULL on threads that don't belong
+to a task. */
+static __thread Thread_t *pxThreadSelf = NULL;
+
+/* Set by vPortEndScheduler() to release xPortStartScheduler(). */
+static Event_t xSchedulerEnd = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, pdFALSE };
+
+static void *prvWaitForStart( void *pvParams );
+static void prvSwitchThread( Thread_t *pxThreadToResume, Thread_t *pxThreadToSuspend );
+
+/*-----------------------------------------------------------*/
+
+static void prvEventInit( Event_t *pxEvent )
+{
+	pthread_mutex_init( &pxEvent->xMutex, NULL );
+	pthread_cond_init( &pxEvent->xCond, NULL );
+	pxEvent->xSignaled = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventDestroy( Event_t *pxEvent )
+{
+	pthread_mutex_destroy( &pxEvent->xMutex );
+	pthread_cond_destroy( &pxEvent->xCond );
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventWait( Event_t *pxEvent )
+{
+	pthread_mutex_lock( &pxEvent->xMutex );
+	while( pxEvent->xSignaled == pdFALSE )
+	{
+		pthread_cond_wait( &pxEvent->xCond, &pxEvent->xMutex );
+	}
+	pxEvent->xSignaled = pdFALSE;
+	pthread_mutex_unlock( &pxEvent->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventSignal( Event_t *pxEvent )
+{
+	pthread_mutex_lock( &pxEvent->xMutex );
+	pxEvent->xSignaled = pdTRUE;
+	pthread_cond_signal( &pxEvent->xCond );
+	pthread_mutex_unlock( &pxEvent->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+/* Fills in the set of signals that are masked while interrupts are disabled.
+This is used before any constructor is guaranteed to have run, so the set is
+built when it's needed rather than once up front. */
+static inline void prvGetTickSignal( sigset_t *pxSignals )
+{
+	sigemptyset( pxSignals );
+	sigaddset( pxSignals, SIGALRM );
+}
+/*-----------------------------------------------------------*/
+
+static inline Thread_t *prvGetThreadFromTask( task_t xTask )
+{
+	/* pxTopOfStack is the first member of the TCB, and it points at the
+	Thread_t that pxPortInitialiseStack() placed on the stack. */
+	return ( Thread_t * ) *( task_stack_t ** ) xTask;
+}
+/*-----------------------------------------------------------*/
+
+/* Ends the calling task's thread.  A deleted task doesn't unwind its stack on
+the V5, so the thread jumps straight back to prvWaitForStart() rather than
+calling pthread_exit(), which would unwind through (and could be caught by) the
+task's C++ frames. */
+static void prvExitThread( Thread_t *pxThread )
+{
+	longjmp( pxThread->xExit, 1 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSuspendSelf( Thread_t *pxThread )
+{
+	prvEventWait( &pxThread->xEvent );
+
+	/* The task may have been deleted by another task while it was parked. */
+	if( pxThread->xDying != pdFALSE )
+	{
+		prvExitThread( pxThread );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+task_stack_t *pxPortInitialiseStack( task_stack_t *pxTopOfStack, task_fn_t pxCode, void *pvParameters )
+{
+Thread_t *pxThread;
+pthread_attr_t xAttr;
+sigset_t xTickSignal;
+sigset_t xSavedSignals;
+
+	/* pxTopOfStack points at the last word of the stack and is only aligned to
+	portBYTE_ALIGNMENT, so the Thread_t is aligned down to a cache line.  A
+	pthread object that straddles two lines makes every atomic on it a split
+	lock, which the host traps and throttles. */
+	pxThread = ( Thread_t * ) ( ( ( uintptr_t ) ( pxTopOfStack + 1 ) - sizeof( Thread_t ) ) & ~( uintptr_t ) 63 );
+	memset( pxThread, 0, sizeof( *pxThread ) );
+	pxThread->pxCode = pxCode;
+	pxThread->pvParams = pvParameters;
+	pxThread->xDying = pdFALSE;
+	prvEventInit( &pxThread->xEvent );
+
+	/* The new thread inherits the signal mask of this one, and it must start
+	with the tick blocked. */
+	prvGetTickSignal( &xTickSignal );
+	pthread_sigmask( SIG_BLOCK, &xTickSignal, &xSavedSignals );
+
+	pthread_attr_init( &xAttr );
+	if( pthread_create( &pxThread->xThread, &xAttr, prvWaitForStart, pxThread ) != 0 )
+	{
+		configASSERT( pdFALSE );
+	}
+	pthread_attr_destroy( &xAttr );
+
+	pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+
+	return ( task_stack_t * ) pxThread;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvWaitForStart( void *pvParams )
+{
+Thread_t *pxThread = ( Thread_t * ) pvParams;
+extern void task_fn_wrapper( task_fn_t fn, void *args );
+
+	pxThreadSelf = pxThread;
+	if( setjmp( pxThread->xExit ) != 0 )
+	{
+		/* The task has been deleted. */
+		return NULL;
+	}
+
+	prvSuspendSelf( pxThread );
+
+	/* The task is running for the first time, so it starts outside of any
+	critical section and with the tick unblocked. */
+	uxCriticalNesting = 0;
+	vPortEnableInterrupts();
+
+	task_fn_wrapper( pxThread->pxCode, pxThread->pvParams );
+
+	/* A task that returns from its implementing function is deleted, as it is
+	on the V5. */
+	task_delete( NULL );
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchThread( Thread_t *pxThreadToResume, Thread_t *pxThreadToSuspend )
+{
+uint32_t uxSavedCriticalNesting;
+
+	if( pxThreadToSuspend != pxThreadToResume )
+	{
+		uxSavedCriticalNesting = uxCriticalNesting;
+
+		prvEventSignal( &pxThreadToResume->xEvent );
+
+		if( pxThreadToSuspend->xDying != pdFALSE )
+		{
+			/* The task deleted itself.  Its thread is joined when the idle task
+			frees the TCB. */
+			prvExitThread( pxThreadToSuspend );
+		}
+
+		prvSuspendSelf( pxThreadToSuspend );
+
+		uxCriticalNesting = uxSavedCriticalNesting;
+	}
+}
+/*-----------------------------------------------------------*/
+
+int32_t xPortStartScheduler( void )
+{
+	/* Interrupts were disabled by rtos_sched_start(), so the tick can't be
+	delivered to this thread.  From here on it only runs on task threads. */
+	configSETUP_TICK_INTERRUPT();
+
+	/* Start the first task executing. */
+	prvEventSignal( &prvGetThreadFromTask( task_get_current() )->xEvent );
+
+	/* Park this thread until the scheduler is stopped. */
+	prvEventWait( &xSchedulerEnd );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+	/* Interrupts have been disabled by rtos_sched_stop(), so no tick will be
+	delivered to any thread from here on. */
+	prvEventSignal( &xSchedulerEnd );
+	prvExitThread( pxThreadSelf );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+Thread_t *pxThreadToSuspend;
+Thread_t *pxThreadToResume;
+
+	vPortEnterCritical();
+	{
+		pxThreadToSuspend = prvGetThreadFromTask( task_get_current() );
+		vTaskSwitchContext();
+		pxThreadToResume = prvGetThreadFromTask( task_get_current() );
+
+		prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+	}
+	vPortExitCritical();
+}
+/*-----------------------------------------------------------*/
+
+int32_t xPortIsTaskThread( void )
+{
+	return ( pxThreadSelf != NULL && pxThreadSelf->xDying == pdFALSE ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortThreadDying( void *pvTaskToDelete, volatile int32_t *pxPendYield )
+{
+	( void ) pxPendYield;
+
+	prvGetThreadFromTask( ( task_t ) pvTaskToDelete )->xDying = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCancelThread( void *pvTaskToDelete )
+{
+Thread_t *pxThread = prvGetThreadFromTask( ( task_t ) pvTaskToDelete );
+
+	/* A task deleted by another task is parked, so wake it up to exit.  A task
+	that deleted itself has already exited (or is just about to). */
+	if( pxThread->xDying == pdFALSE )
+	{
+		pxThread->xDying = pdTRUE;
+		prvEventSignal( &pxThread->xEvent );
+	}
+
+	pthread_join( pxThread->xThread, NULL );
+	prvEventDestroy( &pxThread->xEvent );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+	if( uxCriticalNesting == 0 )
+	{
+		vPortDisableInterrupts();
+	}
+	uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	if( uxCriticalNesting > 0 )
+	{
+		uxCriticalNesting--;
+
+		/* If the nesting level has reached zero then the tick can be
+		delivered again. */
+		if( uxCriticalNesting == 0 )
+		{
+			vPortEnableInterrupts();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+sigset_t xTickSignal;
+
+	prvGetTickSignal( &xTickSignal );
+	pthread_sigmask( SIG_BLOCK, &xTickSignal, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+sigset_t xTickSignal;
+
+	prvGetTickSignal( &xTickSignal );
+	pthread_sigmask( SIG_UNBLOCK, &xTickSignal, NULL );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortSetInterruptMask( void )
+{
+sigset_t xTickSignal;
+sigset_t xOldSignals;
+
+	/* Returns pdTRUE if the tick was already blocked, which is always the case
+	inside the tick handler. */
+	prvGetTickSignal( &xTickSignal );
+	pthread_sigmask( SIG_BLOCK, &xTickSignal, &xOldSignals );
+	return sigismember( &xOldSignals, SIGALRM ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( uint32_t ulNewMaskValue )
+{
+	if( ulNewMaskValue == pdFALSE )
+	{
+		vPortEnableInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortInstallFreeRTOSVectorTable( void )
+{
+	/* There is no vector table to install. */
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_Tick_Handler( void )
+{
+Thread_t *pxThreadToSuspend;
+Thread_t *pxThreadToResume;
+
+	/* The tick is blocked while its handler runs, which makes this a critical
+	section. */
+	uxCriticalNesting++;
+
+	profiler_sample( ulPortInterruptedContext[ 0 ], ulPortInterruptedContext[ 1 ] );
+
+	pxThreadToSuspend = prvGetThreadFromTask( task_get_current() );
+
+	/* Increment the RTOS tick. */
+	if( xTaskIncrementTick() != pdFALSE )
+	{
+		vTaskSwitchContext();
+		pxThreadToResume = prvGetThreadFromTask( task_get_current() );
+
+		prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+	}
+
+	uxCriticalNesting--;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,256 @@
+/**
+ * \file sim/brain.c
+ *
+ * Simulated V5 brain peripherals
+ *
+ * The serial console is the process's stdin and stdout, the controllers report
+ * whatever was set with sim_set_controller() and remember the text that reached
+ * them, and the screen draws nothing. If the PROS_HOST_USD environment variable
+ * names a directory, it is used as the microSD card.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <poll.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "v5_api.h"
+#include "v5_color.h"
+
+/******************************************************************************/
+/**                              Serial console                              **/
+/******************************************************************************/
+
+// The V5's serial output buffer is 2 KB
+#define SERIAL_WRITE_FREE 2048
+
+int32_t vexSerialWriteBuffer(uint32_t channel, uint8_t* data, uint32_t data_len) {
+	(void)channel;
+	ssize_t written = write(STDOUT_FILENO, data, data_len);
+	return written < 0 ? 0 : written;
+}
+
+int32_t vexSerialWriteFree(uint32_t channel) {
+	(void)channel;
+	return SERIAL_WRITE_FREE;
+}
+
+int32_t vexSerialReadChar(uint32_t channel) {
+	(void)channel;
+	struct pollfd fd = {.fd = STDIN_FILENO, .events = POLLIN};
+	uint8_t c;
+	if (poll(&fd, 1, 0) > 0 && read(STDIN_FILENO, &c, 1) == 1) {
+		return c;
+	}
+	return -1;
+}
+
+/******************************************************************************/
+/**                               Controllers                                **/
+/******************************************************************************/
+
+static int32_t controller_values[2][BatteryCapacity + 1];
+
+void sim_set_controller(V5_ControllerId id, V5_ControllerIndex index, int32_t value) {
+	if (id <= kControllerPartner && index <= BatteryCapacity) {
+		controller_values[id][index] = value;
+	}
+}
+
+int32_t vexControllerGet(V5_ControllerId id, V5_ControllerIndex index) {
+	if (id > kControllerPartner || index > BatteryCapacity) {
+		return 0;
+	}
+	return controller_values[id][index];
+}
+
+int32_t vexControllerConnectionStatusGet(V5_ControllerId id) {
+	// the master controller is always tethered
+	return id == kControllerMaster ? 1 : 0;
+}
+
+// Lines 1-3 are text and line 4 is the last rumble pattern
+static char controller_text[2][5][21];
+static uint32_t controller_last_text;
+
+uint32_t vexControllerTextSet(uint32_t id, uint32_t line, uint32_t col, const char* buf) {
+	// Like VEXos, drop updates that come too quickly after the last one
+	uint32_t now = vexSystemTimeGet();
+	if (id != kControllerMaster || line > 4 || col < 1 || col > 20 ||
+	    (controller_last_text && now - controller_last_text < 50)) {
+		return 0;
+	}
+	controller_last_text = now;
+	char* text = controller_text[id][line];
+	for (uint32_t i = col - 1; i < 20 && *buf; i++) {
+		text[i] = *buf++;
+	}
+	return 1;
+}
+
+const char* sim_get_controller_text(V5_ControllerId id, uint32_t line) {
+	return id <= kControllerPartner && line <= 4 ? controller_text[id][line] : NULL;
+}
+
+/******************************************************************************/
+/**                                 Battery                                  **/
+/******************************************************************************/
+
+int32_t vexBatteryVoltageGet(void) {
+	return 12800;
+}
+
+int32_t vexBatteryCurrentGet(void) {
+	return 0;
+}
+
+double vexBatteryTemperatureGet(void) {
+	return 25;
+}
+
+double vexBatteryCapacityGet(void) {
+	return 100;
+}
+
+/******************************************************************************/
+/**                                 Display                                  **/
+/******************************************************************************/
+
+static uint32_t foreground_color = ClrWhite;
+static uint32_t background_color = ClrBlack;
+
+void vexDisplayForegroundColor(uint32_t col) {
+	foreground_color = col;
+}
+
+void vexDisplayBackgroundColor(uint32_t col) {
+	background_color = col;
+}
+
+uint32_t vexDisplayForegroundColorGet(void) {
+	return foreground_color;
+}
+
+uint32_t vexDisplayBackgroundColorGet(void) {
+	return background_color;
+}
+
+void vexDisplayErase(void) {}
+void vexDisplayScroll(int32_t nStartLine, int32_t nLines) {}
+void vexDisplayScrollRect(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t nLines) {}
+void vexDisplayCopyRect(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t* pSrc, int32_t srcStride) {}
+void vexDisplayPixelSet(uint32_t x, uint32_t y) {}
+void vexDisplayPixelClear(uint32_t x, uint32_t y) {}
+void vexDisplayLineDraw(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {}
+void vexDisplayLineClear(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {}
+void vexDisplayRectDraw(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {}
+void vexDisplayRectClear(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {}
+void vexDisplayRectFill(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {}
+void vexDisplayCircleDraw(int32_t xc, int32_t yc, int32_t radius) {}
+void vexDisplayCircleClear(int32_t xc, int32_t yc, int32_t radius) {}
+void vexDisplayCircleFill(int32_t xc, int32_t yc, int32_t radius) {}
+void vexDisplayPrintf(int32_t xpos, int32_t ypos, uint32_t bOpaque, const char* format, ...) {}
+void vexDisplayString(const int32_t nLineNumber, const char* format, ...) {}
+void vexDisplayStringAt(int32_t xpos, int32_t ypos, const char* format, ...) {}
+void vexDisplayBigString(const int32_t nLineNumber, const char* format, ...) {}
+void vexDisplayBigStringAt(int32_t xpos, int32_t ypos, const char* format, ...) {}
+void vexDisplaySmallStringAt(int32_t xpos, int32_t ypos, const char* format, ...) {}
+void vexDisplayCenteredString(const int32_t nLineNumber, const char* format, ...) {}
+void vexDisplayBigCenteredString(const int32_t nLineNumber, const char* format, ...) {}
+void vexDisplayVPrintf(int32_t xpos, int32_t ypos, uint32_t bOpaque, const char* format, va_list args) {}
+void vexDisplayVString(const int32_t nLineNumber, const char* format, va_list args) {}
+void vexDisplayVStringAt(int32_t xpos, int32_t ypos, const char* format, va_list args) {}
+void vexDisplayVBigString(const int32_t nLineNumber, const char* format, va_list args) {}
+void vexDisplayVBigStringAt(int32_t xpos, int32_t ypos, const char* format, va_list args) {}
+void vexDisplayVSmallStringAt(int32_t xpos, int32_t ypos, const char* format, va_list args) {}
+void vexDisplayVCenteredString(const int32_t nLineNumber, const char* format, va_list args) {}
+void vexDisplayVBigCenteredString(const int32_t nLineNumber, const char* format, va_list args) {}
+
+void vexTouchDataGet(V5_TouchStatus* status) {
+	*status = (V5_TouchStatus){0};
+}
+
+/******************************************************************************/
+/**                                 microSD                                  **/
+/******************************************************************************/
+
+struct _FIL {
+	FILE* file;
+};
+
+static FIL* file_open(const char* filename, const char* mode) {
+	const char* root = getenv("PROS_HOST_USD");
+	if (!root) {
+		return NULL;
+	}
+	char path[512];
+	snprintf(path, sizeof(path), "%s/%s", root, filename);
+
+	FILE* file = fopen(path, mode);
+	if (!file) {
+		return NULL;
+	}
+	FIL* fdp = malloc(sizeof(*fdp));
+	fdp->file = file;
+	return fdp;
+}
+
+uint32_t vexFileDriveStatus(uint32_t drive) {
+	(void)drive;
+	return getenv("PROS_HOST_USD") != NULL;
+}
+
+FRESULT vexFileMountSD(void) {
+	return vexFileDriveStatus(0) ? FR_OK : FR_NOT_READY;
+}
+
+FIL* vexFileOpen(const char* filename, const char* mode) {
+	(void)mode;
+	return file_open(filename, "rb");
+}
+
+FIL* vexFileOpenWrite(const char* filename) {
+	return file_open(filename, "ab");
+}
+
+FIL* vexFileOpenCreate(const char* filename) {
+	return file_open(filename, "wb");
+}
+
+void vexFileClose(FIL* fdp) {
+	fclose(fdp->file);
+	free(fdp);
+}
+
+int32_t vexFileWrite(char* buf, uint32_t size, uint32_t nItems, FIL* fdp) {
+	return fwrite(buf, size, nItems, fdp->file);
+}
+
+int32_t vexFileRead(char* buf, uint32_t size, uint32_t nItems, FIL* fdp) {
+	return fread(buf, size, nItems, fdp->file);
+}
+
+int32_t vexFileSize(FIL* fdp) {
+	long position = ftell(fdp->file);
+	fseek(fdp->file, 0, SEEK_END);
+	long size = ftell(fdp->file);
+	fseek(fdp->file, position, SEEK_SET);
+	return size;
+}
+
+FRESULT vexFileSeek(FIL* fdp, uint32_t offset, int32_t whence) {
+	return fseek(fdp->file, offset, whence) ? FR_INVALID_PARAMETER : FR_OK;
+}
+
+int32_t vexFileTell(FIL* fdp) {
+	return ftell(fdp->file);
+}
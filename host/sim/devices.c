@@ -0,0 +1,896 @@
+/**
+ * \file sim/devices.c
+ *
+ * Simulated V5 smart devices
+ *
+ * Each smart port holds a small model of whatever is plugged into it. Motors
+ * move towards whatever they were last told to do at their gearset's free
+ * speed, ADI ports and rotation sensors read back what was written to them,
+ * generic serial and radio ports loop transmitted bytes back to their own
+ * receive buffers, and vision sensors report whatever objects they were given
+ * with sim_set_vision_objects(). Every other reading is zero.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "v5_api.h"
+
+// The smart port that the brain's own ADI ports appear on (port 22)
+#define INTERNAL_ADI_INDEX 21
+
+#define NUM_ADI_PORTS 8
+#define SERIAL_BUFFER_SIZE 1024
+#define VISION_MAX_OBJECTS 16
+#define DEVICE_UPDATE_PERIOD 10
+
+typedef enum { MOTOR_MODE_VELOCITY, MOTOR_MODE_VOLTAGE, MOTOR_MODE_POSITION } motor_mode_e_t;
+
+struct _V5_Device {
+	V5_DeviceType type;
+
+	// motor
+	motor_mode_e_t mode;
+	int32_t command;  // rpm in velocity and position mode, mV in voltage mode
+	double position;  // degrees at the output shaft, before reversal
+	double target;    // degrees, in position mode
+	double velocity;  // rpm
+	uint64_t last_update;
+	V5MotorEncoderUnits units;
+	V5MotorGearset gearset;
+	V5MotorBrakeMode brake_mode;
+	bool reversed;
+	int32_t current_limit;
+	int32_t voltage_limit;
+
+	// ADI
+	V5_AdiPortConfiguration adi_config[NUM_ADI_PORTS];
+	int32_t adi_value[NUM_ADI_PORTS];
+
+	// IMU
+	uint32_t data_rate;
+
+	// vision
+	V5_DeviceVisionObject vision_objects[VISION_MAX_OBJECTS];
+	uint32_t vision_count;
+	uint32_t vision_reads;
+
+	// rotation
+	int32_t abs_position;
+	bool abs_reversed;
+
+	// generic serial and radio
+	uint8_t serial_buffer[SERIAL_BUFFER_SIZE];
+	uint32_t serial_head;
+	uint32_t serial_count;
+	bool radio_linked;
+};
+
+static struct _V5_Device devices[V5_MAX_DEVICE_PORTS] = {[INTERNAL_ADI_INDEX] = {.type = kDeviceTypeAdiSensor}};
+
+static const struct {
+	const char* name;
+	V5_DeviceType type;
+} device_names[] = {{"motor", kDeviceTypeMotorSensor},     {"rotation", kDeviceTypeAbsEncSensor},
+                    {"imu", kDeviceTypeImuSensor},         {"distance", kDeviceTypeDistanceSensor},
+                    {"vision", kDeviceTypeVisionSensor},   {"optical", kDeviceTypeOpticalSensor},
+                    {"gps", kDeviceTypeGpsSensor},         {"adi", kDeviceTypeAdiSensor},
+                    {"serial", kDeviceTypeGenericSerial},  {"radio", kDeviceTypeRadioSensor}};
+
+bool sim_set_device(uint8_t port, V5_DeviceType type) {
+	if (port < 1 || port > 21) {
+		return false;
+	}
+	struct _V5_Device* device = &devices[port - 1];
+	memset(device, 0, sizeof(*device));
+	device->type = type;
+	device->gearset = kMotorGearSet_18;
+	device->current_limit = 2500;
+	device->voltage_limit = 12000;
+	device->last_update = vexSystemHighResTimeGet();
+	return true;
+}
+
+bool sim_parse_devices(const char* spec) {
+	bool ok = true;
+	while (*spec) {
+		char* end;
+		long port = strtol(spec, &end, 10);
+		if (end == spec || *end != ':') {
+			return false;
+		}
+		spec = end + 1;
+		size_t len = strcspn(spec, ",");
+
+		bool found = false;
+		for (size_t i = 0; i < sizeof(device_names) / sizeof(*device_names); i++) {
+			if (strlen(device_names[i].name) == len && !strncmp(device_names[i].name, spec, len)) {
+				found = sim_set_device(port, device_names[i].type);
+				break;
+			}
+		}
+		ok = ok && found;
+
+		spec += len;
+		if (*spec == ',') {
+			spec++;
+		}
+	}
+	return ok;
+}
+
+V5_DeviceT vexDeviceGetByIndex(uint32_t index) {
+	return index < V5_MAX_DEVICE_PORTS ? &devices[index] : NULL;
+}
+
+int32_t vexDeviceGetStatus(V5_DeviceType* buffer) {
+	for (size_t i = 0; i < V5_MAX_DEVICE_PORTS; i++) {
+		buffer[i] = devices[i].type;
+	}
+	return V5_MAX_DEVICE_PORTS;
+}
+
+uint32_t vexDeviceGetTimestamp(V5_DeviceT device) {
+	// Every device sends the brain an update every DEVICE_UPDATE_PERIOD ms,
+	// except for IMUs that have been given their own data rate
+	uint32_t period = device->data_rate ? device->data_rate : DEVICE_UPDATE_PERIOD;
+	return vexSystemTimeGet() / period * period;
+}
+
+/******************************************************************************/
+/**                                  Motors                                  **/
+/******************************************************************************/
+
+static double motor_max_rpm(V5_DeviceT device) {
+	switch (device->gearset) {
+		case kMotorGearSet_36:
+			return 100;
+		case kMotorGearSet_06:
+			return 600;
+		default:
+			return 200;
+	}
+}
+
+static double motor_counts_per_rev(V5_DeviceT device) {
+	switch (device->gearset) {
+		case kMotorGearSet_36:
+			return 1800;
+		case kMotorGearSet_06:
+			return 300;
+		default:
+			return 900;
+	}
+}
+
+// Moves the motor along to the current time
+static void motor_update(V5_DeviceT device) {
+	uint64_t now = vexSystemHighResTimeGet();
+	double dt = (now - device->last_update) / 1e6;
+	device->last_update = now;
+
+	double max_rpm = motor_max_rpm(device);
+	switch (device->mode) {
+		case MOTOR_MODE_VELOCITY:
+			device->velocity = fmax(-max_rpm, fmin(max_rpm, device->command));
+			break;
+		case MOTOR_MODE_VOLTAGE:
+			device->velocity = max_rpm * fmax(-12000, fmin(12000, device->command)) / 12000.0;
+			break;
+		case MOTOR_MODE_POSITION: {
+			double speed = fmin(max_rpm, abs(device->command));
+			double remaining = device->target - device->position;
+			double step = speed * 6 * dt;  // 1 rpm is 6 degrees per second
+			if (fabs(remaining) <= step) {
+				device->position = device->target;
+				device->velocity = 0;
+				return;
+			}
+			device->velocity = remaining > 0 ? speed : -speed;
+			break;
+		}
+	}
+	device->position += device->velocity * 6 * dt;
+}
+
+static double motor_to_units(V5_DeviceT device, double degrees) {
+	switch (device->units) {
+		case kMotorEncoderRotations:
+			return degrees / 360;
+		case kMotorEncoderCounts:
+			return degrees / 360 * motor_counts_per_rev(device);
+		default:
+			return degrees;
+	}
+}
+
+static double motor_from_units(V5_DeviceT device, double value) {
+	return value / motor_to_units(device, 1);
+}
+
+static inline double motor_sign(V5_DeviceT device) {
+	return device->reversed ? -1 : 1;
+}
+
+void vexDeviceMotorVelocitySet(V5_DeviceT device, int32_t velocity) {
+	motor_update(device);
+	device->mode = MOTOR_MODE_VELOCITY;
+	device->command = velocity * motor_sign(device);
+}
+
+void vexDeviceMotorVelocityUpdate(V5_DeviceT device, int32_t velocity) {
+	motor_update(device);
+	device->command = velocity * motor_sign(device);
+}
+
+void vexDeviceMotorVoltageSet(V5_DeviceT device, int32_t value) {
+	motor_update(device);
+	device->mode = MOTOR_MODE_VOLTAGE;
+	device->command = value * motor_sign(device);
+}
+
+int32_t vexDeviceMotorVelocityGet(V5_DeviceT device) {
+	return device->mode == MOTOR_MODE_VOLTAGE ? 0 : device->command * motor_sign(device);
+}
+
+double vexDeviceMotorActualVelocityGet(V5_DeviceT device) {
+	motor_update(device);
+	return device->velocity * motor_sign(device);
+}
+
+int32_t vexDeviceMotorDirectionGet(V5_DeviceT device) {
+	motor_update(device);
+	double velocity = device->velocity * motor_sign(device);
+	return velocity < 0 ? -1 : 1;
+}
+
+void vexDeviceMotorModeSet(V5_DeviceT device, int32_t mode) {
+	(void)device;
+	(void)mode;
+}
+
+void vexDeviceMotorPwmSet(V5_DeviceT device, int32_t value) {
+	vexDeviceMotorVoltageSet(device, value * 12000 / 127);
+}
+
+void vexDeviceMotorCurrentLimitSet(V5_DeviceT device, int32_t value) {
+	device->current_limit = value;
+}
+
+int32_t vexDeviceMotorCurrentLimitGet(V5_DeviceT device) {
+	return device->current_limit;
+}
+
+int32_t vexDeviceMotorVoltageGet(V5_DeviceT device) {
+	motor_update(device);
+	return 12000 * device->velocity / motor_max_rpm(device) * motor_sign(device);
+}
+
+int32_t vexDeviceMotorCurrentGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+double vexDeviceMotorPowerGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+double vexDeviceMotorTorqueGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+double vexDeviceMotorEfficiencyGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+double vexDeviceMotorTemperatureGet(V5_DeviceT device) {
+	(void)device;
+	return 25;
+}
+
+bool vexDeviceMotorOverTempFlagGet(V5_DeviceT device) {
+	(void)device;
+	return false;
+}
+
+bool vexDeviceMotorCurrentLimitFlagGet(V5_DeviceT device) {
+	(void)device;
+	return false;
+}
+
+uint32_t vexDeviceMotorFaultsGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+bool vexDeviceMotorZeroVelocityFlagGet(V5_DeviceT device) {
+	motor_update(device);
+	return device->velocity == 0;
+}
+
+bool vexDeviceMotorZeroPositionFlagGet(V5_DeviceT device) {
+	motor_update(device);
+	return device->position == 0;
+}
+
+uint32_t vexDeviceMotorFlagsGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceMotorReverseFlagSet(V5_DeviceT device, bool value) {
+	device->reversed = value;
+}
+
+bool vexDeviceMotorReverseFlagGet(V5_DeviceT device) {
+	return device->reversed;
+}
+
+void vexDeviceMotorEncoderUnitsSet(V5_DeviceT device, V5MotorEncoderUnits units) {
+	device->units = units;
+}
+
+V5MotorEncoderUnits vexDeviceMotorEncoderUnitsGet(V5_DeviceT device) {
+	return device->units;
+}
+
+void vexDeviceMotorBrakeModeSet(V5_DeviceT device, V5MotorBrakeMode mode) {
+	device->brake_mode = mode;
+}
+
+V5MotorBrakeMode vexDeviceMotorBrakeModeGet(V5_DeviceT device) {
+	return device->brake_mode;
+}
+
+void vexDeviceMotorPositionSet(V5_DeviceT device, double position) {
+	motor_update(device);
+	device->position = motor_from_units(device, position) * motor_sign(device);
+}
+
+double vexDeviceMotorPositionGet(V5_DeviceT device) {
+	motor_update(device);
+	return motor_to_units(device, device->position) * motor_sign(device);
+}
+
+int32_t vexDeviceMotorPositionRawGet(V5_DeviceT device, uint32_t* timestamp) {
+	motor_update(device);
+	if (timestamp) {
+		*timestamp = vexSystemTimeGet();
+	}
+	return device->position / 360 * motor_counts_per_rev(device) * motor_sign(device);
+}
+
+void vexDeviceMotorPositionReset(V5_DeviceT device) {
+	motor_update(device);
+	device->position = 0;
+}
+
+double vexDeviceMotorTargetGet(V5_DeviceT device) {
+	return motor_to_units(device, device->target) * motor_sign(device);
+}
+
+void vexDeviceMotorServoTargetSet(V5_DeviceT device, double position) {
+	vexDeviceMotorAbsoluteTargetSet(device, position, motor_max_rpm(device));
+}
+
+void vexDeviceMotorAbsoluteTargetSet(V5_DeviceT device, double position, int32_t velocity) {
+	motor_update(device);
+	device->mode = MOTOR_MODE_POSITION;
+	device->target = motor_from_units(device, position) * motor_sign(device);
+	device->command = velocity;
+}
+
+void vexDeviceMotorRelativeTargetSet(V5_DeviceT device, double position, int32_t velocity) {
+	motor_update(device);
+	device->mode = MOTOR_MODE_POSITION;
+	device->target = device->position + motor_from_units(device, position) * motor_sign(device);
+	device->command = velocity;
+}
+
+void vexDeviceMotorGearingSet(V5_DeviceT device, V5MotorGearset value) {
+	motor_update(device);
+	device->gearset = value;
+}
+
+V5MotorGearset vexDeviceMotorGearingGet(V5_DeviceT device) {
+	return device->gearset;
+}
+
+void vexDeviceMotorExternalProfileSet(V5_DeviceT device, double position, int32_t velocity) {
+	vexDeviceMotorAbsoluteTargetSet(device, position, velocity);
+}
+
+void vexDeviceMotorPositionPidSet(V5_DeviceT device, V5_DeviceMotorPid* pid) {
+	(void)device;
+	(void)pid;
+}
+
+void vexDeviceMotorVelocityPidSet(V5_DeviceT device, V5_DeviceMotorPid* pid) {
+	(void)device;
+	(void)pid;
+}
+
+void vexDeviceMotorVoltageLimitSet(V5_DeviceT device, int32_t value) {
+	device->voltage_limit = value;
+}
+
+int32_t vexDeviceMotorVoltageLimitGet(V5_DeviceT device) {
+	return device->voltage_limit;
+}
+
+/******************************************************************************/
+/**                                   ADI                                    **/
+/******************************************************************************/
+
+void vexDeviceAdiPortConfigSet(V5_DeviceT device, uint32_t port, V5_AdiPortConfiguration type) {
+	if (port < NUM_ADI_PORTS) {
+		device->adi_config[port] = type;
+	}
+}
+
+V5_AdiPortConfiguration vexDeviceAdiPortConfigGet(V5_DeviceT device, uint32_t port) {
+	return port < NUM_ADI_PORTS ? device->adi_config[port] : kAdiPortTypeUndefined;
+}
+
+void vexDeviceAdiValueSet(V5_DeviceT device, uint32_t port, int32_t value) {
+	if (port < NUM_ADI_PORTS) {
+		device->adi_value[port] = value;
+	}
+}
+
+int32_t vexDeviceAdiValueGet(V5_DeviceT device, uint32_t port) {
+	return port < NUM_ADI_PORTS ? device->adi_value[port] : 0;
+}
+
+int32_t vexDeviceAdiAddrLedSet(V5_DeviceT device, uint32_t port, uint32_t* pData, uint32_t nOffset, uint32_t nLength,
+                               uint32_t options) {
+	(void)device;
+	(void)port;
+	(void)pData;
+	(void)nOffset;
+	(void)options;
+	return nLength;
+}
+
+/******************************************************************************/
+/**                                 Sensors                                  **/
+/******************************************************************************/
+
+void vexDeviceImuReset(V5_DeviceT device) {
+	(void)device;
+}
+
+double vexDeviceImuHeadingGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+double vexDeviceImuDegreesGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceImuQuaternionGet(V5_DeviceT device, V5_DeviceImuQuaternion* data) {
+	(void)device;
+	*data = (V5_DeviceImuQuaternion){0, 0, 0, 1};
+}
+
+void vexDeviceImuAttitudeGet(V5_DeviceT device, V5_DeviceImuAttitude* data) {
+	(void)device;
+	*data = (V5_DeviceImuAttitude){0};
+}
+
+void vexDeviceImuRawGyroGet(V5_DeviceT device, V5_DeviceImuRaw* data) {
+	(void)device;
+	*data = (V5_DeviceImuRaw){0};
+}
+
+void vexDeviceImuRawAccelGet(V5_DeviceT device, V5_DeviceImuRaw* data) {
+	(void)device;
+	// at rest, with gravity pulling down the z axis
+	*data = (V5_DeviceImuRaw){0, 0, 1, 0};
+}
+
+uint32_t vexDeviceImuStatusGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceImuDataRateSet(V5_DeviceT device, uint32_t rate) {
+	device->data_rate = rate;
+}
+
+void vexDeviceAbsEncReset(V5_DeviceT device) {
+	device->abs_position = 0;
+}
+
+void vexDeviceAbsEncPositionSet(V5_DeviceT device, int32_t position) {
+	device->abs_position = position;
+}
+
+int32_t vexDeviceAbsEncPositionGet(V5_DeviceT device) {
+	return device->abs_position;
+}
+
+int32_t vexDeviceAbsEncVelocityGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+int32_t vexDeviceAbsEncAngleGet(V5_DeviceT device) {
+	int32_t angle = device->abs_position % 36000;
+	return angle < 0 ? angle + 36000 : angle;
+}
+
+void vexDeviceAbsEncReverseFlagSet(V5_DeviceT device, bool value) {
+	device->abs_reversed = value;
+}
+
+void vexAbsEncReverseFlagSet(uint32_t index, bool value) {
+	if (index < V5_MAX_DEVICE_PORTS) {
+		vexDeviceAbsEncReverseFlagSet(&devices[index], value);
+	}
+}
+
+bool vexDeviceAbsEncReverseFlagGet(V5_DeviceT device) {
+	return device->abs_reversed;
+}
+
+uint32_t vexDeviceAbsEncStatusGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceAbsEncDataRateSet(V5_DeviceT device, uint32_t rate) {
+	(void)device;
+	(void)rate;
+}
+
+uint32_t vexDeviceDistanceDistanceGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+uint32_t vexDeviceDistanceConfidenceGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+int32_t vexDeviceDistanceObjectSizeGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+double vexDeviceDistanceObjectVelocityGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+uint32_t vexDeviceDistanceStatusGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+double vexDeviceOpticalHueGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+double vexDeviceOpticalSatGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+double vexDeviceOpticalBrightnessGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+int32_t vexDeviceOpticalProximityGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceOpticalRgbGet(V5_DeviceT device, V5_DeviceOpticalRgb* data) {
+	(void)device;
+	*data = (V5_DeviceOpticalRgb){0};
+}
+
+void vexDeviceOpticalLedPwmSet(V5_DeviceT device, int32_t value) {
+	(void)device;
+	(void)value;
+}
+
+int32_t vexDeviceOpticalLedPwmGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceOpticalRawGet(V5_DeviceT device, V5_DeviceOpticalRaw* data) {
+	(void)device;
+	*data = (V5_DeviceOpticalRaw){0};
+}
+
+void vexDeviceOpticalGestureEnable(V5_DeviceT device) {
+	(void)device;
+}
+
+void vexDeviceOpticalGestureDisable(V5_DeviceT device) {
+	(void)device;
+}
+
+int32_t vexDeviceOpticalGestureGet(V5_DeviceT device, V5_DeviceOpticalGesture* pData) {
+	(void)device;
+	if (pData) {
+		*pData = (V5_DeviceOpticalGesture){0};
+	}
+	return 0;
+}
+
+void vexDeviceGpsReset(V5_DeviceT device) {
+	(void)device;
+}
+
+double vexDeviceGpsHeadingGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+double vexDeviceGpsDegreesGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceGpsAttitudeGet(V5_DeviceT device, V5_DeviceGpsAttitude* data, bool bRaw) {
+	(void)device;
+	(void)bRaw;
+	*data = (V5_DeviceGpsAttitude){0};
+}
+
+void vexDeviceGpsRawGyroGet(V5_DeviceT device, V5_DeviceGpsRaw* data) {
+	(void)device;
+	*data = (V5_DeviceGpsRaw){0};
+}
+
+void vexDeviceGpsRawAccelGet(V5_DeviceT device, V5_DeviceGpsRaw* data) {
+	(void)device;
+	*data = (V5_DeviceGpsRaw){0};
+}
+
+uint32_t vexDeviceGpsStatusGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceGpsOriginSet(V5_DeviceT device, double ox, double oy) {
+	(void)device;
+	(void)ox;
+	(void)oy;
+}
+
+void vexDeviceGpsOriginGet(V5_DeviceT device, double* ox, double* oy) {
+	(void)device;
+	*ox = 0;
+	*oy = 0;
+}
+
+void vexDeviceGpsRotationSet(V5_DeviceT device, double value) {
+	(void)device;
+	(void)value;
+}
+
+double vexDeviceGpsRotationGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceGpsInitialPositionSet(V5_DeviceT device, double initial_x, double initial_y, double initial_rotation) {
+	(void)device;
+	(void)initial_x;
+	(void)initial_y;
+	(void)initial_rotation;
+}
+
+double vexDeviceGpsErrorGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceGpsDataRateSet(V5_DeviceT device, uint32_t rate) {
+	(void)device;
+	(void)rate;
+}
+
+void vexDeviceVisionModeSet(V5_DeviceT device, uint32_t mode) {
+	(void)device;
+	(void)mode;
+}
+
+void sim_set_vision_objects(uint8_t port, const V5_DeviceVisionObject* objects, uint32_t count) {
+	if (port < 1 || port > 21) {
+		return;
+	}
+	struct _V5_Device* device = &devices[port - 1];
+	device->vision_count = count < VISION_MAX_OBJECTS ? count : VISION_MAX_OBJECTS;
+	memcpy(device->vision_objects, objects, device->vision_count * sizeof(*objects));
+}
+
+uint32_t sim_get_vision_reads(uint8_t port) {
+	return port >= 1 && port <= 21 ? devices[port - 1].vision_reads : 0;
+}
+
+int32_t vexDeviceVisionObjectCountGet(V5_DeviceT device) {
+	return device->vision_count;
+}
+
+int32_t vexDeviceVisionObjectGet(V5_DeviceT device, uint32_t indexObj, V5_DeviceVisionObject* pObject) {
+	if (indexObj >= device->vision_count) {
+		return 0;
+	}
+	device->vision_reads++;
+	*pObject = device->vision_objects[indexObj];
+	return 1;
+}
+
+void vexDeviceVisionSignatureSet(V5_DeviceT device, V5_DeviceVisionSignature* pSignature) {
+	(void)device;
+	(void)pSignature;
+}
+
+bool vexDeviceVisionSignatureGet(V5_DeviceT device, uint32_t id, V5_DeviceVisionSignature* pSignature) {
+	(void)device;
+	(void)id;
+	memset(pSignature, 0, sizeof(*pSignature));
+	return false;
+}
+
+void vexDeviceVisionBrightnessSet(V5_DeviceT device, uint8_t value) {
+	(void)device;
+	(void)value;
+}
+
+uint8_t vexDeviceVisionBrightnessGet(V5_DeviceT device) {
+	(void)device;
+	return 0;
+}
+
+void vexDeviceVisionWhiteBalanceModeSet(V5_DeviceT device, uint32_t mode) {
+	(void)device;
+	(void)mode;
+}
+
+void vexDeviceVisionWhiteBalanceSet(V5_DeviceT device, V5_DeviceVisionRgb color) {
+	(void)device;
+	(void)color;
+}
+
+V5_DeviceVisionRgb vexDeviceVisionWhiteBalanceGet(V5_DeviceT device) {
+	(void)device;
+	return (V5_DeviceVisionRgb){0};
+}
+
+void vexDeviceVisionLedModeSet(V5_DeviceT device, uint32_t mode) {
+	(void)device;
+	(void)mode;
+}
+
+void vexDeviceVisionLedColorSet(V5_DeviceT device, V5_DeviceVisionRgb color) {
+	(void)device;
+	(void)color;
+}
+
+void vexDeviceVisionWifiModeSet(V5_DeviceT device, uint32_t mode) {
+	(void)device;
+	(void)mode;
+}
+
+/******************************************************************************/
+/**                          Generic serial and radio                        **/
+/******************************************************************************/
+
+static int32_t serial_transmit(V5_DeviceT device, const uint8_t* buffer, int32_t length) {
+	int32_t sent = 0;
+	while (sent < length && device->serial_count < SERIAL_BUFFER_SIZE) {
+		device->serial_buffer[(device->serial_head + device->serial_count) % SERIAL_BUFFER_SIZE] = buffer[sent++];
+		device->serial_count++;
+	}
+	return sent;
+}
+
+static int32_t serial_receive(V5_DeviceT device, uint8_t* buffer, int32_t length) {
+	int32_t received = 0;
+	while (received < length && device->serial_count) {
+		buffer[received++] = device->serial_buffer[device->serial_head];
+		device->serial_head = (device->serial_head + 1) % SERIAL_BUFFER_SIZE;
+		device->serial_count--;
+	}
+	return received;
+}
+
+void vexDeviceGenericSerialEnable(V5_DeviceT device, int32_t options) {
+	(void)options;
+	device->serial_head = 0;
+	device->serial_count = 0;
+}
+
+void vexDeviceGenericSerialBaudrate(V5_DeviceT device, int32_t baudrate) {
+	(void)device;
+	(void)baudrate;
+}
+
+int32_t vexDeviceGenericSerialWriteChar(V5_DeviceT device, uint8_t c) {
+	return serial_transmit(device, &c, 1) ? c : -1;
+}
+
+int32_t vexDeviceGenericSerialWriteFree(V5_DeviceT device) {
+	return SERIAL_BUFFER_SIZE - device->serial_count;
+}
+
+int32_t vexDeviceGenericSerialTransmit(V5_DeviceT device, uint8_t* buffer, int32_t length) {
+	return serial_transmit(device, buffer, length);
+}
+
+int32_t vexDeviceGenericSerialReadChar(V5_DeviceT device) {
+	uint8_t c;
+	return serial_receive(device, &c, 1) ? c : -1;
+}
+
+int32_t vexDeviceGenericSerialPeekChar(V5_DeviceT device) {
+	return device->serial_count ? device->serial_buffer[device->serial_head] : -1;
+}
+
+int32_t vexDeviceGenericSerialReceiveAvail(V5_DeviceT device) {
+	return device->serial_count;
+}
+
+int32_t vexDeviceGenericSerialReceive(V5_DeviceT device, uint8_t* buffer, int32_t length) {
+	return serial_receive(device, buffer, length);
+}
+
+void vexDeviceGenericSerialFlush(V5_DeviceT device) {
+	device->serial_head = 0;
+	device->serial_count = 0;
+}
+
+void vexDeviceGenericRadioConnection(V5_DeviceT device, char* link_id, int type, bool ov) {
+	(void)link_id;
+	(void)type;
+	(void)ov;
+	// Like a real radio, a linked radio reports itself as a generic serial device
+	device->type = kDeviceTypeGenericSerial;
+	device->radio_linked = true;
+	device->serial_head = 0;
+	device->serial_count = 0;
+}
+
+int32_t vexDeviceGenericRadioWriteFree(V5_DeviceT device) {
+	return SERIAL_BUFFER_SIZE - device->serial_count;
+}
+
+int32_t vexDeviceGenericRadioTransmit(V5_DeviceT device, uint8_t* data, uint16_t size) {
+	return serial_transmit(device, data, size);
+}
+
+int32_t vexDeviceGenericRadioReceiveAvail(V5_DeviceT device) {
+	return device->serial_count;
+}
+
+int32_t vexDeviceGenericRadioReceive(V5_DeviceT device, uint8_t* data, uint16_t size) {
+	return serial_receive(device, data, size);
+}
+
+bool vexDeviceGenericRadioLinkStatus(V5_DeviceT device) {
+	return device->radio_linked;
+}
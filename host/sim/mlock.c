@@ -0,0 +1,97 @@
+/**
+ * \file sim/mlock.c
+ *
+ * Memory locking for glibc's allocator
+ *
+ * On the V5, newlib's malloc suspends the scheduler while it works (see
+ * system/mlock.c). glibc protects its heap with locks instead, and a task
+ * preempted while holding one of them would deadlock the next task to
+ * allocate. The allocator is wrapped here so that it behaves as it does on the
+ * V5.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rtos/FreeRTOS.h"
+#include "rtos/task.h"
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void* __libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void* ptr);
+
+// Threads that aren't running a task (the main thread, and the threads of
+// deleted tasks while they exit) must not touch the scheduler
+static inline bool malloc_lock(void) {
+	if (xPortIsTaskThread()) {
+		rtos_suspend_all();
+		return true;
+	}
+	return false;
+}
+
+static inline void malloc_unlock(bool locked) {
+	if (locked) {
+		rtos_resume_all();
+	}
+}
+
+void* malloc(size_t size) {
+	bool locked = malloc_lock();
+	void* ptr = __libc_malloc(size);
+	malloc_unlock(locked);
+	return ptr;
+}
+
+void* calloc(size_t nmemb, size_t size) {
+	bool locked = malloc_lock();
+	void* ptr = __libc_calloc(nmemb, size);
+	malloc_unlock(locked);
+	return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+	bool locked = malloc_lock();
+	ptr = __libc_realloc(ptr, size);
+	malloc_unlock(locked);
+	return ptr;
+}
+
+void* memalign(size_t alignment, size_t size) {
+	bool locked = malloc_lock();
+	void* ptr = __libc_memalign(alignment, size);
+	malloc_unlock(locked);
+	return ptr;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+	return memalign(alignment, size);
+}
+
+int posix_memalign(void** memptr, size_t alignment, size_t size) {
+	if (alignment < sizeof(void*) || (alignment & (alignment - 1))) {
+		return EINVAL;
+	}
+	void* ptr = memalign(alignment, size);
+	if (!ptr) {
+		return ENOMEM;
+	}
+	*memptr = ptr;
+	return 0;
+}
+
+void free(void* ptr) {
+	bool locked = malloc_lock();
+	__libc_free(ptr);
+	malloc_unlock(locked);
+}
@@ -0,0 +1,54 @@
+/**
+ * \file sim/startup.c
+ *
+ * Contains the startup code for the host build. This mirrors system/startup.c,
+ * except that the simulator is set up first and there is no hot/cold linking.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "kapi.h"
+#include "sim.h"
+
+extern void rtos_initialize();
+extern void vfs_initialize();
+extern void system_daemon_initialize();
+extern void graphical_context_daemon_initialize(void);
+extern void display_initialize(void);
+extern void rtos_sched_start();
+extern void vdml_initialize();
+
+// glibc passes the command line to constructors, so the simulator gets to see
+// it before any global C++ constructors run
+__attribute__((constructor(101))) static void pros_init(int argc, char** argv) {
+	sim_initialize(argc, argv);
+
+	rtos_initialize();
+
+	vfs_initialize();
+
+	vdml_initialize();
+
+	graphical_context_daemon_initialize();
+
+	display_initialize();
+
+	// NOTE: this function should be called after all other initialize
+	// functions (see system/startup.c)
+	system_daemon_initialize();
+}
+
+int main() {
+	rtos_sched_start();
+
+	fprintf(stderr, "Failed to start Scheduler\n");
+	return EXIT_FAILURE;
+}
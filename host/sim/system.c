@@ -0,0 +1,190 @@
+/**
+ * \file sim/system.c
+ *
+ * Simulated V5 system services
+ *
+ * Implements the SDK's clocks, tick timer, competition status and program
+ * exit on top of POSIX, along with the pieces of newlib and the hot/cold
+ * linker that the kernel expects to find.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdio_ext.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "system/hot.h"
+#include "v5_api.h"
+
+// The V5's RTOS tick period
+#define TICK_PERIOD_US 1000
+
+int sim_argc;
+char** sim_argv;
+
+static struct timespec start_time;
+static volatile uint32_t competition_status;
+static void (*tick_handler)(void* data);
+
+// Programs in the host build are always linked as a single monolith, so there
+// is never a hot table
+struct hot_table* const HOT_TABLE = NULL;
+
+void sim_initialize(int argc, char** argv) {
+	sim_argc = argc;
+	sim_argv = argv;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+	// kprintf writes to file descriptor 3, which is kdbg on the V5
+	int kdbg = getenv("PROS_HOST_KDBG") ? dup(STDERR_FILENO) : open("/dev/null", O_WRONLY);
+	if (kdbg >= 0 && kdbg != 3) {
+		dup2(kdbg, 3);
+		close(kdbg);
+	}
+
+	// A task can be preempted anywhere, including while it holds a stdio lock,
+	// and the task that runs next would then block forever on that lock. Only
+	// one task runs at a time, so the locks aren't needed anyway.
+	__fsetlocking(stdin, FSETLOCKING_BYCALLER);
+	__fsetlocking(stdout, FSETLOCKING_BYCALLER);
+	__fsetlocking(stderr, FSETLOCKING_BYCALLER);
+	setvbuf(stdout, NULL, _IOLBF, 0);
+
+	const char* devices = getenv("PROS_HOST_DEVICES");
+	if (devices && !sim_parse_devices(devices)) {
+		fprintf(stderr, "Couldn't understand PROS_HOST_DEVICES=%s\n", devices);
+	}
+}
+
+void sim_set_competition_status(uint32_t status) {
+	competition_status = status;
+}
+
+/******************************************************************************/
+/**                               Time and tick                              **/
+/******************************************************************************/
+
+uint64_t vexSystemHighResTimeGet(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)(now.tv_sec - start_time.tv_sec) * 1000000 + (now.tv_nsec - start_time.tv_nsec) / 1000;
+}
+
+uint32_t vexSystemTimeGet(void) {
+	return vexSystemHighResTimeGet() / 1000;
+}
+
+// The run time stats counter
+uint32_t vexSystemWatchdogGet(void) {
+	return vexSystemHighResTimeGet();
+}
+
+void vexSystemWatchdogReinitRtos(void) {}
+
+// Where the V5's IRQ handler saves the interrupted address and link register,
+// which it only does while the profiler is running
+extern volatile uint32_t ulPortInterruptedContext[2];
+extern volatile uint32_t ulPortProfilerEnabled;
+// The start of the executable, which nm reports PIE symbols relative to
+extern const char __executable_start[];
+
+static void tick_signal_handler(int signal, siginfo_t* info, void* context) {
+	(void)signal;
+	(void)info;
+	int saved_errno = errno;
+	const ucontext_t* uc = context;
+	uintptr_t pc = 0;
+	uintptr_t lr = 0;
+	if (!ulPortProfilerEnabled) {
+		tick_handler(NULL);
+		errno = saved_errno;
+		return;
+	}
+#if defined(__x86_64__)
+	// x86 has no link register, so only the address is sampled. glibc only
+	// names the registers (REG_RIP is 16) with _GNU_SOURCE, which is too late
+	// to define once newlib_compat.h has been included
+	pc = uc->uc_mcontext.gregs[16];
+#elif defined(__aarch64__)
+	pc = uc->uc_mcontext.pc;
+	lr = uc->uc_mcontext.regs[30];
+#endif
+	ulPortInterruptedContext[0] = pc ? (uint32_t)(pc - (uintptr_t)__executable_start) : 0;
+	ulPortInterruptedContext[1] = lr ? (uint32_t)(lr - (uintptr_t)__executable_start) : 0;
+	tick_handler(NULL);
+	errno = saved_errno;
+}
+
+int32_t vexSystemTimerReinitForRtos(uint32_t priority, void (*handler)(void* data)) {
+	(void)priority;
+	tick_handler = handler;
+
+	struct sigaction action = {0};
+	action.sa_sigaction = tick_signal_handler;
+	action.sa_flags = SA_RESTART | SA_SIGINFO;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGALRM, &action, NULL);
+
+	struct itimerval timer = {.it_interval = {0, TICK_PERIOD_US}, .it_value = {0, TICK_PERIOD_US}};
+	return setitimer(ITIMER_REAL, &timer, NULL);
+}
+
+void vexSystemTimerStop(void) {
+	struct itimerval timer = {0};
+	setitimer(ITIMER_REAL, &timer, NULL);
+}
+
+void vexSystemTimerClearInterrupt(void) {}
+
+/******************************************************************************/
+/**                                  System                                  **/
+/******************************************************************************/
+
+void vexBackgroundProcessing(void) {}
+
+uint32_t vexSystemVersion(void) {
+	return 0x01010000;
+}
+
+uint32_t vexSystemLinkAddrGet(void) {
+	return 0;
+}
+
+void vexSystemExitRequest(void) {
+	fflush(stdout);
+	fflush(stderr);
+	_exit(EXIT_SUCCESS);
+}
+
+uint32_t vexCompetitionStatus(void) {
+	return competition_status;
+}
+
+/******************************************************************************/
+/**                                  Newlib                                  **/
+/******************************************************************************/
+
+struct _reent* __host_getreent(void) {
+	static __thread struct _reent reent;
+	reent._errno_location = &errno;
+	reent.__sdidinit = 1;
+	return &reent;
+}
+
+void __sinit(struct _reent* s) {
+	(void)s;
+}
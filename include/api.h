@@ -55,10 +55,12 @@
 #include "pros/llemu.h"
 #include "pros/misc.h"
 #include "pros/motors.h"
+#include "pros/odometry.h"
 #include "pros/optical.h"
 #include "pros/rtos.h"
 #include "pros/rotation.h"
 #include "pros/screen.h"
+#include "pros/telemetry.h"
 #include "pros/vision.h"
 
 #ifdef __cplusplus
@@ -69,10 +71,12 @@
 #include "pros/llemu.hpp"
 #include "pros/misc.hpp"
 #include "pros/motors.hpp"
+#include "pros/odometry.hpp"
 #include "pros/optical.hpp"
 #include "pros/rotation.hpp"
 #include "pros/rtos.hpp"
 #include "pros/screen.hpp"
+#include "pros/telemetry.hpp"
 #include "pros/vision.hpp"
 #include "pros/link.hpp"
 #endif
@@ -15,9 +15,13 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
-#define COBS_ENCODE_MEASURE_MAX(src_len) ((src_len) + (((src_len) + 253) / 254))
+// Worst case encoded size of src_len bytes: one code byte up front plus one for
+// every full run of 254 non-zero bytes. Add 4 to src_len to account for the
+// stream identifier prefix written by cobs_encode()
+#define COBS_ENCODE_MEASURE_MAX(src_len) ((src_len) + 1 + ((src_len) / 254))
 
 /**
  * Encodes src in the Consistent Overhead Byte Stuffing algorithm, and writes
@@ -52,3 +56,28 @@ int cobs_encode(uint8_t* restrict dest, const uint8_t* restrict src, const size_
  * \return The size of src when encoded
  */
 size_t cobs_encode_measure(const uint8_t* restrict src, const size_t src_len, const uint32_t prefix);
+
+/**
+ * Same as cobs_encode() but writes the result to a destination that is split
+ * in two pieces, such as space reserved in a ring buffer that wraps around.
+ * The first first_len bytes are written to first and the remainder is written
+ * to second. The total space must be at least
+ * COBS_ENCODE_MEASURE_MAX(src_len + 4) bytes.
+ *
+ * \param[out] first
+ *             The location to write the start of the stuffed data to
+ * \param first_len
+ *        The number of bytes available at first
+ * \param[out] second
+ *             The location to write the rest of the stuffed data to
+ * \param[in] src
+ *            The location of the incoming data
+ * \param src_len
+ *        The length of the source data
+ * \param prefix
+ *        The four character stream identifier
+ *
+ * \return The number of bytes written
+ */
+size_t cobs_encode_wrapped(uint8_t* restrict first, const size_t first_len, uint8_t* restrict second,
+                           const uint8_t* restrict src, const size_t src_len, const uint32_t prefix);
@@ -0,0 +1,39 @@
+/**
+ * \file common/crc.h
+ *
+ * Cyclic redundancy checks
+ *
+ * See common/crc.c for discussion
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The value to start a CRC-16 with
+#define CRC16_INIT 0xffff
+
+/**
+ * Adds data to a CRC-16/CCITT-FALSE (polynomial 0x1021, not reflected).
+ *
+ * Start with CRC16_INIT and pass the result of each call to the next one to
+ * check data that is split into several pieces.
+ *
+ * \param crc
+ *        The CRC of the data so far
+ * \param[in] data
+ *            The data to add
+ * \param len
+ *        The length of the data
+ *
+ * \return The CRC of the data so far followed by data
+ */
+uint16_t crc16_update(uint16_t crc, const uint8_t* data, size_t len);
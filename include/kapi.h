@@ -106,6 +106,46 @@ int32_t rtos_resume_all(void);
 task_t task_create_static(task_fn_t task_code, void* const param, uint32_t priority, const size_t stack_size,
                           const char* const name, task_stack_t* const stack_buffer, static_task_s_t* const task_buffer);
 
+/**
+ * Creates a task that calls a function once every period milliseconds, like
+ * task_create_periodic(), and takes ownership of its parameters.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The period is 0, the deadline is longer than the period, or align
+ *          is true and the period is not a multiple of 2 ms.
+ * ENOMEM - The stack cannot be used as the TCB was not created.
+ *
+ * \param function
+ *        Pointer to the function to call for each job
+ * \param parameters
+ *        Pointer to memory that will be passed to every call of function
+ * \param cleanup
+ *        Called with parameters when the task is deleted, or before this
+ *        function returns if the task could not be created
+ * \param period
+ *        The number of milliseconds between releases
+ * \param deadline
+ *        The number of milliseconds after its release by which each job must
+ *        finish, or 0 to use the period
+ * \param align
+ *        Whether to release the task on the system daemon's ticks
+ * \param prio
+ *        The priority at which the task should run.
+ * \param stack_depth
+ *        The number of words (i.e. 4 * stack_depth) available on the task's
+ *        stack.
+ * \param name
+ *        A descriptive name for the task.
+ *
+ * \return A handle by which the newly created task can be referenced. If an
+ * error occurred, NULL will be returned and errno can be checked for hints as
+ * to why task_create_periodic_owned failed.
+ */
+task_t task_create_periodic_owned(task_fn_t function, void* const parameters, task_fn_t cleanup, uint32_t period,
+                                  uint32_t deadline, bool align, uint32_t prio, const uint16_t stack_depth,
+                                  const char* const name);
+
 /**
  * Creates a statically allocated mutex.
  *
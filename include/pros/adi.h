@@ -243,11 +243,16 @@ int32_t adi_port_set_value(uint8_t port, int32_t value);
  * calibration value.
  *
  * This method assumes that the true sensor value is not actively changing at
- * this time and computes an average from approximately 500 samples, 1 ms apart,
- * for a 0.5 s period of calibration. The average value thus calculated is
- * returned and stored for later calls to the adi_analog_read_calibrated() and
- * adi_analog_read_calibrated_HR() functions. These functions will return
- * the difference between this value and the current sensor value when called.
+ * this time and computes an average from 50 samples, one from each update of
+ * the ADI ports, for a 0.5 s period of calibration. The average value thus
+ * calculated is returned and stored for later calls to the
+ * adi_analog_read_calibrated() and adi_analog_read_calibrated_HR() functions.
+ * These functions will return the difference between this value and the
+ * current sensor value when called.
+ *
+ * The samples are taken by the system daemon, so other tasks can use the ADI
+ * while this function waits. It is equivalent to calling
+ * adi_analog_calibrate_async() and then adi_analog_calibrate_wait().
  *
  * Do not use this function when the sensor value might be unstable
  * (gyro rotation, accelerometer movement).
@@ -255,6 +260,7 @@ int32_t adi_port_set_value(uint8_t port, int32_t value);
  * This function uses the following values of errno when an error state is
  * reached:
  * ENXIO - The given value is not within the range of ADI Ports
+ * EADDRINUSE - The port is not configured as an analog input
  *
  * \param port
  *        The ADI port to calibrate (from 1-8, 'a'-'h', 'A'-'H')
@@ -263,6 +269,55 @@ int32_t adi_port_set_value(uint8_t port, int32_t value);
  */
 int32_t adi_analog_calibrate(uint8_t port);
 
+/**
+ * Starts calibrating the analog sensor on the specified port without waiting
+ * for the calibration to finish.
+ *
+ * The system daemon averages one sample from each update of the ADI ports for
+ * the next 0.5 s, as in adi_analog_calibrate(), so several sensors can be
+ * calibrated at the same time. Until the calibration finishes, the calibrated
+ * read functions keep using the previous calibration value. Calling this
+ * function again for a port that is still calibrating starts its calibration
+ * over.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of ADI Ports
+ * EADDRINUSE - The port is not configured as an analog input
+ *
+ * \param port
+ *        The ADI port to calibrate (from 1-8, 'a'-'h', 'A'-'H')
+ *
+ * \return 1 if the calibration was started or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t adi_analog_calibrate_async(uint8_t port);
+
+/**
+ * Waits for the calibration started by adi_analog_calibrate_async() to finish
+ * and returns the new calibration value.
+ *
+ * A timeout of 0 checks whether the calibration has finished without
+ * blocking.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of ADI Ports
+ * EINVAL - The port was never calibrated, or it stopped being an analog input
+ *          before its calibration finished
+ * EAGAIN - The calibration did not finish before the timeout
+ *
+ * \param port
+ *        The ADI port to wait on (from 1-8, 'a'-'h', 'A'-'H')
+ * \param timeout
+ *        The maximum number of milliseconds to wait, or TIMEOUT_MAX to wait
+ *        until the calibration finishes
+ *
+ * \return The average sensor value of the calibration, or PROS_ERR if the
+ * operation failed, setting errno.
+ */
+int32_t adi_analog_calibrate_wait(uint8_t port, uint32_t timeout);
+
 /**
  * Gets the 12-bit value of the specified port.
  *
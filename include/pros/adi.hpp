@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "pros/adi.h"
+#include "pros/rtos.h"
 
 namespace pros {
 
@@ -150,25 +151,65 @@ class ADIAnalogIn : protected ADIPort {
 	 * calibration value.
 	 *
 	 * This method assumes that the true sensor value is not actively changing at
-	 * this time and computes an average from approximately 500 samples, 1 ms
-	 * apart, for a 0.5 s period of calibration. The average value thus calculated
-	 * is returned and stored for later calls to the
+	 * this time and computes an average from 50 samples, one from each update of
+	 * the ADI ports, for a 0.5 s period of calibration. The average value thus
+	 * calculated is returned and stored for later calls to the
 	 * pros::ADIAnalogIn::get_value_calibrated() and
 	 * pros::ADIAnalogIn::get_value_calibrated_HR() functions. These functions
 	 * will return the difference between this value and the current sensor value
 	 * when called.
 	 *
+	 * The samples are taken by the system daemon, so other tasks can use the ADI
+	 * while this function waits.
+	 *
 	 * Do not use this function when the sensor value might be unstable (gyro
 	 * rotation, accelerometer movement).
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
-	 * ENODEV - The port is not configured as an analog input
+	 * EADDRINUSE - The port is not configured as an analog input
 	 *
 	 * \return The average sensor value computed by this function
 	 */
 	std::int32_t calibrate() const;
 
+	/**
+	 * Starts calibrating the analog sensor without waiting for the calibration
+	 * to finish.
+	 *
+	 * The system daemon takes the same samples as pros::ADIAnalogIn::calibrate(),
+	 * so several sensors can be calibrated at the same time. Until the
+	 * calibration finishes, the calibrated getters keep using the previous
+	 * calibration value.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EADDRINUSE - The port is not configured as an analog input
+	 *
+	 * \return 1 if the calibration was started or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t calibrate_async() const;
+
+	/**
+	 * Waits for the calibration started by pros::ADIAnalogIn::calibrate_async()
+	 * to finish and returns the new calibration value.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The port was never calibrated, or it stopped being an analog
+	 *          input before its calibration finished
+	 * EAGAIN - The calibration did not finish before the timeout
+	 *
+	 * \param timeout
+	 *        The maximum number of milliseconds to wait, 0 to check without
+	 *        blocking, or TIMEOUT_MAX to wait until the calibration finishes
+	 *
+	 * \return The average sensor value of the calibration, or PROS_ERR if the
+	 * operation failed, setting errno.
+	 */
+	std::int32_t calibrate_wait(std::uint32_t timeout = TIMEOUT_MAX) const;
+
 	/**
 	 * Gets the 12 bit calibrated value of an analog input port.
 	 *
@@ -356,6 +356,430 @@ void queue_delete(queue_t queue);
  */
 void queue_reset(queue_t queue);
 
+/******************************************************************************/
+/**                               Kernel Heap                                **/
+/**                                                                          **/
+/**     Allocations made by the kernel (including LVGL) with kmalloc() of    **/
+/**     up to 256 bytes are served from size-class pools, and larger ones    **/
+/**     from the general purpose heap. These statistics help size the heap   **/
+/**     and spot allocations that lock out the scheduler for too long.       **/
+/******************************************************************************/
+
+/**
+ * The number of size classes served from pools
+ */
+#define KMALLOC_POOL_CLASSES 8
+
+/**
+ * Statistics for one kernel heap size class
+ */
+typedef struct kmalloc_pool_stats_s {
+	uint32_t object_size;      // The largest allocation served by this class
+	uint32_t slabs;            // The number of slabs taken from the heap
+	uint32_t capacity;         // The number of objects in those slabs
+	uint32_t in_use;           // The number of objects currently allocated
+	uint32_t peak_in_use;      // The largest number of objects allocated at once
+	uint32_t requested_bytes;  // The bytes requested by the allocations in use
+	uint32_t allocs;           // The total number of allocations served
+} kmalloc_pool_stats_s_t;
+
+/**
+ * Statistics for allocations that went to the general purpose heap
+ */
+typedef struct kmalloc_stats_s {
+	uint32_t heap_allocs;    // Allocations too large for the pools
+	uint32_t refills;        // Slabs taken from the heap to refill the pools
+	uint32_t heap_max_us;    // Longest single heap operation
+	uint64_t heap_total_us;  // Total time spent in heap operations
+} kmalloc_stats_s_t;
+
+/**
+ * Gets the statistics for a kernel heap size class.
+ *
+ * Internal fragmentation in the class is
+ * in_use * object_size - requested_bytes, and the memory held by the class
+ * but not in use is (capacity - in_use) * object_size.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The size class is out of range or stats is NULL
+ *
+ * \param size_class
+ *        The size class, from 0 to KMALLOC_POOL_CLASSES - 1
+ * \param[out] stats
+ *        The statistics for the class
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t kmalloc_get_pool_stats(uint8_t size_class, kmalloc_pool_stats_s_t* const stats);
+
+/**
+ * Gets the statistics for kernel allocations that used the general purpose
+ * heap, which suspends the scheduler while it searches for a free block.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stats is NULL
+ *
+ * \param[out] stats
+ *        The statistics for the heap
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t kmalloc_get_stats(kmalloc_stats_s_t* const stats);
+
+/**
+ * The number of buckets in the free block histogram
+ */
+#define KMALLOC_HISTOGRAM_BUCKETS 10
+
+/**
+ * The state of the general purpose heap
+ */
+typedef struct kmalloc_heap_info_s {
+	uint32_t free_bytes;           // The total free space, which may be split up
+	uint32_t largest_free_block;   // The largest allocation that can currently succeed
+	uint32_t min_ever_free_bytes;  // The lowest free_bytes has been since startup
+	uint32_t free_blocks;          // The number of free blocks
+	// Bucket i counts free blocks smaller than 64 << i bytes, the last bucket
+	// counts the rest
+	uint32_t free_block_histogram[KMALLOC_HISTOGRAM_BUCKETS];
+} kmalloc_heap_info_s_t;
+
+/**
+ * Gets the state of the general purpose heap.
+ *
+ * This walks the heap's free list with the scheduler suspended, so it should
+ * not be called often while the robot is running.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - info is NULL
+ *
+ * \param[out] info
+ *        The state of the heap
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t kmalloc_get_heap_info(kmalloc_heap_info_s_t* const info);
+
+/**
+ * The number of tasks that kernel heap usage can be attributed to at once.
+ * Allocations made by further tasks are counted under the first entry.
+ */
+#define KMALLOC_TRACKED_TASKS 32
+
+/**
+ * Kernel heap usage of a single task
+ */
+typedef struct kmalloc_task_stats_s {
+	task_t task;                   // The task, or NULL if it has been deleted
+	char name[TASK_NAME_MAX_LEN];  // The name of the task
+	uint32_t live_bytes;           // The bytes the task has allocated and not freed
+	uint32_t live_allocs;          // The number of allocations the task has not freed
+	uint32_t peak_bytes;           // The most bytes the task has had allocated at once
+} kmalloc_task_stats_s_t;
+
+/**
+ * Gets the kernel heap usage of each task.
+ *
+ * Allocations are attributed to the task that made them, even if another task
+ * frees them. Memory that a task still had allocated when it was deleted is
+ * reported with a NULL task until it is freed, which makes leaks easy to spot.
+ * The first entry is always for allocations made outside of any task.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stats is NULL
+ *
+ * \param[out] stats
+ *        An array to hold the usage of each task
+ * \param count
+ *        The length of stats
+ *
+ * \return The number of entries written or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t kmalloc_get_task_stats(kmalloc_task_stats_s_t* const stats, const size_t count);
+
+/**
+ * The serial stream identifier that kmalloc_trace_dump() sends on ('heap'
+ * little endian)
+ */
+#define KMALLOC_TRACE_STREAM_ID 0x70616568
+
+/**
+ * The kind of operation in a trace entry
+ */
+typedef enum kmalloc_trace_op_e {
+	E_KMALLOC_TRACE_ALLOC = 0,  // A successful allocation
+	E_KMALLOC_TRACE_FREE = 1,   // A free
+	E_KMALLOC_TRACE_FAIL = 2    // An allocation that failed
+} kmalloc_trace_op_e_t;
+
+/**
+ * A single kernel heap operation, as recorded in the trace. Entries are sent
+ * over the serial line in this packed, little endian layout.
+ */
+typedef struct __attribute__((packed)) kmalloc_trace_entry_s {
+	uint32_t timestamp;  // The time of the operation in microseconds
+	uint32_t address;    // The address of the allocation, or 0 for a failure
+	uint32_t size;       // The size that was requested
+	uint8_t op;          // A kmalloc_trace_op_e_t
+	uint8_t owner;       // The index of the owning task in kmalloc_get_task_stats()
+	uint16_t reserved;
+} kmalloc_trace_entry_s_t;
+
+/**
+ * Starts recording every kernel heap operation into a ring buffer. If a trace
+ * is already being recorded, it is discarded and a new one is started.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - entries is 0
+ * ENOMEM - The ring buffer couldn't be allocated
+ *
+ * \param entries
+ *        The number of operations to keep. The ring buffer takes 16 bytes per
+ *        entry.
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t kmalloc_trace_start(const size_t entries);
+
+/**
+ * Stops recording kernel heap operations and frees the trace.
+ */
+void kmalloc_trace_stop(void);
+
+/**
+ * Sends the recorded kernel heap operations over the serial line, oldest first,
+ * as COBS frames of kmalloc_trace_entry_s_t on the 'heap' stream. The stream
+ * must be activated with serctl(SERCTL_ACTIVATE, (void*)KMALLOC_TRACE_STREAM_ID)
+ * first. Recording continues while the trace is sent.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EACCES - The 'heap' stream isn't active
+ * EIO - The trace couldn't be written to the serial line
+ *
+ * \return The number of entries sent or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t kmalloc_trace_dump(void);
+
+/******************************************************************************/
+/**                             Scheduler Trace                              **/
+/**                                                                          **/
+/**   The kernel always records task switches, blocking on queues and        **/
+/**   mutexes, priority inheritance and user markers into a ring buffer.     **/
+/**   Dump it after something goes wrong and convert it with                 **/
+/**   tools/trace_to_chrome.py to see it as a timeline.                      **/
+/******************************************************************************/
+
+/**
+ * The serial stream identifier that trace_dump() sends on ('trce' little
+ * endian)
+ */
+#define TRACE_STREAM_ID 0x65637274
+
+/**
+ * The number of entries the scheduler trace keeps
+ */
+#define TRACE_BUFFER_ENTRIES 4096
+
+/**
+ * The kind of event in a trace entry, and what the entry's object and value
+ * hold for it
+ */
+typedef enum trace_event_e {
+	E_TRACE_TASK_SWITCHED_IN = 0,     // The task started running
+	E_TRACE_TASK_SWITCHED_OUT,        // The task stopped running
+	E_TRACE_TASK_CREATE,              // object: the new task's number, value: its priority
+	E_TRACE_TASK_DELETE,              // object: the deleted task's number
+	E_TRACE_TASK_DELAY,               // The task started a delay
+	E_TRACE_PRIORITY_INHERIT,         // object: the mutex holder's number, value: the priority it inherited
+	E_TRACE_PRIORITY_DISINHERIT,      // object: the mutex holder's number, value: the priority it went back to
+	E_TRACE_QUEUE_BLOCK_RECEIVE,      // Blocked taking. object: the queue, value: its type
+	E_TRACE_QUEUE_BLOCK_SEND,         // Blocked giving. object: the queue, value: its type
+	E_TRACE_QUEUE_RECEIVE,            // Took from a queue or mutex. object: the queue, value: its type
+	E_TRACE_QUEUE_SEND,               // Gave to a queue or mutex. object: the queue, value: its type
+	E_TRACE_QUEUE_RECEIVE_FROM_ISR,   // An interrupt took from a queue. object: the queue, value: its type
+	E_TRACE_QUEUE_SEND_FROM_ISR,      // An interrupt gave to a queue. object: the queue, value: its type
+	E_TRACE_NOTIFY_FROM_ISR,          // An interrupt notified a task. object: the notified task's number
+	E_TRACE_MARK,                     // trace_mark(). object: the id, value: the value
+	E_TRACE_BEGIN,                    // trace_begin(). object: the id
+	E_TRACE_END                       // trace_end(). object: the id
+} trace_event_e_t;
+
+/**
+ * A single entry in the scheduler trace. Entries are sent over the serial line
+ * in this packed, little endian layout.
+ *
+ * Tasks are identified by their task number, which is never reused while the
+ * program runs. Queue types are 0 for queues, 1 for mutexes, 2 for counting
+ * semaphores, 3 for binary semaphores and 4 for recursive mutexes.
+ */
+typedef struct __attribute__((packed)) trace_entry_s {
+	uint32_t timestamp;  // The time of the event in microseconds
+	uint32_t object;     // See trace_event_e_t
+	uint32_t value;      // See trace_event_e_t
+	uint16_t task;       // The number of the task that was running
+	uint8_t event;       // A trace_event_e_t
+	uint8_t reserved;
+} trace_entry_s_t;
+
+/**
+ * The name of a task, as sent by trace_dump()
+ */
+typedef struct __attribute__((packed)) trace_task_name_s {
+	uint16_t task;                  // The task's number
+	char name[TASK_NAME_MAX_LEN];  // The task's name
+} trace_task_name_s_t;
+
+/**
+ * The first byte of each frame that trace_dump() sends, saying what follows it
+ */
+#define TRACE_FRAME_TASK_NAMES 0
+#define TRACE_FRAME_ENTRIES 1
+
+/**
+ * Records an instant marker in the scheduler trace.
+ *
+ * \param id
+ *        A number that identifies the marker
+ * \param value
+ *        A value to record with it
+ */
+void trace_mark(uint32_t id, uint32_t value);
+
+/**
+ * Records the start of a span in the scheduler trace, such as one iteration of
+ * a control loop. Each trace_begin() should be matched by a trace_end() with
+ * the same id from the same task.
+ *
+ * \param id
+ *        A number that identifies the span
+ */
+void trace_begin(uint32_t id);
+
+/**
+ * Records the end of a span started with trace_begin().
+ *
+ * \param id
+ *        A number that identifies the span
+ */
+void trace_end(uint32_t id);
+
+/**
+ * Pauses or resumes recording the scheduler trace. Recording starts when the
+ * program does.
+ *
+ * \param enabled
+ *        Whether to record events
+ */
+void trace_set_enabled(bool enabled);
+
+/**
+ * Sends the scheduler trace over the serial line, oldest first, on the 'trce'
+ * stream. The stream must be activated with
+ * serctl(SERCTL_ACTIVATE, (void*)TRACE_STREAM_ID) first.
+ *
+ * The names of the tasks that still exist are sent first, as frames starting
+ * with TRACE_FRAME_TASK_NAMES followed by trace_task_name_s_t. The entries
+ * follow, as frames starting with TRACE_FRAME_ENTRIES followed by
+ * trace_entry_s_t. Recording is paused while the trace is sent so that the
+ * dump doesn't record itself.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EACCES - The 'trce' stream isn't active
+ * ENOMEM - The task names couldn't be collected
+ * EIO - The trace couldn't be written to the serial line
+ *
+ * \return The number of entries sent or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t trace_dump(void);
+
+/******************************************************************************/
+/**                                 Profiler                                 **/
+/**                                                                          **/
+/**   While it runs, the profiler records what code each RTOS tick           **/
+/**   interrupts. Dump the samples and run tools/profile_symbolize.py on     **/
+/**   them to see which functions use the most CPU.                          **/
+/******************************************************************************/
+
+/**
+ * The serial stream identifier that profiler_dump() sends on ('prof' little
+ * endian)
+ */
+#define PROFILER_STREAM_ID 0x666f7270
+
+/**
+ * A single profiler sample. Samples are sent over the serial line in this
+ * packed, little endian layout.
+ */
+typedef struct __attribute__((packed)) profiler_sample_s {
+	uint32_t pc;        // The address of the instruction that the tick interrupted
+	uint32_t lr;        // The link register at that point, which is usually in the caller of that function
+	uint16_t task;      // The number of the task that was running, as in the scheduler trace
+	uint16_t reserved;
+} profiler_sample_s_t;
+
+/**
+ * Starts sampling the running code once every millisecond, from the RTOS tick.
+ * If the profiler has already been started, its samples are discarded.
+ *
+ * Once the buffer is full, each sample replaces the oldest one, so the
+ * profiler can be left running and dumped after the part of the program that
+ * is of interest.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - samples is 0
+ * ENOMEM - The sample buffer couldn't be allocated
+ *
+ * \param samples
+ *        The number of samples to keep. Each sample takes 12 bytes, so 15000
+ *        samples (176 KB) cover an autonomous period.
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t profiler_start(const size_t samples);
+
+/**
+ * Stops sampling. The samples are kept for profiler_dump() until the profiler
+ * is started again.
+ */
+void profiler_stop(void);
+
+/**
+ * Sends the profiler's samples over the serial line, oldest first, on the
+ * 'prof' stream. The stream must be activated with
+ * serctl(SERCTL_ACTIVATE, (void*)PROFILER_STREAM_ID) first. The profiler may be
+ * running or stopped.
+ *
+ * The frames are the same as those of trace_dump(): the names of the tasks
+ * that still exist come first, then frames starting with TRACE_FRAME_ENTRIES
+ * followed by profiler_sample_s_t.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EACCES - The 'prof' stream isn't active
+ * ENOMEM - The task names couldn't be collected
+ * EIO - The samples couldn't be written to the serial line
+ *
+ * \return The number of samples sent or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t profiler_dump(void);
+
 /******************************************************************************/
 /**                           Device Registration                            **/
 /******************************************************************************/
@@ -0,0 +1,677 @@
+/**
+ * \file pros/async.hpp
+ *
+ * Contains declarations for running many cooperative routines on one task with
+ * C++20 coroutines.
+ *
+ * A routine is a function that returns pros::async::Routine and uses co_await
+ * wherever it would otherwise block. Routines don't have stacks of their own,
+ * so dozens of them can run on the single task that calls Executor::run(),
+ * where each would otherwise need a task with a TASK_STACK_DEPTH_DEFAULT
+ * stack. They only switch at co_await, so data shared between routines on the
+ * same executor needs no mutex.
+ *
+ *     pros::async::Routine<> intake() {
+ *         while (true) {
+ *             // ...
+ *             co_await pros::async::next_cycle();
+ *         }
+ *     }
+ *
+ *     pros::async::Routine<> drive_then_score() {
+ *         co_await pros::async::all(drive_to_goal(), raise_lift());
+ *         co_await score();
+ *     }
+ *
+ *     void autonomous() {
+ *         pros::async::Executor executor;
+ *         executor.spawn(intake());
+ *         executor.spawn(drive_then_score());
+ *         executor.run();
+ *     }
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_ASYNC_HPP_
+#define _PROS_ASYNC_HPP_
+
+#include "pros/rtos.hpp"
+
+#include <array>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pros {
+namespace async {
+class Executor;
+
+template <class T = void>
+class Routine;
+
+namespace detail {
+/**
+ * The part of a routine's promise that doesn't depend on what it returns.
+ */
+struct PromiseBase {
+	// The executor that the routine runs on, set when it is started
+	Executor* executor = nullptr;
+	// The coroutine to resume when the routine finishes
+	std::coroutine_handle<> continuation;
+	// If not null, the number of routines that continuation is waiting for
+	std::uint32_t* pending = nullptr;
+	// Whether nothing owns the routine, so that it destroys itself when it finishes
+	bool detached = false;
+
+	struct FinalAwaiter {
+		bool await_ready() noexcept {
+			return false;
+		}
+
+		template <class Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> routine) noexcept {
+			PromiseBase& promise = routine.promise();
+			std::coroutine_handle<> next = std::noop_coroutine();
+			if (promise.continuation && (!promise.pending || --*promise.pending == 0)) {
+				next = promise.continuation;
+			}
+			if (promise.detached) {
+				routine.destroy();
+			}
+			return next;
+		}
+
+		void await_resume() noexcept {}
+	};
+
+	std::suspend_always initial_suspend() noexcept {
+		return {};
+	}
+
+	FinalAwaiter final_suspend() noexcept {
+		return {};
+	}
+
+	void unhandled_exception() noexcept {
+		std::terminate();
+	}
+};
+
+template <class T>
+struct Promise : PromiseBase {
+	std::optional<T> value;
+
+	Routine<T> get_return_object() noexcept;
+
+	template <class U>
+	void return_value(U&& result) {
+		value.emplace(std::forward<U>(result));
+	}
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+	Routine<void> get_return_object() noexcept;
+
+	void return_void() noexcept {}
+};
+
+/**
+ * A routine waiting for something that the executor has to check for, such as
+ * a mutex or a queue.
+ */
+struct Poller {
+	std::coroutine_handle<> routine;
+	// The tick at which to give up, or TIMEOUT_MAX to wait forever
+	std::uint32_t deadline = TIMEOUT_MAX;
+	// Whether the wait succeeded
+	bool result = false;
+
+	virtual ~Poller() = default;
+
+	/**
+	 * Tries to complete the wait without blocking.
+	 *
+	 * \return True if the wait is over
+	 */
+	virtual bool poll() = 0;
+};
+
+/**
+ * A routine waiting for a notification of the executor's task.
+ */
+struct NotificationWaiter {
+	std::coroutine_handle<> routine;
+	// The tick at which to give up, or TIMEOUT_MAX to wait forever
+	std::uint32_t deadline = TIMEOUT_MAX;
+	// The notification count received, or 0 if the wait timed out
+	std::uint32_t count = 0;
+};
+
+/**
+ * Gets the deadline of a wait that began now.
+ */
+std::uint32_t deadline_after(std::uint32_t timeout);
+
+/**
+ * Receives an item from a queue without blocking.
+ */
+bool try_receive(void* queue, void* buffer);
+
+/**
+ * Gets the executor of the routine that is awaiting something.
+ */
+template <class Promise>
+Executor& executor_of(std::coroutine_handle<Promise> routine) {
+	return *static_cast<PromiseBase&>(routine.promise()).executor;
+}
+}  // namespace detail
+
+/**
+ * The result of a function that runs as a routine.
+ *
+ * A routine doesn't start when it is called. It starts when it is awaited
+ * (co_await routine), which runs it to completion before the awaiting routine
+ * continues, or when it is passed to all(), spawn() or Executor::spawn().
+ *
+ * \tparam T
+ *         The type of the value the routine returns with co_return
+ */
+template <class T>
+class [[nodiscard]] Routine {
+	public:
+	using promise_type = detail::Promise<T>;
+
+	explicit Routine(std::coroutine_handle<promise_type> routine) noexcept : routine(routine) {}
+
+	Routine(Routine&& other) noexcept : routine(std::exchange(other.routine, {})) {}
+
+	Routine& operator=(Routine&& other) noexcept {
+		if (this != &other) {
+			release();
+			routine = std::exchange(other.routine, {});
+		}
+		return *this;
+	}
+
+	Routine(const Routine&) = delete;
+	Routine& operator=(const Routine&) = delete;
+
+	/**
+	 * Destroys a routine that hasn't started or has finished. A routine that is
+	 * still running is left to finish on its own.
+	 */
+	~Routine() {
+		release();
+	}
+
+	/**
+	 * Checks whether the routine has finished.
+	 *
+	 * \return True if the routine has returned
+	 */
+	bool done() const noexcept {
+		return routine && routine.done();
+	}
+
+	/**
+	 * Gives up ownership of the routine's coroutine, for Executor::spawn().
+	 */
+	std::coroutine_handle<promise_type> take() noexcept {
+		return std::exchange(routine, {});
+	}
+
+	/**
+	 * Waits for a routine that was awaited or started by spawn().
+	 */
+	struct Awaiter {
+		std::coroutine_handle<promise_type> routine;
+
+		bool await_ready() noexcept {
+			return routine.done();
+		}
+
+		template <class Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+			promise_type& promise = routine.promise();
+			promise.continuation = awaiting;
+			if (promise.executor) {
+				// already started by spawn(), so wait for it to finish
+				return std::noop_coroutine();
+			}
+			promise.executor = &detail::executor_of(awaiting);
+			return routine;
+		}
+
+		T await_resume() {
+			if constexpr (!std::is_void_v<T>) {
+				return std::move(*routine.promise().value);
+			}
+		}
+	};
+
+	Awaiter operator co_await() const noexcept {
+		return Awaiter{routine};
+	}
+
+	private:
+	void release() noexcept {
+		if (!routine) {
+			return;
+		}
+		if (routine.done() || !routine.promise().executor) {
+			routine.destroy();
+		} else {
+			routine.promise().detached = true;
+		}
+		routine = {};
+	}
+
+	std::coroutine_handle<promise_type> routine;
+};
+
+/**
+ * Runs routines on the task that calls run().
+ *
+ * Routines are resumed in the order in which they become ready. The executor
+ * sleeps while every routine is waiting, and wakes when the first delay
+ * expires or the task is notified. While any routine waits for a mutex or a
+ * queue, it also wakes every millisecond to check for them.
+ *
+ * An executor may only be used from the task that runs it, and must not be
+ * destroyed while it has routines left.
+ */
+class Executor {
+	public:
+	Executor() = default;
+
+	Executor(const Executor&) = delete;
+	Executor(Executor&&) = delete;
+	Executor& operator=(const Executor&) = delete;
+	Executor& operator=(Executor&&) = delete;
+
+	/**
+	 * Adds a routine to run concurrently with the others. The executor owns the
+	 * routine from then on and destroys it when it finishes.
+	 *
+	 * \param routine
+	 *        The routine to run. It must not have started.
+	 */
+	void spawn(Routine<void> routine);
+
+	/**
+	 * Runs routines on the calling task until all of them have finished.
+	 *
+	 * The executor's task can be notified with task_notify() to wake routines
+	 * waiting in notified().
+	 */
+	void run();
+
+	/**
+	 * Gets the task running the executor.
+	 *
+	 * \return The task running run(), or NULL if it isn't running
+	 */
+	task_t get_task() const {
+		return task;
+	}
+
+	/**
+	 * Queues a routine to be resumed. Used by awaitables.
+	 */
+	void schedule(std::coroutine_handle<> routine);
+
+	/**
+	 * Queues a routine to be resumed at a tick. Used by awaitables.
+	 */
+	void schedule_at(std::coroutine_handle<> routine, std::uint32_t time);
+
+	/**
+	 * Resumes a poller's routine once its poll() succeeds or its deadline
+	 * passes. Used by awaitables.
+	 */
+	void add_poller(detail::Poller* poller);
+
+	/**
+	 * Resumes a waiter's routine once the executor's task is notified or the
+	 * waiter's deadline passes. Used by awaitables.
+	 *
+	 * \return True if the waiter was suspended, or false if a notification was
+	 * already pending and has been given to it
+	 */
+	bool add_notification_waiter(detail::NotificationWaiter* waiter);
+
+	private:
+	struct Timer {
+		std::uint32_t time;
+		std::coroutine_handle<> routine;
+	};
+
+	void wake_timers(std::uint32_t now);
+	void wake_pollers(std::uint32_t now);
+	void wake_notification_waiters(std::uint32_t now);
+	std::uint32_t sleep_time(std::uint32_t now) const;
+
+	std::deque<std::coroutine_handle<>> ready;
+	// A min-heap on time
+	std::vector<Timer> timers;
+	std::vector<detail::Poller*> pollers;
+	std::deque<detail::NotificationWaiter*> notification_waiters;
+	// Notifications received while no routine was waiting for them
+	std::uint32_t notifications = 0;
+	task_t task = nullptr;
+};
+
+namespace detail {
+struct DelayAwaiter {
+	std::uint32_t time;
+	bool yield;
+
+	bool await_ready() const noexcept {
+		return false;
+	}
+
+	template <class Promise>
+	void await_suspend(std::coroutine_handle<Promise> awaiting) {
+		Executor& executor = executor_of(awaiting);
+		if (yield) {
+			executor.schedule(awaiting);
+		} else {
+			executor.schedule_at(awaiting, time);
+		}
+	}
+
+	void await_resume() const noexcept {}
+};
+
+struct MutexAwaiter : Poller {
+	Mutex& mutex;
+	std::uint32_t timeout;
+
+	MutexAwaiter(Mutex& mutex, std::uint32_t timeout) : mutex(mutex), timeout(timeout) {}
+
+	bool poll() override {
+		return mutex.take(0);
+	}
+
+	bool await_ready() {
+		result = poll();
+		return result || timeout == 0;
+	}
+
+	template <class Promise>
+	void await_suspend(std::coroutine_handle<Promise> awaiting) {
+		routine = awaiting;
+		deadline = deadline_after(timeout);
+		executor_of(awaiting).add_poller(this);
+	}
+
+	bool await_resume() const noexcept {
+		return result;
+	}
+};
+
+struct QueueAwaiter : Poller {
+	void* queue;
+	void* buffer;
+	std::uint32_t timeout;
+
+	QueueAwaiter(void* queue, void* buffer, std::uint32_t timeout) : queue(queue), buffer(buffer), timeout(timeout) {}
+
+	bool poll() override {
+		return try_receive(queue, buffer);
+	}
+
+	bool await_ready() {
+		result = poll();
+		return result || timeout == 0;
+	}
+
+	template <class Promise>
+	void await_suspend(std::coroutine_handle<Promise> awaiting) {
+		routine = awaiting;
+		deadline = deadline_after(timeout);
+		executor_of(awaiting).add_poller(this);
+	}
+
+	bool await_resume() const noexcept {
+		return result;
+	}
+};
+
+struct NotificationAwaiter : NotificationWaiter {
+	std::uint32_t timeout;
+
+	explicit NotificationAwaiter(std::uint32_t timeout) : timeout(timeout) {}
+
+	bool await_ready() const noexcept {
+		return false;
+	}
+
+	template <class Promise>
+	bool await_suspend(std::coroutine_handle<Promise> awaiting) {
+		routine = awaiting;
+		deadline = deadline_after(timeout);
+		return executor_of(awaiting).add_notification_waiter(this);
+	}
+
+	std::uint32_t await_resume() const noexcept {
+		return count;
+	}
+};
+
+template <std::size_t Count>
+struct AllAwaiter {
+	std::array<Routine<void>, Count> routines;
+	std::uint32_t pending = 0;
+
+	bool await_ready() const noexcept {
+		return false;
+	}
+
+	template <class Promise>
+	bool await_suspend(std::coroutine_handle<Promise> awaiting) {
+		Executor& executor = executor_of(awaiting);
+		// the routines only run once this returns, so none can finish early
+		pending = Count;
+		for (Routine<void>& routine : routines) {
+			std::coroutine_handle<Routine<void>::promise_type> handle = routine.take();
+			if (handle.done()) {
+				pending--;
+			} else {
+				handle.promise().continuation = awaiting;
+				handle.promise().pending = &pending;
+				if (!handle.promise().executor) {
+					handle.promise().executor = &executor;
+					executor.schedule(handle);
+				}
+			}
+			// keep owning it, so that it is destroyed when the awaiting routine
+			// continues
+			routine = Routine<void>(handle);
+		}
+		return pending != 0;
+	}
+
+	void await_resume() const noexcept {}
+};
+
+template <class T>
+struct SpawnAwaiter {
+	Routine<T>& routine;
+
+	bool await_ready() const noexcept {
+		return false;
+	}
+
+	template <class Promise>
+	bool await_suspend(std::coroutine_handle<Promise> awaiting) {
+		std::coroutine_handle<typename Routine<T>::promise_type> handle = routine.take();
+		if (!handle.promise().executor) {
+			handle.promise().executor = &executor_of(awaiting);
+			handle.promise().executor->schedule(handle);
+		}
+		routine = Routine<T>(handle);
+		return false;
+	}
+
+	void await_resume() const noexcept {}
+};
+}  // namespace detail
+
+/**
+ * Suspends the routine for a number of milliseconds. A delay of 0 lets every
+ * other ready routine run before this one continues.
+ *
+ * \param milliseconds
+ *        The number of milliseconds to wait (1000 milliseconds per second)
+ */
+inline detail::DelayAwaiter delay(std::uint32_t milliseconds) {
+	return {pros::c::millis() + milliseconds, milliseconds == 0};
+}
+
+/**
+ * Suspends the routine until a specified time, like task_delay_until().
+ *
+ * The routine is resumed at the time *prev_time + delta, and *prev_time is
+ * updated to that time. If that time has already passed, the routine only
+ * yields to the other ready routines.
+ *
+ * \param prev_time
+ *        A pointer to the location storing the setpoint time. This should
+ *        typically be initialized to the return value of millis().
+ * \param delta
+ *        The number of milliseconds to wait (1000 milliseconds per second)
+ */
+inline detail::DelayAwaiter delay_until(std::uint32_t* const prev_time, std::uint32_t delta) {
+	*prev_time += delta;
+	return {*prev_time, false};
+}
+
+/**
+ * Gets the tick of the system daemon's next release.
+ *
+ * \return The first tick after now at which the daemon runs
+ */
+std::uint32_t next_cycle_time();
+
+/**
+ * Suspends the routine until the system daemon's next cycle, when new data has
+ * just been read from the smart ports. A routine that loops on this runs once
+ * every 2 ms, in phase with the daemon.
+ */
+inline detail::DelayAwaiter next_cycle() {
+	return {next_cycle_time(), false};
+}
+
+/**
+ * Suspends the routine until it has taken a mutex.
+ *
+ * The mutex is owned by the executor's task, so a routine on the same
+ * executor trying to take it again waits as well, and any routine on the same
+ * executor may give it back.
+ *
+ * \param mutex
+ *        The mutex to take
+ * \param timeout
+ *        The number of milliseconds to wait for the mutex, or TIMEOUT_MAX to
+ *        wait forever
+ *
+ * \return co_await returns true if the mutex was taken, or false if the
+ * timeout expired
+ */
+inline detail::MutexAwaiter take(Mutex& mutex, std::uint32_t timeout = TIMEOUT_MAX) {
+	return {mutex, timeout};
+}
+
+/**
+ * Suspends the routine until an item has been received from a queue.
+ *
+ * \param queue
+ *        The queue, from queue_create(), to receive from
+ * \param[out] buffer
+ *        Where to copy the item, which must be as large as the queue's items
+ *        and outlive the wait
+ * \param timeout
+ *        The number of milliseconds to wait for an item, or TIMEOUT_MAX to
+ *        wait forever
+ *
+ * \return co_await returns true if an item was received, or false if the
+ * timeout expired
+ */
+inline detail::QueueAwaiter receive(void* queue, void* buffer, std::uint32_t timeout = TIMEOUT_MAX) {
+	return {queue, buffer, timeout};
+}
+
+/**
+ * Suspends the routine until the executor's task is notified with
+ * task_notify(), like task_notify_take(true, timeout).
+ *
+ * Each notification wakes the routine that has been waiting the longest, and
+ * notifications that arrive while no routine is waiting are kept for the next.
+ *
+ * \param timeout
+ *        The number of milliseconds to wait for a notification, or
+ *        TIMEOUT_MAX to wait forever
+ *
+ * \return co_await returns the notification count, or 0 if the timeout
+ * expired
+ */
+inline detail::NotificationAwaiter notified(std::uint32_t timeout = TIMEOUT_MAX) {
+	return detail::NotificationAwaiter{timeout};
+}
+
+/**
+ * Runs routines concurrently and suspends the awaiting routine until all of
+ * them have finished.
+ *
+ * \param routines
+ *        The routines to run
+ */
+template <class... Routines>
+detail::AllAwaiter<sizeof...(Routines)> all(Routines&&... routines) {
+	static_assert((std::is_same_v<std::decay_t<Routines>, Routine<void>> && ...), "all() takes Routine<void>s");
+	return {{std::forward<Routines>(routines)...}};
+}
+
+/**
+ * Starts a routine on the awaiting routine's executor without waiting for it.
+ * The routine can still be awaited later to wait for it to finish.
+ *
+ * \param routine
+ *        The routine to start. If it is destroyed before it finishes, it
+ *        finishes on its own.
+ */
+template <class T>
+detail::SpawnAwaiter<T> spawn(Routine<T>& routine) {
+	return {routine};
+}
+
+namespace detail {
+template <class T>
+Routine<T> Promise<T>::get_return_object() noexcept {
+	return Routine<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Routine<void> Promise<void>::get_return_object() noexcept {
+	return Routine<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+}  // namespace detail
+}  // namespace async
+}  // namespace pros
+
+#endif  // _PROS_ASYNC_HPP_
@@ -66,6 +66,25 @@ typedef struct __attribute__((__packed__)) euler_s {
 #endif
 #endif
 
+/**
+ * One sample of an Inertial Sensor that is streaming, see imu_stream_enable().
+ *
+ * The offsets set by the tare and set functions have already been applied, so
+ * the attitude fields hold the same values that the individual getters would
+ * have returned for this sample.
+ */
+typedef struct imu_sample_s {
+	uint32_t timestamp;         // The time (in ms) at which the sensor sent the sample
+	uint32_t sequence;          // Incremented for every sample that is recorded for the port
+	uint32_t status;            // A bitfield of imu_status_e_t
+	double rotation;            // See imu_get_rotation()
+	double heading;             // See imu_get_heading()
+	euler_s_t euler;            // See imu_get_euler()
+	quaternion_s_t quaternion;  // See imu_get_quaternion()
+	imu_gyro_s_t gyro;          // See imu_get_gyro_rate()
+	imu_accel_s_t accel;        // See imu_get_accel()
+} imu_sample_s_t;
+
 #define IMU_MINIMUM_DATA_RATE 5
 
 /**
@@ -536,6 +555,110 @@ int32_t imu_set_roll(uint8_t port, double target);
  */
 int32_t imu_set_yaw(uint8_t port, double target);
 
+/**
+ * Starts recording every sample of the Inertial Sensor.
+ *
+ * The system daemon records each new sample that the sensor sends, at the rate
+ * set by imu_set_data_rate(), into a ring buffer that holds the last depth
+ * samples. The offsets, the quaternion and the heading are worked out once as
+ * each sample is recorded. While the sensor is streaming, the rotation,
+ * heading, quaternion and euler getters return the values of the latest
+ * sample instead of reading the sensor again.
+ *
+ * The buffer is allocated the first time that a port is streamed and is kept
+ * for the life of the program, so its depth cannot be changed afterwards.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Inertial Sensor
+ * EINVAL - depth is 0
+ * EBUSY - The port already has a buffer of a different depth
+ * ENOMEM - There was not enough memory for the buffer
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \param  depth
+ * 				 The number of samples to keep
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t imu_stream_enable(uint8_t port, uint32_t depth);
+
+/**
+ * Stops recording the samples of the Inertial Sensor.
+ *
+ * The samples that were already recorded can still be read.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Inertial Sensor
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t imu_stream_disable(uint8_t port);
+
+/**
+ * Gets the latest sample recorded for a streaming Inertial Sensor.
+ *
+ * This function does not take the port mutex or talk to the sensor, so any
+ * number of tasks can call it at once.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Inertial Sensor
+ * EAGAIN - No sample has been recorded for the port yet, or the latest sample
+ *          kept being overwritten while it was copied
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \param[out]  sample
+ * 				 The sample to copy the latest sample into
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t imu_get_sample(uint8_t port, imu_sample_s_t* const sample);
+
+/**
+ * Reads the samples recorded for a streaming Inertial Sensor since the last
+ * call, oldest first.
+ *
+ * Each consumer keeps its own cursor, which holds the sequence number of the
+ * next sample that it wants. Start a cursor at 0 to read from the oldest
+ * sample in the buffer. The cursor is moved past the samples that are read, so
+ * calling this function in a loop sees every sample exactly once. If the
+ * consumer falls more than a buffer behind, the samples that were overwritten
+ * are skipped, which shows up as a gap in the sequence numbers.
+ *
+ * Like imu_get_sample(), this function never blocks.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Inertial Sensor
+ * EINVAL - The port has never streamed, or cursor or samples is NULL
+ * EAGAIN - No sample could be read because each one was overwritten while
+ *          it was copied
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \param  cursor
+ * 				 The sequence number of the next sample to read, which is updated
+ * 				 to follow the samples that were read
+ * \param[out]  samples
+ * 				 An array to copy the samples into
+ * \param  count
+ * 				 The most samples to read
+ * \return The number of samples read, or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t imu_read_samples(uint8_t port, uint32_t* const cursor, imu_sample_s_t* const samples, uint32_t count);
+
 #ifdef __cplusplus
 }
 }
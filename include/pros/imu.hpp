@@ -19,6 +19,8 @@
 #define _PROS_IMU_HPP_
 
 #include <cstdint>
+#include <vector>
+
 #include "pros/imu.h"
 
 namespace pros {
@@ -450,6 +452,81 @@ class Imu {
 	 * false if it is not.
 	 */
 	virtual bool is_calibrating() const;
+	/**
+	 * Starts recording every sample of the Inertial Sensor.
+	 *
+	 * The system daemon records each new sample into a ring buffer of the last
+	 * depth samples, working out the offsets, quaternion and heading once per
+	 * sample. While the sensor is streaming, the rotation, heading, quaternion
+	 * and euler getters return the values of the latest sample.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as an Inertial Sensor
+	 * EINVAL - depth is 0
+	 * EBUSY - The port already has a buffer of a different depth
+	 * ENOMEM - There was not enough memory for the buffer
+	 *
+	 * \param  depth
+	 * 				 The number of samples to keep
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t stream_enable(std::uint32_t depth) const;
+	/**
+	 * Stops recording the samples of the Inertial Sensor.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as an Inertial Sensor
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t stream_disable() const;
+	/**
+	 * Gets the latest sample recorded for a streaming Inertial Sensor without
+	 * blocking.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as an Inertial Sensor
+	 * EAGAIN - No sample has been recorded for the port yet, or the latest sample
+	 *          kept being overwritten while it was copied
+	 *
+	 * \return The latest sample, or a sample with a sequence number of 0 if the
+	 * operation failed, setting errno.
+	 */
+	virtual pros::c::imu_sample_s_t get_sample() const;
+	/**
+	 * Reads the samples recorded since the last call, oldest first, without
+	 * blocking.
+	 *
+	 * The cursor holds the sequence number of the next sample to read and is
+	 * moved past the samples that are read. Start it at 0 to read from the
+	 * oldest sample in the buffer. Samples that were overwritten before they
+	 * could be read show up as a gap in the sequence numbers.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as an Inertial Sensor
+	 * EINVAL - The port has never streamed
+	 * EAGAIN - No sample could be read because each one was overwritten while
+	 *          it was copied
+	 *
+	 * \param  cursor
+	 * 				 The sequence number of the next sample to read
+	 * \param  max_count
+	 * 				 The most samples to read
+	 * \return The samples that were read, which is empty if there were none or
+	 * the operation failed
+	 */
+	virtual std::vector<pros::c::imu_sample_s_t> read_samples(std::uint32_t& cursor,
+	                                                          std::uint32_t max_count = UINT32_MAX) const;
 };
 
 using IMU = Imu;
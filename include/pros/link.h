@@ -50,6 +50,51 @@ typedef enum link_type_e {
 
 #define LINK_BUFFER_SIZE 512
 
+/**
+ * The bytes that link_transmit_message() adds to each message: a start byte,
+ * the type, the length, a check on the header and a CRC-16 of the frame.
+ */
+#define LINK_FRAME_OVERHEAD 7
+
+/**
+ * The largest message that fits in a single frame.
+ */
+#define LINK_MAX_MESSAGE_SIZE (LINK_BUFFER_SIZE - LINK_FRAME_OVERHEAD)
+
+/**
+ * The largest message type that user code should use. Larger types are
+ * reserved for the kernel.
+ */
+#define LINK_MAX_MESSAGE_TYPE 127
+
+/**
+ * Counters kept by the framed transport of a link.
+ */
+typedef struct link_stats_s {
+    uint32_t frames_sent;      // Messages transmitted
+    uint32_t frames_received;  // Messages received with a valid CRC
+    uint32_t crc_errors;       // Frames whose CRC didn't match
+    uint32_t bytes_dropped;    // Bytes skipped while looking for the start of a frame
+    uint32_t retransmissions;  // Fragments sent again by the reliable mode
+    uint32_t state_bytes_sent; // Bytes of shared state updates queued for the reliable mode
+    uint32_t session_resets;   // Times the reliable mode started over because a robot restarted
+} link_stats_s_t;
+
+/**
+ * The largest message that can be sent with link_reliable_send().
+ */
+#define LINK_RELIABLE_MAX_MESSAGE_SIZE 4096
+
+/**
+ * The number of shared states that a link can have, see link_state_register().
+ */
+#define LINK_STATE_MAX_IDS 16
+
+/**
+ * The largest shared state in bytes.
+ */
+#define LINK_STATE_MAX_SIZE 2048
+
 #ifdef __cplusplus
 namespace c {
 #endif
@@ -181,6 +226,9 @@ uint32_t link_transmit_raw(uint8_t port, void* data, uint16_t data_size);
 /**
  * Receive raw serial data through vexlink.
  * 
+ * This reads straight from the radio, so it shouldn't be mixed with the
+ * message functions on the same link.
+ * 
  * This function uses the following values of errno when an error state is
  * reached:
  * ENXIO - The given value is not within the range of V5 ports (1-21).
@@ -203,6 +251,8 @@ uint32_t link_receive_raw(uint8_t port, void* dest, uint16_t data_size);
 
 /**
  * Send packeted message through vexlink, with a checksum and start byte.
+ *
+ * This is link_transmit_message() with a type of 0.
  * 
  * This function uses the following values of errno when an error state is
  * reached:
@@ -227,6 +277,9 @@ uint32_t link_transmit(uint8_t port, void* data, uint16_t data_size);
 
 /**
  * Receive packeted message through vexlink, with a checksum and start byte.
+ *
+ * This receives the next message like link_receive_message(), but fails if it
+ * isn't exactly data_size bytes long. Only that message is dropped.
  * 
  * This function uses the following values of errno when an error state is
  * reached:
@@ -235,7 +288,8 @@ uint32_t link_transmit(uint8_t port, void* data, uint16_t data_size);
  * ENXIO - The sensor is still calibrating, or no link is connected via the radio.
  * EINVAL - The destination given is NULL, or the size given is larger than the FIFO buffer 
  * or destination buffer. 
- * EBADMSG - Protocol error related to start byte, data size, or checksum.
+ * EBUSY - No complete message has been received yet
+ * EBADMSG - The message received was not data_size bytes long.
  * 
  * \param port 
  *      The port of the radio for the intended link.
@@ -249,9 +303,277 @@ uint32_t link_transmit(uint8_t port, void* data, uint16_t data_size);
  */
 uint32_t link_receive(uint8_t port, void* dest, uint16_t data_size);
 
+/**
+ * Send a message of any length up to LINK_MAX_MESSAGE_SIZE through vexlink,
+ * tagged with a type.
+ *
+ * The message is sent as a single frame with a start byte, its type and
+ * length, and a CRC-16, so that the receiver can find it in the stream again
+ * after corrupted or lost bytes.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a radio.
+ * ENXIO - The sensor is still calibrating, or no link is connected via the radio.
+ * EBUSY - There is not enough room in the transmit buffer for the frame.
+ * EINVAL - The data given is NULL, data_size is larger than LINK_MAX_MESSAGE_SIZE,
+ *          or type is larger than LINK_MAX_MESSAGE_TYPE
+ * ENOMEM - The link's state couldn't be allocated
+ *
+ * \param port 
+ *      The port of the radio for the intended link.
+ * \param type
+ *      A tag for the receiver to tell messages apart, from 0 to LINK_MAX_MESSAGE_TYPE
+ * \param data
+ *      Buffer with data to send
+ * \param data_size
+ *      Bytes of data to send
+ *
+ * \return PROS_ERR if the message couldn't be sent, and data_size if it was.
+ */
+uint32_t link_transmit_message(uint8_t port, uint8_t type, const void* data, uint16_t data_size);
+
+/**
+ * Receive the next message sent with link_transmit_message().
+ *
+ * Any bytes that aren't part of a valid frame are skipped, so a corrupted
+ * frame is dropped on its own and the frames after it are still received.
+ * Messages are received whole and in order; this function never waits for
+ * one.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a radio.
+ * ENXIO - The sensor is still calibrating, or no link is connected via the radio.
+ * EINVAL - The destination given is NULL
+ * EAGAIN - No complete message has been received yet
+ * EMSGSIZE - The next message is larger than data_size. It is dropped, so
+ * that the messages behind it can still be received.
+ * ENOMEM - The link's state couldn't be allocated
+ *
+ * \param port 
+ *      The port of the radio for the intended link.
+ * \param[out] type
+ *      Set to the type of the message, or NULL if it isn't needed
+ * \param dest
+ *      Destination buffer to copy the message to
+ * \param data_size
+ *      Size of the destination buffer
+ *
+ * \return PROS_ERR if there is no message to receive, and the size of the
+ * message if there is.
+ */
+uint32_t link_receive_message(uint8_t port, uint8_t* type, void* dest, uint16_t data_size);
+
+/**
+ * Get the counters of the framed transport of a link.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a radio.
+ * EINVAL - stats is NULL
+ *
+ * \param port 
+ *      The port of the radio for the intended link.
+ * \param[out] stats
+ *      The counters
+ *
+ * \return PROS_ERR if the port is not a link, and 1 if it is.
+ */
+uint32_t link_get_stats(uint8_t port, link_stats_s_t* stats);
+
+/**
+ * Enable the reliable mode of a link.
+ *
+ * Messages sent in the reliable mode are split into fragments that are
+ * acknowledged by the other robot, and fragments that aren't acknowledged in
+ * time are sent again. A kernel task does the sending and receiving, so
+ * link_reliable_send() and link_reliable_receive() never wait. Both robots
+ * need to enable the reliable mode.
+ *
+ * If either robot restarts its program, the reliable mode starts over with the
+ * other robot without losing messages. A message whose delivery hadn't been
+ * acknowledged when that happens is sent again, so it may arrive twice.
+ *
+ * Messages sent with link_transmit_message() can still be used alongside the
+ * reliable mode, but reliable messages are held up while more than
+ * LINK_BUFFER_SIZE bytes of them are waiting to be received.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a radio.
+ * ENOMEM - The state of the reliable mode couldn't be allocated
+ *
+ * \param port 
+ *      The port of the radio for the intended link.
+ *
+ * \return PROS_ERR if the reliable mode couldn't be enabled, and 1 if it was.
+ */
+uint32_t link_reliable_enable(uint8_t port);
+
+/**
+ * Queue a message to be delivered reliably.
+ *
+ * The message is copied, so the data can be reused as soon as this returns.
+ * Messages are received whole, in the order they were sent.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a radio.
+ * EINVAL - The data given is NULL, data_size is larger than
+ * LINK_RELIABLE_MAX_MESSAGE_SIZE, the type is larger than
+ * LINK_MAX_MESSAGE_TYPE, or the reliable mode isn't enabled
+ * EAGAIN - Too many messages are waiting to be delivered already
+ * ENOMEM - The message couldn't be copied
+ *
+ * \param port 
+ *      The port of the radio for the intended link.
+ * \param type
+ *      A tag for the receiver to tell messages apart, from 0 to LINK_MAX_MESSAGE_TYPE
+ * \param data
+ *      Buffer with data to send
+ * \param data_size
+ *      Bytes of data to send
+ *
+ * \return PROS_ERR if the message couldn't be queued, and 1 if it was.
+ */
+uint32_t link_reliable_send(uint8_t port, uint8_t type, const void* data, uint32_t data_size);
+
+/**
+ * Receive the next message sent with link_reliable_send().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a radio.
+ * EINVAL - The destination given is NULL, or the reliable mode isn't enabled
+ * EAGAIN - No message has been received yet
+ * EMSGSIZE - The next message is larger than data_size. It is dropped, so
+ * that the messages behind it can still be received.
+ *
+ * \param port 
+ *      The port of the radio for the intended link.
+ * \param[out] type
+ *      Set to the type of the message, or NULL if it isn't needed
+ * \param dest
+ *      Destination buffer to copy the message to
+ * \param data_size
+ *      Size of the destination buffer
+ *
+ * \return PROS_ERR if there is no message to receive, and the size of the
+ * message if there is.
+ */
+uint32_t link_reliable_receive(uint8_t port, uint8_t* type, void* dest, uint32_t data_size);
+
+/**
+ * Get the number of messages sent with link_reliable_send() that haven't been
+ * acknowledged by the other robot yet.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a radio.
+ * EINVAL - The reliable mode isn't enabled
+ *
+ * \param port 
+ *      The port of the radio for the intended link.
+ *
+ * \return PROS_ERR if the operation failed, and the number of messages if it
+ * succeeded.
+ */
+uint32_t link_reliable_pending(uint8_t port);
+
+/**
+ * Register a state that is shared with the other robot.
+ *
+ * Each robot publishes its own copy of the state with link_state_publish()
+ * and reads the other robot's copy with link_state_get(). The kernel only
+ * sends the bytes that changed since the last update it sent, so a state can
+ * be published every loop even if it is large. Updates are sent in the
+ * reliable mode, which must be enabled first, and are applied in order. When
+ * a robot registers the state, or misses updates because it restarted, the
+ * other robot sends it the whole state again.
+ *
+ * Both robots need to register the state with the same id and size.
+ * Registering it again with the same size does nothing.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a radio.
+ * EINVAL - The id is not below LINK_STATE_MAX_IDS, the size is 0 or larger
+ * than LINK_STATE_MAX_SIZE, or the reliable mode isn't enabled
+ * EEXIST - The id is registered with a different size
+ * ENOMEM - The copies of the state couldn't be allocated
+ *
+ * \param port 
+ *      The port of the radio for the intended link.
+ * \param id
+ *      The id of the state, from 0 to LINK_STATE_MAX_IDS - 1
+ * \param size
+ *      The size of the state in bytes
+ *
+ * \return PROS_ERR if the state couldn't be registered, and 1 if it was.
+ */
+uint32_t link_state_register(uint8_t port, uint8_t id, uint32_t size);
+
+/**
+ * Publish this robot's copy of a shared state.
+ *
+ * The state is copied and this function never waits. The kernel sends the
+ * latest published copy as soon as the link has room, so publishing faster
+ * than the link can keep up with only skips the copies in between.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a radio.
+ * EINVAL - The data given is NULL, or the state isn't registered
+ *
+ * \param port 
+ *      The port of the radio for the intended link.
+ * \param id
+ *      The id of the state
+ * \param data
+ *      The state, which is as many bytes as the state was registered with
+ *
+ * \return PROS_ERR if the operation failed, and 1 if it succeeded.
+ */
+uint32_t link_state_publish(uint8_t port, uint8_t id, const void* data);
+
+/**
+ * Get the other robot's copy of a shared state.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a radio.
+ * EINVAL - The destination given is NULL, or the state isn't registered
+ *
+ * \param port 
+ *      The port of the radio for the intended link.
+ * \param id
+ *      The id of the state
+ * \param[out] dest
+ *      The buffer to copy the state to, which is as many bytes as the state was
+ *      registered with
+ *
+ * \return PROS_ERR if the operation failed, and otherwise the version of the
+ * state, which the other robot increments with every update it sends. The
+ * state is all zeros until the first update, at version 0.
+ */
+uint32_t link_state_get(uint8_t port, uint8_t id, void* dest);
+
 /**
  * Clear the receive buffer of the link, and discarding the data.
  * 
+ * This also discards any partly received message.
+ * 
  * This function uses the following values of errno when an error state is
  * reached:
  * ENXIO - The given value is not within the range of V5 ports (1-21).
@@ -20,6 +20,7 @@
 
 #include <cstdint>
 #include <string>
+#include <type_traits>
 
 #include "pros/link.h"
 
@@ -170,7 +171,8 @@ class Link {
 	 * ENXIO - The sensor is still calibrating, or no link is connected via the radio.
 	 * EINVAL - The destination given is NULL, or the size given is larger than the FIFO buffer
 	 * or destination buffer.
-	 * EBADMSG - Protocol error related to start byte, data size, or checksum.
+	 * EBUSY - No complete message has been received yet
+	 * EBADMSG - The message received was not data_size bytes long.
 
 	 * \param dest
 	 *      Destination buffer to read data to
@@ -182,6 +184,152 @@ class Link {
 	 */
 	std::uint32_t receive(void* dest, std::uint16_t data_size);
 
+	/**
+	 * Send a message of up to LINK_MAX_MESSAGE_SIZE bytes through vexlink,
+	 * tagged with a type, as a single frame with a CRC-16.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as a radio.
+	 * ENXIO - The sensor is still calibrating, or no link is connected via the radio.
+	 * EBUSY - There is not enough room in the transmit buffer for the frame.
+	 * EINVAL - The data given is NULL, data_size is larger than LINK_MAX_MESSAGE_SIZE,
+	 *          or type is larger than LINK_MAX_MESSAGE_TYPE
+	 * ENOMEM - The link's state couldn't be allocated
+	 *
+	 * \param type
+	 *      A tag for the receiver to tell messages apart, from 0 to LINK_MAX_MESSAGE_TYPE
+	 * \param data
+	 *      Buffer with data to send
+	 * \param data_size
+	 *      Bytes of data to send
+	 *
+	 * \return PROS_ERR if the message couldn't be sent, and data_size if it was.
+	 */
+	std::uint32_t transmit_message(std::uint8_t type, const void* data, std::uint16_t data_size);
+
+	/**
+	 * Receive the next message sent with transmit_message(), skipping over any
+	 * corrupted frames. This never waits for a message.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as a radio.
+	 * ENXIO - The sensor is still calibrating, or no link is connected via the radio.
+	 * EINVAL - The destination given is NULL
+	 * EAGAIN - No complete message has been received yet
+	 * EMSGSIZE - The next message is larger than data_size. It is dropped, so
+	 * that the messages behind it can still be received.
+	 * ENOMEM - The link's state couldn't be allocated
+	 *
+	 * \param[out] type
+	 *      Set to the type of the message
+	 * \param dest
+	 *      Destination buffer to copy the message to
+	 * \param data_size
+	 *      Size of the destination buffer
+	 *
+	 * \return PROS_ERR if there is no message to receive, and the size of the
+	 * message if there is.
+	 */
+	std::uint32_t receive_message(std::uint8_t& type, void* dest, std::uint16_t data_size);
+
+	/**
+	 * Get the counters of the framed transport of the link.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as a radio.
+	 *
+	 * \return The counters, which are all 0 if the operation failed, setting
+	 * errno.
+	 */
+	link_stats_s_t get_stats();
+
+	/**
+	 * Enable the reliable mode of the link, in which messages are acknowledged,
+	 * retransmitted and split into fragments by a kernel task. Both robots need
+	 * to enable it.
+	 *
+	 * If either robot restarts its program, the reliable mode starts over with
+	 * the other robot. A message whose delivery hadn't been acknowledged when
+	 * that happens is sent again, so it may arrive twice.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as a radio.
+	 * ENOMEM - The state of the reliable mode couldn't be allocated
+	 *
+	 * \return PROS_ERR if the reliable mode couldn't be enabled, and 1 if it was.
+	 */
+	std::uint32_t reliable_enable();
+
+	/**
+	 * Queue a message of up to LINK_RELIABLE_MAX_MESSAGE_SIZE bytes to be
+	 * delivered reliably. This never waits.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as a radio.
+	 * EINVAL - The data given is NULL, data_size is larger than
+	 * LINK_RELIABLE_MAX_MESSAGE_SIZE, or the reliable mode isn't enabled
+	 * EAGAIN - Too many messages are waiting to be delivered already
+	 * ENOMEM - The message couldn't be copied
+	 *
+	 * \param type
+	 *      A tag for the receiver to tell messages apart
+	 * \param data
+	 *      Buffer with data to send
+	 * \param data_size
+	 *      Bytes of data to send
+	 *
+	 * \return PROS_ERR if the message couldn't be queued, and 1 if it was.
+	 */
+	std::uint32_t reliable_send(std::uint8_t type, const void* data, std::uint32_t data_size);
+
+	/**
+	 * Receive the next message sent with reliable_send(). This never waits.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as a radio.
+	 * EINVAL - The destination given is NULL, or the reliable mode isn't enabled
+	 * EAGAIN - No message has been received yet
+	 * EMSGSIZE - The next message is larger than data_size. It is dropped, so
+	 * that the messages behind it can still be received.
+	 *
+	 * \param[out] type
+	 *      Set to the type of the message
+	 * \param dest
+	 *      Destination buffer to copy the message to
+	 * \param data_size
+	 *      Size of the destination buffer
+	 *
+	 * \return PROS_ERR if there is no message to receive, and the size of the
+	 * message if there is.
+	 */
+	std::uint32_t reliable_receive(std::uint8_t& type, void* dest, std::uint32_t data_size);
+
+	/**
+	 * Get the number of reliable messages that haven't been acknowledged yet.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as a radio.
+	 * EINVAL - The reliable mode isn't enabled
+	 *
+	 * \return PROS_ERR if the operation failed, and the number of messages if
+	 * it succeeded.
+	 */
+	std::uint32_t reliable_pending();
+
 	/**
 	 * Clear the receive buffer of the link, and discarding the data.
 	 *
@@ -195,6 +343,104 @@ class Link {
 	 */
 	std::uint32_t clear_receive_buf();
 };
+
+/**
+ * A state of type T that is shared with the other robot over a link.
+ *
+ * Each robot publishes its own copy and reads the other robot's. Only the
+ * bytes that changed since the last update are sent, in the reliable mode of
+ * the link, which must be enabled first. Both robots need to share the state
+ * with the same id and type.
+ *
+ * T must be trivially copyable, since it is sent as raw bytes.
+ *
+ * \code
+ * struct FieldMap {
+ *   std::uint8_t claimed[36];
+ *   float target_x, target_y;
+ * };
+ * pros::Link link(1, "team", pros::E_LINK_TX);
+ * link.reliable_enable();
+ * pros::SharedState<FieldMap> map(1, 0);
+ * map.publish(my_map);
+ * FieldMap theirs = map.get();
+ * \endcode
+ */
+template <typename T>
+class SharedState {
+	static_assert(std::is_trivially_copyable<T>::value, "Shared states must be trivially copyable");
+	static_assert(sizeof(T) <= LINK_STATE_MAX_SIZE, "Shared states must be at most 2048 bytes");
+
+	public:
+	/**
+	 * Registers a state shared over the link on a port.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as a radio.
+	 * EINVAL - The id is not below LINK_STATE_MAX_IDS, or the reliable mode
+	 * isn't enabled
+	 * EEXIST - The id is registered with a different size
+	 * ENOMEM - The copies of the state couldn't be allocated
+	 *
+	 * \param port
+	 *      The port of the radio for the intended link.
+	 * \param id
+	 *      The id of the state, from 0 to LINK_STATE_MAX_IDS - 1
+	 */
+	SharedState(const std::uint8_t port, const std::uint8_t id) : _port(port), _id(id) {
+		pros::c::link_state_register(port, id, sizeof(T));
+	}
+
+	/**
+	 * Publishes this robot's copy of the state. This never waits.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as a radio.
+	 * EINVAL - The state isn't registered
+	 *
+	 * \param state
+	 *      The state to publish
+	 *
+	 * \return PROS_ERR if the operation failed, and 1 if it succeeded.
+	 */
+	std::uint32_t publish(const T& state) const {
+		return pros::c::link_state_publish(_port, _id, &state);
+	}
+
+	/**
+	 * Gets the other robot's copy of the state.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as a radio.
+	 * EINVAL - The state isn't registered
+	 *
+	 * \param[out] version
+	 *      If not NULL, set to the version of the state, which the other robot
+	 *      increments with every update it sends, or PROS_ERR if the operation
+	 *      failed
+	 *
+	 * \return The other robot's state, which is all zeros until the first
+	 * update arrives.
+	 */
+	T get(std::uint32_t* version = nullptr) const {
+		T state{};
+		std::uint32_t rtv = pros::c::link_state_get(_port, _id, &state);
+		if (version != nullptr) {
+			*version = rtv;
+		}
+		return state;
+	}
+
+	private:
+	const std::uint8_t _port;
+	const std::uint8_t _id;
+};
 }  // namespace pros
 
 #endif
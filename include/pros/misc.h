@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 
+#include "pros/rtos.h"
+
 #define NUM_V5_PORTS (22)
 
 /******************************************************************************/
@@ -127,6 +129,73 @@ typedef enum {
 #endif
 #endif
 
+/**
+ * The kinds of controller events. See controller_wait_event().
+ */
+typedef enum controller_event_type_e {
+	E_CONTROLLER_EVENT_PRESSED = 0,  // A button was pressed
+	E_CONTROLLER_EVENT_RELEASED,     // A button was released
+	E_CONTROLLER_EVENT_AXIS_RISE,    // An analog channel went from below its threshold to at or above it
+	E_CONTROLLER_EVENT_AXIS_FALL     // An analog channel went from at or above its threshold to below it
+} controller_event_type_e_t;
+
+#ifdef PROS_USE_SIMPLE_NAMES
+#ifdef __cplusplus
+#define CONTROLLER_EVENT_PRESSED pros::E_CONTROLLER_EVENT_PRESSED
+#define CONTROLLER_EVENT_RELEASED pros::E_CONTROLLER_EVENT_RELEASED
+#define CONTROLLER_EVENT_AXIS_RISE pros::E_CONTROLLER_EVENT_AXIS_RISE
+#define CONTROLLER_EVENT_AXIS_FALL pros::E_CONTROLLER_EVENT_AXIS_FALL
+#else
+#define CONTROLLER_EVENT_PRESSED E_CONTROLLER_EVENT_PRESSED
+#define CONTROLLER_EVENT_RELEASED E_CONTROLLER_EVENT_RELEASED
+#define CONTROLLER_EVENT_AXIS_RISE E_CONTROLLER_EVENT_AXIS_RISE
+#define CONTROLLER_EVENT_AXIS_FALL E_CONTROLLER_EVENT_AXIS_FALL
+#endif
+#endif
+
+/**
+ * The bit of a button in controller_snapshot_s_t's buttons and
+ * controller_event_filter_s_t's buttons.
+ */
+#define CONTROLLER_BUTTON_BIT(button) (1U << ((button)-E_CONTROLLER_DIGITAL_L1))
+#define CONTROLLER_ALL_BUTTONS 0x0fff
+
+/**
+ * The number of event subscribers that can exist at once.
+ */
+#define CONTROLLER_MAX_SUBSCRIBERS 8
+
+/**
+ * The state of a controller, sampled once per cycle by the system daemon.
+ */
+typedef struct controller_snapshot_s {
+	uint32_t timestamp;  // The time (in ms) at which the controller was sampled
+	uint32_t sequence;   // Incremented every time a snapshot is published
+	int8_t analog[4];    // The analog channels, indexed by controller_analog_e_t, from -127 to 127
+	uint16_t buttons;    // A CONTROLLER_BUTTON_BIT() for each button that is pressed
+	uint8_t connected;   // 1 if the controller is connected
+} controller_snapshot_s_t;
+
+/**
+ * Something that happened on a controller, recorded by the system daemon.
+ */
+typedef struct controller_event_s {
+	uint32_t timestamp;               // The time (in ms) of the sample in which it happened
+	controller_id_e_t controller;     // The controller it happened on
+	controller_event_type_e_t type;   // What happened
+	uint8_t channel;                  // The controller_digital_e_t or controller_analog_e_t
+	int8_t value;                     // The analog channel's new value, or 0 for buttons
+} controller_event_s_t;
+
+/**
+ * The events that a subscriber is sent. See controller_events_subscribe().
+ */
+typedef struct controller_event_filter_s {
+	uint16_t buttons;      // A CONTROLLER_BUTTON_BIT() for each button to report presses and releases of
+	uint8_t axes;          // A bit (1 << channel) for each analog channel to report threshold crossings of
+	int8_t thresholds[4];  // The threshold of each analog channel, indexed by controller_analog_e_t
+} controller_event_filter_s_t;
+
 /*
 Given an id and a port, this macro sets the port 
 variable based on the id and allows the mutex to take that port.
@@ -279,6 +348,9 @@ int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t butt
  * use-case for this function is to call inside opcontrol to detect new button
  * presses, and not in any other tasks.
  *
+ * The system daemon remembers every press after the first call for a button,
+ * so a tap that starts and ends between two calls is still reported.
+ *
  * This function uses the following values of errno when an error state is
  * reached:
  * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
@@ -292,22 +364,25 @@ int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t butt
  * 			  The button to read. Must be one of
  *        DIGITAL_{RIGHT,DOWN,LEFT,UP,A,B,Y,X,R1,R2,L1,L2}
  *
- * \return 1 if the button on the controller is pressed and had not been pressed
- * the last time this function was called, 0 otherwise.
+ * \return 1 if the button was pressed since the last time this function was
+ * called for it (or, on the first call, if it is pressed now), 0 otherwise.
  */
 int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button);
 
 /**
  * Sets text to the controller LCD screen.
  *
- * \note Controller text setting is currently in beta, so continuous, fast
- * updates will not work well.
+ * The text is written to a buffer and this function returns immediately. The
+ * system daemon sends changed lines to the controller as fast as VEXos accepts
+ * them (one line every 50ms, shared between both controllers), so only the
+ * latest text of a line that changes quickly is shown.
  *
  * This function uses the following values of errno when an error state is
  * reached:
  * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
  * given.
  * EACCES - Another resource is currently trying to access the controller port.
+ * EINVAL - The line is not within 0-2.
  *
  * \param id
  *        The ID of the controller (e.g. the master or partner controller).
@@ -315,7 +390,7 @@ int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digita
  * \param line
  *        The line number at which the text will be displayed [0-2]
  * \param col
- *        The column number at which the text will be displayed [0-14]
+ *        The column number at which the text will be displayed [0-18]
  * \param fmt
  *        The format string to print to the controller
  * \param ...
@@ -329,14 +404,17 @@ int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const
 /**
  * Sets text to the controller LCD screen.
  *
- * \note Controller text setting is currently in beta, so continuous, fast
- * updates will not work well.
+ * The text is written to a buffer and this function returns immediately. The
+ * system daemon sends changed lines to the controller as fast as VEXos accepts
+ * them (one line every 50ms, shared between both controllers), so only the
+ * latest text of a line that changes quickly is shown.
  *
  * This function uses the following values of errno when an error state is
  * reached:
  * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
  * given.
  * EACCES - Another resource is currently trying to access the controller port.
+ * EINVAL - The line is not within 0-2.
  *
  * \param id
  *        The ID of the controller (e.g. the master or partner controller).
@@ -344,7 +422,7 @@ int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const
  * \param line
  *        The line number at which the text will be displayed [0-2]
  * \param col
- *        The column number at which the text will be displayed [0-14]
+ *        The column number at which the text will be displayed [0-18]
  * \param str
  *        The pre-formatted string to print to the controller
  *
@@ -356,14 +434,15 @@ int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, con
 /**
  * Clears an individual line of the controller screen.
  *
- * \note Controller text setting is currently in beta, so continuous, fast
- * updates will not work well.
+ * Like controller_set_text(), this only changes the buffered text and returns
+ * immediately.
  *
  * This function uses the following values of errno when an error state is
  * reached:
  * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
  * given.
  * EACCES - Another resource is currently trying to access the controller port.
+ * EINVAL - The line is not within 0-2.
  *
  * \param id
  *        The ID of the controller (e.g. the master or partner controller).
@@ -379,9 +458,8 @@ int32_t controller_clear_line(controller_id_e_t id, uint8_t line);
 /**
  * Clears all of the lines on the controller screen.
  *
- * \note Controller text setting is currently in beta, so continuous, fast
- * updates will not work well. On vexOS version 1.0.0 this function will block
- * for 110ms.
+ * Like controller_set_text(), this only changes the buffered text and returns
+ * immediately.
  *
  * This function uses the following values of errno when an error state is
  * reached:
@@ -401,14 +479,16 @@ int32_t controller_clear(controller_id_e_t id);
 /**
  * Rumble the controller.
  *
- * \note Controller rumble activation is currently in beta, so continuous, fast
- * updates will not work well.
+ * The pattern is queued and this function returns immediately. The system
+ * daemon sends queued patterns to the controller in order, ahead of any
+ * pending text.
  *
  * This function uses the following values of errno when an error state is
  * reached:
  * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
  * given.
  * EACCES - Another resource is currently trying to access the controller port.
+ * EAGAIN - The rumble queue is full.
  *
  * \param id
  *				The ID of the controller (e.g. the master or partner controller).
@@ -423,6 +503,122 @@ int32_t controller_clear(controller_id_e_t id);
  */
 int32_t controller_rumble(controller_id_e_t id, const char* rumble_pattern);
 
+/**
+ * Gets the latest state of a controller, as sampled by the system daemon.
+ *
+ * Every channel is read at the same moment, and this function does not take
+ * the controller's port mutex or talk to VEXos, so it never blocks. Reading
+ * one snapshot per loop is cheaper than reading each channel separately.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
+ * given, or snapshot is NULL.
+ * EAGAIN - The controller hasn't been sampled yet.
+ *
+ * \param id
+ *        The ID of the controller (e.g. the master or partner controller).
+ *        Must be one of CONTROLLER_MASTER or CONTROLLER_PARTNER
+ * \param[out] snapshot
+ *             The snapshot to copy the controller's state into
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t controller_get_snapshot(controller_id_e_t id, controller_snapshot_s_t* const snapshot);
+
+/**
+ * Subscribes to events on a controller.
+ *
+ * Every cycle, the system daemon compares each controller's new sample with
+ * the last one and appends the button presses, button releases and threshold
+ * crossings that match the filter to the subscriber's queue, so presses that
+ * are shorter than a loop of the task reading them are never missed. Events
+ * that don't fit in the queue are dropped.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
+ * given, filter is NULL, or queue_length is 0.
+ * ENOMEM - There are already CONTROLLER_MAX_SUBSCRIBERS subscribers, or the
+ * queue could not be allocated.
+ *
+ * \param id
+ *        The ID of the controller (e.g. the master or partner controller).
+ *        Must be one of CONTROLLER_MASTER or CONTROLLER_PARTNER
+ * \param filter
+ *        The events to report
+ * \param queue_length
+ *        The number of events that can be waiting at once
+ *
+ * \return A handle to pass to controller_wait_event(), or PROS_ERR if the
+ * operation failed, setting errno.
+ */
+int32_t controller_events_subscribe(controller_id_e_t id, const controller_event_filter_s_t* const filter,
+                                    uint32_t queue_length);
+
+/**
+ * Removes a subscriber and frees its queue.
+ *
+ * Tasks waiting in controller_wait_event() for the subscriber's events are
+ * woken, and this function waits for them to return before freeing the
+ * queue.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - handle is not a subscriber.
+ *
+ * \param handle
+ *        The handle returned by controller_events_subscribe()
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t controller_events_unsubscribe(int32_t handle);
+
+/**
+ * Notifies a task whenever events are queued for a subscriber.
+ *
+ * The system daemon calls task_notify() on the task after it queues events, so
+ * a task can wait with task_notify_take() for events from several subscribers
+ * and then read each one with a timeout of 0.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - handle is not a subscriber.
+ *
+ * \param handle
+ *        The handle returned by controller_events_subscribe()
+ * \param task
+ *        The task to notify, or NULL to stop notifying
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t controller_events_notify(int32_t handle, task_t task);
+
+/**
+ * Waits for the next event of a subscriber.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - handle is not a subscriber, event is NULL, or the subscriber was
+ * removed while waiting.
+ * EAGAIN - No event arrived within the timeout.
+ *
+ * \param handle
+ *        The handle returned by controller_events_subscribe()
+ * \param[out] event
+ *             The event to copy the next event into
+ * \param timeout
+ *        The maximum time to wait in milliseconds, 0 to return immediately or
+ *        TIMEOUT_MAX to wait forever
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t controller_wait_event(int32_t handle, controller_event_s_t* const event, uint32_t timeout);
+
 /**
  * Gets the current voltage of the battery, as reported by VEXos.
  *
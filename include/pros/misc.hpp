@@ -24,6 +24,7 @@
 #include "pros/misc.h"
 
 #include <cstdint>
+#include <functional>
 #include <string>
 
 namespace pros {
@@ -121,6 +122,10 @@ class Controller {
 	 * 1 or 2. A typical use-case for this function is to call inside opcontrol
 	 * to detect new button presses, and not in any other tasks.
 	 *
+	 * The system daemon remembers every press after the first call for a
+	 * button, so a tap that starts and ends between two calls is still
+	 * reported.
+	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
 	 * EACCES - Another resource is currently trying to access the controller
@@ -130,11 +135,89 @@ class Controller {
 	 * 			  The button to read. Must be one of
 	 *        DIGITAL_{RIGHT,DOWN,LEFT,UP,A,B,Y,X,R1,R2,L1,L2}
 	 *
-	 * \return 1 if the button on the controller is pressed and had not been
-	 * pressed the last time this function was called, 0 otherwise.
+	 * \return 1 if the button was pressed since the last time this function
+	 * was called for it (or, on the first call, if it is pressed now), 0
+	 * otherwise.
 	 */
 	std::int32_t get_digital_new_press(controller_digital_e_t button);
 
+	/**
+	 * Gets the latest state of the controller, as sampled by the system daemon.
+	 *
+	 * This does not take the controller's port mutex, so it never blocks.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - snapshot is NULL.
+	 * EAGAIN - The controller hasn't been sampled yet.
+	 *
+	 * \param[out] snapshot
+	 *             The snapshot to copy the controller's state into
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t get_snapshot(controller_snapshot_s_t* snapshot);
+
+	/**
+	 * Calls a function for every event on the controller that matches a filter.
+	 *
+	 * The functions registered with on_event() and on_press() are all called in
+	 * order by one task, so a function that blocks delays the others. Events
+	 * that arrive while more than queue_length are waiting are dropped.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENOMEM - There are already CONTROLLER_MAX_SUBSCRIBERS subscribers, or the
+	 * queue or task could not be allocated.
+	 *
+	 * \param filter
+	 *        The events to call the function for
+	 * \param callback
+	 *        The function to call with each event
+	 * \param queue_length
+	 *        The number of events that can be waiting at once
+	 *
+	 * \return A handle to pass to unsubscribe() to stop calling the function, or
+	 * PROS_ERR if the operation failed, setting errno.
+	 */
+	std::int32_t on_event(const controller_event_filter_s_t& filter,
+	                      std::function<void(const controller_event_s_t&)> callback, std::uint32_t queue_length = 16);
+
+	/**
+	 * Calls a function every time a button is pressed.
+	 *
+	 * See on_event() for how the function is called.
+	 *
+	 * \param button
+	 * 			  The button to watch. Must be one of
+	 *        DIGITAL_{RIGHT,DOWN,LEFT,UP,A,B,Y,X,R1,R2,L1,L2}
+	 * \param callback
+	 *        The function to call
+	 *
+	 * \return A handle to pass to unsubscribe() to stop calling the function, or
+	 * PROS_ERR if the operation failed, setting errno.
+	 */
+	std::int32_t on_press(controller_digital_e_t button, std::function<void()> callback);
+
+	/**
+	 * Stops calling a function registered with on_event() or on_press().
+	 *
+	 * The function may be called from itself. Otherwise, it isn't called again
+	 * once this returns, except that a call already in progress finishes.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - handle is not a registered function.
+	 *
+	 * \param handle
+	 *        The handle returned by on_event() or on_press()
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t unsubscribe(std::int32_t handle);
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-function"
 	template <typename T>
@@ -149,18 +232,21 @@ class Controller {
 	/**
 	 * Sets text to the controller LCD screen.
 	 *
-	 * \note Controller text setting is currently in beta, so continuous, fast
-	 * updates will not work well.
+	 * The text is written to a buffer and this function returns immediately. The
+	 * system daemon sends changed lines to the controller as fast as VEXos accepts
+	 * them (one line every 50ms, shared between both controllers), so only the
+	 * latest text of a line that changes quickly is shown.
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
 	 * EACCES - Another resource is currently trying to access the controller
 	 * port.
+	 * EINVAL - The line is not within 0-2.
 	 *
 	 * \param line
 	 *        The line number at which the text will be displayed [0-2]
 	 * \param col
-	 *        The column number at which the text will be displayed [0-14]
+	 *        The column number at which the text will be displayed [0-18]
 	 * \param fmt
 	 *        The format string to print to the controller
 	 * \param ...
@@ -177,18 +263,21 @@ class Controller {
 	/**
 	 * Sets text to the controller LCD screen.
 	 *
-	 * \note Controller text setting is currently in beta, so continuous, fast
-	 * updates will not work well.
+	 * The text is written to a buffer and this function returns immediately. The
+	 * system daemon sends changed lines to the controller as fast as VEXos accepts
+	 * them (one line every 50ms, shared between both controllers), so only the
+	 * latest text of a line that changes quickly is shown.
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
 	 * EACCES - Another resource is currently trying to access the controller
 	 * port.
+	 * EINVAL - The line is not within 0-2.
 	 *
 	 * \param line
 	 *        The line number at which the text will be displayed [0-2]
 	 * \param col
-	 *        The column number at which the text will be displayed [0-14]
+	 *        The column number at which the text will be displayed [0-18]
 	 * \param str
 	 *        The pre-formatted string to print to the controller
 	 *
@@ -201,13 +290,14 @@ class Controller {
 	/**
 	 * Clears an individual line of the controller screen.
 	 *
-	 * \note Controller text setting is currently in beta, so continuous, fast
-	 * updates will not work well.
+	 * Like set_text(), this only changes the buffered text and returns
+	 * immediately.
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
 	 * EACCES - Another resource is currently trying to access the controller
 	 * port.
+	 * EINVAL - The line is not within 0-2.
 	 *
 	 * \param line
 	 *        The line number to clear [0-2]
@@ -220,13 +310,15 @@ class Controller {
 	/**
 	 * Rumble the controller.
 	 *
-	 * \note Controller rumble activation is currently in beta, so continuous, fast
-	 * updates will not work well.
+	 * The pattern is queued and this function returns immediately. The system
+	 * daemon sends queued patterns to the controller in order, ahead of any
+	 * pending text.
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
 	 * EACCES - Another resource is currently trying to access the controller
 	 * port.
+	 * EAGAIN - The rumble queue is full.
 	 *
 	 * \param rumble_pattern
 	 *				A string consisting of the characters '.', '-', and ' ', where dots
@@ -241,9 +333,8 @@ class Controller {
 	/**
 	 * Clears all of the lines on the controller screen.
 	 *
-	 * \note Controller text setting is currently in beta, so continuous, fast
-	 * updates will not work well. On vexOS version 1.0.0 this function will
-	 * block for 110ms.
+	 * Like set_text(), this only changes the buffered text and returns
+	 * immediately.
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
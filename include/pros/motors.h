@@ -20,6 +20,7 @@
 #define _PROS_MOTORS_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -684,6 +685,220 @@ typedef struct motor_pid_s {
 	uint8_t kd;  // The derivative constant
 } motor_pid_s_t;
 
+/**
+ * A consistent copy of a motor's telemetry.
+ *
+ * Snapshots are published by the system daemon immediately after VEXos
+ * refreshes the device data, so every field comes from the same device frame.
+ */
+typedef struct motor_snapshot_s {
+	uint32_t timestamp;      // The time (in ms) at which the snapshot was published
+	uint32_t sequence;       // Incremented every time a snapshot is published for the port
+	double position;         // The absolute position in the motor's encoder units
+	int32_t raw_position;    // The raw encoder count
+	uint32_t raw_timestamp;  // The time (in ms) at which raw_position was read by the motor
+	double actual_velocity;  // The velocity in RPM
+	int32_t current_draw;    // The current drawn in mA
+	int32_t voltage;         // The voltage delivered in mV
+	double power;            // The power drawn in Watts
+	double torque;           // The torque generated in Nm
+	double efficiency;       // The efficiency in percent
+	double temperature;      // The temperature in degrees Celsius
+	int32_t direction;       // 1 for positive motion, -1 for negative motion
+	uint32_t faults;         // A bitfield of motor_fault_e_t
+	uint32_t flags;          // A bitfield of motor_flag_e_t
+} motor_snapshot_s_t;
+
+#ifdef __cplusplus
+namespace c {
+#endif
+
+/**
+ * Gets the most recent telemetry snapshot for the motor.
+ *
+ * Unlike the individual telemetry getters, this function does not take the
+ * port mutex or query the device. It copies the snapshot that the system
+ * daemon published after the last device update, so it never blocks and all
+ * of the fields are consistent with one another.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a motor
+ * EAGAIN - No snapshot has been published for the motor yet
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param[out] snapshot
+ *             The snapshot to copy the motor's telemetry into
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t motor_get_snapshot(uint8_t port, motor_snapshot_s_t* const snapshot);
+
+#ifdef __cplusplus
+}  // namespace c
+#endif
+
+/**
+ * Selects which fields of a motor_snapshot_s_t are read by motor_batch_read().
+ */
+typedef enum motor_field_e {
+	E_MOTOR_FIELD_POSITION = 0x0001,
+	E_MOTOR_FIELD_RAW_POSITION = 0x0002,  // Also fills raw_timestamp
+	E_MOTOR_FIELD_ACTUAL_VELOCITY = 0x0004,
+	E_MOTOR_FIELD_CURRENT_DRAW = 0x0008,
+	E_MOTOR_FIELD_VOLTAGE = 0x0010,
+	E_MOTOR_FIELD_POWER = 0x0020,
+	E_MOTOR_FIELD_TORQUE = 0x0040,
+	E_MOTOR_FIELD_EFFICIENCY = 0x0080,
+	E_MOTOR_FIELD_TEMPERATURE = 0x0100,
+	E_MOTOR_FIELD_DIRECTION = 0x0200,
+	E_MOTOR_FIELD_FAULTS = 0x0400,
+	E_MOTOR_FIELD_FLAGS = 0x0800,
+	E_MOTOR_FIELD_ALL = 0x0FFF
+} motor_field_e_t;
+
+#ifdef PROS_USE_SIMPLE_NAMES
+#ifdef __cplusplus
+#define MOTOR_FIELD_POSITION pros::E_MOTOR_FIELD_POSITION
+#define MOTOR_FIELD_RAW_POSITION pros::E_MOTOR_FIELD_RAW_POSITION
+#define MOTOR_FIELD_ACTUAL_VELOCITY pros::E_MOTOR_FIELD_ACTUAL_VELOCITY
+#define MOTOR_FIELD_CURRENT_DRAW pros::E_MOTOR_FIELD_CURRENT_DRAW
+#define MOTOR_FIELD_VOLTAGE pros::E_MOTOR_FIELD_VOLTAGE
+#define MOTOR_FIELD_POWER pros::E_MOTOR_FIELD_POWER
+#define MOTOR_FIELD_TORQUE pros::E_MOTOR_FIELD_TORQUE
+#define MOTOR_FIELD_EFFICIENCY pros::E_MOTOR_FIELD_EFFICIENCY
+#define MOTOR_FIELD_TEMPERATURE pros::E_MOTOR_FIELD_TEMPERATURE
+#define MOTOR_FIELD_DIRECTION pros::E_MOTOR_FIELD_DIRECTION
+#define MOTOR_FIELD_FAULTS pros::E_MOTOR_FIELD_FAULTS
+#define MOTOR_FIELD_FLAGS pros::E_MOTOR_FIELD_FLAGS
+#define MOTOR_FIELD_ALL pros::E_MOTOR_FIELD_ALL
+#else
+#define MOTOR_FIELD_POSITION E_MOTOR_FIELD_POSITION
+#define MOTOR_FIELD_RAW_POSITION E_MOTOR_FIELD_RAW_POSITION
+#define MOTOR_FIELD_ACTUAL_VELOCITY E_MOTOR_FIELD_ACTUAL_VELOCITY
+#define MOTOR_FIELD_CURRENT_DRAW E_MOTOR_FIELD_CURRENT_DRAW
+#define MOTOR_FIELD_VOLTAGE E_MOTOR_FIELD_VOLTAGE
+#define MOTOR_FIELD_POWER E_MOTOR_FIELD_POWER
+#define MOTOR_FIELD_TORQUE E_MOTOR_FIELD_TORQUE
+#define MOTOR_FIELD_EFFICIENCY E_MOTOR_FIELD_EFFICIENCY
+#define MOTOR_FIELD_TEMPERATURE E_MOTOR_FIELD_TEMPERATURE
+#define MOTOR_FIELD_DIRECTION E_MOTOR_FIELD_DIRECTION
+#define MOTOR_FIELD_FAULTS E_MOTOR_FIELD_FAULTS
+#define MOTOR_FIELD_FLAGS E_MOTOR_FIELD_FLAGS
+#define MOTOR_FIELD_ALL E_MOTOR_FIELD_ALL
+#endif
+#endif
+
+#ifdef __cplusplus
+namespace c {
+#endif
+
+/**
+ * Sets the voltage for several motors at once, each from -127 to 127 as in
+ * motor_move().
+ *
+ * Every port in the batch is claimed together before any command is issued,
+ * so all of the motors receive their new voltage in the same device frame.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - One of the given values is not within the range of V5 ports (1-21).
+ * ENODEV - One of the ports cannot be configured as a motor
+ *
+ * \param ports
+ *        The V5 port numbers from 1-21
+ * \param count
+ *        The number of motors in the batch
+ * \param voltages
+ *        The new voltage for each motor from -127 to 127
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t motor_batch_move(const uint8_t* const ports, const size_t count, const int32_t* const voltages);
+
+/**
+ * Sets the output voltage for several motors at once.
+ *
+ * Every port in the batch is claimed together before any command is issued,
+ * so all of the motors receive their new voltage in the same device frame.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - One of the given values is not within the range of V5 ports (1-21).
+ * ENODEV - One of the ports cannot be configured as a motor
+ *
+ * \param ports
+ *        The V5 port numbers from 1-21
+ * \param count
+ *        The number of motors in the batch
+ * \param voltages
+ *        The new voltage for each motor from -12000 to 12000
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t motor_batch_move_voltage(const uint8_t* const ports, const size_t count, const int32_t* const voltages);
+
+/**
+ * Sets the velocity for several motors at once.
+ *
+ * Every port in the batch is claimed together before any command is issued,
+ * so all of the motors receive their new velocity in the same device frame.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - One of the given values is not within the range of V5 ports (1-21).
+ * ENODEV - One of the ports cannot be configured as a motor
+ *
+ * \param ports
+ *        The V5 port numbers from 1-21
+ * \param count
+ *        The number of motors in the batch
+ * \param velocities
+ *        The new velocity for each motor from +-100, +-200, or +-600 depending
+ *        on the motor's gearset
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t motor_batch_move_velocity(const uint8_t* const ports, const size_t count, const int32_t* const velocities);
+
+/**
+ * Reads telemetry from several motors at once.
+ *
+ * Every port in the batch is claimed together and the requested fields of
+ * each motor are read in a single pass. Fields that are not requested are
+ * left untouched. The sequence field of each result is set to the sequence
+ * number of the motor's latest published snapshot.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - One of the given values is not within the range of V5 ports (1-21).
+ * ENODEV - One of the ports cannot be configured as a motor
+ *
+ * \param ports
+ *        The V5 port numbers from 1-21
+ * \param count
+ *        The number of motors in the batch
+ * \param fields
+ *        A bitfield of motor_field_e_t selecting the fields to read
+ * \param[out] out
+ *             An array of count snapshots to read the telemetry into
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t motor_batch_read(const uint8_t* const ports, const size_t count, const uint32_t fields,
+                         motor_snapshot_s_t* const out);
+
+#ifdef __cplusplus
+}  // namespace c
+#endif
+
 #ifdef __cplusplus
 namespace c {
 #endif
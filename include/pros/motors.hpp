@@ -464,6 +464,23 @@ class Motor {
 	 */
 	virtual std::int32_t get_voltage(void) const;
 
+	/**
+	 * Gets the most recent telemetry snapshot for the motor.
+	 *
+	 * The snapshot is published by the system daemon after every device update,
+	 * so this function never blocks on the port and every field comes from the
+	 * same device frame.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - The port cannot be configured as a motor
+	 * EAGAIN - No snapshot has been published for the motor yet
+	 *
+	 * \return The motor's latest snapshot, or a snapshot with a sequence number
+	 * of 0 if the operation failed, setting errno.
+	 */
+	motor_snapshot_s_t snapshot(void) const;
+
 	/****************************************************************************/
 	/**                      Motor configuration functions                     **/
 	/**                                                                        **/
@@ -997,6 +1014,49 @@ class Motor_Group {
 	 */
 	std::int32_t move_voltage(const std::int32_t voltage);
 
+	/**
+	 * Sets a separate velocity for each motor in the motor group.
+	 *
+	 * Every motor's port is claimed once before any command is issued, so all
+	 * of the motors in the group pick up their new velocity in the same device
+	 * frame.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - One of the ports cannot be configured as a motor
+	 * EACCESS - The Motor group mutex can't be taken or given
+	 *
+	 * \param velocities
+	 *        An array with the new velocity of each motor, in the same order
+	 *        as the motors in the group
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t move_velocities(const std::int32_t* const velocities);
+
+	/**
+	 * Sets a separate output voltage in millivolts for each motor in the motor
+	 * group.
+	 *
+	 * Every motor's port is claimed once before any command is issued, so all
+	 * of the motors in the group pick up their new voltage in the same device
+	 * frame.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - One of the ports cannot be configured as a motor
+	 * EACCESS - The Motor group mutex can't be taken or given
+	 *
+	 * \param voltages
+	 *        An array with the new voltage of each motor from -12000 to 12000,
+	 *        in the same order as the motors in the group
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t move_voltages(const std::int32_t* const voltages);
+
 	/**
 	 * Stops the motor using the currently configured brake mode.
 	 *
@@ -1342,8 +1402,38 @@ class Motor_Group {
 	 */
 	std::vector<pros::motor_encoder_units_e_t> get_encoder_units(void);
 
+	/**
+	 * Reads telemetry from every motor in the motor group in a single pass.
+	 *
+	 * Unlike the other getters, this function does not allocate. Each motor's
+	 * port is claimed once and only the requested fields are read.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - One of the ports cannot be configured as a motor
+	 * EACCESS - The Motor group mutex can't be taken or given
+	 *
+	 * \param fields
+	 *        A bitfield of motor_field_e_t selecting the fields to read
+	 * \param[out] out
+	 *             An array of pros::Motor_Group::size() snapshots, in the same
+	 *             order as the motors in the group
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t read(const std::uint32_t fields, motor_snapshot_s_t* const out);
+
 	private:
+	typedef std::int32_t (*batch_fn_t)(const std::uint8_t* const, const size_t, const std::int32_t* const);
+
+	/**
+	 * Sends the same value to every motor through one of the batch functions.
+	 */
+	std::int32_t _batch_uniform(batch_fn_t batch_fn, const std::int32_t value);
+
 	std::vector<Motor> _motors;
+	std::vector<std::uint8_t> _ports;
 	pros::Mutex _motor_group_mutex;
 	std::uint8_t _motor_count;
 };
@@ -0,0 +1,202 @@
+/**
+ * \file pros/odometry.h
+ *
+ * Contains prototypes for the pose estimation service.
+ *
+ * Once started, the system daemon tracks the robot's position on the field
+ * from its tracking wheels, and optionally an Inertial Sensor and a GPS
+ * Sensor. The pose is updated right after every device update, so it is never
+ * more than one daemon period old, and it can be read from any task without
+ * blocking.
+ *
+ * Distances are in inches. Headings are in degrees, increasing clockwise when
+ * seen from above like the Inertial Sensor's rotation, and are not wrapped to
+ * a single turn. A heading of 0 faces along the y axis.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_ODOMETRY_H_
+#define _PROS_ODOMETRY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+namespace pros {
+#endif
+
+/**
+ * The number of tracking wheels parallel to the direction of travel that the
+ * service can use.
+ */
+#define ODOMETRY_MAX_PARALLEL_WHEELS 2
+
+/**
+ * The sensor that a tracking wheel is measured with.
+ */
+typedef enum odometry_sensor_e {
+	E_ODOMETRY_SENSOR_NONE = 0,  // The wheel isn't used
+	E_ODOMETRY_SENSOR_ROTATION,  // A Rotation Sensor
+	E_ODOMETRY_SENSOR_MOTOR      // The encoder of a motor, in any units or gearset
+} odometry_sensor_e_t;
+
+/**
+ * Bits of odometry_pose_s_t's status.
+ */
+typedef enum odometry_status_e {
+	E_ODOMETRY_STATUS_SENSOR_ERROR = 0x01,  // A sensor couldn't be read, so the pose wasn't moved
+	E_ODOMETRY_STATUS_GPS_CORRECTED = 0x02  // A new GPS reading was blended into the pose
+} odometry_status_e_t;
+
+#ifdef PROS_USE_SIMPLE_NAMES
+#ifdef __cplusplus
+#define ODOMETRY_SENSOR_NONE pros::E_ODOMETRY_SENSOR_NONE
+#define ODOMETRY_SENSOR_ROTATION pros::E_ODOMETRY_SENSOR_ROTATION
+#define ODOMETRY_SENSOR_MOTOR pros::E_ODOMETRY_SENSOR_MOTOR
+#define ODOMETRY_STATUS_SENSOR_ERROR pros::E_ODOMETRY_STATUS_SENSOR_ERROR
+#define ODOMETRY_STATUS_GPS_CORRECTED pros::E_ODOMETRY_STATUS_GPS_CORRECTED
+#else
+#define ODOMETRY_SENSOR_NONE E_ODOMETRY_SENSOR_NONE
+#define ODOMETRY_SENSOR_ROTATION E_ODOMETRY_SENSOR_ROTATION
+#define ODOMETRY_SENSOR_MOTOR E_ODOMETRY_SENSOR_MOTOR
+#define ODOMETRY_STATUS_SENSOR_ERROR E_ODOMETRY_STATUS_SENSOR_ERROR
+#define ODOMETRY_STATUS_GPS_CORRECTED E_ODOMETRY_STATUS_GPS_CORRECTED
+#endif
+#endif
+
+/**
+ * A tracking wheel.
+ *
+ * The offset places the wheel relative to the robot's tracking center. For a
+ * wheel that is parallel to the direction of travel it is the distance to the
+ * right of the center, and for the perpendicular wheel it is the distance in
+ * front of the center. Offsets to the left or behind are negative.
+ */
+typedef struct odometry_wheel_s {
+	odometry_sensor_e_t sensor;  // What the wheel is measured with
+	uint8_t port;                // The V5 port of the sensor, from 1-21
+	bool reversed;               // Whether the sensor counts backwards when the robot moves forwards or right
+	double diameter;             // The diameter of the wheel in inches
+	double gear_ratio;           // Wheel turns per sensor turn, or 0 for 1
+	double offset;               // See above, in inches
+} odometry_wheel_s_t;
+
+/**
+ * The sensors that the pose is estimated from.
+ *
+ * At least one parallel wheel is needed. The heading comes from the Inertial
+ * Sensor if there is one, and otherwise from the difference between two
+ * parallel wheels. Without a perpendicular wheel, the robot is assumed not to
+ * slide sideways.
+ */
+typedef struct odometry_config_s {
+	odometry_wheel_s_t parallel[ODOMETRY_MAX_PARALLEL_WHEELS];  // Wheels that track forward motion
+	odometry_wheel_s_t perpendicular;                           // A wheel that tracks sideways motion
+	uint8_t imu_port;      // The port of the Inertial Sensor, or 0 for none
+	uint8_t gps_port;      // The port of the GPS Sensor, or 0 for none
+	double gps_gain;       // The fraction of the difference from each GPS reading that is corrected, from 0-1
+	double gps_max_error;  // GPS readings with a larger error estimate (in meters) are ignored, or 0 for no limit
+} odometry_config_s_t;
+
+/**
+ * An estimate of the robot's pose, published by the system daemon.
+ */
+typedef struct odometry_pose_s {
+	uint32_t timestamp;  // The time (in ms) of the device update that the pose was worked out from
+	uint32_t sequence;   // Incremented every time a pose is published
+	double x;            // The position along the x axis in inches
+	double y;            // The position along the y axis in inches
+	double heading;      // The heading in degrees
+	uint32_t status;     // A bitfield of odometry_status_e_t
+} odometry_pose_s_t;
+
+#ifdef __cplusplus
+namespace c {
+#endif
+
+/**
+ * Starts estimating the robot's pose.
+ *
+ * The pose starts at (0, 0) with a heading of 0, or wherever it was when the
+ * service was last stopped. Calling this function while the service is
+ * running replaces the configuration without moving the pose.
+ *
+ * The GPS Sensor reports its position in meters from the center of the field,
+ * so x and y follow the GPS's axes when one is used.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - One of the ports is not within the range of V5 ports (1-21).
+ * EINVAL - The configuration has no parallel wheel, no way to work out the
+ *          heading, a wheel without a positive diameter, or a GPS gain
+ *          outside 0-1
+ *
+ * \param config
+ *        The sensors to estimate the pose from
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t odometry_start(const odometry_config_s_t* const config);
+
+/**
+ * Stops estimating the robot's pose.
+ *
+ * The last pose that was published can still be read.
+ *
+ * \return 1
+ */
+int32_t odometry_stop(void);
+
+/**
+ * Moves the pose estimate to the given pose.
+ *
+ * The next pose that the daemon publishes continues from this one.
+ *
+ * \param x
+ *        The position along the x axis in inches
+ * \param y
+ *        The position along the y axis in inches
+ * \param heading
+ *        The heading in degrees
+ *
+ * \return 1
+ */
+int32_t odometry_set_pose(double x, double y, double heading);
+
+/**
+ * Gets the latest pose published by the system daemon.
+ *
+ * This function does not take any port mutexes or talk to any sensors, so it
+ * never blocks and any number of tasks can call it at once.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - pose is NULL
+ * EAGAIN - No pose has been published yet
+ *
+ * \param[out] pose
+ *             The pose to copy the estimate into
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t odometry_get_pose(odometry_pose_s_t* const pose);
+
+#ifdef __cplusplus
+}  // namespace c
+}  // namespace pros
+}
+#endif
+
+#endif  // _PROS_ODOMETRY_H_
@@ -0,0 +1,85 @@
+/**
+ * \file pros/odometry.hpp
+ *
+ * Contains the C++ interface to the pose estimation service.
+ *
+ * See pros/odometry.h for the units and conventions the pose uses.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_ODOMETRY_HPP_
+#define _PROS_ODOMETRY_HPP_
+
+#include <cstdint>
+
+#include "pros/odometry.h"
+
+namespace pros {
+namespace odometry {
+/**
+ * Starts estimating the robot's pose.
+ *
+ * The pose starts at (0, 0) with a heading of 0, or wherever it was when the
+ * service was last stopped. Calling this function while the service is
+ * running replaces the configuration without moving the pose.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - One of the ports is not within the range of V5 ports (1-21).
+ * EINVAL - The configuration has no parallel wheel, no way to work out the
+ *          heading, a wheel without a positive diameter, or a GPS gain
+ *          outside 0-1
+ *
+ * \param config
+ *        The sensors to estimate the pose from
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+std::int32_t start(const odometry_config_s_t& config);
+
+/**
+ * Stops estimating the robot's pose.
+ *
+ * \return 1
+ */
+std::int32_t stop(void);
+
+/**
+ * Moves the pose estimate to the given pose.
+ *
+ * \param x
+ *        The position along the x axis in inches
+ * \param y
+ *        The position along the y axis in inches
+ * \param heading
+ *        The heading in degrees
+ *
+ * \return 1
+ */
+std::int32_t set_pose(double x, double y, double heading);
+
+/**
+ * Gets the latest pose published by the system daemon without blocking.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EAGAIN - No pose has been published yet
+ *
+ * \return The latest pose, or a pose whose fields are all PROS_ERR_F (with a
+ * sequence of 0) if the operation failed, setting errno.
+ */
+odometry_pose_s_t get_pose(void);
+}  // namespace odometry
+}  // namespace pros
+
+#endif  // _PROS_ODOMETRY_HPP_
@@ -22,8 +22,11 @@
 #define _PROS_RTOS_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#include "pros/task_periodic.h"
+
 #ifdef __cplusplus
 extern "C" {
 namespace pros {
@@ -105,6 +108,55 @@ typedef enum {
 
 typedef void* mutex_t;
 
+/**
+ * The number of bytes that the kernel needs to keep track of a task. This is
+ * checked against the kernel's task structure when PROS is built.
+ */
+#define TASK_BUFFER_SIZE 1536
+
+/**
+ * Storage for the kernel's record of a task created with
+ * task_create_from_buffers(). Its contents are private to the kernel.
+ */
+typedef struct task_buffer_s {
+	uint64_t data[TASK_BUFFER_SIZE / sizeof(uint64_t)];
+} task_buffer_s_t;
+
+/**
+ * The length of the window that task_get_stats() reports recent CPU usage
+ * over, in milliseconds. The window moves forward every quarter of its length.
+ */
+#define TASK_STATS_WINDOW 1000
+
+/**
+ * The CPU usage of a task. Times are in microseconds. Time spent handling
+ * interrupts counts towards the task that was interrupted.
+ */
+typedef struct task_stats_s {
+	task_t task;                   // The task
+	char name[TASK_NAME_MAX_LEN];  // The name of the task
+	uint32_t priority;             // The priority of the task, including any it has inherited
+	task_state_e_t state;          // The state of the task
+	uint64_t run_time;             // The time the task has spent running since it was created
+	uint32_t window_run_time;      // The time the task spent running in the last TASK_STATS_WINDOW
+	float usage;                   // window_run_time as a percentage of the window
+	uint32_t switches;             // The number of times the task has been switched in
+	uint32_t preemptions;          // The number of times the task was switched out while still ready to run
+	uint32_t stack_high_water;     // The least free stack the task has ever had, in words
+} task_stats_s_t;
+
+/**
+ * The CPU usage of the whole system. Times are in microseconds.
+ */
+typedef struct task_system_stats_s {
+	uint64_t run_time;     // The time since the program started
+	uint32_t window;       // The length of the window, which is shorter during the program's first second
+	uint32_t idle_time;    // The time the idle task spent running in the window
+	float idle_usage;      // idle_time as a percentage of the window; what is left for new work
+	uint32_t task_count;   // The number of tasks
+	uint32_t switches;     // The number of context switches since the program started
+} task_system_stats_s_t;
+
 /**
  * Refers to the current task handle
  */
@@ -162,6 +214,44 @@ uint64_t micros(void);
 task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
                    const char* const name);
 
+/**
+ * Creates a new task in memory provided by the caller and adds it to the list
+ * of tasks that are ready to run. Unlike task_create(), this never allocates
+ * from the heap, so tasks can be created at any time without fragmenting it.
+ *
+ * The stack and buffer must stay valid until the task has been deleted, so
+ * they are usually global or static variables. If function returns, the task
+ * is not deleted; it must call task_delete(NULL) itself.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stack or buffer is NULL
+ *
+ * \param function
+ *        Pointer to the task entry function
+ * \param parameters
+ *        Pointer to memory that will be used as a parameter for the task being
+ *        created
+ * \param prio
+ *        The priority at which the task should run.
+ *        TASK_PRIO_DEFAULT plus/minus 1 or 2 is typically used.
+ * \param stack_depth
+ *        The number of words in stack
+ * \param name
+ *        A descriptive name for the task.  This is mainly used to facilitate
+ *        debugging. The name may be up to 32 characters long.
+ * \param stack
+ *        The memory to use as the task's stack, at least stack_depth words long
+ * \param buffer
+ *        The memory in which the kernel keeps track of the task
+ *
+ * \return A handle by which the newly created task can be referenced. If an
+ * error occurred, NULL will be returned and errno can be checked for hints as
+ * to why task_create_from_buffers failed.
+ */
+task_t task_create_from_buffers(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
+                                const char* const name, uint32_t* const stack, task_buffer_s_t* const buffer);
+
 /**
  * Removes a task from the RTOS real time kernel's management. The task being
  * deleted will be removed from all ready, blocked, suspended and event lists.
@@ -204,6 +294,129 @@ void delay(const uint32_t milliseconds);
  */
 void task_delay_until(uint32_t* const prev_time, const uint32_t delta);
 
+/**
+ * Creates a task that runs function once every period milliseconds.
+ *
+ * The kernel releases a job every period milliseconds and calls function once
+ * for each, so function should do one iteration of the work and return rather
+ * than loop. A job that runs past its next release makes the kernel skip that
+ * release, which keeps the task in phase instead of letting it run back to
+ * back to catch up. The timing of every job is recorded, see
+ * task_get_periodic_stats().
+ *
+ * If align is true, releases fall on the ticks at which the system daemon runs,
+ * so the task runs as soon as the daemon has fetched new data from the smart
+ * ports (provided its priority is below the daemon's, which is
+ * TASK_PRIORITY_MAX - 2). This needs a period that is a multiple of the
+ * daemon's 2 ms period.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The period is 0, the deadline is longer than the period, or align
+ *          is true and the period is not a multiple of 2 ms.
+ * ENOMEM - The stack cannot be used as the TCB was not created.
+ *
+ * \param function
+ *        Pointer to the function to call for each job
+ * \param parameters
+ *        Pointer to memory that will be passed to every call of function
+ * \param period
+ *        The number of milliseconds between releases
+ * \param deadline
+ *        The number of milliseconds after its release by which each job must
+ *        finish, or 0 to use the period
+ * \param align
+ *        Whether to release the task on the system daemon's ticks
+ * \param prio
+ *        The priority at which the task should run.
+ *        TASK_PRIO_DEFAULT plus/minus 1 or 2 is typically used.
+ * \param stack_depth
+ *        The number of words (i.e. 4 * stack_depth) available on the task's
+ *        stack. TASK_STACK_DEPTH_DEFAULT is typically sufficienct.
+ * \param name
+ *        A descriptive name for the task.  This is mainly used to facilitate
+ *        debugging. The name may be up to 32 characters long.
+ *
+ * \return A handle by which the newly created task can be referenced. If an
+ * error occurred, NULL will be returned and errno can be checked for hints as
+ * to why task_create_periodic failed.
+ */
+task_t task_create_periodic(task_fn_t function, void* const parameters, uint32_t period, uint32_t deadline,
+                            bool align, uint32_t prio, const uint16_t stack_depth, const char* const name);
+
+/**
+ * Gets the timing of a task created with task_create_periodic().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stats is NULL, or the task was not created with
+ *          task_create_periodic()
+ *
+ * \param task
+ *        The task to check, or NULL for the calling task
+ * \param[out] stats
+ *        The timing of the task
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t task_get_periodic_stats(task_t task, task_periodic_stats_s_t* const stats);
+
+/**
+ * Gets the CPU usage of a task.
+ *
+ * The kernel keeps these statistics as it switches tasks, so this is cheap
+ * enough to call every second, even during a match. It measures the task's
+ * unused stack, which takes longer the more unused stack it has.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stats is NULL
+ *
+ * \param task
+ *        The task to check, or NULL for the calling task
+ * \param[out] stats
+ *        The CPU usage of the task
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t task_get_stats(task_t task, task_stats_s_t* const stats);
+
+/**
+ * Gets the CPU usage of every task, like top.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stats is NULL
+ *
+ * \param[out] stats
+ *        An array to hold the usage of each task. task_get_count() gives the
+ *        number of tasks.
+ * \param count
+ *        The length of stats
+ *
+ * \return The number of entries written or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t task_get_all_stats(task_stats_s_t* const stats, const size_t count);
+
+/**
+ * Gets the CPU usage of the whole system, including how much of the CPU was
+ * left idle in the last TASK_STATS_WINDOW.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stats is NULL
+ *
+ * \param[out] stats
+ *        The CPU usage of the system
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t task_get_system_stats(task_system_stats_s_t* const stats);
+
 /**
  * Gets the priority of the specified task.
  *
@@ -24,12 +24,15 @@
 #include "pros/rtos.h"
 #undef delay
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <memory>
+#include <new>
 #include <optional>
 #include <type_traits>
+#include <vector>
 
 namespace pros {
 class Task {
@@ -380,10 +383,213 @@ class Task {
 	 */
 	static std::uint32_t get_count();
 
+	/**
+	 * Gets the CPU usage of this task, including its time running in the last
+	 * TASK_STATS_WINDOW, how often it was switched in or preempted and its
+	 * stack high-water mark. See pros::c::task_get_stats() for details.
+	 *
+	 * \return The CPU usage of the task
+	 */
+	task_stats_s_t stats();
+
+	/**
+	 * Gets the CPU usage of every task, like top.
+	 *
+	 * \return The CPU usage of each task
+	 */
+	static std::vector<task_stats_s_t> all_stats();
+
+	/**
+	 * Gets the CPU usage of the whole system, including how much of the CPU was
+	 * left idle in the last TASK_STATS_WINDOW.
+	 *
+	 * \return The CPU usage of the system
+	 */
+	static task_system_stats_s_t system_stats();
+
 	private:
 	task_t task{};
 };
 
+class PeriodicTask : public Task {
+	public:
+	/**
+	 * Creates a task that runs function once every period milliseconds.
+	 *
+	 * The kernel calls function once per release, so it should do one
+	 * iteration of the work and return rather than loop. See
+	 * pros::c::task_create_periodic() for details.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The period is 0, the deadline is longer than the period, or
+	 *          align is true and the period is not a multiple of 2 ms.
+	 * ENOMEM - The stack cannot be used as the TCB was not created.
+	 *
+	 * \param function
+	 *        Pointer to the function to call for each job
+	 * \param parameters
+	 *        Pointer to memory that will be passed to every call of function
+	 * \param period
+	 *        The number of milliseconds between releases
+	 * \param deadline
+	 *        The number of milliseconds after its release by which each job
+	 *        must finish, or 0 to use the period
+	 * \param align
+	 *        Whether to release the task on the system daemon's ticks, so that
+	 *        it runs right after the smart ports have been read
+	 * \param prio
+	 *        The priority at which the task should run.
+	 *        TASK_PRIO_DEFAULT plus/minus 1 or 2 is typically used.
+	 * \param stack_depth
+	 *        The number of words (i.e. 4 * stack_depth) available on the task's
+	 *        stack. TASK_STACK_DEPTH_DEFAULT is typically sufficient.
+	 * \param name
+	 *        A descriptive name for the task.  This is mainly used to facilitate
+	 *        debugging. The name may be up to 32 characters long.
+	 */
+	PeriodicTask(task_fn_t function, void* parameters, std::uint32_t period, std::uint32_t deadline = 0,
+	             bool align = false, std::uint32_t prio = TASK_PRIORITY_DEFAULT,
+	             std::uint16_t stack_depth = TASK_STACK_DEPTH_DEFAULT, const char* name = "");
+
+	/**
+	 * Creates a task that calls a callable object once every period
+	 * milliseconds.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The period is 0, the deadline is longer than the period, or
+	 *          align is true and the period is not a multiple of 2 ms.
+	 * ENOMEM - The stack cannot be used as the TCB was not created.
+	 *
+	 * \param function
+	 *        Callable object to call for each job
+	 * \param period
+	 *        The number of milliseconds between releases
+	 * \param deadline
+	 *        The number of milliseconds after its release by which each job
+	 *        must finish, or 0 to use the period
+	 * \param align
+	 *        Whether to release the task on the system daemon's ticks, so that
+	 *        it runs right after the smart ports have been read
+	 * \param prio
+	 *        The priority at which the task should run.
+	 *        TASK_PRIO_DEFAULT plus/minus 1 or 2 is typically used.
+	 * \param stack_depth
+	 *        The number of words (i.e. 4 * stack_depth) available on the task's
+	 *        stack. TASK_STACK_DEPTH_DEFAULT is typically sufficient.
+	 * \param name
+	 *        A descriptive name for the task.  This is mainly used to facilitate
+	 *        debugging. The name may be up to 32 characters long.
+	 */
+	template <class F>
+	explicit PeriodicTask(F&& function, std::uint32_t period, std::uint32_t deadline = 0, bool align = false,
+	                      std::uint32_t prio = TASK_PRIORITY_DEFAULT,
+	                      std::uint16_t stack_depth = TASK_STACK_DEPTH_DEFAULT, const char* name = "")
+	    : PeriodicTask(std::make_unique<std::function<void()>>(std::forward<F>(function)), period, deadline, align,
+	                   prio, stack_depth, name) {
+		static_assert(std::is_invocable_r_v<void, F>);
+	}
+
+	/**
+	 * Gets the timing of the task's jobs.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The task was not created as a periodic task
+	 *
+	 * \return The release jitter, execution time, response time and deadline
+	 * overruns of the task's jobs. If the operation failed, all fields are 0.
+	 */
+	task_periodic_stats_s_t get_periodic_stats();
+
+	private:
+	// Hands the callable object over to the task, which deletes it along with
+	// the task
+	PeriodicTask(std::unique_ptr<std::function<void()>> function, std::uint32_t period, std::uint32_t deadline,
+	             bool align, std::uint32_t prio, std::uint16_t stack_depth, const char* name);
+};
+
+/**
+ * A task whose stack, kernel record and entry function are all stored in the
+ * object itself, so creating it never touches the heap. Declaring one at
+ * namespace scope starts the task before initialize() runs and reserves its
+ * memory when the program is linked.
+ *
+ * The object must outlive the task, and can't be copied or moved because the
+ * kernel keeps pointers into it. When the function returns, it is destroyed
+ * and the task deletes itself.
+ *
+ * \tparam StackWords
+ *         The number of words (i.e. 4 * StackWords) available on the task's
+ *         stack
+ * \tparam FunctionSize
+ *         The number of bytes available to store the callable object. A lambda
+ *         needs about one pointer for each variable that it captures by
+ *         reference.
+ */
+template <std::size_t StackWords = TASK_STACK_DEPTH_DEFAULT, std::size_t FunctionSize = 8 * sizeof(void*)>
+class StaticTask : public Task {
+	static_assert(StackWords > 0 && StackWords <= UINT16_MAX, "StackWords must fit in a task's stack depth");
+
+	public:
+	/**
+	 * Creates a new task and adds it to the list of tasks that are ready to
+	 * run.
+	 *
+	 * \param function
+	 *        Callable object to use as entry function. It is copied or moved
+	 *        into the StaticTask and must fit in FunctionSize bytes.
+	 * \param prio
+	 *        The priority at which the task should run.
+	 *        TASK_PRIO_DEFAULT plus/minus 1 or 2 is typically used.
+	 * \param name
+	 *        A descriptive name for the task.  This is mainly used to facilitate
+	 *        debugging. The name may be up to 32 characters long.
+	 */
+	template <class F>
+	explicit StaticTask(F&& function, std::uint32_t prio = TASK_PRIORITY_DEFAULT, const char* name = "")
+	    : Task(task_t{}) {
+		using Function = std::decay_t<F>;
+		static_assert(std::is_invocable_r_v<void, Function&>);
+		static_assert(sizeof(Function) <= FunctionSize, "the callable object is larger than FunctionSize");
+		static_assert(alignof(Function) <= alignof(std::max_align_t), "the callable object is over-aligned");
+		Function* stored = ::new (static_cast<void*>(storage)) Function(std::forward<F>(function));
+		Task::operator=(pros::c::task_create_from_buffers(run<Function>, stored, prio, StackWords, name, stack, &buffer));
+	}
+
+	/**
+	 * Creates a new task and adds it to the list of tasks that are ready to
+	 * run.
+	 *
+	 * \param function
+	 *        Callable object to use as entry function
+	 * \param name
+	 *        A descriptive name for the task.  This is mainly used to facilitate
+	 *        debugging. The name may be up to 32 characters long.
+	 */
+	template <class F>
+	StaticTask(F&& function, const char* name) : StaticTask(std::forward<F>(function), TASK_PRIORITY_DEFAULT, name) {}
+
+	StaticTask(const StaticTask&) = delete;
+	StaticTask(StaticTask&&) = delete;
+	StaticTask& operator=(const StaticTask&) = delete;
+	StaticTask& operator=(StaticTask&&) = delete;
+
+	private:
+	template <class Function>
+	static void run(void* parameters) {
+		Function* function = static_cast<Function*>(parameters);
+		(*function)();
+		function->~Function();
+		pros::c::task_delete(nullptr);
+	}
+
+	std::uint32_t stack[StackWords];
+	task_buffer_s_t buffer;
+	alignas(std::max_align_t) unsigned char storage[FunctionSize];
+};
+
 // STL Clock compliant clock
 struct Clock {
 	using rep = std::uint32_t;
@@ -28,6 +28,11 @@ namespace pros {
 namespace c {
 #endif
 
+/**
+ * The size of the read buffer given to ports opened as /dev/N.
+ */
+#define SERIAL_DEV_READ_BUFFER_SIZE 4096
+
 /******************************************************************************/
 /**                      Serial communication functions                      **/
 /**                                                                          **/
@@ -53,6 +58,37 @@ namespace c {
  */
 int32_t serial_enable(uint8_t port);
 
+/**
+ * Gives the port a read buffer in the kernel.
+ *
+ * Once a port has a read buffer, the system daemon moves every byte that
+ * VEXos receives on it into the buffer once per cycle, so bytes aren't lost
+ * when VEXos's own small buffer would overflow between two reads. The read
+ * functions then read from the buffer, and the blocking reads below can be
+ * used. Ports opened through the filesystem as /dev/N get a buffer of
+ * SERIAL_DEV_READ_BUFFER_SIZE bytes.
+ *
+ * Bytes that don't fit in a full buffer are left in VEXos's buffer.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port is not a generic serial port.
+ * EACCES - Another resource is currently trying to access the port.
+ * EBUSY - The port already has a buffer of a different size.
+ * ENOMEM - The buffer could not be allocated.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param size
+ *        The size of the buffer in bytes, or 0 to remove the buffer. Tasks
+ *        blocked reading the port when the buffer is removed fail with ENOBUFS.
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t serial_set_read_buffer(uint8_t port, uint32_t size);
+
 /**
  * Sets the baudrate for the serial port to operate at.
  *
@@ -191,6 +227,109 @@ int32_t serial_read_byte(uint8_t port);
  */
 int32_t serial_read(uint8_t port, uint8_t* buffer, int32_t length);
 
+/**
+ * Reads up to length bytes from the port's read buffer, waiting for at least
+ * one byte to arrive.
+ *
+ * Only one task should block on a port at a time.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port is not a generic serial port.
+ * EACCES - Another resource is currently trying to access the port.
+ * EINVAL - buffer is NULL or length is not positive.
+ * ENOBUFS - The port has no read buffer. See serial_set_read_buffer().
+ * EAGAIN - No bytes arrived within the timeout.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param buffer
+ *        The location to place the data read
+ * \param length
+ *        The maximum number of bytes to read
+ * \param timeout
+ *        The maximum time to wait in milliseconds, 0 to return immediately or
+ *        TIMEOUT_MAX to wait forever
+ *
+ * \return The number of bytes read or PROS_ERR if the operation failed, setting
+ * errno.
+ */
+int32_t serial_read_timeout(uint8_t port, uint8_t* buffer, int32_t length, uint32_t timeout);
+
+/**
+ * Reads a frame that ends with a delimiter from the port's read buffer,
+ * waiting for the whole frame to arrive.
+ *
+ * The delimiter is removed from the buffer but not copied. If the frame
+ * doesn't fit in the given buffer, it is left in the read buffer so it can be
+ * read some other way.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port is not a generic serial port.
+ * EACCES - Another resource is currently trying to access the port.
+ * EINVAL - buffer is NULL or length is negative.
+ * ENOBUFS - The port has no read buffer. See serial_set_read_buffer().
+ * EMSGSIZE - The frame is longer than length, or than the read buffer.
+ * EAGAIN - The frame didn't arrive within the timeout.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param buffer
+ *        The location to place the frame
+ * \param length
+ *        The size of buffer
+ * \param delimiter
+ *        The byte that ends each frame, such as '\n'
+ * \param timeout
+ *        The maximum time to wait in milliseconds, 0 to return immediately or
+ *        TIMEOUT_MAX to wait forever
+ *
+ * \return The length of the frame, without the delimiter, or PROS_ERR if the
+ * operation failed, setting errno.
+ */
+int32_t serial_read_until(uint8_t port, uint8_t* buffer, int32_t length, uint8_t delimiter, uint32_t timeout);
+
+/**
+ * The size of the prefix that serial_read_frame() expects before each frame.
+ */
+#define SERIAL_FRAME_PREFIX_SIZE 2
+
+/**
+ * Reads a length-prefixed frame from the port's read buffer, waiting for the
+ * whole frame to arrive.
+ *
+ * Each frame starts with its length in bytes, not counting the prefix, as a
+ * 16-bit little-endian number. If the frame doesn't fit in the given buffer,
+ * it is left in the read buffer so it can be read some other way.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port is not a generic serial port.
+ * EACCES - Another resource is currently trying to access the port.
+ * EINVAL - buffer is NULL or length is negative.
+ * ENOBUFS - The port has no read buffer. See serial_set_read_buffer().
+ * EMSGSIZE - The frame is longer than length, or than the read buffer.
+ * EAGAIN - The frame didn't arrive within the timeout.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param buffer
+ *        The location to place the frame, without its prefix
+ * \param length
+ *        The size of buffer
+ * \param timeout
+ *        The maximum time to wait in milliseconds, 0 to return immediately or
+ *        TIMEOUT_MAX to wait forever
+ *
+ * \return The length of the frame or PROS_ERR if the operation failed, setting
+ * errno.
+ */
+int32_t serial_read_frame(uint8_t port, uint8_t* buffer, int32_t length, uint32_t timeout);
+
 /**
  * Write the given byte to the port's output buffer.
  *
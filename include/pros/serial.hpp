@@ -20,6 +20,7 @@
 #define _PROS_SERIAL_HPP_
 
 #include <cstdint>
+#include "pros/rtos.h"
 #include "pros/serial.h"
 
 namespace pros {
@@ -174,6 +175,104 @@ class Serial {
 	 */
 	virtual std::int32_t read(std::uint8_t* buffer, std::int32_t length) const;
 
+	/**
+	 * Gives the port a read buffer in the kernel.
+	 *
+	 * Once a port has a read buffer, the system daemon moves every byte that
+	 * VEXos receives on it into the buffer once per cycle, so bytes aren't lost
+	 * when VEXos's own small buffer would overflow between two reads. The read
+	 * functions then read from the buffer, and the blocking reads below can be
+	 * used.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EACCES - Another resource is currently trying to access the port.
+	 * EBUSY - The port already has a buffer of a different size.
+	 * ENOMEM - The buffer could not be allocated.
+	 *
+	 * \param size
+	 *        The size of the buffer in bytes, or 0 to remove the buffer. Tasks
+	 *        blocked reading the port when the buffer is removed fail with
+	 *        ENOBUFS.
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t set_read_buffer(std::uint32_t size) const;
+
+	/**
+	 * Reads up to length bytes from the port's read buffer, waiting for at
+	 * least one byte to arrive.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EACCES - Another resource is currently trying to access the port.
+	 * ENOBUFS - The port has no read buffer. See set_read_buffer().
+	 * EAGAIN - No bytes arrived within the timeout.
+	 *
+	 * \param buffer
+	 *        The location to place the data read
+	 * \param length
+	 *        The maximum number of bytes to read
+	 * \param timeout
+	 *        The maximum time to wait in milliseconds
+	 *
+	 * \return The number of bytes read or PROS_ERR if the operation failed,
+	 * setting errno.
+	 */
+	virtual std::int32_t read(std::uint8_t* buffer, std::int32_t length, std::uint32_t timeout) const;
+
+	/**
+	 * Reads a frame that ends with a delimiter from the port's read buffer,
+	 * waiting for the whole frame to arrive. See serial_read_until().
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EACCES - Another resource is currently trying to access the port.
+	 * ENOBUFS - The port has no read buffer. See set_read_buffer().
+	 * EMSGSIZE - The frame is longer than length, or than the read buffer.
+	 * EAGAIN - The frame didn't arrive within the timeout.
+	 *
+	 * \param buffer
+	 *        The location to place the frame
+	 * \param length
+	 *        The size of buffer
+	 * \param delimiter
+	 *        The byte that ends each frame
+	 * \param timeout
+	 *        The maximum time to wait in milliseconds
+	 *
+	 * \return The length of the frame, without the delimiter, or PROS_ERR if
+	 * the operation failed, setting errno.
+	 */
+	virtual std::int32_t read_until(std::uint8_t* buffer, std::int32_t length, std::uint8_t delimiter,
+	                                std::uint32_t timeout = TIMEOUT_MAX) const;
+
+	/**
+	 * Reads a frame prefixed with its 16-bit little-endian length from the
+	 * port's read buffer, waiting for the whole frame to arrive. See
+	 * serial_read_frame().
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EACCES - Another resource is currently trying to access the port.
+	 * ENOBUFS - The port has no read buffer. See set_read_buffer().
+	 * EMSGSIZE - The frame is longer than length, or than the read buffer.
+	 * EAGAIN - The frame didn't arrive within the timeout.
+	 *
+	 * \param buffer
+	 *        The location to place the frame
+	 * \param length
+	 *        The size of buffer
+	 * \param timeout
+	 *        The maximum time to wait in milliseconds
+	 *
+	 * \return The length of the frame or PROS_ERR if the operation failed,
+	 * setting errno.
+	 */
+	virtual std::int32_t read_frame(std::uint8_t* buffer, std::int32_t length,
+	                                std::uint32_t timeout = TIMEOUT_MAX) const;
+
 	/**
 	 * Write the given byte to the port's output buffer.
 	 *
@@ -0,0 +1,49 @@
+/**
+ * \file pros/task_periodic.h
+ *
+ * Contains the timing record of a periodic task. It is kept apart from
+ * pros/rtos.h so that the kernel can share the definition.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_TASK_PERIODIC_H_
+#define _PROS_TASK_PERIODIC_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+namespace pros {
+#endif
+
+/**
+ * The timing of a task created with task_create_periodic(). Times are in
+ * microseconds and are measured from the tick at which each job is released.
+ */
+typedef struct task_periodic_stats_s {
+	uint32_t period;             // The time between releases, in milliseconds
+	uint32_t deadline;           // The time after its release by which each job must finish, in milliseconds
+	uint32_t releases;           // The number of jobs that have been run
+	uint32_t overruns;           // The number of jobs that finished after their deadline
+	uint32_t skipped;            // The number of releases dropped because the previous job was still running
+	uint32_t jitter;             // The delay between the last job's release and its start
+	uint32_t max_jitter;         // The largest jitter of any job
+	uint32_t exec_time;          // The time between the last job's start and its end
+	uint32_t max_exec_time;      // The largest execution time of any job
+	uint32_t response_time;      // The time between the last job's release and its end
+	uint32_t max_response_time;  // The worst-case response time of any job
+} task_periodic_stats_s_t;
+
+#ifdef __cplusplus
+}  // namespace pros
+#endif
+
+#endif  // _PROS_TASK_PERIODIC_H_
@@ -0,0 +1,171 @@
+/**
+ * \file pros/telemetry.h
+ *
+ * Contains prototypes for the binary telemetry stream.
+ *
+ * Telemetry samples are fixed-layout structures which are sent to the host
+ * over the serial line without being formatted as text. Each sample is framed
+ * with a timestamp and a sequence number, and each channel periodically
+ * announces a schema describing its samples so that the host can decode them
+ * without any prior knowledge of the program.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_TELEMETRY_H_
+#define _PROS_TELEMETRY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The serial stream identifier that telemetry is sent on ('tlmy' little
+ * endian). Like other streams, telemetry is only sent once the stream has been
+ * activated with serctl(SERCTL_ACTIVATE, (void*)TELEMETRY_STREAM_ID).
+ */
+#define TELEMETRY_STREAM_ID 0x796d6c74
+
+/**
+ * The number of telemetry channels available
+ */
+#define TELEMETRY_MAX_CHANNELS 32
+
+/**
+ * The largest sample that can be logged on a channel, in bytes
+ */
+#define TELEMETRY_MAX_SAMPLE_SIZE 240
+
+#ifdef __cplusplus
+extern "C" {
+namespace pros {
+#endif
+
+/**
+ * The type of a telemetry frame, found in the first byte of every frame.
+ *
+ * Every frame on the telemetry stream starts with the following packed, little
+ * endian header:
+ *
+ *   uint8_t type       - a telemetry_frame_e_t
+ *   uint8_t channel    - the channel the frame belongs to
+ *   uint16_t length    - the number of bytes following the header
+ *   uint32_t sequence  - the channel's sample counter
+ *   uint64_t timestamp - microseconds since PROS initialized
+ *
+ * A sample frame is followed by the raw bytes of the sample. A schema frame is
+ * followed by the uint16_t size of a sample and then three NUL terminated
+ * strings: the name of the channel, its format, and its comma separated field
+ * names. The sequence number of a schema frame is that of the next sample.
+ */
+typedef enum telemetry_frame_e {
+	E_TELEMETRY_FRAME_SAMPLE = 0,
+	E_TELEMETRY_FRAME_SCHEMA = 1
+} telemetry_frame_e_t;
+
+#ifdef PROS_USE_SIMPLE_NAMES
+#ifdef __cplusplus
+#define TELEMETRY_FRAME_SAMPLE pros::E_TELEMETRY_FRAME_SAMPLE
+#define TELEMETRY_FRAME_SCHEMA pros::E_TELEMETRY_FRAME_SCHEMA
+#else
+#define TELEMETRY_FRAME_SAMPLE E_TELEMETRY_FRAME_SAMPLE
+#define TELEMETRY_FRAME_SCHEMA E_TELEMETRY_FRAME_SCHEMA
+#endif
+#endif
+
+#ifdef __cplusplus
+namespace c {
+#endif
+
+/**
+ * Describes the samples that will be logged on a telemetry channel.
+ *
+ * The format uses the same codes as Python's struct module, with samples
+ * always packed and little endian: x (pad byte), ? (bool), b/B (8 bit), h/H
+ * (16 bit), i/I (32 bit), q/Q (64 bit), f (float) and d (double). Lowercase
+ * letters are signed. A code may be preceded by a repeat count, e.g. "3f".
+ *
+ * A channel's schema can't be changed once it has been announced. Announcing
+ * the same schema again has no effect.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The channel is out of range, the format is invalid, or the format
+ *          doesn't describe exactly size bytes
+ * EEXIST - The channel has already been announced with a different schema
+ * ENOMEM - The schema couldn't be stored
+ *
+ * \param channel
+ *        The channel to announce, from 0 to TELEMETRY_MAX_CHANNELS - 1
+ * \param name
+ *        The name of the channel
+ * \param format
+ *        The layout of a sample
+ * \param fields
+ *        The comma separated names of the fields in the sample
+ * \param size
+ *        The size of a sample in bytes, which must match the format
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t telemetry_announce(uint8_t channel, const char* name, const char* format, const char* fields, size_t size);
+
+/**
+ * Logs a sample on a telemetry channel.
+ *
+ * The sample is timestamped and framed directly into the serial output queue.
+ * This function never blocks waiting for the serial line: if another task is
+ * writing to it or there is no space for the sample, the sample is dropped and
+ * counted in telemetry_get_dropped(), and the host will see a gap in the
+ * sequence numbers. Samples logged while the telemetry stream isn't active are
+ * discarded.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The channel hasn't been announced or size doesn't match its schema
+ * ENOBUFS - The serial output queue was busy or full and the sample was
+ *           dropped
+ *
+ * \param channel
+ *        The channel to log to
+ * \param data
+ *        The sample to log
+ * \param size
+ *        The size of the sample in bytes
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t telemetry_log(uint8_t channel, const void* data, size_t size);
+
+/**
+ * Gets the number of samples on a telemetry channel that were dropped because
+ * the serial output queue was busy or full.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The channel hasn't been announced
+ *
+ * \param channel
+ *        The channel to check
+ *
+ * \return The number of dropped samples or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t telemetry_get_dropped(uint8_t channel);
+
+#ifdef __cplusplus
+}  // namespace c
+}  // namespace pros
+}
+#endif
+
+#endif  // _PROS_TELEMETRY_H_
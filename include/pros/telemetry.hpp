@@ -0,0 +1,120 @@
+/**
+ * \file pros/telemetry.hpp
+ *
+ * Contains the C++ interface to the binary telemetry stream.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_TELEMETRY_HPP_
+#define _PROS_TELEMETRY_HPP_
+
+#include <cstdint>
+#include <type_traits>
+
+#include "pros/telemetry.h"
+
+namespace pros {
+/**
+ * A telemetry channel that logs samples of type T.
+ *
+ * T must be trivially copyable, since samples are sent as raw bytes. Declaring
+ * T with __attribute__((packed)) avoids having to describe padding in the
+ * format.
+ *
+ * \code
+ * struct __attribute__((packed)) DriveSample {
+ *   float left, right;
+ *   std::int32_t heading;
+ * };
+ * pros::Telemetry<DriveSample> drive(0, "drive", "2fi", "left,right,heading");
+ * drive.log({left_velocity, right_velocity, heading});
+ * \endcode
+ */
+template <typename T>
+class Telemetry {
+	static_assert(std::is_trivially_copyable<T>::value, "Telemetry samples must be trivially copyable");
+	static_assert(sizeof(T) <= TELEMETRY_MAX_SAMPLE_SIZE, "Telemetry samples must be at most 240 bytes");
+
+	public:
+	/**
+	 * Announces a telemetry channel for samples of type T.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The channel is out of range, the format is invalid, or the format
+	 *          doesn't describe exactly sizeof(T) bytes
+	 * EEXIST - The channel has already been announced with a different schema
+	 * ENOMEM - The schema couldn't be stored
+	 *
+	 * \param channel
+	 *        The channel to announce, from 0 to TELEMETRY_MAX_CHANNELS - 1
+	 * \param name
+	 *        The name of the channel
+	 * \param format
+	 *        The layout of T, see telemetry_announce() for details
+	 * \param fields
+	 *        The comma separated names of the fields in T
+	 */
+	Telemetry(const std::uint8_t channel, const char* name, const char* format, const char* fields)
+	    : _channel(channel) {
+		c::telemetry_announce(channel, name, format, fields, sizeof(T));
+	}
+
+	/**
+	 * Logs a sample on the channel.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The channel wasn't announced successfully
+	 * ENOBUFS - The serial output queue was busy or full and the sample was
+	 *           dropped
+	 *
+	 * \param sample
+	 *        The sample to log
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t log(const T& sample) const {
+		return c::telemetry_log(_channel, &sample, sizeof(T));
+	}
+
+	/**
+	 * Gets the number of samples on the channel that were dropped because the
+	 * serial output queue was busy or full.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The channel wasn't announced successfully
+	 *
+	 * \return The number of dropped samples or PROS_ERR if the operation failed,
+	 * setting errno.
+	 */
+	std::int32_t get_dropped() const {
+		return c::telemetry_get_dropped(_channel);
+	}
+
+	/**
+	 * Gets the channel that samples are logged on.
+	 *
+	 * \return The channel number
+	 */
+	std::uint8_t get_channel() const {
+		return _channel;
+	}
+
+	private:
+	const std::uint8_t _channel;
+};
+}  // namespace pros
+
+#endif  // _PROS_TELEMETRY_HPP_
@@ -273,6 +273,30 @@ vision_object_s_t vision_get_by_code(uint8_t port, const uint32_t size_id, const
  */
 int32_t vision_get_exposure(uint8_t port);
 
+/**
+ * Gets the sequence number of the frame that the Vision Sensor's objects are
+ * read from.
+ *
+ * The objects of each new frame from the sensor are read once and kept until
+ * the next frame arrives, so every object query in between is answered without
+ * talking to the sensor. The sequence number goes up by one each time a new
+ * frame is read. Comparing it between calls tells whether the objects have
+ * changed, and reading it is enough to pick up a new frame.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a vision sensor
+ * EAGAIN - Reading the vision sensor failed for an unknown reason.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ *
+ * \return The sequence number of the current frame, or PROS_ERR if an error
+ * occurred.
+ */
+int32_t vision_get_frame_sequence(uint8_t port);
+
 /**
  * Gets the number of objects currently detected by the Vision Sensor.
  *
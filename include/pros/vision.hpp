@@ -184,6 +184,25 @@ class Vision {
 	 */
 	std::int32_t get_exposure(void) const;
 
+	/**
+	 * Gets the sequence number of the frame that the Vision Sensor's objects
+	 * are read from.
+	 *
+	 * The objects of each new frame from the sensor are read once and kept
+	 * until the next frame arrives, so every object query in between is
+	 * answered without talking to the sensor. The sequence number goes up by
+	 * one each time a new frame is read.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - The port cannot be configured as a vision sensor
+	 * EAGAIN - Reading the vision sensor failed for an unknown reason.
+	 *
+	 * \return The sequence number of the current frame, or PROS_ERR if an
+	 * error occurred.
+	 */
+	std::int32_t get_frame_sequence(void) const;
+
 	/**
 	 * Gets the number of objects currently detected by the Vision Sensor.
 	 *
@@ -809,6 +809,10 @@ extern "C" {
 	#define configUSE_TASK_NOTIFICATIONS 1
 #endif
 
+#ifndef configUSE_PERIODIC_TASKS
+	#define configUSE_PERIODIC_TASKS 0
+#endif
+
 #ifndef portTICK_TYPE_IS_ATOMIC
 	#define portTICK_TYPE_IS_ATOMIC 0
 #endif
@@ -1013,7 +1017,8 @@ typedef struct xSTATIC_TCB
 		void			*pvDummy15[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
 	#endif
 	#if ( configGENERATE_RUN_TIME_STATS == 1 )
-		uint32_t		ulDummy16;
+		uint64_t		ullDummy16;
+		uint32_t		ulDummy24[ 3 + configRUN_TIME_STATS_WINDOW_SLOTS + 1 ];
 	#endif
 	#if ( configUSE_NEWLIB_REENTRANT == 1 )
 		struct	_reent	xDummy17;
@@ -1029,6 +1034,10 @@ typedef struct xSTATIC_TCB
 	#if( INCLUDE_xTaskAbortDelay == 1 )
 		uint8_t ucDummy21;
 	#endif
+	uint8_t				ucDummy22;
+	#if( configUSE_PERIODIC_TASKS == 1 )
+		void			*pxDummy23;
+	#endif
 
 } static_task_s_t;
 
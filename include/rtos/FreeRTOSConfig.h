@@ -137,8 +137,14 @@
 #define configUSE_APPLICATION_TASK_TAG          0
 #define configUSE_COUNTING_SEMAPHORES           1
 #define configUSE_QUEUE_SETS                    0
+#define configUSE_PERIODIC_TASKS                1
 #define configSUPPORT_STATIC_ALLOCATION         1
+#ifdef PROS_HOST
+/* glibc already gives every thread, and so every task, its own errno */
+#define configUSE_NEWLIB_REENTRANT              0
+#else
 #define configUSE_NEWLIB_REENTRANT              1
+#endif
 #define configSTACK_DEPTH_TYPE                  size_t
 
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 2
@@ -182,12 +188,17 @@ readable ASCII form.  See the notes in the implementation of vTaskList() within
 FreeRTOS/Source/tasks.c for limitations. */
 #define configUSE_STATS_FORMATTING_FUNCTIONS    1
 
-/* The private watchdog is used to generate run time stats. */
+/* Run time stats are kept in microseconds from the high resolution timer, so
+that task_get_stats() can report them as times.  Each task also keeps its run
+time in each of the last few slots of configRUN_TIME_STATS_SLOT_LENGTH
+microseconds, which give the sliding window of task_get_stats(). */
 extern void vInitialiseTimerForRunTimeStats( void );
-extern uint32_t vexSystemWatchdogGet( void );
+extern uint64_t vexSystemHighResTimeGet( void );
 #define configGENERATE_RUN_TIME_STATS 1
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vInitialiseTimerForRunTimeStats()
-#define portGET_RUN_TIME_COUNTER_VALUE()         vexSystemWatchdogGet()
+#define portGET_RUN_TIME_COUNTER_VALUE()         vexSystemHighResTimeGet()
+#define configRUN_TIME_STATS_SLOT_LENGTH         250000
+#define configRUN_TIME_STATS_WINDOW_SLOTS        4
 
 /* The size of the global output buffer that is available for use when there
 are multiple command interpreters running at once (for example, one on a UART
@@ -231,4 +242,8 @@ Zynq MPU. */
 #define configINTERRUPT_CONTROLLER_CPU_INTERFACE_OFFSET ( -0xf00 )
 #define configUNIQUE_INTERRUPT_PRIORITIES               32
 
+/* Record scheduling, blocking and priority inheritance into the scheduler
+trace. */
+#include "system/trace.h"
+
 #endif /* FREERTOS_CONFIG_H */
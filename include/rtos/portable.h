@@ -35,9 +35,15 @@
 /* If portENTER_CRITICAL is not defined then including deprecated_definitions.h
 did not result in a portmacro.h header file being included - and it should be
 included here.  In this case the path to the correct portmacro.h header file
-must be set in the compiler's include path. */
+must be set in the compiler's include path.  The host build uses the POSIX
+port, whose portmacro.h would otherwise be hidden by the one next to this
+file. */
 #ifndef portENTER_CRITICAL
-	#include "portmacro.h"
+	#ifdef PROS_HOST
+		#include "host/rtos/portmacro.h"
+	#else
+		#include "portmacro.h"
+	#endif
 #endif
 
 #if portBYTE_ALIGNMENT == 32
@@ -110,10 +116,45 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) ;
  */
 void *kmalloc( size_t xSize ) ;
 void kfree( void *pv ) ;
+
+/*
+ * The general purpose heap (heap_4.c).  kmalloc() and kfree() serve small
+ * allocations from size-class pools (heap_pool.c) and pass everything else
+ * through to these.
+ */
+void *heap_malloc( size_t xSize ) ;
+void heap_free( void *pv ) ;
 void vPortInitialiseBlocks( void ) ;
 size_t xPortGetFreeHeapSize( void ) ;
 size_t xPortGetMinimumEverFreeHeapSize( void ) ;
 
+/* Used to pass information about the heap out of vPortGetHeapStats(). */
+#define heapHISTOGRAM_BUCKETS			10
+#define heapHISTOGRAM_SMALLEST_BUCKET	( ( size_t ) 64 )
+typedef struct xHeapStats
+{
+	size_t xAvailableHeapSpaceInBytes;		/* The total heap size currently available - this is the sum of all the free blocks, not the largest block that can be allocated. */
+	size_t xSizeOfLargestFreeBlockInBytes; 	/* The maximum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
+	size_t xSizeOfSmallestFreeBlockInBytes; /* The minimum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
+	size_t xNumberOfFreeBlocks;				/* The number of free memory blocks within the heap at the time vPortGetHeapStats() is called. */
+	size_t xMinimumEverFreeBytesRemaining;	/* The minimum amount of total free memory (sum of all free blocks) there has been in the heap since the system booted. */
+	size_t xNumberOfSuccessfulAllocations;	/* The number of calls to heap_malloc() that have returned a valid memory block. */
+	size_t xNumberOfSuccessfulFrees;		/* The number of calls to heap_free() that has successfully freed a block of memory. */
+	size_t xFreeBlockHistogram[ heapHISTOGRAM_BUCKETS ]; /* Free blocks smaller than heapHISTOGRAM_SMALLEST_BUCKET << i are counted in bucket i, and the last bucket counts the rest. */
+} HeapStats_t;
+
+/*
+ * Returns a HeapStats_t structure filled with information about the current
+ * heap state.  This walks the free list with the scheduler suspended.
+ */
+void vPortGetHeapStats( HeapStats_t *pxHeapStats ) ;
+
+/*
+ * The same as vPortGetHeapStats(), for callers that already have interrupts
+ * masked or the scheduler suspended, where suspending it again is not allowed.
+ */
+void vPortGetHeapStatsFromCritical( HeapStats_t *pxHeapStats ) ;
+
 /*
  * Setup the hardware ready for the scheduler to take control.  This generally
  * sets up a tick interrupt and sets timers for the correct tick frequency.
@@ -309,6 +309,124 @@ size_t stream_buf_send( stream_buf_t xStreamBuffer,
 						  size_t xDataLengthBytes,
 						  uint32_t xTicksToWait ) ;
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t stream_buf_reserve( stream_buf_t xStreamBuffer,
+                           size_t xDataLengthBytes,
+                           uint8_t **ppucFirst,
+                           size_t *pxFirstLength,
+                           uint8_t **ppucSecond,
+                           uint32_t xTicksToWait );
+</pre>
+ *
+ * Reserves space in a stream buffer so that data can be written into it in
+ * place, rather than being built elsewhere and copied in with
+ * stream_buf_send().  Nothing becomes visible to the reader until
+ * stream_buf_commit() is called.
+ *
+ * The reserved region starts at the head of the buffer and may wrap around
+ * the end of the storage area, so it is returned as two pieces: the first
+ * *pxFirstLength bytes start at *ppucFirst, and the remaining bytes (if any)
+ * start at *ppucSecond.
+ *
+ * Like stream_buf_send(), only one task may write to the stream buffer at a
+ * time, and a reservation must be committed before the next one is made.
+ * Reservations can't be made in message buffers.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to reserve space in.
+ *
+ * @param xDataLengthBytes The number of bytes to reserve.
+ *
+ * @param ppucFirst Set to the start of the reserved region.
+ *
+ * @param pxFirstLength Set to the number of reserved bytes that are contiguous
+ * with *ppucFirst.
+ *
+ * @param ppucSecond Set to the location of the reserved bytes that wrapped
+ * around to the start of the storage area.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should remain
+ * in the Blocked state to wait for enough space to become available.
+ *
+ * @return xDataLengthBytes if the space was reserved, or 0 if the call timed
+ * out or the region can never fit in the buffer.
+ *
+ * \defgroup stream_buf_reserve stream_buf_reserve
+ * \ingroup StreamBufferManagement
+ */
+size_t stream_buf_reserve( stream_buf_t xStreamBuffer,
+						   size_t xDataLengthBytes,
+						   uint8_t **ppucFirst,
+						   size_t *pxFirstLength,
+						   uint8_t **ppucSecond,
+						   uint32_t xTicksToWait ) ;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+void stream_buf_commit( stream_buf_t xStreamBuffer, size_t xDataLengthBytes );
+</pre>
+ *
+ * Makes the first xDataLengthBytes bytes of a region reserved with
+ * stream_buf_reserve() available to the reader.  xDataLengthBytes may be less
+ * than the number of bytes that were reserved.
+ *
+ * @param xStreamBuffer The handle of the stream buffer that was written to.
+ *
+ * @param xDataLengthBytes The number of bytes that were written.
+ *
+ * \defgroup stream_buf_commit stream_buf_commit
+ * \ingroup StreamBufferManagement
+ */
+void stream_buf_commit( stream_buf_t xStreamBuffer, size_t xDataLengthBytes ) ;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t stream_buf_peek( stream_buf_t xStreamBuffer, uint8_t **ppucData );
+</pre>
+ *
+ * Gets a pointer to the oldest data in a stream buffer so that it can be used
+ * in place, rather than copied out with stream_buf_recv().  The data is not
+ * removed from the buffer until stream_buf_consume() is called.
+ *
+ * Only the data up to the end of the storage area is returned.  If the data
+ * wraps around, call this function again after consuming the first piece.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to read from.
+ *
+ * @param ppucData Set to the start of the data.
+ *
+ * @return The number of contiguous bytes available at *ppucData.
+ *
+ * \defgroup stream_buf_peek stream_buf_peek
+ * \ingroup StreamBufferManagement
+ */
+size_t stream_buf_peek( stream_buf_t xStreamBuffer, uint8_t **ppucData ) ;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+void stream_buf_consume( stream_buf_t xStreamBuffer, size_t xDataLengthBytes );
+</pre>
+ *
+ * Removes data that was read in place using stream_buf_peek() from a stream
+ * buffer, unblocking a writer that is waiting for space.
+ *
+ * @param xStreamBuffer The handle of the stream buffer that was read from.
+ *
+ * @param xDataLengthBytes The number of bytes to remove.
+ *
+ * \defgroup stream_buf_consume stream_buf_consume
+ * \ingroup StreamBufferManagement
+ */
+void stream_buf_consume( stream_buf_t xStreamBuffer, size_t xDataLengthBytes ) ;
+
 /**
  * stream_buffer.h
  *
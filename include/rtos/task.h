@@ -35,6 +35,7 @@
 #endif
 
 #include "list.h"
+#include "pros/task_periodic.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -121,11 +122,54 @@ typedef struct xTASK_STATUS
 	task_state_e_t eCurrentState;		/* The state in which the task existed when the structure was populated. */
 	uint32_t uxCurrentPriority;	/* The priority at which the task was running (may be inherited) when the structure was populated. */
 	uint32_t uxBasePriority;		/* The priority to which the task will return if the task's current priority has been inherited to avoid unbounded priority inversion when obtaining a mutex.  Only valid if configUSE_MUTEXES is defined as 1 in FreeRTOSConfig.h. */
-	uint32_t ulRunTimeCounter;		/* The total run time allocated to the task so far, as defined by the run time stats clock.  See http://www.freertos.org/rtos-run-time-stats.html.  Only valid when configGENERATE_RUN_TIME_STATS is defined as 1 in FreeRTOSConfig.h. */
+	uint64_t ullRunTimeCounter;		/* The total run time allocated to the task so far, as defined by the run time stats clock.  See http://www.freertos.org/rtos-run-time-stats.html.  Only valid when configGENERATE_RUN_TIME_STATS is defined as 1 in FreeRTOSConfig.h. */
 	task_stack_t *pxStackBase;		/* Points to the lowest address of the task's stack area. */
 	uint16_t usStackHighWaterMark;	/* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
 } TaskStatus_t;
 
+/* The timing of a task created by task_create_periodic(), as returned by
+task_get_periodic_stats(), is shared with the public API. */
+#ifdef __cplusplus
+using pros::task_periodic_stats_s_t;
+#endif
+
+/* Storage for the TCB of a task created by task_create_from_buffers(), which
+application code can declare without seeing static_task_s_t.  Mirrors
+task_buffer_s_t in pros/rtos.h. */
+#define TASK_BUFFER_SIZE 1536
+typedef struct task_buffer_s
+{
+	uint64_t data[ TASK_BUFFER_SIZE / sizeof( uint64_t ) ];
+} task_buffer_s_t;
+
+/* The CPU usage of a task, as returned by task_get_stats().  Mirrors
+task_stats_s_t in pros/rtos.h. */
+typedef struct task_stats_s
+{
+	task_t task;							/* The task. */
+	char name[ configMAX_TASK_NAME_LEN ];	/* The name of the task. */
+	uint32_t priority;						/* The priority of the task, including any it has inherited. */
+	task_state_e_t state;					/* The state of the task. */
+	uint64_t run_time;						/* The time the task has spent running, in microseconds. */
+	uint32_t window_run_time;				/* The time the task spent running in the slots of the window, in microseconds. */
+	float usage;							/* window_run_time as a percentage of the window. */
+	uint32_t switches;						/* The number of times the task has been switched in. */
+	uint32_t preemptions;					/* The number of times the task was switched out while still ready to run. */
+	uint32_t stack_high_water;				/* The least free stack the task has ever had, in words. */
+} task_stats_s_t;
+
+/* The CPU usage of the whole system, as returned by task_get_system_stats().
+Mirrors task_system_stats_s_t in pros/rtos.h. */
+typedef struct task_system_stats_s
+{
+	uint64_t run_time;			/* The run time counter value, in microseconds. */
+	uint32_t window;			/* The length of the window, in microseconds. */
+	uint32_t idle_time;			/* The time the idle task spent running in the window, in microseconds. */
+	float idle_usage;			/* idle_time as a percentage of the window. */
+	uint32_t task_count;		/* The number of tasks. */
+	uint32_t switches;			/* The number of context switches. */
+} task_system_stats_s_t;
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -424,6 +468,21 @@ is used in assert() statements. */
 	                            const char* const name,
 	                            task_stack_t * const stack_buffer,
 	                            static_task_s_t * const task_buffer ) ;
+
+/**
+ * task. h
+ * <pre>task_t task_create_from_buffers( task_fn_t pxTaskCode, void * const pvParameters, uint32_t uxPriority, const uint16_t usStackDepth, const char * const pcName, uint32_t * const puxStackBuffer, task_buffer_s_t * const pxTaskBuffer );</pre>
+ *
+ * The same as task_create_static(), for application code, which declares the
+ * TCB as a task_buffer_s_t because it can't see static_task_s_t.
+ *
+ * @return The handle of the new task, or NULL with errno set to EINVAL if
+ * puxStackBuffer or pxTaskBuffer is NULL.
+ *
+ * \defgroup task_create_from_buffers task_create_from_buffers
+ * \ingroup Tasks
+ */
+	task_t task_create_from_buffers( task_fn_t pxTaskCode, void * const pvParameters, uint32_t uxPriority, const uint16_t usStackDepth, const char * const pcName, uint32_t * const puxStackBuffer, task_buffer_s_t * const pxTaskBuffer ) ;
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
 /**
@@ -578,6 +637,127 @@ void task_delay( const uint32_t xTicksToDelay ) ;
  */
 void task_delay_until( uint32_t * const pxPreviousWakeTime, const uint32_t xTimeIncrement ) ;
 
+/**
+ * task. h
+ * <pre>task_t task_create_periodic( task_fn_t pxJobCode, void * const pvParameters, const uint32_t xPeriod, const uint32_t xDeadline, const bool xAlign, uint32_t uxPriority, const uint16_t usStackDepth, const char * const pcName );</pre>
+ *
+ * configUSE_PERIODIC_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * Creates a task that calls pxJobCode once every xPeriod ticks.  Each call is
+ * a job: its release is the tick at which it became due, and the task records
+ * how late each job started, how long it ran and whether it finished within
+ * xDeadline ticks of its release.  A job that is still running at the next
+ * release causes that release to be skipped, so releases stay on the grid set
+ * by the first one.
+ *
+ * If xAlign is true the first release is placed on a tick at which the system
+ * daemon is released, and xPeriod must be a multiple of the daemon's period.
+ *
+ * @param xDeadline The deadline of each job relative to its release, or 0 to
+ * use xPeriod.
+ *
+ * @return The handle of the new task, or NULL with errno set to EINVAL if the
+ * timing is invalid or to ENOMEM if the task could not be allocated.
+ *
+ * \defgroup task_create_periodic task_create_periodic
+ * \ingroup Tasks
+ */
+task_t task_create_periodic( task_fn_t pxJobCode, void * const pvParameters, const uint32_t xPeriod, const uint32_t xDeadline, const bool xAlign, uint32_t uxPriority, const uint16_t usStackDepth, const char * const pcName ) ;
+
+/**
+ * task. h
+ * <pre>task_t task_create_periodic_owned( task_fn_t pxJobCode, void * const pvParameters, task_fn_t pxCleanup, const uint32_t xPeriod, const uint32_t xDeadline, const bool xAlign, uint32_t uxPriority, const uint16_t usStackDepth, const char * const pcName );</pre>
+ *
+ * configUSE_PERIODIC_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * Like task_create_periodic(), but the task owns pvParameters.  pxCleanup is
+ * called with pvParameters when the task is deleted, or before returning if
+ * the task could not be created.
+ *
+ * \defgroup task_create_periodic_owned task_create_periodic_owned
+ * \ingroup Tasks
+ */
+task_t task_create_periodic_owned( task_fn_t pxJobCode, void * const pvParameters, task_fn_t pxCleanup, const uint32_t xPeriod, const uint32_t xDeadline, const bool xAlign, uint32_t uxPriority, const uint16_t usStackDepth, const char * const pcName ) ;
+
+/**
+ * task. h
+ * <pre>int32_t task_get_periodic_stats( task_t xTask, task_periodic_stats_s_t * const pxStats );</pre>
+ *
+ * configUSE_PERIODIC_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * Copies the timing of a task created by task_create_periodic() into pxStats.
+ *
+ * @param xTask The task to query, or NULL for the calling task.
+ *
+ * @return 1 on success, or PROS_ERR with errno set to EINVAL if pxStats is NULL
+ * or the task is not periodic.
+ *
+ * \defgroup task_get_periodic_stats task_get_periodic_stats
+ * \ingroup TaskUtils
+ */
+int32_t task_get_periodic_stats( task_t xTask, task_periodic_stats_s_t * const pxStats ) ;
+
+/**
+ * task. h
+ * <pre>int32_t task_get_stats( task_t xTask, task_stats_s_t * const pxStats );</pre>
+ *
+ * configGENERATE_RUN_TIME_STATS must be defined as 1 for this function to be
+ * available.
+ *
+ * Copies the CPU usage of a task into pxStats.  The run time of the calling
+ * task is brought up to date first.  The window covers the last
+ * configRUN_TIME_STATS_WINDOW_SLOTS whole slots.
+ *
+ * @param xTask The task to query, or NULL for the calling task.
+ *
+ * @return 1 on success, or PROS_ERR with errno set to EINVAL if pxStats is
+ * NULL.
+ *
+ * \defgroup task_get_stats task_get_stats
+ * \ingroup TaskUtils
+ */
+int32_t task_get_stats( task_t xTask, task_stats_s_t * const pxStats ) ;
+
+/**
+ * task. h
+ * <pre>int32_t task_get_all_stats( task_stats_s_t * const pxStats, const size_t xCount );</pre>
+ *
+ * configGENERATE_RUN_TIME_STATS must be defined as 1 for this function to be
+ * available.
+ *
+ * Copies the CPU usage of up to xCount tasks into pxStats, walking the same
+ * lists as uxTaskGetSystemState().  A task deleted before its stack is scanned
+ * has a stack_high_water of 0.
+ *
+ * @return The number of tasks copied, or PROS_ERR with errno set to EINVAL if
+ * pxStats is NULL.
+ *
+ * \defgroup task_get_all_stats task_get_all_stats
+ * \ingroup TaskUtils
+ */
+int32_t task_get_all_stats( task_stats_s_t * const pxStats, const size_t xCount ) ;
+
+/**
+ * task. h
+ * <pre>int32_t task_get_system_stats( task_system_stats_s_t * const pxStats );</pre>
+ *
+ * configGENERATE_RUN_TIME_STATS must be defined as 1 for this function to be
+ * available.
+ *
+ * Copies the idle time in the window and the total number of context switches
+ * into pxStats.
+ *
+ * @return 1 on success, or PROS_ERR with errno set to EINVAL if pxStats is
+ * NULL.
+ *
+ * \defgroup task_get_system_stats task_get_system_stats
+ * \ingroup TaskUtils
+ */
+int32_t task_get_system_stats( task_system_stats_s_t * const pxStats ) ;
+
 /**
  * task. h
  * <pre>int32_t task_abort_delay( task_t xTask );</pre>
@@ -1265,7 +1445,9 @@ task_t xTaskGetIdleTaskHandle( void ) ;
  * definition in this file for the full member list.
  *
  * NOTE:  This function is intended for debugging use only as its use results in
- * the scheduler remaining suspended for an extended period.
+ * the scheduler remaining suspended for an extended period.  The stack high
+ * water marks are found after the lists are copied, suspending the scheduler
+ * for one stack at a time.
  *
  * @param pxTaskStatusArray A pointer to an array of TaskStatus_t structures.
  * The array must contain at least one TaskStatus_t structure for each task
@@ -1277,11 +1459,11 @@ task_t xTaskGetIdleTaskHandle( void ) ;
  * the number of TaskStatus_t structures contained in the array, not by the
  * number of bytes in the array.
  *
- * @param pulTotalRunTime If configGENERATE_RUN_TIME_STATS is set to 1 in
- * FreeRTOSConfig.h then *pulTotalRunTime is set by uxTaskGetSystemState() to the
+ * @param pullTotalRunTime If configGENERATE_RUN_TIME_STATS is set to 1 in
+ * FreeRTOSConfig.h then *pullTotalRunTime is set by uxTaskGetSystemState() to the
  * total run time (as defined by the run time stats clock, see
  * http://www.freertos.org/rtos-run-time-stats.html) since the target booted.
- * pulTotalRunTime can be set to NULL to omit the total run time information.
+ * pullTotalRunTime can be set to NULL to omit the total run time information.
  *
  * @return The number of TaskStatus_t structures that were populated by
  * uxTaskGetSystemState().  This should equal the number returned by the
@@ -1297,7 +1479,8 @@ task_t xTaskGetIdleTaskHandle( void ) ;
 	{
 	TaskStatus_t *pxTaskStatusArray;
 	volatile uint32_t uxArraySize, x;
-	uint32_t ulTotalRunTime, ulStatsAsPercentage;
+	uint64_t ullTotalRunTime;
+	uint32_t ulStatsAsPercentage;
 
 		// Make sure the write buffer does not contain a string.
 		*pcWriteBuffer = 0x00;
@@ -1313,13 +1496,13 @@ task_t xTaskGetIdleTaskHandle( void ) ;
 		if( pxTaskStatusArray != NULL )
 		{
 			// Generate raw status information about each task.
-			uxArraySize = uxTaskGetSystemState( pxTaskStatusArray, uxArraySize, &ulTotalRunTime );
+			uxArraySize = uxTaskGetSystemState( pxTaskStatusArray, uxArraySize, &ullTotalRunTime );
 
 			// For percentage calculations.
-			ulTotalRunTime /= 100UL;
+			ullTotalRunTime /= 100ULL;
 
 			// Avoid divide by zero errors.
-			if( ulTotalRunTime > 0 )
+			if( ullTotalRunTime > 0 )
 			{
 				// For each populated position in the pxTaskStatusArray array,
 				// format the raw data as human readable ASCII data
@@ -1328,17 +1511,17 @@ task_t xTaskGetIdleTaskHandle( void ) ;
 					// What percentage of the total run time has the task used?
 					// This will always be rounded down to the nearest integer.
 					// ulTotalRunTimeDiv100 has already been divided by 100.
-					ulStatsAsPercentage = pxTaskStatusArray[ x ].ulRunTimeCounter / ulTotalRunTime;
+					ulStatsAsPercentage = ( uint32_t ) ( pxTaskStatusArray[ x ].ullRunTimeCounter / ullTotalRunTime );
 
 					if( ulStatsAsPercentage > 0UL )
 					{
-						sprintf( pcWriteBuffer, "%s\t\t%lu\t\t%lu%%\r\n", pxTaskStatusArray[ x ].pcTaskName, pxTaskStatusArray[ x ].ulRunTimeCounter, ulStatsAsPercentage );
+						sprintf( pcWriteBuffer, "%s\t\t%llu\t\t%lu%%\r\n", pxTaskStatusArray[ x ].pcTaskName, pxTaskStatusArray[ x ].ullRunTimeCounter, ulStatsAsPercentage );
 					}
 					else
 					{
 						// If the percentage is zero here then the task has
 						// consumed less than 1% of the total run time.
-						sprintf( pcWriteBuffer, "%s\t\t%lu\t\t<1%%\r\n", pxTaskStatusArray[ x ].pcTaskName, pxTaskStatusArray[ x ].ulRunTimeCounter );
+						sprintf( pcWriteBuffer, "%s\t\t%llu\t\t<1%%\r\n", pxTaskStatusArray[ x ].pcTaskName, pxTaskStatusArray[ x ].ullRunTimeCounter );
 					}
 
 					pcWriteBuffer += strlen( ( char * ) pcWriteBuffer );
@@ -1351,7 +1534,7 @@ task_t xTaskGetIdleTaskHandle( void ) ;
 	}
 	</pre>
  */
-uint32_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const uint32_t uxArraySize, uint32_t * const pulTotalRunTime ) ;
+uint32_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const uint32_t uxArraySize, uint64_t * const pullTotalRunTime ) ;
 
 /**
  * task. h
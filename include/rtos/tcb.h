@@ -3,6 +3,27 @@
 #include "rtos/FreeRTOS.h"
 #include "rtos/list.h"
 
+/* Sometimes the FreeRTOSConfig.h settings only allow a task to be created using
+dynamically allocated RAM, in which case when any task is deleted it is known
+that both the task's stack and TCB need to be freed.  Sometimes the
+FreeRTOSConfig.h settings only allow a task to be created using statically
+allocated RAM, in which case when any task is deleted it is known that neither
+the task's stack or TCB should be freed.  Sometimes the FreeRTOSConfig.h
+settings allow a task to be created using either statically or dynamically
+allocated RAM, in which case a member of the TCB is used to record whether the
+stack and/or TCB were allocated statically or dynamically, so when a task is
+deleted the RAM that was allocated dynamically is freed again and no attempt is
+made to free the RAM that was allocated statically.
+tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE is only true if it is possible for a
+task to be created using either statically or dynamically allocated RAM.  Note
+that if portUSING_MPU_WRAPPERS is 1 then a protected task can be created with
+a statically allocated stack and a dynamically allocated TCB.
+!!!NOTE!!! If the definition of tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE is
+changed then the definition of static_task_s_t must also be updated.  It is
+defined here rather than in tasks.c so that every file that includes this header
+sees the same TCB layout. */
+#define tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE	( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
 /*
  * Task control block.  A task control block (TCB) is allocated for each task,
  * and stores task state information, including a pointer to the task's context
@@ -46,7 +67,11 @@ typedef struct tskTaskControlBlock
 	#endif
 
 	#if( configGENERATE_RUN_TIME_STATS == 1 )
-		uint32_t		ulRunTimeCounter;	/*< Stores the amount of time the task has spent in the Running state. */
+		uint64_t		ullRunTimeCounter;	/*< Stores the amount of time the task has spent in the Running state. */
+		uint32_t		ulSwitchCount;		/*< The number of times the task has been switched in. */
+		uint32_t		ulPreemptCount;		/*< The number of times the task was switched out while it was still ready to run. */
+		uint32_t		ulStatsSlot;		/*< The latest run time stats slot in which the task ran. */
+		uint32_t		ulSlotRunTime[ configRUN_TIME_STATS_WINDOW_SLOTS + 1 ];	/*< The time the task ran in each of the slots up to ulStatsSlot, indexed by slot modulo the array length. */
 	#endif
 
 	#if ( configUSE_NEWLIB_REENTRANT == 1 )
@@ -75,6 +100,12 @@ typedef struct tskTaskControlBlock
 		uint8_t ucDelayAborted;
 	#endif
 
+	uint8_t ucHeapOwner;	/*< The slot that kmalloc() attributes this task's allocations to, or 0 if it has not been assigned one yet. */
+
+	#if( configUSE_PERIODIC_TASKS == 1 )
+		struct xPERIODIC_TASK *pxPeriodic;	/*< The release bookkeeping of a task created by task_create_periodic(), or NULL. */
+	#endif
+
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
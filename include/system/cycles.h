@@ -0,0 +1,65 @@
+/**
+ * \file system/cycles.h
+ *
+ * Cycle counter for the kernel
+ *
+ * On the V5 this reads the Cortex-A9's PMU cycle counter, which must first be
+ * started with cycles_initialize(). The counter is 32 bits wide and wraps
+ * about every 6.4 seconds, so it is only suitable for timing short intervals.
+ * In the host build a "cycle" is a nanosecond of CLOCK_MONOTONIC.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef PROS_HOST
+#include <time.h>
+
+#define CYCLES_PER_US 1000
+#define CYCLES_UNIT "ns"
+
+static inline void cycles_initialize(void) {}
+
+static inline uint32_t cycles_get(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)now.tv_sec * 1000000000u + (uint32_t)now.tv_nsec;
+}
+#else
+// The V5's processor runs at 666.67 MHz
+#define CYCLES_PER_US 667
+#define CYCLES_UNIT "cycles"
+
+/**
+ * Starts the PMU cycle counter, counting every cycle. This is safe to call
+ * more than once.
+ */
+static inline void cycles_initialize(void) {
+	uint32_t pmcr;
+	__asm__ volatile("mrc p15, 0, %0, c9, c12, 0" : "=r"(pmcr));
+	// set E (enable all counters) and clear D (count every 64th cycle)
+	pmcr = (pmcr | 1u) & ~(1u << 3);
+	__asm__ volatile("mcr p15, 0, %0, c9, c12, 0" ::"r"(pmcr));
+	// PMCNTENSET: enable the cycle counter
+	__asm__ volatile("mcr p15, 0, %0, c9, c12, 1" ::"r"(1u << 31));
+}
+
+/**
+ * Reads the PMU cycle counter.
+ *
+ * \return The current value of the cycle counter
+ */
+static inline uint32_t cycles_get(void) {
+	uint32_t cycles;
+	__asm__ volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(cycles));
+	return cycles;
+}
+#endif
@@ -15,8 +15,47 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 #include "vfs.h"
 
+/**
+ * The largest buffer that ser_output_write_frame() sends as one frame.
+ */
+#define SER_MAX_FRAME_SIZE 512
+
 extern const struct fs_driver* const ser_driver;
 int ser_open_r(struct _reent* r, const char* path, int flags, int mode);
 void ser_initialize(void);
+
+/**
+ * Checks if data written to a stream will be sent over the serial line, either
+ * because the stream has been activated or because it has guaranteed delivery
+ *
+ * \param stream_id
+ *        The little endian representation of the stream identifier
+ *
+ * \return True if the stream is enabled
+ */
+bool ser_stream_enabled(uint32_t stream_id);
+
+/**
+ * Writes a buffer to the serial output queue as a single COBS frame on the
+ * given stream. The frame is encoded directly into the output queue.
+ *
+ * \param stream_id
+ *        The little endian representation of the stream identifier
+ * \param buffer
+ *        The data to frame
+ * \param size
+ *        The length of the data, which must be at most SER_MAX_FRAME_SIZE
+ * \param timeout
+ *        How long to wait for other writers to finish and for space in the
+ *        output queue
+ *
+ * \return True if the frame was queued, false if COBS is disabled, the frame is
+ * too large, or the queue couldn't be written to in time
+ */
+bool ser_output_write_frame(uint32_t stream_id, const uint8_t* buffer, size_t size, uint32_t timeout);
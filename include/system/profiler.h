@@ -0,0 +1,36 @@
+/**
+ * \file system/profiler.h
+ *
+ * Sampling profiler hook
+ *
+ * The port's tick handler calls profiler_sample() with the address it
+ * interrupted, so the profiler sees whatever was running once per tick.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Set while the profiler is running. The port's interrupt entry only saves the
+ * interrupted context for profiler_sample() while this is set.
+ */
+extern volatile uint32_t ulPortProfilerEnabled;
+
+/**
+ * Records a sample if the profiler is running. Must be called from the tick
+ * interrupt.
+ *
+ * \param pc
+ *        The address of the instruction that the tick interrupted
+ * \param lr
+ *        The link register of the code that the tick interrupted
+ */
+void profiler_sample(uint32_t pc, uint32_t lr);
@@ -0,0 +1,39 @@
+/**
+ * \file system/system_daemon.h
+ *
+ * Timing of the system daemon, which services the smart ports, the serial
+ * output and the competition state every SYSTEM_DAEMON_PERIOD milliseconds.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The number of milliseconds between runs of the system daemon
+#define SYSTEM_DAEMON_PERIOD 2
+
+/**
+ * Gets a tick at which the system daemon is released.
+ *
+ * Once user initialization is over, the daemon is released every
+ * SYSTEM_DAEMON_PERIOD ticks from this one, so it can be used to put other
+ * periodic work in phase with the daemon.
+ *
+ * \return The tick of the daemon's next (or most recent) release
+ */
+uint32_t system_daemon_get_release(void);
+
+#ifdef __cplusplus
+}
+#endif
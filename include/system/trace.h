@@ -0,0 +1,86 @@
+/**
+ * \file system/trace.h
+ *
+ * Scheduler trace hooks
+ *
+ * FreeRTOSConfig.h includes this file so that these definitions replace the
+ * empty trace macros in FreeRTOS.h. Each hook records one entry into the
+ * trace ring with trace_record(), which never blocks or takes a lock, so the
+ * hooks are safe to run from the scheduler and from interrupts.
+ *
+ * The queue hooks read the queue's type, so they can only be expanded inside
+ * queue.c, which is the only place FreeRTOS uses them.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Records an entry into the scheduler trace, stamped with the time and the
+ * running task. See trace_event_e_t in pros/apix.h for what object and value
+ * hold for each event.
+ */
+void trace_record(uint8_t event, uint32_t object, uint32_t value);
+
+/**
+ * Copies the number and name of up to capacity tasks into numbers and names.
+ *
+ * \return The number of tasks copied, or 0 if there are more than capacity
+ * tasks or memory ran out
+ */
+uint32_t trace_get_task_names(uint16_t* numbers, char (*names)[configMAX_TASK_NAME_LEN], uint32_t capacity);
+
+/**
+ * Sends the number and name of every task on a serial stream, as frames
+ * starting with TRACE_FRAME_TASK_NAMES followed by trace_task_name_s_t.
+ *
+ * \return 1 if the names were sent, or PROS_ERR with errno set to ENOMEM or
+ * EIO
+ */
+int32_t trace_send_task_names(uint32_t stream_id);
+
+// These mirror trace_event_e_t in pros/apix.h, which can't be included here
+#define TRACE_TASK_SWITCHED_IN 0
+#define TRACE_TASK_SWITCHED_OUT 1
+#define TRACE_TASK_CREATE 2
+#define TRACE_TASK_DELETE 3
+#define TRACE_TASK_DELAY 4
+#define TRACE_PRIORITY_INHERIT 5
+#define TRACE_PRIORITY_DISINHERIT 6
+#define TRACE_QUEUE_BLOCK_RECEIVE 7
+#define TRACE_QUEUE_BLOCK_SEND 8
+#define TRACE_QUEUE_RECEIVE 9
+#define TRACE_QUEUE_SEND 10
+#define TRACE_QUEUE_RECEIVE_FROM_ISR 11
+#define TRACE_QUEUE_SEND_FROM_ISR 12
+#define TRACE_NOTIFY_FROM_ISR 13
+
+#define TRACE_QUEUE(event, queue) trace_record(event, (uint32_t)(uintptr_t)(queue), (queue)->ucQueueType)
+
+#define traceTASK_SWITCHED_IN() trace_record(TRACE_TASK_SWITCHED_IN, 0, 0)
+#define traceTASK_SWITCHED_OUT() trace_record(TRACE_TASK_SWITCHED_OUT, 0, 0)
+#define traceTASK_CREATE(pxNewTCB) trace_record(TRACE_TASK_CREATE, (pxNewTCB)->uxTCBNumber, (pxNewTCB)->uxPriority)
+#define traceTASK_DELETE(pxTaskToDelete) trace_record(TRACE_TASK_DELETE, (pxTaskToDelete)->uxTCBNumber, 0)
+#define traceTASK_DELAY() trace_record(TRACE_TASK_DELAY, 0, 0)
+#define traceTASK_DELAY_UNTIL(x) trace_record(TRACE_TASK_DELAY, 0, 0)
+#define traceTASK_PRIORITY_INHERIT(pxTCBOfMutexHolder, uxInheritedPriority) \
+	trace_record(TRACE_PRIORITY_INHERIT, (pxTCBOfMutexHolder)->uxTCBNumber, uxInheritedPriority)
+#define traceTASK_PRIORITY_DISINHERIT(pxTCBOfMutexHolder, uxOriginalPriority) \
+	trace_record(TRACE_PRIORITY_DISINHERIT, (pxTCBOfMutexHolder)->uxTCBNumber, uxOriginalPriority)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) TRACE_QUEUE(TRACE_QUEUE_BLOCK_RECEIVE, pxQueue)
+#define traceBLOCKING_ON_QUEUE_PEEK(pxQueue) TRACE_QUEUE(TRACE_QUEUE_BLOCK_RECEIVE, pxQueue)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue) TRACE_QUEUE(TRACE_QUEUE_BLOCK_SEND, pxQueue)
+#define traceQUEUE_RECEIVE(pxQueue) TRACE_QUEUE(TRACE_QUEUE_RECEIVE, pxQueue)
+#define traceQUEUE_SEND(pxQueue) TRACE_QUEUE(TRACE_QUEUE_SEND, pxQueue)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue) TRACE_QUEUE(TRACE_QUEUE_RECEIVE_FROM_ISR, pxQueue)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue) TRACE_QUEUE(TRACE_QUEUE_SEND_FROM_ISR, pxQueue)
+#define traceTASK_NOTIFY_FROM_ISR() trace_record(TRACE_NOTIFY_FROM_ISR, pxTCB->uxTCBNumber, 0)
+#define traceTASK_NOTIFY_GIVE_FROM_ISR() trace_record(TRACE_NOTIFY_FROM_ISR, pxTCB->uxTCBNumber, 0)
@@ -15,6 +15,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "vdml/registry.h"
 
 /**
@@ -195,6 +196,30 @@ void port_mutex_take_all();
  */
 void port_mutex_give_all();
 
+/**
+ * Claims a set of smart ports at once, so that no other task can operate on
+ * any of them until port_mutex_give_set().
+ *
+ * This takes each port's mutex in ascending port order, the order in which port
+ * mutexes are always taken together. The system daemon can't open its update
+ * window until the set is given back, so commands issued to the ports in
+ * between land in the same device frame.
+ *
+ * \param ports
+ *        A bitmap of the V5 ports (0-indexed) to claim
+ *
+ * \return The value to pass to port_mutex_give_set()
+ */
+uint32_t port_mutex_take_set(uint32_t ports);
+
+/**
+ * Gives back a set of smart ports claimed by port_mutex_take_set().
+ *
+ * \param claimed
+ *        The value returned by port_mutex_take_set()
+ */
+void port_mutex_give_set(uint32_t claimed);
+
 /**
  * Obtains a port mutex with bounds checking for V5_MAX_PORTS (32) not user
  * exposed device ports (20). Intended for internal usage for protecting
@@ -231,6 +256,118 @@ int internal_port_mutex_take(uint8_t port);
  */
 int internal_port_mutex_give(uint8_t port);
 
+/**
+ * Sequence counter for the system daemon's device update window.
+ *
+ * The counter is odd while the daemon is inside vexBackgroundProcessing() and
+ * even otherwise, so a reader can detect that data it copied may straddle a
+ * device frame by comparing the counter before and after the copy.
+ */
+extern volatile uint32_t vdml_update_seq;
+
+/**
+ * Opens the system daemon's device update window.
+ *
+ * Rather than taking every port mutex, this waits only on the ports that a
+ * task is currently operating on, then suspends the scheduler and marks the
+ * window as open. Tasks touching any other port are never blocked by the
+ * daemon. Like every other user of the port mutexes, the daemon only ever
+ * waits on them in ascending port order. Must be paired with
+ * vdml_update_window_close().
+ */
+void vdml_update_window_open();
+
+/**
+ * Closes the system daemon's device update window, resuming the scheduler and
+ * returning any port mutexes taken by vdml_update_window_open().
+ *
+ * The window only covers vexBackgroundProcessing(), so that the scheduler is
+ * suspended for as short a time as possible.
+ */
+void vdml_update_window_close();
+
+/**
+ * Publishes a telemetry snapshot for every registered device that supports
+ * them (currently motors), moves received bytes into the read buffers of
+ * generic serial ports, and then publishes the pose estimate if the odometry
+ * service is running. Finally, samples the controllers, publishing their
+ * snapshots and events.
+ *
+ * This is called by the system daemon right after the update window closes,
+ * with the scheduler running. Each device is published with its port mutex
+ * held. Device data only changes inside the window, so each snapshot still
+ * reflects exactly one device frame.
+ */
+void vdml_publish_snapshots();
+
+/**
+ * Copies the latest value out of a pair of slots that the system daemon
+ * publishes to, such as a motor's telemetry snapshots.
+ *
+ * The daemon writes slot [seq & 1] and then publishes seq with release
+ * ordering, so a reader copies the slot that seq points to and retries if seq
+ * moved on while it was copying. The daemon publishes at most once per device
+ * frame, so this can only retry if the reader is preempted for about a frame.
+ *
+ * \param seq
+ *        The sequence number of the latest published slot, or 0 if nothing has
+ *        been published yet
+ * \param slots
+ *        The two slots
+ * \param size
+ *        The size of each slot
+ * \param[out] out
+ *        Where to copy the latest slot
+ *
+ * \return True if a value was copied, or false if nothing has been published
+ */
+static inline bool vdml_snapshot_read(const uint32_t* seq, const void* slots, size_t size, void* out) {
+	uint32_t latest;
+	do {
+		latest = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+		if (latest == 0) {
+			return false;
+		}
+		memcpy(out, (const uint8_t*)slots + (latest & 1) * size, size);
+		// The copy must be finished before seq is checked again
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	} while (__atomic_load_n(seq, __ATOMIC_ACQUIRE) != latest);
+	return true;
+}
+
+/**
+ * Gets the slot that the system daemon writes the next value into, for a pair
+ * of slots read with vdml_snapshot_read().
+ *
+ * Readers that loaded the previous sequence number may still be copying this
+ * slot, so this issues a barrier first. Otherwise the stores to the slot could
+ * become visible before the last sequence number, and a reader would not see
+ * that its copy was torn.
+ *
+ * \param seq
+ *        The sequence number of the latest published slot
+ * \param slots
+ *        The two slots
+ * \param size
+ *        The size of each slot
+ *
+ * \return The slot to fill in before calling vdml_snapshot_publish()
+ */
+static inline void* vdml_snapshot_begin(const uint32_t* seq, void* slots, size_t size) {
+	__sync_synchronize();
+	return (uint8_t*)slots + ((*seq + 1) & 1) * size;
+}
+
+/**
+ * Publishes the slot returned by vdml_snapshot_begin() to readers.
+ *
+ * \param seq
+ *        The sequence number of the latest published slot
+ */
+static inline void vdml_snapshot_publish(uint32_t* seq) {
+	__atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
 #define V5_PORT_BATTERY 24
 #define V5_PORT_CONTROLLER_1 25
 #define V5_PORT_CONTROLLER_2 26
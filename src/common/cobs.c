@@ -16,7 +16,7 @@
 
 #include <string.h>
 
-#include "cobs.h"
+#include "common/cobs.h"
 
 size_t cobs_encode_measure(const uint8_t* restrict src, const size_t src_len, const uint32_t prefix) {
 	size_t read_idx = 0;
@@ -97,3 +97,58 @@ int cobs_encode(uint8_t* restrict dest, const uint8_t* restrict src, const size_
 
 	return write_idx;
 }
+
+// Writes byte to position idx of a destination split across first and second
+#define WRAPPED_AT(idx) (*((idx) < first_len ? &first[(idx)] : &second[(idx)-first_len]))
+
+size_t cobs_encode_wrapped(uint8_t* restrict first, const size_t first_len, uint8_t* restrict second,
+                           const uint8_t* restrict src, const size_t src_len, const uint32_t prefix) {
+	// Most of the time the output doesn't wrap, so use the straight-line encoder
+	if (COBS_ENCODE_MEASURE_MAX(src_len + sizeof(prefix)) <= first_len) {
+		return cobs_encode(first, src, src_len, prefix);
+	}
+
+	size_t read_idx = 0;
+	size_t write_idx = 1;
+	size_t code_idx = 0;
+	uint8_t code = 1;
+
+	uint8_t* prefix_bytes = (uint8_t*)&prefix;
+	for (read_idx = 0; read_idx < 4;) {
+		if (prefix_bytes[read_idx] == 0) {
+			WRAPPED_AT(code_idx) = code;
+			code = 1;
+			code_idx = write_idx++;
+			read_idx++;
+		} else {
+			WRAPPED_AT(write_idx) = prefix_bytes[read_idx++];
+			write_idx++;
+			code++;
+		}
+	}
+	read_idx = 0;
+
+	while (read_idx < src_len) {
+		if (src[read_idx] == 0) {
+			WRAPPED_AT(code_idx) = code;
+			code = 1;
+			code_idx = write_idx++;
+			read_idx++;
+		} else {
+			WRAPPED_AT(write_idx) = src[read_idx++];
+			write_idx++;
+			code++;
+			if (code == 0xff) {
+				WRAPPED_AT(code_idx) = code;
+				code = 1;
+				code_idx = write_idx++;
+			}
+		}
+	}
+
+	WRAPPED_AT(code_idx) = code;
+
+	return write_idx;
+}
+
+#undef WRAPPED_AT
@@ -23,19 +23,6 @@
 // From enum in misc.h
 #define NUM_BUTTONS 12
 
-typedef struct controller_data {
-	bool button_pressed[NUM_BUTTONS];
-} controller_data_s_t;
-
-bool get_button_pressed(int port, int button) {
-	return ((controller_data_s_t*)registry_get_device_internal(port)->pad)->button_pressed[button];
-}
-
-void set_button_pressed(int port, int button, bool state) {
-	controller_data_s_t* data = (controller_data_s_t*)registry_get_device_internal(port)->pad;
-	data->button_pressed[button] = state;
-}
-
 int32_t controller_is_connected(controller_id_e_t id) {
 	uint8_t port;
 	CONTROLLER_PORT_MUTEX_TAKE(id, port)
@@ -77,107 +64,438 @@ int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t butt
 	return rtn;
 }
 
-int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button) {
-	int32_t pressed = controller_get_digital(id, button);
-	uint8_t port;
-	CONTROLLER_PORT_MUTEX_TAKE(id, port)
-	uint8_t button_num = button - E_CONTROLLER_DIGITAL_L1;
+/**
+ * The system daemon samples both controllers once per cycle, publishes the
+ * sample as a snapshot, and turns the differences from the last sample into
+ * events for the subscribers. Snapshots are published like motor snapshots:
+ * the daemon writes snapshot [seq & 1] and then publishes seq.
+ */
+typedef struct controller_subscriber {
+	queue_t queue;  // NULL if the slot is free
+	controller_id_e_t id;
+	controller_event_filter_s_t filter;
+	task_t notify;     // A task to notify when events are queued, or NULL
+	uint32_t waiters;  // Tasks in controller_wait_event() and the daemon while it queues events, which keep
+	                   // the queue from being deleted
+	bool closing;      // Whether the subscriber is being removed
+	sem_t closed;      // Given when the last waiter leaves a closing subscriber
+} controller_subscriber_s_t;
+
+typedef struct controller_input {
+	controller_snapshot_s_t snapshots[2];
+	uint32_t seq;
+	controller_snapshot_s_t last;  // The last sample, for finding edges
+	uint16_t watched;              // Buttons that controller_get_digital_new_press() has been called for
+	uint16_t latched;              // Watched buttons pressed since their last controller_get_digital_new_press()
+} controller_input_s_t;
 
-	if (!pressed) {
-		set_button_pressed(port, button_num, false);
+static controller_input_s_t controller_inputs[2];
+static controller_subscriber_s_t controller_subscribers[CONTROLLER_MAX_SUBSCRIBERS];
+
+/**
+ * Stops waiting on a subscriber. If it is being removed, this wakes the next
+ * task waiting for its events, or lets controller_events_unsubscribe() free it
+ * if this was the last one. Must be called with the scheduler suspended.
+ */
+static void controller_subscriber_leave(controller_subscriber_s_t* subscriber) {
+	subscriber->waiters--;
+	if (!subscriber->closing) {
+		return;
 	}
-	if (pressed && !get_button_pressed(port, button_num)) {
-		// button is currently pressed and was not detected as being pressed during
-		// last check
-		set_button_pressed(port, button_num, true);
-		internal_port_mutex_give(port);
-		return true;
+	if (subscriber->waiters) {
+		controller_event_s_t wake = {0};
+		queue_append(subscriber->queue, &wake, 0);
 	} else {
+		sem_post(subscriber->closed);
+	}
+}
+
+static void controller_events_publish(controller_id_e_t id, const controller_snapshot_s_t* sample) {
+	const controller_snapshot_s_t* last = &controller_inputs[id].last;
+	uint16_t changed = sample->buttons ^ last->buttons;
+	for (int i = 0; i < CONTROLLER_MAX_SUBSCRIBERS; i++) {
+		controller_subscriber_s_t* subscriber = &controller_subscribers[i];
+		// Hold on to the subscriber like a waiting task does, so that it can't be
+		// removed while its events are queued with the scheduler running
+		rtos_suspend_all();
+		if (!subscriber->queue || subscriber->closing || subscriber->id != id) {
+			rtos_resume_all();
+			continue;
+		}
+		subscriber->waiters++;
+		rtos_resume_all();
+
+		uint32_t queued = queue_get_waiting(subscriber->queue);
+		controller_event_s_t event = {.timestamp = sample->timestamp, .controller = id};
+		uint16_t buttons = changed & subscriber->filter.buttons;
+		for (int b = 0; buttons; b++, buttons >>= 1) {
+			if (buttons & 1) {
+				event.type = (sample->buttons & (1 << b)) ? E_CONTROLLER_EVENT_PRESSED : E_CONTROLLER_EVENT_RELEASED;
+				event.channel = E_CONTROLLER_DIGITAL_L1 + b;
+				event.value = 0;
+				queue_append(subscriber->queue, &event, 0);
+			}
+		}
+		for (int a = 0; a < 4; a++) {
+			if (!(subscriber->filter.axes & (1 << a))) {
+				continue;
+			}
+			int8_t threshold = subscriber->filter.thresholds[a];
+			bool above = sample->analog[a] >= threshold;
+			if (above != (last->analog[a] >= threshold)) {
+				event.type = above ? E_CONTROLLER_EVENT_AXIS_RISE : E_CONTROLLER_EVENT_AXIS_FALL;
+				event.channel = a;
+				event.value = sample->analog[a];
+				queue_append(subscriber->queue, &event, 0);
+			}
+		}
+		bool notify = queue_get_waiting(subscriber->queue) != queued;
+
+		rtos_suspend_all();
+		if (notify && subscriber->notify) {
+			task_notify(subscriber->notify);
+		}
+		controller_subscriber_leave(subscriber);
+		rtos_resume_all();
+	}
+}
+
+void controller_input_update(void) {
+	uint32_t now = millis();
+	for (int id = 0; id < 2; id++) {
+		controller_input_s_t* input = &controller_inputs[id];
+		controller_snapshot_s_t sample = {.timestamp = now};
+		uint8_t port = id == E_CONTROLLER_MASTER ? V5_PORT_CONTROLLER_1 : V5_PORT_CONTROLLER_2;
+		internal_port_mutex_take(port);
+		sample.connected = vexControllerConnectionStatusGet(id) != 0;
+		if (sample.connected) {
+			for (int a = 0; a < 4; a++) {
+				sample.analog[a] = vexControllerGet(id, E_CONTROLLER_ANALOG_LEFT_X + a);
+			}
+			for (int b = 0; b < NUM_BUTTONS; b++) {
+				if (vexControllerGet(id, E_CONTROLLER_DIGITAL_L1 + b)) {
+					sample.buttons |= 1 << b;
+				}
+			}
+		}
+		input->latched |= sample.buttons & ~input->last.buttons & input->watched;
 		internal_port_mutex_give(port);
-		return false;  // button is not pressed or was already detected
+		controller_events_publish(id, &sample);
+
+		sample.sequence = input->seq + 1;
+		input->last = sample;
+		*(controller_snapshot_s_t*)vdml_snapshot_begin(&input->seq, input->snapshots, sizeof(sample)) = sample;
+		vdml_snapshot_publish(&input->seq);
 	}
 }
 
-int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str) {
+int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button) {
 	uint8_t port;
 	CONTROLLER_PORT_MUTEX_TAKE(id, port)
-	line++;
-	if (col >= CONTROLLER_MAX_COLS)
-		col = CONTROLLER_MAX_COLS;
-	else
-		col++;
-
-	char* buf = strndup(str, CONTROLLER_MAX_COLS + 1);
-
-	uint32_t rtn_val = vexControllerTextSet(id, line, col, buf);
-	free(buf);
+	controller_input_s_t* input = &controller_inputs[id];
+	uint16_t bit = CONTROLLER_BUTTON_BIT(button);
+	int32_t rtn;
+	if (input->watched & bit) {
+		// The daemon latches every press, so taps between two calls aren't missed
+		rtn = (input->latched & bit) != 0;
+	} else {
+		// Presses from before the first call don't count
+		input->watched |= bit;
+		rtn = vexControllerGet(id, button) != 0;
+	}
+	input->latched &= ~bit;
 	internal_port_mutex_give(port);
+	return rtn;
+}
 
-	if (!rtn_val) {
+int32_t controller_get_snapshot(controller_id_e_t id, controller_snapshot_s_t* const snapshot) {
+	if ((id != E_CONTROLLER_MASTER && id != E_CONTROLLER_PARTNER) || snapshot == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	controller_input_s_t* input = &controller_inputs[id];
+	if (!vdml_snapshot_read(&input->seq, input->snapshots, sizeof(*snapshot), snapshot)) {
 		errno = EAGAIN;
 		return PROS_ERR;
 	}
 	return 1;
 }
 
-int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) {
-	uint8_t port;
-	CONTROLLER_PORT_MUTEX_TAKE(id, port)
-	line++;
-	if (col >= CONTROLLER_MAX_COLS)
-		col = CONTROLLER_MAX_COLS;
-	else
-		col++;
+int32_t controller_events_subscribe(controller_id_e_t id, const controller_event_filter_s_t* const filter,
+                                    uint32_t queue_length) {
+	if ((id != E_CONTROLLER_MASTER && id != E_CONTROLLER_PARTNER) || filter == NULL || queue_length == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	queue_t queue = queue_create(queue_length, sizeof(controller_event_s_t));
+	sem_t closed = sem_create(1, 0);
+	if (queue == NULL || closed == NULL) {
+		if (queue) {
+			queue_delete(queue);
+		}
+		if (closed) {
+			sem_delete(closed);
+		}
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	// The subscribers are only changed with the scheduler suspended
+	rtos_suspend_all();
+	for (int i = 0; i < CONTROLLER_MAX_SUBSCRIBERS; i++) {
+		controller_subscriber_s_t* subscriber = &controller_subscribers[i];
+		if (!subscriber->queue) {
+			subscriber->id = id;
+			subscriber->filter = *filter;
+			subscriber->queue = queue;
+			subscriber->closed = closed;
+			rtos_resume_all();
+			return i;
+		}
+	}
+	rtos_resume_all();
+	queue_delete(queue);
+	sem_delete(closed);
+	errno = ENOMEM;
+	return PROS_ERR;
+}
 
-	va_list args;
-	va_start(args, fmt);
-	char* buf = (char*)malloc(CONTROLLER_MAX_COLS + 1);
-	vsnprintf(buf, CONTROLLER_MAX_COLS + 1, fmt, args);
+int32_t controller_events_unsubscribe(int32_t handle) {
+	if (handle < 0 || handle >= CONTROLLER_MAX_SUBSCRIBERS) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	controller_subscriber_s_t* subscriber = &controller_subscribers[handle];
+	rtos_suspend_all();
+	if (!subscriber->queue || subscriber->closing) {
+		rtos_resume_all();
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	// Stops the daemon from queueing events and new waits from starting
+	subscriber->closing = true;
+	bool busy = subscriber->waiters != 0;
+	rtos_resume_all();
 
-	uint32_t rtn_val = vexControllerTextSet(id, line, col, buf);
-	free(buf);
-	va_end(args);
+	// Wake the first task that is waiting for events. Each one wakes the next as
+	// it leaves, and the last one gives closed, so the queue is kept until
+	// nothing is using it.
+	if (busy) {
+		queue_reset(subscriber->queue);
+		controller_event_s_t wake = {0};
+		queue_append(subscriber->queue, &wake, 0);
+		sem_wait(subscriber->closed, TIMEOUT_MAX);
+	}
 
-	internal_port_mutex_give(port);
+	rtos_suspend_all();
+	queue_t queue = subscriber->queue;
+	sem_t closed = subscriber->closed;
+	subscriber->queue = NULL;
+	subscriber->closed = NULL;
+	subscriber->notify = NULL;
+	subscriber->closing = false;
+	rtos_resume_all();
+	queue_delete(queue);
+	sem_delete(closed);
+	return 1;
+}
+
+int32_t controller_events_notify(int32_t handle, task_t task) {
+	if (handle < 0 || handle >= CONTROLLER_MAX_SUBSCRIBERS) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	controller_subscriber_s_t* subscriber = &controller_subscribers[handle];
+	rtos_suspend_all();
+	if (!subscriber->queue || subscriber->closing) {
+		rtos_resume_all();
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	subscriber->notify = task;
+	rtos_resume_all();
+	return 1;
+}
 
-	if (!rtn_val) {
+int32_t controller_wait_event(int32_t handle, controller_event_s_t* const event, uint32_t timeout) {
+	if (handle < 0 || handle >= CONTROLLER_MAX_SUBSCRIBERS || event == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	controller_subscriber_s_t* subscriber = &controller_subscribers[handle];
+	rtos_suspend_all();
+	if (!subscriber->queue || subscriber->closing) {
+		rtos_resume_all();
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	subscriber->waiters++;
+	queue_t queue = subscriber->queue;
+	rtos_resume_all();
+
+	bool received = queue_recv(queue, event, timeout);
+
+	rtos_suspend_all();
+	bool closed = subscriber->closing;
+	controller_subscriber_leave(subscriber);
+	rtos_resume_all();
+	if (closed) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	if (!received) {
 		errno = EAGAIN;
 		return PROS_ERR;
 	}
 	return 1;
 }
 
-int32_t controller_clear_line(controller_id_e_t id, uint8_t line) {
+/**
+ * The controller screens are written by the system daemon rather than by the
+ * tasks that set the text. VEXos silently drops text updates that come faster
+ * than about one per CONTROLLER_TEXT_PERIOD, so user writes only change a
+ * framebuffer, and each period the daemon sends one changed line or rumble
+ * pattern, taking turns between the controllers and between the lines.
+ */
+#define CONTROLLER_TEXT_PERIOD 50
+#define CONTROLLER_MAX_LINES 3
+#define CONTROLLER_MAX_RUMBLE 8
+#define CONTROLLER_RUMBLE_QUEUE 4
+
+typedef struct controller_screen {
+	char lines[CONTROLLER_MAX_LINES][CONTROLLER_MAX_COLS + 1];  // Padded with spaces
+	uint8_t dirty;       // A bit for each line that has changed since it was sent
+	uint8_t next_line;   // The line to look at first in the next slot
+	bool connected;      // Whether the controller was connected during the last update
+	char rumble[CONTROLLER_RUMBLE_QUEUE][CONTROLLER_MAX_RUMBLE + 1];
+	uint8_t rumble_head;
+	uint8_t rumble_count;
+} controller_screen_s_t;
+
+static controller_screen_s_t controller_screens[2] = {
+    {.lines = {"                   ", "                   ", "                   "}},
+    {.lines = {"                   ", "                   ", "                   "}}};
+static uint32_t controller_next_slot;
+static uint8_t controller_next_id;
+
+// Sends the next pending update of a controller. Returns false if it had
+// nothing to send. An update that VEXos doesn't take stays pending, so it is
+// tried again in a later slot.
+static bool controller_screen_send(controller_id_e_t id) {
+	controller_screen_s_t* screen = &controller_screens[id];
+	if (screen->rumble_count) {
+		// Rumble patterns are sent as text on the line after the last
+		if (vexControllerTextSet(id, CONTROLLER_MAX_LINES + 1, 1, screen->rumble[screen->rumble_head])) {
+			screen->rumble_head = (screen->rumble_head + 1) % CONTROLLER_RUMBLE_QUEUE;
+			screen->rumble_count--;
+		}
+		return true;
+	}
+	for (int i = 0; i < CONTROLLER_MAX_LINES; i++) {
+		uint8_t line = (screen->next_line + i) % CONTROLLER_MAX_LINES;
+		if (!(screen->dirty & (1 << line))) {
+			continue;
+		}
+		// Whole lines are sent, so the text doesn't depend on what was there before
+		if (vexControllerTextSet(id, line + 1, 1, screen->lines[line])) {
+			screen->dirty &= ~(1 << line);
+		}
+		// Move on either way, so a line that VEXos keeps refusing doesn't hold
+		// up the others
+		screen->next_line = (line + 1) % CONTROLLER_MAX_LINES;
+		return true;
+	}
+	return false;
+}
+
+void controller_screen_update(void) {
+	uint32_t now = millis();
+	bool due = (int32_t)(now - controller_next_slot) >= 0;
+	bool sent = false;
+	for (int i = 0; i < 2; i++) {
+		uint8_t id = (controller_next_id + i) % 2;
+		uint8_t port = id == E_CONTROLLER_MASTER ? V5_PORT_CONTROLLER_1 : V5_PORT_CONTROLLER_2;
+		controller_screen_s_t* screen = &controller_screens[id];
+		// The screens are written with the controller's port held
+		internal_port_mutex_take(port);
+		bool connected = vexControllerConnectionStatusGet(id) != 0;
+		if (connected && !screen->connected) {
+			// The controller forgets its screen when it disconnects
+			screen->dirty = (1 << CONTROLLER_MAX_LINES) - 1;
+		}
+		screen->connected = connected;
+		// The slot is used up by any attempt, since VEXos drops updates that come
+		// too quickly whether or not it takes this one
+		if (due && !sent && connected && controller_screen_send(id)) {
+			sent = true;
+			controller_next_id = (id + 1) % 2;
+			controller_next_slot = now + CONTROLLER_TEXT_PERIOD;
+		}
+		internal_port_mutex_give(port);
+	}
+}
+
+static int32_t controller_screen_write(controller_id_e_t id, uint8_t line, uint8_t col, const char* str) {
 	uint8_t port;
-	CONTROLLER_PORT_MUTEX_TAKE(id, port);
-	int32_t rtn;
-	if (vexSystemVersion() >= 0x1000C38) {
-		static char* clear = "";
-		rtn = vexControllerTextSet(id, ++line, 1, clear);
-	} else {
-		static char* clear = "                   ";
-		kassert(strlen(clear) == CONTROLLER_MAX_COLS);
-		rtn = vexControllerTextSet(id, ++line, 1, clear);
+	CONTROLLER_PORT_MUTEX_TAKE(id, port)
+	if (line >= CONTROLLER_MAX_LINES) {
+		internal_port_mutex_give(port);
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	controller_screen_s_t* screen = &controller_screens[id];
+	if (col < CONTROLLER_MAX_COLS) {
+		size_t len = strnlen(str, CONTROLLER_MAX_COLS - col);
+		if (memcmp(&screen->lines[line][col], str, len)) {
+			memcpy(&screen->lines[line][col], str, len);
+			screen->dirty |= 1 << line;
+		}
 	}
 	internal_port_mutex_give(port);
-	return rtn;
+	return 1;
+}
+
+int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str) {
+	return controller_screen_write(id, line, col, str);
+}
+
+int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) {
+	char buf[CONTROLLER_MAX_COLS + 1];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(buf, sizeof(buf), fmt, args);
+	va_end(args);
+	return controller_screen_write(id, line, col, buf);
+}
+
+int32_t controller_clear_line(controller_id_e_t id, uint8_t line) {
+	static const char clear[] = "                   ";
+	kassert(strlen(clear) == CONTROLLER_MAX_COLS);
+	return controller_screen_write(id, line, 0, clear);
 }
 
 int32_t controller_clear(controller_id_e_t id) {
-	if (vexSystemVersion() > 0x01000000) {
-		return controller_print(id, -1, 0, "");
-	} else {
-		for (int i = 0; i < 3; i++) {
-			int32_t rtn = controller_clear_line(id, i);
-			if (rtn == PROS_ERR) return PROS_ERR;
-			if (i != 2) delay(55);
-		}
-		return 1;
+	for (int i = 0; i < CONTROLLER_MAX_LINES; i++) {
+		int32_t rtn = controller_clear_line(id, i);
+		if (rtn == PROS_ERR) return PROS_ERR;
 	}
+	return 1;
 }
 
 int32_t controller_rumble(controller_id_e_t id, const char* rumble_pattern) {
-	return controller_set_text(id, 3, 0, rumble_pattern);
+	uint8_t port;
+	CONTROLLER_PORT_MUTEX_TAKE(id, port)
+	controller_screen_s_t* screen = &controller_screens[id];
+	if (screen->rumble_count == CONTROLLER_RUMBLE_QUEUE) {
+		internal_port_mutex_give(port);
+		errno = EAGAIN;
+		return PROS_ERR;
+	}
+	char* slot = screen->rumble[(screen->rumble_head + screen->rumble_count) % CONTROLLER_RUMBLE_QUEUE];
+	strncpy(slot, rumble_pattern, CONTROLLER_MAX_RUMBLE);
+	slot[CONTROLLER_MAX_RUMBLE] = '\0';
+	screen->rumble_count++;
+	internal_port_mutex_give(port);
+	return 1;
 }
 
 uint8_t competition_get_status(void) {
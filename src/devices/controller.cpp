@@ -12,6 +12,8 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <new>
+
 #include "kapi.h"
 
 namespace pros {
@@ -43,6 +45,117 @@ std::int32_t Controller::get_digital_new_press(pros::controller_digital_e_t butt
 	return controller_get_digital_new_press(_id, button);
 }
 
+std::int32_t Controller::get_snapshot(controller_snapshot_s_t* snapshot) {
+	return controller_get_snapshot(_id, snapshot);
+}
+
+/**
+ * The functions registered with on_event() and on_press() are called by one
+ * dispatcher task, which the system daemon notifies whenever it queues events
+ * for their subscribers. callbacks is indexed by subscriber handle and, like
+ * running, is only accessed with the scheduler suspended. A function that is
+ * removed while the dispatcher is running it is deleted by the dispatcher.
+ */
+using EventCallback = std::function<void(const controller_event_s_t&)>;
+
+static EventCallback* callbacks[CONTROLLER_MAX_SUBSCRIBERS];
+static std::int32_t running = -1;
+static task_t dispatcher = nullptr;
+
+static void dispatch(void* ign) {
+	while (true) {
+		task_notify_take(true, TIMEOUT_MAX);
+		for (std::int32_t handle = 0; handle < CONTROLLER_MAX_SUBSCRIBERS; handle++) {
+			while (true) {
+				rtos_suspend_all();
+				EventCallback* callback = callbacks[handle];
+				controller_event_s_t event;
+				// Only read the subscribers that have a callback, since the others
+				// belong to tasks waiting with controller_wait_event()
+				if (callback == nullptr || controller_wait_event(handle, &event, 0) != 1) {
+					rtos_resume_all();
+					break;
+				}
+				running = handle;
+				rtos_resume_all();
+
+				(*callback)(event);
+
+				rtos_suspend_all();
+				running = -1;
+				bool removed = callbacks[handle] != callback;
+				rtos_resume_all();
+				if (removed) {
+					delete callback;
+				}
+			}
+		}
+	}
+}
+
+std::int32_t Controller::on_event(const controller_event_filter_s_t& filter, EventCallback callback,
+                                  std::uint32_t queue_length) {
+	rtos_suspend_all();
+	if (dispatcher == nullptr) {
+		dispatcher = task_create(dispatch, nullptr, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT,
+		                         "Controller Events");
+	}
+	task_t task = dispatcher;
+	rtos_resume_all();
+	if (task == nullptr) {
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	EventCallback* copy = new (std::nothrow) EventCallback(std::move(callback));
+	if (copy == nullptr) {
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	std::int32_t handle = controller_events_subscribe(_id, &filter, queue_length);
+	if (handle == PROS_ERR) {
+		delete copy;
+		return PROS_ERR;
+	}
+	rtos_suspend_all();
+	callbacks[handle] = copy;
+	rtos_resume_all();
+	controller_events_notify(handle, task);
+	// Events may have been queued before the dispatcher was notified about them
+	task_notify(task);
+	return handle;
+}
+
+std::int32_t Controller::on_press(controller_digital_e_t button, std::function<void()> callback) {
+	controller_event_filter_s_t filter = {};
+	filter.buttons = CONTROLLER_BUTTON_BIT(button);
+	return on_event(filter, [callback = std::move(callback)](const controller_event_s_t& event) {
+		if (event.type == E_CONTROLLER_EVENT_PRESSED) {
+			callback();
+		}
+	});
+}
+
+std::int32_t Controller::unsubscribe(std::int32_t handle) {
+	if (handle < 0 || handle >= CONTROLLER_MAX_SUBSCRIBERS) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	rtos_suspend_all();
+	EventCallback* callback = callbacks[handle];
+	callbacks[handle] = nullptr;
+	bool in_use = running == handle;
+	rtos_resume_all();
+	if (callback == nullptr) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	controller_events_unsubscribe(handle);
+	if (!in_use) {
+		delete callback;
+	}
+	return 1;
+}
+
 std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str) {
 	return controller_set_text(_id, line, col, str);
 }
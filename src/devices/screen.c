@@ -16,7 +16,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
-#include <sys/_stdint.h>
+#include <stdint.h>
 
 #include "common/linkedlist.h"
 #include "kapi.h"
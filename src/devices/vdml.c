@@ -28,6 +28,13 @@ int32_t port_errors;
 
 extern void registry_init();
 extern void port_mutex_init();
+extern void odometry_init(void);
+extern void motor_snapshot_publish(uint8_t port, v5_smart_device_s_t* device);
+extern void ext_adi_calibration_update(uint8_t port, v5_smart_device_s_t* device);
+extern void imu_stream_update(uint8_t port, v5_smart_device_s_t* device);
+extern void serial_buffer_update(uint8_t port, v5_smart_device_s_t* device);
+extern void odometry_update(void);
+extern void controller_input_update(void);
 
 int32_t claim_port_try(uint8_t port, v5_device_e_t type) {
 	if (!VALIDATE_PORT_NO(port)) {
@@ -52,12 +59,22 @@ int32_t claim_port_try(uint8_t port, v5_device_e_t type) {
 mutex_t port_mutexes[V5_MAX_DEVICE_PORTS];            // Mutexes for each port
 static_sem_s_t port_mutex_bufs[V5_MAX_DEVICE_PORTS];  // Stack mem for rtos
 
+/**
+ * Sequence counter for the system daemon's device update window. It is odd
+ * while vexBackgroundProcessing() is refreshing device data and even otherwise.
+ */
+volatile uint32_t vdml_update_seq;
+
+// Bitmap of the ports that the daemon had to wait on for the current window
+static uint32_t drained_ports;
+
 /**
  * Shorcut to initialize all of VDML (mutexes and register)
  */
 void vdml_initialize() {
 	port_mutex_init();
 	registry_init();
+	odometry_init();
 }
 
 /**
@@ -112,6 +129,23 @@ int internal_port_mutex_give(uint8_t port) {
 	return mutex_give(port_mutexes[port]);
 }
 
+uint32_t port_mutex_take_set(uint32_t ports) {
+	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		if (ports & (1U << i)) {
+			port_mutex_take(i);
+		}
+	}
+	return ports;
+}
+
+void port_mutex_give_set(uint32_t claimed) {
+	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		if (claimed & (1U << i)) {
+			port_mutex_give(i);
+		}
+	}
+}
+
 void port_mutex_take_all() {
 	for (int i = 0; i < V5_MAX_DEVICE_PORTS; i++) {
 		port_mutex_take(i);
@@ -124,6 +158,95 @@ void port_mutex_give_all() {
 	}
 }
 
+static void release_drained_ports() {
+	for (int i = 0; i < V5_MAX_DEVICE_PORTS; i++) {
+		if (drained_ports & (1U << i)) {
+			mutex_give(port_mutexes[i]);
+		}
+	}
+	drained_ports = 0;
+}
+
+void vdml_update_window_open() {
+	drained_ports = 0;
+	while (1) {
+		rtos_suspend_all();
+		int held = -1;
+		for (int i = 0; i < V5_MAX_DEVICE_PORTS; i++) {
+			if (!(drained_ports & (1U << i)) && mutex_get_owner(port_mutexes[i]) != NULL) {
+				held = i;
+				break;
+			}
+		}
+		if (held < 0) {
+			break;
+		}
+		rtos_resume_all();
+		// Port mutexes are always taken in ascending order, so if a port above
+		// this one has already been drained, waiting here could deadlock with a
+		// task that holds this port and wants that one. Give everything back and
+		// start over from the lowest busy port.
+		if (drained_ports >> held) {
+			release_drained_ports();
+			continue;
+		}
+		// A task is in the middle of talking to this port. Wait for it to finish
+		// (it inherits our priority while we wait) and keep the port until the
+		// window closes so it can't start another operation mid-update
+		mutex_take(port_mutexes[held], TIMEOUT_MAX);
+		drained_ports |= 1U << held;
+	}
+	vdml_update_seq++;
+}
+
+void vdml_update_window_close() {
+	vdml_update_seq++;
+	rtos_resume_all();
+	release_drained_ports();
+}
+
+// Publishes what the daemon keeps for a device, if it keeps anything for it
+static void publish_device(uint8_t port, v5_smart_device_s_t* device) {
+	switch (device->device_type) {
+		case E_DEVICE_MOTOR:
+			motor_snapshot_publish(port, device);
+			break;
+		case E_DEVICE_ADI:
+			ext_adi_calibration_update(port, device);
+			break;
+		case E_DEVICE_IMU:
+			imu_stream_update(port, device);
+			break;
+		case E_DEVICE_SERIAL:
+			serial_buffer_update(port, device);
+			break;
+		default:
+			break;
+	}
+}
+
+void vdml_publish_snapshots() {
+	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		v5_smart_device_s_t* device = registry_get_device(i);
+		switch (device->device_type) {
+			case E_DEVICE_MOTOR:
+			case E_DEVICE_ADI:
+			case E_DEVICE_IMU:
+			case E_DEVICE_SERIAL:
+				// publish_device() checks the type again, since the port may have
+				// been reconfigured before it was taken
+				mutex_take(port_mutexes[i], TIMEOUT_MAX);
+				publish_device(i, device);
+				mutex_give(port_mutexes[i]);
+				break;
+			default:
+				break;
+		}
+	}
+	odometry_update();
+	controller_input_update();
+}
+
 void vdml_set_port_error(uint8_t port) {
 	if (VALIDATE_PORT_NO(port)) {
 		port_errors |= (1 << port);
@@ -177,7 +300,10 @@ void vdml_background_processing() {
 	int num_errors = 0;
 	int mismatch_errors = 0;
 	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		// Validation may bind the port, so only this port needs to be locked
+		port_mutex_take(i);
 		error_arr[i] = registry_validate_binding(i, E_DEVICE_NONE);
+		port_mutex_give(i);
 		if (error_arr[i] != 0) num_errors++;
 		if (error_arr[i] == 2) mismatch_errors++;
 	}
@@ -34,6 +34,14 @@ int32_t adi_analog_calibrate(uint8_t port) {
 	return ext_adi_analog_calibrate(INTERNAL_ADI_PORT, port);
 }
 
+int32_t adi_analog_calibrate_async(uint8_t port) {
+	return ext_adi_analog_calibrate_async(INTERNAL_ADI_PORT, port);
+}
+
+int32_t adi_analog_calibrate_wait(uint8_t port, uint32_t timeout) {
+	return ext_adi_analog_calibrate_wait(INTERNAL_ADI_PORT, port, timeout);
+}
+
 int32_t adi_analog_read(uint8_t port) {
 	return ext_adi_analog_read(INTERNAL_ADI_PORT, port);
 }
@@ -53,6 +53,14 @@ std::int32_t ADIAnalogIn::calibrate() const {
 	return ext_adi_analog_calibrate(_smart_port, _adi_port);
 }
 
+std::int32_t ADIAnalogIn::calibrate_async() const {
+	return ext_adi_analog_calibrate_async(_smart_port, _adi_port);
+}
+
+std::int32_t ADIAnalogIn::calibrate_wait(std::uint32_t timeout) const {
+	return ext_adi_analog_calibrate_wait(_smart_port, _adi_port, timeout);
+}
+
 std::int32_t ADIAnalogIn::get_value_calibrated() const {
 	return ext_adi_analog_read_calibrated(_smart_port, _adi_port);
 }
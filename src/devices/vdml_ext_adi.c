@@ -43,9 +43,17 @@ extern "C" {
 }
 #endif
 
+// The number of ADI updates that a calibration averages. The ADI ports are
+// updated every 10 ms, so this is half a second.
+#define ADI_CALIBRATION_SAMPLES 50
+// How often a task waiting on a calibration checks whether it has finished
+#define ADI_CALIBRATION_POLL 10
+
 typedef union adi_data {
 	struct {
 		int32_t calib;
+		uint32_t total;    // sum of the samples of the calibration in progress
+		uint16_t samples;  // number of samples in total
 	} analog_data;
 	struct {
 		bool was_pressed;
@@ -62,6 +70,15 @@ typedef union adi_data {
 	} gyro_data;
 } adi_data_s_t;
 
+// Bitmaps of the ADI ports of each smart port that are being calibrated by the
+// system daemon, and of those that have finished a calibration. Both are only
+// changed while holding the smart port or by the daemon, which runs while no
+// task holds the port.
+static uint8_t adi_calibrating[NUM_V5_PORTS];
+static uint8_t adi_calibrated[NUM_V5_PORTS];
+// The timestamp of the last ADI update that was sampled for each smart port
+static uint32_t adi_calibration_frame[NUM_V5_PORTS];
+
 #define transform_adi_port(port)       \
 	if (port >= 'a' && port <= 'h')      \
 		port -= 'a';                       \
@@ -151,18 +168,77 @@ int32_t ext_adi_port_set_value(uint8_t smart_port, uint8_t adi_port, int32_t val
 }
 
 int32_t ext_adi_analog_calibrate(uint8_t smart_port, uint8_t adi_port) {
+	if (ext_adi_analog_calibrate_async(smart_port, adi_port) == PROS_ERR) {
+		return PROS_ERR;
+	}
+	return ext_adi_analog_calibrate_wait(smart_port, adi_port, TIMEOUT_MAX);
+}
+
+int32_t ext_adi_analog_calibrate_async(uint8_t smart_port, uint8_t adi_port) {
 	transform_adi_port(adi_port);
 	claim_port_i(smart_port - 1, E_DEVICE_ADI);
 	validate_type(device, adi_port, smart_port - 1, E_ADI_ANALOG_IN);
-	uint32_t total = 0;
-	for (uint32_t i = 0; i < 512; i++) {
-		total += vexDeviceAdiValueGet(device->device_info, adi_port);
-		task_delay(1);  // TODO: If smart ports (and the ADI) only update every 10ms, this really only reads 56 samples,
-		                // maybe change to a 10ms
-	}
 	adi_data_s_t* const adi_data = &((adi_data_s_t*)(device->pad))[adi_port];
-	adi_data->analog_data.calib = (int32_t)((total + 16) >> 5);
-	return_port(smart_port - 1, (int32_t)((total + 256) >> 9));
+	adi_data->analog_data.total = 0;
+	adi_data->analog_data.samples = 0;
+	adi_calibrated[smart_port - 1] &= ~(1 << adi_port);
+	adi_calibrating[smart_port - 1] |= 1 << adi_port;
+	return_port(smart_port - 1, 1);
+}
+
+int32_t ext_adi_analog_calibrate_wait(uint8_t smart_port, uint8_t adi_port, uint32_t timeout) {
+	transform_adi_port(adi_port);
+	const uint32_t start = millis();
+	while (1) {
+		claim_port_i(smart_port - 1, E_DEVICE_ADI);
+		if (adi_calibrated[smart_port - 1] & (1 << adi_port)) {
+			adi_data_s_t* const adi_data = &((adi_data_s_t*)(device->pad))[adi_port];
+			return_port(smart_port - 1, (adi_data->analog_data.calib + 8) >> 4);
+		}
+		if (!(adi_calibrating[smart_port - 1] & (1 << adi_port))) {
+			errno = EINVAL;
+			return_port(smart_port - 1, PROS_ERR);
+		}
+		port_mutex_give(smart_port - 1);
+
+		if (timeout != TIMEOUT_MAX && millis() - start >= timeout) {
+			errno = EAGAIN;
+			return PROS_ERR;
+		}
+		task_delay(ADI_CALIBRATION_POLL);
+	}
+}
+
+void ext_adi_calibration_update(uint8_t port, v5_smart_device_s_t* device) {
+	if (!adi_calibrating[port]) {
+		return;
+	}
+	// Only take one sample from each update of the ADI
+	uint32_t frame = vexDeviceGetTimestamp(device->device_info);
+	if (frame == adi_calibration_frame[port]) {
+		return;
+	}
+	adi_calibration_frame[port] = frame;
+
+	for (uint8_t adi_port = 0; adi_port < 8; adi_port++) {
+		if (!(adi_calibrating[port] & (1 << adi_port))) {
+			continue;
+		}
+		if ((adi_port_config_e_t)vexDeviceAdiPortConfigGet(device->device_info, adi_port) != E_ADI_ANALOG_IN) {
+			// The port was reconfigured, so the calibration can't finish
+			adi_calibrating[port] &= ~(1 << adi_port);
+			continue;
+		}
+		adi_data_s_t* const adi_data = &((adi_data_s_t*)(device->pad))[adi_port];
+		adi_data->analog_data.total += vexDeviceAdiValueGet(device->device_info, adi_port);
+		if (++adi_data->analog_data.samples == ADI_CALIBRATION_SAMPLES) {
+			// The calibration value keeps 4 extra bits for the HR reads
+			adi_data->analog_data.calib =
+			    (int32_t)(((adi_data->analog_data.total << 4) + ADI_CALIBRATION_SAMPLES / 2) / ADI_CALIBRATION_SAMPLES);
+			adi_calibrating[port] &= ~(1 << adi_port);
+			adi_calibrated[port] |= 1 << adi_port;
+		}
+	}
 }
 
 int32_t ext_adi_analog_read(uint8_t smart_port, uint8_t adi_port) {
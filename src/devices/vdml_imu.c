@@ -11,6 +11,7 @@
  */
 
 #include <errno.h>
+#include "kapi.h"
 #include "pros/imu.h"
 #include "v5_api.h"
 #include "vdml/registry.h"
@@ -29,6 +30,10 @@
 
 #define IMU_RESET_FLAG_SET_TIMEOUT 1000
 #define IMU_RESET_TIMEOUT 3000 // Canonically this should be 2s, but 3s for good margin
+// How many times imu_read_samples() tries to copy a sample before giving up. A
+// copy only fails if the daemon overwrites the sample meanwhile, which takes the
+// reader being preempted for about a whole buffer's worth of device frames.
+#define IMU_STREAM_READ_ATTEMPTS 4
 
 typedef struct __attribute__ ((packed)) imu_reset_data { 
 	double heading_offset;
@@ -38,6 +43,131 @@ typedef struct __attribute__ ((packed)) imu_reset_data {
 	double roll_offset;
 } imu_data_s_t;
 
+// Samples recorded by the system daemon for a streaming IMU. The latest sample
+// is published in a pair of slots like motor snapshots. The history slot of a
+// sample is its sequence number modulo depth, and a history slot's sequence
+// field is 0 while it is being written, so readers can tell a torn copy apart.
+typedef struct imu_stream {
+	bool enabled;
+	uint32_t depth;
+	uint32_t last_timestamp;  // device timestamp of the latest sample
+	uint32_t sequence;        // sequence number of the latest sample, 0 if none
+	imu_sample_s_t latest[2];
+	imu_sample_s_t samples[];
+} imu_stream_s_t;
+
+// Allocated the first time that each port is streamed and never freed, since
+// readers use them without holding the port
+static imu_stream_s_t* imu_streams[NUM_V5_PORTS];
+
+// Reads the sensor once and works out everything that goes into a sample
+static void imu_sample_read(v5_smart_device_s_t* device, imu_sample_s_t* sample) {
+	imu_data_s_t* data = (imu_data_s_t*)device->pad;
+	euler_s_t euler;
+	vexDeviceImuAttitudeGet(device->device_info, (V5_DeviceImuAttitude*)&euler);
+
+	sample->status = vexDeviceImuStatusGet(device->device_info);
+	sample->rotation = vexDeviceImuHeadingGet(device->device_info) + data->rotation_offset;
+	sample->heading = fmod(vexDeviceImuDegreesGet(device->device_info) + data->heading_offset + IMU_HEADING_MAX,
+	                       (double)IMU_HEADING_MAX);
+	sample->euler.pitch = fmod(euler.pitch + data->pitch_offset, 2.0 * IMU_EULER_LIMIT);
+	sample->euler.roll = fmod(euler.roll + data->roll_offset, 2.0 * IMU_EULER_LIMIT);
+	sample->euler.yaw = fmod(euler.yaw + data->yaw_offset, 2.0 * IMU_EULER_LIMIT);
+
+	double cy = cos(DEGTORAD * sample->euler.yaw * 0.5);
+	double sy = sin(DEGTORAD * sample->euler.yaw * 0.5);
+	double cp = cos(DEGTORAD * sample->euler.pitch * 0.5);
+	double sp = sin(DEGTORAD * sample->euler.pitch * 0.5);
+	double cr = cos(DEGTORAD * sample->euler.roll * 0.5);
+	double sr = sin(DEGTORAD * sample->euler.roll * 0.5);
+	sample->quaternion.w = cr * cp * cy + sr * sp * sy;
+	sample->quaternion.x = sr * cp * cy - cr * sp * sy;
+	sample->quaternion.y = cr * sp * cy + sr * cp * sy;
+	sample->quaternion.z = cr * cp * sy - sr * sp * cy;
+
+	// See imu_get_gyro_rate() for why these go through a quaternion
+	quaternion_s_t raw;
+	vexDeviceImuRawGyroGet(device->device_info, (V5_DeviceImuRaw*)&raw);
+	sample->gyro = (imu_gyro_s_t){.x = raw.x, .y = raw.y, .z = raw.z};
+	vexDeviceImuRawAccelGet(device->device_info, (V5_DeviceImuRaw*)&raw);
+	sample->accel = (imu_accel_s_t){.x = raw.x, .y = raw.y, .z = raw.z};
+}
+
+// Appends a sample to the port's stream. Only one task may record at a time,
+// which holds because the daemon, the offset setters and imu_stream_enable()
+// all record with the port held.
+static void imu_stream_record(uint8_t port, v5_smart_device_s_t* device, uint32_t timestamp) {
+	imu_stream_s_t* stream = imu_streams[port];
+	uint32_t seq = stream->sequence + 1;
+	imu_sample_s_t* latest = vdml_snapshot_begin(&stream->sequence, stream->latest, sizeof(imu_sample_s_t));
+	imu_sample_read(device, latest);
+	latest->timestamp = timestamp;
+	// Copied into the history with the sequence field still 0, which marks the
+	// history slot as being written until the real number is stored
+	latest->sequence = 0;
+
+	imu_sample_s_t* sample = &stream->samples[seq % stream->depth];
+	__atomic_store_n(&sample->sequence, 0, __ATOMIC_RELAXED);
+	__sync_synchronize();
+	*sample = *latest;
+	__atomic_store_n(&sample->sequence, seq, __ATOMIC_RELEASE);
+
+	latest->sequence = seq;
+	stream->last_timestamp = timestamp;
+	vdml_snapshot_publish(&stream->sequence);
+}
+
+void imu_stream_update(uint8_t port, v5_smart_device_s_t* device) {
+	imu_stream_s_t* stream = imu_streams[port];
+	if (stream == NULL || !stream->enabled) {
+		return;
+	}
+	uint32_t timestamp = vexDeviceGetTimestamp(device->device_info);
+	if (timestamp != stream->last_timestamp) {
+		imu_stream_record(port, device, timestamp);
+	}
+}
+
+// The offsets have changed, so record the current sample again with the new
+// offsets for the getters to use. The port must be held.
+static void imu_stream_offsets_changed(uint8_t port, v5_smart_device_s_t* device) {
+	imu_stream_s_t* stream = imu_streams[port];
+	if (stream != NULL && stream->enabled) {
+		imu_stream_record(port, device, stream->last_timestamp);
+	}
+}
+
+// Copies sample seq out of the stream's history. Returns false if the daemon
+// overwrote it before or during the copy.
+static bool imu_stream_copy(imu_stream_s_t* stream, uint32_t seq, imu_sample_s_t* out) {
+	imu_sample_s_t* sample = &stream->samples[seq % stream->depth];
+	if (__atomic_load_n(&sample->sequence, __ATOMIC_ACQUIRE) != seq) {
+		return false;
+	}
+	*out = *sample;
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&sample->sequence, __ATOMIC_ACQUIRE) == seq;
+}
+
+// Copies the latest sample out of the stream. Returns false if nothing has
+// been recorded yet.
+static bool imu_stream_copy_latest(imu_stream_s_t* stream, imu_sample_s_t* out) {
+	return vdml_snapshot_read(&stream->sequence, stream->latest, sizeof(*out), out);
+}
+
+// Gets the latest sample if the port is streaming
+static bool imu_stream_latest(uint8_t port, imu_sample_s_t* out) {
+	imu_stream_s_t* stream = imu_streams[port];
+	return stream != NULL && stream->enabled && imu_stream_copy_latest(stream, out);
+}
+
+// Gets the latest sample for the attitude getters, which fall back to reading
+// the sensor when this returns false
+static bool imu_get_streamed(uint8_t port, imu_sample_s_t* out) {
+	return VALIDATE_PORT_NO(port - 1) && imu_streams[port - 1] != NULL &&
+	       registry_validate_binding(port - 1, E_DEVICE_IMU) == 0 && imu_stream_latest(port - 1, out);
+}
+
 int32_t imu_reset(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_IMU);
 	ERROR_IMU_STILL_CALIBRATING(port, device, PROS_ERR);
@@ -116,6 +246,14 @@ int32_t imu_set_data_rate(uint8_t port, uint32_t rate) {
 }
 
 double imu_get_rotation(uint8_t port) {
+	imu_sample_s_t sample;
+	if (imu_get_streamed(port, &sample)) {
+		if (sample.status & E_IMU_STATUS_CALIBRATING) {
+			errno = EAGAIN;
+			return PROS_ERR_F;
+		}
+		return sample.rotation;
+	}
 	claim_port_f(port - 1, E_DEVICE_IMU);
 	ERROR_IMU_STILL_CALIBRATING(port, device, PROS_ERR_F);
 	double rtn = vexDeviceImuHeadingGet(device->device_info) + ((imu_data_s_t*)registry_get_device(port - 1)->pad)->rotation_offset;
@@ -123,6 +261,14 @@ double imu_get_rotation(uint8_t port) {
 }
 
 double imu_get_heading(uint8_t port) {
+	imu_sample_s_t sample;
+	if (imu_get_streamed(port, &sample)) {
+		if (sample.status & E_IMU_STATUS_CALIBRATING) {
+			errno = EAGAIN;
+			return PROS_ERR_F;
+		}
+		return sample.heading;
+	}
 	claim_port_f(port - 1, E_DEVICE_IMU);
 	ERROR_IMU_STILL_CALIBRATING(port, device, PROS_ERR_F);
 	double rtn = vexDeviceImuDegreesGet(device->device_info) + ((imu_data_s_t*)registry_get_device(port - 1)->pad)->heading_offset;
@@ -135,6 +281,14 @@ double imu_get_heading(uint8_t port) {
 
 quaternion_s_t imu_get_quaternion(uint8_t port) {
 	quaternion_s_t rtn = QUATERNION_ERR_INIT;
+	imu_sample_s_t sample;
+	if (imu_get_streamed(port, &sample)) {
+		if (sample.status & E_IMU_STATUS_CALIBRATING) {
+			errno = EAGAIN;
+			return rtn;
+		}
+		return sample.quaternion;
+	}
 	if (!claim_port_try(port - 1, E_DEVICE_IMU)) {
 		return rtn;
 	}
@@ -169,6 +323,14 @@ quaternion_s_t imu_get_quaternion(uint8_t port) {
 
 euler_s_t imu_get_euler(uint8_t port) {
 	euler_s_t rtn = ATTITUDE_ERR_INIT;
+	imu_sample_s_t sample;
+	if (imu_get_streamed(port, &sample)) {
+		if (sample.status & E_IMU_STATUS_CALIBRATING) {
+			errno = EAGAIN;
+			return rtn;
+		}
+		return sample.euler;
+	}
 	if (!claim_port_try(port - 1, E_DEVICE_IMU)) {
 		return rtn;
 	}
@@ -187,6 +349,10 @@ euler_s_t imu_get_euler(uint8_t port) {
 
 double imu_get_pitch(uint8_t port) {
 	double rtn = PROS_ERR_F;
+	imu_sample_s_t sample;
+	if (imu_get_streamed(port, &sample)) {
+		return sample.euler.pitch;
+	}
 	if (!claim_port_try(port - 1, E_DEVICE_IMU)) {
 		return rtn;
 	}
@@ -200,6 +366,10 @@ double imu_get_pitch(uint8_t port) {
 
 double imu_get_roll(uint8_t port) {
 	double rtn = PROS_ERR_F;
+	imu_sample_s_t sample;
+	if (imu_get_streamed(port, &sample)) {
+		return sample.euler.roll;
+	}
 	if (!claim_port_try(port - 1, E_DEVICE_IMU)) {
 		return rtn;
 	}
@@ -213,6 +383,10 @@ double imu_get_roll(uint8_t port) {
 
 double imu_get_yaw(uint8_t port) {
 	double rtn = PROS_ERR_F;
+	imu_sample_s_t sample;
+	if (imu_get_streamed(port, &sample)) {
+		return sample.euler.yaw;
+	}
 	if (!claim_port_try(port - 1, E_DEVICE_IMU)) {
 		return rtn;
 	}
@@ -284,6 +458,7 @@ int32_t imu_tare(uint8_t port){
 	data->pitch_offset = -euler_values.pitch;
 	data->roll_offset = -euler_values.roll;
 	data->yaw_offset = -euler_values.yaw;
+	imu_stream_offsets_changed(port - 1, device);
 	return_port(port - 1, PROS_SUCCESS);
 }
 
@@ -322,6 +497,7 @@ int32_t imu_set_rotation(uint8_t port, double target){
 	vexDeviceImuAttitudeGet(device->device_info, (V5_DeviceImuAttitude*)&euler_values);
 	imu_data_s_t* data = (imu_data_s_t*)device->pad;
 	data->rotation_offset = target - vexDeviceImuHeadingGet(device->device_info);
+	imu_stream_offsets_changed(port - 1, device);
 	return_port(port - 1, PROS_SUCCESS);
 }
 
@@ -337,6 +513,7 @@ int32_t imu_set_heading(uint8_t port, double target){
 	if (target > IMU_HEADING_MAX) target = IMU_HEADING_MAX;
 	if (target < 0) target = 0;
 	data->heading_offset = target - vexDeviceImuDegreesGet(device->device_info);
+	imu_stream_offsets_changed(port - 1, device);
 	return_port(port - 1, PROS_SUCCESS);
 }
 
@@ -352,6 +529,7 @@ int32_t imu_set_pitch(uint8_t port, double target){
 	if (target > IMU_EULER_LIMIT) target = IMU_EULER_LIMIT;
 	if (target < -IMU_EULER_LIMIT) target = -IMU_EULER_LIMIT;
 	data->pitch_offset = target - euler_values.pitch;
+	imu_stream_offsets_changed(port - 1, device);
 	return_port(port - 1, PROS_SUCCESS);
 }
 
@@ -367,6 +545,7 @@ int32_t imu_set_roll(uint8_t port, double target){
 	if (target > IMU_EULER_LIMIT) target = IMU_EULER_LIMIT;
 	if (target < -IMU_EULER_LIMIT) target = -IMU_EULER_LIMIT;
 	data->roll_offset = target - euler_values.roll;
+	imu_stream_offsets_changed(port - 1, device);
 	return_port(port - 1, PROS_SUCCESS);
 }
 
@@ -382,6 +561,7 @@ int32_t imu_set_yaw(uint8_t port, double target){
 	data->yaw_offset = target - euler_values.yaw;
 	if (target > IMU_EULER_LIMIT) target = IMU_EULER_LIMIT;
 	if (target < -IMU_EULER_LIMIT) target = -IMU_EULER_LIMIT;
+	imu_stream_offsets_changed(port - 1, device);
 	return_port(port - 1, PROS_SUCCESS);
 }
 
@@ -402,5 +582,98 @@ int32_t imu_set_euler(uint8_t port, euler_s_t target){
 	data->pitch_offset = target.pitch - euler_values.pitch;
 	data->roll_offset = target.roll - euler_values.roll;
 	data->yaw_offset = target.yaw - euler_values.yaw;
+	imu_stream_offsets_changed(port - 1, device);
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+int32_t imu_stream_enable(uint8_t port, uint32_t depth) {
+	if (depth == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	claim_port_i(port - 1, E_DEVICE_IMU);
+	imu_stream_s_t* stream = imu_streams[port - 1];
+	if (stream == NULL) {
+		stream = (imu_stream_s_t*)kmalloc(sizeof(imu_stream_s_t) + depth * sizeof(imu_sample_s_t));
+		if (stream == NULL) {
+			errno = ENOMEM;
+			return_port(port - 1, PROS_ERR);
+		}
+		stream->depth = depth;
+		stream->sequence = 0;
+		for (uint32_t i = 0; i < depth; i++) {
+			stream->samples[i].sequence = 0;
+		}
+		imu_streams[port - 1] = stream;
+	} else if (stream->depth != depth) {
+		errno = EBUSY;
+		return_port(port - 1, PROS_ERR);
+	}
+	stream->enabled = true;
+	// Record the current sample straight away so the getters never see an empty stream
+	imu_stream_record(port - 1, device, vexDeviceGetTimestamp(device->device_info));
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+int32_t imu_stream_disable(uint8_t port) {
+	if (registry_validate_binding(port - 1, E_DEVICE_IMU) != 0) {
+		return PROS_ERR;
+	}
+	if (!port_mutex_take(port - 1)) {
+		errno = EACCES;
+		return PROS_ERR;
+	}
+	if (imu_streams[port - 1] != NULL) {
+		imu_streams[port - 1]->enabled = false;
+	}
 	return_port(port - 1, PROS_SUCCESS);
 }
+
+int32_t imu_get_sample(uint8_t port, imu_sample_s_t* const sample) {
+	if (registry_validate_binding(port - 1, E_DEVICE_IMU) != 0) {
+		return PROS_ERR;
+	}
+	imu_stream_s_t* stream = imu_streams[port - 1];
+	if (stream == NULL || !imu_stream_copy_latest(stream, sample)) {
+		errno = EAGAIN;
+		return PROS_ERR;
+	}
+	return PROS_SUCCESS;
+}
+
+int32_t imu_read_samples(uint8_t port, uint32_t* const cursor, imu_sample_s_t* const samples, uint32_t count) {
+	if (registry_validate_binding(port - 1, E_DEVICE_IMU) != 0) {
+		return PROS_ERR;
+	}
+	imu_stream_s_t* stream = imu_streams[port - 1];
+	if (stream == NULL || cursor == NULL || samples == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	uint32_t read = 0;
+	uint32_t next = *cursor;
+	int failed = 0;
+	while (read < count && failed < IMU_STREAM_READ_ATTEMPTS) {
+		uint32_t latest = __atomic_load_n(&stream->sequence, __ATOMIC_ACQUIRE);
+		uint32_t oldest = latest >= stream->depth ? latest - stream->depth + 1 : 1;
+		if (next < oldest) {
+			next = oldest;
+		}
+		if (next > latest) {
+			break;
+		}
+		// If the daemon laps us mid-copy, go around again from the new oldest sample
+		if (imu_stream_copy(stream, next, &samples[read])) {
+			read++;
+			next++;
+		} else {
+			failed++;
+		}
+	}
+	*cursor = next;
+	if (read == 0 && failed == IMU_STREAM_READ_ATTEMPTS) {
+		errno = EAGAIN;
+		return PROS_ERR;
+	}
+	return read;
+}
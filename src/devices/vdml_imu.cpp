@@ -10,6 +10,9 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <algorithm>
+
+#include "pros/error.h"
 #include "pros/imu.hpp"
 
 namespace pros {
@@ -117,4 +120,37 @@ std::int32_t Imu::tare() const {
 	return pros::c::imu_tare(_port);
 }
 
+std::int32_t Imu::stream_enable(std::uint32_t depth) const {
+	return pros::c::imu_stream_enable(_port, depth);
+}
+
+std::int32_t Imu::stream_disable() const {
+	return pros::c::imu_stream_disable(_port);
+}
+
+pros::c::imu_sample_s_t Imu::get_sample() const {
+	pros::c::imu_sample_s_t sample;
+	if (pros::c::imu_get_sample(_port, &sample) != 1) {
+		sample.sequence = 0;
+	}
+	return sample;
+}
+
+std::vector<pros::c::imu_sample_s_t> Imu::read_samples(std::uint32_t& cursor, std::uint32_t max_count) const {
+	std::vector<pros::c::imu_sample_s_t> samples;
+	pros::c::imu_sample_s_t chunk[16];
+	while (samples.size() < max_count) {
+		std::uint32_t want = std::min<std::uint32_t>(16, max_count - samples.size());
+		std::int32_t read = pros::c::imu_read_samples(_port, &cursor, chunk, want);
+		if (read == PROS_ERR || read == 0) {
+			break;
+		}
+		samples.insert(samples.end(), chunk, chunk + read);
+		if (static_cast<std::uint32_t>(read) < want) {
+			break;
+		}
+	}
+	return samples;
+}
+
 }  // namespace pros
@@ -20,16 +20,771 @@
  #include "kapi.h"
  #include "pros/apix.h"
  #include "vdml/vdml.h"
+ #include "common/crc.h"
  #include <string.h>
 
-#define PROTOCOL_SIZE         4 // Protocol Size 
+// Frame layout: start byte, type, length (little endian), header check,
+// payload, CRC-16 of everything after the start byte (little endian)
+#define FRAME_HEADER_SIZE 5
+#define FRAME_START       0x33
 
-static const uint8_t START_BYTE = 0x33;
+// Frame types used by the reliable mode, above LINK_MAX_MESSAGE_TYPE
+#define FRAME_TYPE_DATA  0x80
+#define FRAME_TYPE_ACK   0x81
+#define FRAME_TYPE_RESET 0x82
+
+// Reliable mode: each fragment of a message is sent in a DATA frame with a
+// sequence number, and the receiver answers with ACK frames. At most
+// RELIABLE_WINDOW fragments are unacknowledged at once.
+//
+// Sequence numbers count from 0 within a session, which the sender names with
+// a random id. The fragments of a session's first window are flagged
+// RELIABLE_SYN, and a receiver starts over whenever it gets one from a session
+// it doesn't know, so a robot that restarts its program is picked up by the
+// other even if the very first fragment is lost. A receiver that gets
+// fragments of a session whose start it never saw, because it restarted
+// itself, answers with a RESET frame instead, and the sender starts a new
+// session with the messages that haven't been acknowledged. The receiver never
+// accepts a session that it asked to start over, since those messages are all
+// sent again. ACKs name the session they are for, so that ones from before a
+// reset are ignored.
+#define RELIABLE_WINDOW         8
+#define RELIABLE_QUEUE_LENGTH   8
+#define RELIABLE_FRAGMENT_SIZE  128
+#define RELIABLE_DATA_HEADER    6  // sequence number (little endian), message type, flags, session (little endian)
+#define RELIABLE_ACK_SIZE       5  // next expected sequence number (little endian), bitmap, session (little endian)
+#define RELIABLE_RESET_SIZE     2  // session to start over (little endian)
+#define RELIABLE_FIRST          0x01
+#define RELIABLE_LAST           0x02
+#define RELIABLE_SYN            0x04
+#define RELIABLE_INITIAL_TIMEOUT 500
+#define RELIABLE_MIN_TIMEOUT    100
+#define RELIABLE_MAX_TIMEOUT    2000
+#define RELIABLE_DAEMON_PERIOD  10
+
+// Shared state is sent as reliable messages of this type. Each one starts with
+// the state's id and the kind of message:
+// - A delta holds the version it applies to and the version it makes (both
+//   little endian), then runs of changed bytes, each as its offset (little
+//   endian), its length and the XOR of the old and new bytes.
+// - A keyframe holds the version it makes and the whole state.
+// - A request asks the other robot for a keyframe. It is sent when the state is
+//   registered and when a delta doesn't apply to the version this robot has.
+#define MESSAGE_TYPE_STATE      0x80
+#define STATE_DELTA             0
+#define STATE_KEYFRAME          1
+#define STATE_REQUEST           2
+#define STATE_DELTA_HEADER_SIZE    10
+#define STATE_KEYFRAME_HEADER_SIZE 6
+#define STATE_REQUEST_SIZE         2
+#define STATE_RUN_HEADER_SIZE   3
+#define STATE_RUN_MAX           255
+// Unchanged gaps shorter than this are sent as part of the run around them,
+// since a new run would cost more
+#define STATE_RUN_MIN_GAP       (STATE_RUN_HEADER_SIZE + 1)
+// Leave room in the send queue for the user's reliable messages
+#define STATE_QUEUE_LIMIT       (RELIABLE_QUEUE_LENGTH / 2)
+
+// A state shared with the other robot
+typedef struct link_shared {
+    uint32_t size;
+    bool dirty;              // Whether local has been published since it was last sent
+    bool keyframe_due;       // Whether the other robot asked for the whole state
+    bool request_due;        // Whether to ask the other robot for the whole state
+    bool awaiting_keyframe;  // Whether a keyframe was asked for and hasn't arrived
+    uint32_t local_version;  // The version of the last update sent
+    uint32_t remote_version; // The version of the last update received
+    uint8_t* local;          // The latest published state
+    uint8_t* sent;           // The state as of the last update sent
+    uint8_t* remote;         // The other robot's state
+} link_shared_s_t;
+
+// A message that is queued to be sent or waiting to be received
+typedef struct link_message {
+    uint8_t type;
+    uint32_t size;
+    uint32_t unacked;  // Fragments not acknowledged yet, when sending
+    uint8_t data[];
+} link_message_s_t;
+
+// A fragment in the send window
+typedef struct link_fragment {
+    link_message_s_t* message;
+    uint32_t offset;
+    uint16_t size;
+    uint8_t flags;
+    bool acked;
+    bool retransmitted;
+    uint32_t sent_time;
+} link_fragment_s_t;
+
+// A fragment in the receive window
+typedef struct link_rx_fragment {
+    bool present;
+    uint8_t type;
+    uint8_t flags;
+    uint16_t size;
+    uint8_t data[RELIABLE_FRAGMENT_SIZE];
+} link_rx_fragment_s_t;
+
+typedef struct link_reliable {
+    // Sending. Messages are queued from send_head, and the first send_next of
+    // them have been split into fragments already.
+    link_message_s_t* send_queue[RELIABLE_QUEUE_LENGTH];
+    uint8_t send_head;
+    uint8_t send_count;
+    uint8_t send_next;
+    uint32_t send_offset;  // Bytes of message send_next that are in fragments
+    link_fragment_s_t window[RELIABLE_WINDOW];
+    uint16_t base_seq;     // The oldest unacknowledged fragment
+    uint16_t next_seq;     // The next fragment to send
+    uint16_t session;      // The id of the session being sent
+    bool wrapped;          // Whether next_seq has wrapped around in this session
+    uint32_t srtt;         // Smoothed round trip time
+    uint32_t timeout;
+
+    // Receiving
+    link_rx_fragment_s_t rx_window[RELIABLE_WINDOW];
+    uint16_t expected_seq;  // The next fragment to put in the message being assembled
+    uint16_t peer_session;  // The session being received, or 0 before the first one starts
+    uint16_t reset_session; // The last session the other robot was asked to start over
+    bool reset_due;
+    bool ack_due;
+    bool assembling;
+    uint8_t assembly_type;
+    uint32_t assembly_size;
+    uint8_t assembly[LINK_RELIABLE_MAX_MESSAGE_SIZE];
+    link_message_s_t* rx_queue[RELIABLE_QUEUE_LENGTH];
+    uint8_t rx_head;
+    uint8_t rx_count;
+} link_reliable_s_t;
+
+// Receive state of a link. The radio's buffer is drained into buf, which is
+// scanned for complete frames.
+typedef struct link_state {
+    uint8_t buf[LINK_BUFFER_SIZE];
+    uint16_t count;
+    // Messages waiting for link_receive_message(), each stored as its type,
+    // length (little endian) and payload
+    uint8_t inbox[LINK_BUFFER_SIZE];
+    uint16_t inbox_count;
+    link_reliable_s_t* reliable;
+    link_shared_s_t* shared[LINK_STATE_MAX_IDS];
+    link_stats_s_t stats;
+} link_state_s_t;
+
+static link_state_s_t* link_states[NUM_V5_PORTS];
+
+// Gets the state of a link, allocating it the first time. The port must be held.
+static link_state_s_t* _get_state(uint8_t port) {
+    if (link_states[port] == NULL) {
+        link_states[port] = (link_state_s_t*)kmalloc(sizeof(link_state_s_t));
+        if (link_states[port] != NULL) {
+            memset(link_states[port], 0, sizeof(link_state_s_t));
+        }
+    }
+    return link_states[port];
+}
+
+// The header check is the low byte of the CRC of the type and length, so that
+// a corrupted length is noticed before waiting for a frame that never comes
+static uint8_t _header_check(const uint8_t* header) {
+    return crc16_update(CRC16_INIT, header + 1, 3) & 0xff;
+}
+
+// Drops the first n bytes of the receive buffer
+static void _drop(link_state_s_t* state, uint16_t n) {
+    memmove(state->buf, state->buf + n, state->count - n);
+    state->count -= n;
+}
+
+// Moves whatever the radio has received into the receive buffer
+static void _fill(v5_smart_device_s_t* device, link_state_s_t* state) {
+    int32_t avail = vexDeviceGenericRadioReceiveAvail(device->device_info);
+    uint16_t room = LINK_BUFFER_SIZE - state->count;
+    if (avail > room) {
+        avail = room;
+    }
+    if (avail > 0) {
+        state->count += vexDeviceGenericRadioReceive(device->device_info, state->buf + state->count, avail);
+    }
+}
+
+// Finds the next complete frame in the receive buffer, which then starts at
+// buf[0]. Returns the payload length, or -1 if there isn't a complete frame yet.
+// Anything that isn't a valid frame is skipped up to the next start byte, so a
+// corrupted byte only costs the frame it is in.
+static int32_t _next_frame(link_state_s_t* state) {
+    while (state->count > 0) {
+        uint8_t* start = memchr(state->buf, FRAME_START, state->count);
+        uint16_t skip = start == NULL ? state->count : start - state->buf;
+        if (skip) {
+            state->stats.bytes_dropped += skip;
+            _drop(state, skip);
+            continue;
+        }
+        if (state->count < FRAME_HEADER_SIZE) {
+            return -1;
+        }
+        uint16_t len = state->buf[2] | (state->buf[3] << 8);
+        if (_header_check(state->buf) != state->buf[4] || len > LINK_MAX_MESSAGE_SIZE) {
+            state->stats.bytes_dropped++;
+            _drop(state, 1);
+            continue;
+        }
+        if (state->count < len + LINK_FRAME_OVERHEAD) {
+            return -1;
+        }
+        uint16_t crc = crc16_update(CRC16_INIT, state->buf + 1, len + FRAME_HEADER_SIZE - 1);
+        uint8_t* crc_bytes = state->buf + FRAME_HEADER_SIZE + len;
+        if (crc != (crc_bytes[0] | (crc_bytes[1] << 8))) {
+            state->stats.crc_errors++;
+            state->stats.bytes_dropped++;
+            _drop(state, 1);
+            continue;
+        }
+        return len;
+    }
+    return -1;
+}
+
+// Sends a frame. The caller must check that the radio has room for it.
+static void _transmit_frame(v5_smart_device_s_t* device, link_state_s_t* state, uint8_t type, const void* data,
+                            uint16_t data_size) {
+    // build the whole frame so that it goes to the radio in one piece
+    uint8_t frame[LINK_BUFFER_SIZE];
+    frame[0] = FRAME_START;
+    frame[1] = type;
+    frame[2] = data_size & 0xff;
+    frame[3] = (data_size >> 8) & 0xff;
+    frame[4] = _header_check(frame);
+    if (data_size) {
+        memcpy(frame + FRAME_HEADER_SIZE, data, data_size);
+    }
+    uint16_t crc = crc16_update(CRC16_INIT, frame + 1, data_size + FRAME_HEADER_SIZE - 1);
+    frame[FRAME_HEADER_SIZE + data_size] = crc & 0xff;
+    frame[FRAME_HEADER_SIZE + data_size + 1] = (crc >> 8) & 0xff;
+    vexDeviceGenericRadioTransmit(device->device_info, frame, data_size + LINK_FRAME_OVERHEAD);
+    state->stats.frames_sent++;
+}
+
+static bool _has_room(v5_smart_device_s_t* device, uint16_t data_size) {
+    return data_size + LINK_FRAME_OVERHEAD <= vexDeviceGenericRadioWriteFree(device->device_info);
+}
+
+// Sequence numbers wrap around, so compare them by their difference
+static inline int16_t _seq_diff(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b);
+}
+
+// Picks a session id other than 0 and the previous one. The time is the only
+// source of randomness, but it is enough to tell a restarted program apart.
+static uint16_t _new_session(uint16_t previous) {
+    uint32_t seed = (uint32_t)micros();
+    uint16_t session;
+    do {
+        seed = seed * 1103515245 + 12345;
+        session = seed >> 16;
+    } while (session == 0 || session == previous);
+    return session;
+}
+
+// The types above LINK_MAX_MESSAGE_TYPE are kept for the reliable mode's frames
+static inline bool _is_user_type(uint8_t type) {
+    return type <= LINK_MAX_MESSAGE_TYPE;
+}
+
+static uint32_t _fragment_count(uint32_t size) {
+    return size ? (size + RELIABLE_FRAGMENT_SIZE - 1) / RELIABLE_FRAGMENT_SIZE : 1;
+}
+
+static inline uint32_t _read_u32(const uint8_t* in) {
+    return in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static inline void _write_u32(uint8_t* out, uint32_t value) {
+    out[0] = value & 0xff;
+    out[1] = (value >> 8) & 0xff;
+    out[2] = (value >> 16) & 0xff;
+    out[3] = (value >> 24) & 0xff;
+}
+
+// Checks that every run of a delta fits in the state, so that a delta is
+// either applied whole or not at all
+static bool _state_delta_valid(link_shared_s_t* shared, const uint8_t* data, uint32_t size) {
+    uint32_t pos = STATE_DELTA_HEADER_SIZE;
+    while (pos < size) {
+        if (pos + STATE_RUN_HEADER_SIZE > size) {
+            return false;
+        }
+        uint16_t offset = data[pos] | (data[pos + 1] << 8);
+        uint8_t len = data[pos + 2];
+        pos += STATE_RUN_HEADER_SIZE;
+        if (pos + len > size || offset + len > shared->size) {
+            return false;
+        }
+        pos += len;
+    }
+    return true;
+}
+
+// Applies a message about a shared state received from the other robot.
+// Messages that don't fit the state, because the other robot registered it
+// with a different size, are dropped.
+static void _state_apply(link_state_s_t* state, const uint8_t* data, uint32_t size) {
+    if (size < STATE_REQUEST_SIZE || data[0] >= LINK_STATE_MAX_IDS || state->shared[data[0]] == NULL) {
+        return;
+    }
+    link_shared_s_t* shared = state->shared[data[0]];
+    if (data[1] == STATE_REQUEST) {
+        shared->keyframe_due = true;
+    } else if (data[1] == STATE_KEYFRAME && size == STATE_KEYFRAME_HEADER_SIZE + shared->size) {
+        memcpy(shared->remote, data + STATE_KEYFRAME_HEADER_SIZE, shared->size);
+        shared->remote_version = _read_u32(data + 2);
+        shared->awaiting_keyframe = false;
+    } else if (data[1] == STATE_DELTA && size >= STATE_DELTA_HEADER_SIZE) {
+        if (_read_u32(data + 2) != shared->remote_version) {
+            // Deltas that were sent before the keyframe arrives don't apply
+            // either, so only ask once
+            if (!shared->awaiting_keyframe) {
+                shared->request_due = true;
+                shared->awaiting_keyframe = true;
+            }
+            return;
+        }
+        if (!_state_delta_valid(shared, data, size)) {
+            return;
+        }
+        uint32_t pos = STATE_DELTA_HEADER_SIZE;
+        while (pos < size) {
+            uint16_t offset = data[pos] | (data[pos + 1] << 8);
+            uint8_t len = data[pos + 2];
+            pos += STATE_RUN_HEADER_SIZE;
+            for (uint8_t i = 0; i < len; i++) {
+                shared->remote[offset + i] ^= data[pos + i];
+            }
+            pos += len;
+        }
+        shared->remote_version = _read_u32(data + 6);
+    }
+}
+
+static void _state_queue(link_state_s_t* state, link_message_s_t* message, uint32_t size) {
+    link_reliable_s_t* rel = state->reliable;
+    message->type = MESSAGE_TYPE_STATE;
+    message->size = size;
+    message->unacked = _fragment_count(size);
+    rel->send_queue[(rel->send_head + rel->send_count) % RELIABLE_QUEUE_LENGTH] = message;
+    rel->send_count++;
+    state->stats.state_bytes_sent += size;
+}
+
+// Encodes the changes to a shared state since it was last sent as the runs of
+// a delta, returning the size of the delta
+static uint32_t _state_encode_delta(link_shared_s_t* shared, uint8_t* out) {
+    uint32_t pos = STATE_DELTA_HEADER_SIZE;
+    uint32_t i = 0;
+    while (i < shared->size) {
+        if (shared->local[i] == shared->sent[i]) {
+            i++;
+            continue;
+        }
+        // Extend the run over changed bytes and short unchanged gaps
+        uint32_t end = i + 1;
+        uint32_t last_changed = i;
+        while (end < shared->size && end - i < STATE_RUN_MAX && end - last_changed < STATE_RUN_MIN_GAP) {
+            if (shared->local[end] != shared->sent[end]) {
+                last_changed = end;
+            }
+            end++;
+        }
+        uint8_t len = last_changed + 1 - i;
+        out[pos] = i & 0xff;
+        out[pos + 1] = (i >> 8) & 0xff;
+        out[pos + 2] = len;
+        pos += STATE_RUN_HEADER_SIZE;
+        for (uint8_t j = 0; j < len; j++) {
+            out[pos + j] = shared->local[i + j] ^ shared->sent[i + j];
+        }
+        pos += len;
+        i += len;
+    }
+    return pos;
+}
+
+// Queues the messages each shared state needs: a request if this robot needs
+// the other's whole state, a keyframe if the other robot asked for it, and
+// otherwise a delta if the state has changed since it was last sent. A delta
+// is the XOR of the new state with the one last sent, which the other robot
+// has (or will have, since messages arrive in order).
+static void _state_service(link_state_s_t* state) {
+    link_reliable_s_t* rel = state->reliable;
+    for (uint8_t id = 0; id < LINK_STATE_MAX_IDS; id++) {
+        link_shared_s_t* shared = state->shared[id];
+        if (shared == NULL) {
+            continue;
+        }
+        if (shared->request_due) {
+            if (rel->send_count >= STATE_QUEUE_LIMIT) {
+                return;
+            }
+            link_message_s_t* message = (link_message_s_t*)kmalloc(sizeof(link_message_s_t) + STATE_REQUEST_SIZE);
+            if (message == NULL) {
+                return;
+            }
+            message->data[0] = id;
+            message->data[1] = STATE_REQUEST;
+            _state_queue(state, message, STATE_REQUEST_SIZE);
+            shared->request_due = false;
+        }
+        if (!shared->keyframe_due && !shared->dirty) {
+            continue;
+        }
+        if (rel->send_count >= STATE_QUEUE_LIMIT) {
+            return;
+        }
+        uint32_t max_size = shared->keyframe_due
+                                ? STATE_KEYFRAME_HEADER_SIZE + shared->size
+                                : STATE_DELTA_HEADER_SIZE + shared->size +
+                                      STATE_RUN_HEADER_SIZE * ((shared->size + STATE_RUN_MAX - 1) / STATE_RUN_MAX);
+        link_message_s_t* message = (link_message_s_t*)kmalloc(sizeof(link_message_s_t) + max_size);
+        if (message == NULL) {
+            return;
+        }
+        uint8_t* out = message->data;
+        uint32_t size;
+        if (shared->keyframe_due) {
+            memcpy(out + STATE_KEYFRAME_HEADER_SIZE, shared->local, shared->size);
+            out[1] = STATE_KEYFRAME;
+            _write_u32(out + 2, shared->local_version + 1);
+            size = max_size;
+        } else {
+            size = _state_encode_delta(shared, out);
+            if (size == STATE_DELTA_HEADER_SIZE) {
+                // Published again without changing
+                kfree(message);
+                shared->dirty = false;
+                continue;
+            }
+            out[1] = STATE_DELTA;
+            _write_u32(out + 2, shared->local_version);
+            _write_u32(out + 6, shared->local_version + 1);
+        }
+        out[0] = id;
+        shared->local_version++;
+        shared->keyframe_due = false;
+        shared->dirty = false;
+        memcpy(shared->sent, shared->local, shared->size);
+        _state_queue(state, message, size);
+    }
+}
+
+// Moves the fragments at the start of the receive window into the message
+// being assembled, and queues each message once its last fragment is in
+static void _reliable_assemble(link_state_s_t* state) {
+    link_reliable_s_t* rel = state->reliable;
+    while (rel->rx_window[rel->expected_seq % RELIABLE_WINDOW].present) {
+        link_rx_fragment_s_t* frag = &rel->rx_window[rel->expected_seq % RELIABLE_WINDOW];
+        if ((frag->flags & RELIABLE_LAST) && rel->rx_count == RELIABLE_QUEUE_LENGTH) {
+            // Hold on to the fragment until there's room to receive the message
+            return;
+        }
+        if (frag->flags & RELIABLE_FIRST) {
+            rel->assembling = true;
+            rel->assembly_type = frag->type;
+            rel->assembly_size = 0;
+        }
+        if (rel->assembling && rel->assembly_size + frag->size <= LINK_RELIABLE_MAX_MESSAGE_SIZE) {
+            memcpy(rel->assembly + rel->assembly_size, frag->data, frag->size);
+            rel->assembly_size += frag->size;
+        } else {
+            rel->assembling = false;
+        }
+        if ((frag->flags & RELIABLE_LAST) && rel->assembling && rel->assembly_type == MESSAGE_TYPE_STATE) {
+            _state_apply(state, rel->assembly, rel->assembly_size);
+            rel->assembling = false;
+        } else if ((frag->flags & RELIABLE_LAST) && rel->assembling) {
+            link_message_s_t* message = (link_message_s_t*)kmalloc(sizeof(link_message_s_t) + rel->assembly_size);
+            if (message != NULL) {
+                message->type = rel->assembly_type;
+                message->size = rel->assembly_size;
+                memcpy(message->data, rel->assembly, rel->assembly_size);
+                rel->rx_queue[(rel->rx_head + rel->rx_count) % RELIABLE_QUEUE_LENGTH] = message;
+                rel->rx_count++;
+            }
+            rel->assembling = false;
+        }
+        frag->present = false;
+        rel->expected_seq++;
+    }
+}
+
+static void _reliable_handle_data(link_state_s_t* state, const uint8_t* payload, uint16_t size) {
+    link_reliable_s_t* rel = state->reliable;
+    if (size < RELIABLE_DATA_HEADER || size - RELIABLE_DATA_HEADER > RELIABLE_FRAGMENT_SIZE) {
+        return;
+    }
+    uint16_t seq = payload[0] | (payload[1] << 8);
+    uint16_t session = payload[4] | (payload[5] << 8);
+    if (session != rel->peer_session) {
+        // We never saw this session start, so we can't tell which of its
+        // fragments have already been received. A session that was already
+        // asked to start over is refused even from its first window, since its
+        // messages are all sent again in the new session and any delivered now
+        // would be delivered twice.
+        if (!(payload[3] & RELIABLE_SYN) || session == rel->reset_session) {
+            rel->reset_session = session;
+            rel->reset_due = true;
+            return;
+        }
+        // The other robot started a new session, so whatever was left of the
+        // old one will never be completed
+        if (rel->peer_session != 0) {
+            state->stats.session_resets++;
+        }
+        for (int i = 0; i < RELIABLE_WINDOW; i++) {
+            rel->rx_window[i].present = false;
+        }
+        rel->assembling = false;
+        rel->expected_seq = 0;
+        rel->peer_session = session;
+    }
+    int16_t ahead = _seq_diff(seq, rel->expected_seq);
+    // Answer duplicates too, since the ACK for them may have been lost
+    rel->ack_due = true;
+    if (ahead < 0 || ahead >= RELIABLE_WINDOW) {
+        return;
+    }
+    link_rx_fragment_s_t* frag = &rel->rx_window[seq % RELIABLE_WINDOW];
+    if (!frag->present) {
+        frag->present = true;
+        frag->type = payload[2];
+        frag->flags = payload[3];
+        frag->size = size - RELIABLE_DATA_HEADER;
+        memcpy(frag->data, payload + RELIABLE_DATA_HEADER, frag->size);
+    }
+    _reliable_assemble(state);
+}
+
+static void _reliable_handle_ack(link_state_s_t* state, const uint8_t* payload, uint16_t size) {
+    link_reliable_s_t* rel = state->reliable;
+    if (size != RELIABLE_ACK_SIZE || (payload[3] | (payload[4] << 8)) != rel->session) {
+        return;
+    }
+    // Everything before next has arrived, and so has next + i for each bit i
+    uint16_t next = payload[0] | (payload[1] << 8);
+    uint8_t bitmap = payload[2];
+    uint32_t now = millis();
+    for (uint16_t seq = rel->base_seq; seq != rel->next_seq; seq++) {
+        link_fragment_s_t* frag = &rel->window[seq % RELIABLE_WINDOW];
+        int16_t offset = _seq_diff(seq, next);
+        if (frag->acked || (offset >= 0 && (offset >= 8 || !(bitmap & (1 << offset))))) {
+            continue;
+        }
+        frag->acked = true;
+        frag->message->unacked--;
+        if (!frag->retransmitted) {
+            // Only time fragments that were sent once, since an ACK for a
+            // retransmitted one could be for either copy
+            uint32_t rtt = now - frag->sent_time;
+            rel->srtt = rel->srtt ? (7 * rel->srtt + rtt) / 8 : rtt;
+            rel->timeout = 2 * rel->srtt;
+            if (rel->timeout < RELIABLE_MIN_TIMEOUT) {
+                rel->timeout = RELIABLE_MIN_TIMEOUT;
+            } else if (rel->timeout > RELIABLE_MAX_TIMEOUT) {
+                rel->timeout = RELIABLE_MAX_TIMEOUT;
+            }
+        }
+    }
+    while (rel->base_seq != rel->next_seq && rel->window[rel->base_seq % RELIABLE_WINDOW].acked) {
+        rel->base_seq++;
+    }
+    // Free the messages that have been delivered
+    while (rel->send_count && rel->send_next && rel->send_queue[rel->send_head]->unacked == 0) {
+        kfree(rel->send_queue[rel->send_head]);
+        rel->send_head = (rel->send_head + 1) % RELIABLE_QUEUE_LENGTH;
+        rel->send_count--;
+        rel->send_next--;
+    }
+}
+
+// The other robot doesn't know where the session being sent started, so start
+// a new one and send every message that hasn't been acknowledged again
+static void _reliable_handle_reset(link_state_s_t* state, const uint8_t* payload, uint16_t size) {
+    link_reliable_s_t* rel = state->reliable;
+    if (size != RELIABLE_RESET_SIZE || (payload[0] | (payload[1] << 8)) != rel->session) {
+        return;
+    }
+    rel->session = _new_session(rel->session);
+    rel->base_seq = 0;
+    rel->next_seq = 0;
+    rel->wrapped = false;
+    rel->send_next = 0;
+    rel->send_offset = 0;
+    for (uint8_t i = 0; i < rel->send_count; i++) {
+        link_message_s_t* message = rel->send_queue[(rel->send_head + i) % RELIABLE_QUEUE_LENGTH];
+        message->unacked = _fragment_count(message->size);
+    }
+    state->stats.session_resets++;
+}
+
+static void _reliable_send_fragment(v5_smart_device_s_t* device, link_state_s_t* state, link_fragment_s_t* frag,
+                                    uint16_t seq) {
+    uint8_t payload[RELIABLE_DATA_HEADER + RELIABLE_FRAGMENT_SIZE];
+    payload[0] = seq & 0xff;
+    payload[1] = (seq >> 8) & 0xff;
+    payload[2] = frag->message->type;
+    payload[3] = frag->flags;
+    payload[4] = state->reliable->session & 0xff;
+    payload[5] = (state->reliable->session >> 8) & 0xff;
+    memcpy(payload + RELIABLE_DATA_HEADER, frag->message->data + frag->offset, frag->size);
+    _transmit_frame(device, state, FRAME_TYPE_DATA, payload, RELIABLE_DATA_HEADER + frag->size);
+    frag->sent_time = millis();
+}
+
+// Sends ACKs, retransmits fragments that timed out, and sends new fragments
+// while the window has room. The port must be held.
+static void _reliable_service(v5_smart_device_s_t* device, link_state_s_t* state) {
+    link_reliable_s_t* rel = state->reliable;
+    _reliable_assemble(state);
+    if (rel->ack_due && _has_room(device, RELIABLE_ACK_SIZE)) {
+        uint8_t bitmap = 0;
+        for (int i = 0; i < RELIABLE_WINDOW; i++) {
+            if (rel->rx_window[(uint16_t)(rel->expected_seq + i) % RELIABLE_WINDOW].present) {
+                bitmap |= 1 << i;
+            }
+        }
+        uint8_t ack[RELIABLE_ACK_SIZE] = {rel->expected_seq & 0xff, (rel->expected_seq >> 8) & 0xff, bitmap,
+                                          rel->peer_session & 0xff, (rel->peer_session >> 8) & 0xff};
+        _transmit_frame(device, state, FRAME_TYPE_ACK, ack, RELIABLE_ACK_SIZE);
+        rel->ack_due = false;
+    }
+    if (rel->reset_due && _has_room(device, RELIABLE_RESET_SIZE)) {
+        uint8_t reset[RELIABLE_RESET_SIZE] = {rel->reset_session & 0xff, (rel->reset_session >> 8) & 0xff};
+        _transmit_frame(device, state, FRAME_TYPE_RESET, reset, RELIABLE_RESET_SIZE);
+        rel->reset_due = false;
+    }
+
+    uint32_t now = millis();
+    bool timed_out = false;
+    for (uint16_t seq = rel->base_seq; seq != rel->next_seq; seq++) {
+        link_fragment_s_t* frag = &rel->window[seq % RELIABLE_WINDOW];
+        if (frag->acked || now - frag->sent_time < rel->timeout) {
+            continue;
+        }
+        if (!_has_room(device, RELIABLE_DATA_HEADER + frag->size)) {
+            break;
+        }
+        _reliable_send_fragment(device, state, frag, seq);
+        frag->retransmitted = true;
+        state->stats.retransmissions++;
+        timed_out = true;
+    }
+    if (timed_out) {
+        // Back off in case the link is slower than we thought
+        rel->timeout = rel->timeout * 2 > RELIABLE_MAX_TIMEOUT ? RELIABLE_MAX_TIMEOUT : rel->timeout * 2;
+    }
+
+    _state_service(state);
+    while (_seq_diff(rel->next_seq, rel->base_seq) < RELIABLE_WINDOW && rel->send_next < rel->send_count) {
+        link_message_s_t* message = rel->send_queue[(rel->send_head + rel->send_next) % RELIABLE_QUEUE_LENGTH];
+        uint32_t size = message->size - rel->send_offset;
+        if (size > RELIABLE_FRAGMENT_SIZE) {
+            size = RELIABLE_FRAGMENT_SIZE;
+        }
+        if (!_has_room(device, RELIABLE_DATA_HEADER + size)) {
+            return;
+        }
+        link_fragment_s_t* frag = &rel->window[rel->next_seq % RELIABLE_WINDOW];
+        frag->message = message;
+        frag->offset = rel->send_offset;
+        frag->size = size;
+        frag->flags = (rel->send_offset == 0 ? RELIABLE_FIRST : 0) |
+                      (rel->send_offset + size == message->size ? RELIABLE_LAST : 0) |
+                      (rel->next_seq < RELIABLE_WINDOW && !rel->wrapped ? RELIABLE_SYN : 0);
+        frag->acked = false;
+        frag->retransmitted = false;
+        _reliable_send_fragment(device, state, frag, rel->next_seq);
+        rel->next_seq++;
+        if (rel->next_seq == 0) {
+            rel->wrapped = true;
+        }
+        rel->send_offset += size;
+        if (frag->flags & RELIABLE_LAST) {
+            rel->send_next++;
+            rel->send_offset = 0;
+        }
+    }
+}
+
+// Takes every complete frame out of the receive buffer. Frames of the reliable
+// mode are handled, and user messages are moved to the inbox until it is full.
+static void _poll(v5_smart_device_s_t* device, link_state_s_t* state) {
+    while (true) {
+        _fill(device, state);
+        int32_t len = _next_frame(state);
+        if (len < 0) {
+            return;
+        }
+        uint8_t type = state->buf[1];
+        uint8_t* payload = state->buf + FRAME_HEADER_SIZE;
+        if (type == FRAME_TYPE_DATA && state->reliable != NULL) {
+            _reliable_handle_data(state, payload, len);
+        } else if (type == FRAME_TYPE_ACK && state->reliable != NULL) {
+            _reliable_handle_ack(state, payload, len);
+        } else if (type == FRAME_TYPE_RESET && state->reliable != NULL) {
+            _reliable_handle_reset(state, payload, len);
+        } else if (_is_user_type(type)) {
+            if (state->inbox_count + len + 3 > LINK_BUFFER_SIZE) {
+                // Leave it in the receive buffer until there's room
+                return;
+            }
+            uint8_t* entry = state->inbox + state->inbox_count;
+            entry[0] = type;
+            entry[1] = len & 0xff;
+            entry[2] = (len >> 8) & 0xff;
+            memcpy(entry + 3, payload, len);
+            state->inbox_count += len + 3;
+        }
+        state->stats.frames_received++;
+        _drop(state, len + LINK_FRAME_OVERHEAD);
+    }
+}
+
+static task_stack_t link_daemon_stack[TASK_STACK_DEPTH_MIN * 4];
+static static_task_s_t link_daemon_task_buffer;
+static task_t link_daemon_task;
+
+// Runs the reliable mode of every link that has it enabled
+static void link_daemon(void* ign) {
+    uint32_t time = millis();
+    while (true) {
+        for (uint8_t port = 0; port < NUM_V5_PORTS; port++) {
+            link_state_s_t* state = link_states[port];
+            if (state == NULL || state->reliable == NULL || !claim_port_try(port, E_DEVICE_SERIAL)) {
+                continue;
+            }
+            v5_smart_device_s_t* device = registry_get_device(port);
+            if (vexDeviceGenericRadioLinkStatus(device->device_info)) {
+                _poll(device, state);
+                _reliable_service(device, state);
+            }
+            port_mutex_give(port);
+        }
+        task_delay_until(&time, RELIABLE_DAEMON_PERIOD);
+    }
+}
 
 // internal function for clearing the rx buffer 
-static uint32_t _clear_rx_buf(v5_smart_device_s_t* device) {
+static uint32_t _clear_rx_buf(uint8_t port, v5_smart_device_s_t* device) {
     uint8_t buf[LINK_BUFFER_SIZE];
-    return vexDeviceGenericRadioReceive(device->device_info, 
+    uint32_t rtv = 0;
+    if (link_states[port] != NULL) {
+        rtv = link_states[port]->count + link_states[port]->inbox_count;
+        link_states[port]->count = 0;
+        link_states[port]->inbox_count = 0;
+    }
+    return rtv + vexDeviceGenericRadioReceive(device->device_info, 
     (uint8_t*)buf, 
     vexDeviceGenericRadioReceiveAvail(device->device_info));
 }
@@ -119,8 +874,8 @@ uint32_t link_receive_raw(uint8_t port, void* dest, uint16_t data_size) {
     return_port(port - 1, rtv);
 }
 
-uint32_t link_transmit(uint8_t port, void* data, uint16_t data_size) {
-    if(data == NULL) {
+uint32_t link_transmit_message(uint8_t port, uint8_t type, const void* data, uint16_t data_size) {
+    if((data == NULL && data_size) || data_size > LINK_MAX_MESSAGE_SIZE || !_is_user_type(type)) {
         errno = EINVAL;
         return PROS_ERR;
     }
@@ -129,32 +884,21 @@ uint32_t link_transmit(uint8_t port, void* data, uint16_t data_size) {
         errno = ENXIO;
         return_port(port - 1, PROS_ERR);
     }
-    if(data_size + PROTOCOL_SIZE > vexDeviceGenericRadioWriteFree(device->device_info)) {
+    if(!_has_room(device, data_size)) {
         errno = EBUSY;
         return_port(port - 1, PROS_ERR);
     }
-    // calculated checksum
-    uint8_t checksum = START_BYTE;
-    uint8_t size_tx_buf[2];
-    size_tx_buf[1] = (data_size >> 8) & 0xff;
-    size_tx_buf[0] = (data_size) & 0xff;
-    checksum ^= size_tx_buf[1];
-    checksum ^= size_tx_buf[0];
-    
-    for(int i = 0; i < data_size; i++) {
-        checksum ^= ((uint8_t*)data)[i];
+    link_state_s_t* state = _get_state(port - 1);
+    if(state == NULL) {
+        errno = ENOMEM;
+        return_port(port - 1, PROS_ERR);
     }
-    uint32_t rtv = 0;
-    // send protocol
-    rtv += vexDeviceGenericRadioTransmit(device->device_info, (uint8_t*)&START_BYTE, 1);
-    rtv += vexDeviceGenericRadioTransmit(device->device_info, size_tx_buf, 2);
-    rtv += vexDeviceGenericRadioTransmit(device->device_info, (uint8_t*)data, data_size);
-    rtv += vexDeviceGenericRadioTransmit(device->device_info, &checksum, 1);
-    return_port(port - 1, rtv);
+    _transmit_frame(device, state, type, data, data_size);
+    return_port(port - 1, data_size);
 }
 
-uint32_t link_receive(uint8_t port, void* dest, uint16_t data_size) {
-    if(dest == NULL) {
+uint32_t link_receive_message(uint8_t port, uint8_t* type, void* dest, uint16_t data_size) {
+    if(dest == NULL && data_size) {
         errno = EINVAL;
         return PROS_ERR;
     }
@@ -163,56 +907,286 @@ uint32_t link_receive(uint8_t port, void* dest, uint16_t data_size) {
         errno = ENXIO;
         return_port(port - 1, PROS_ERR);
     }
-    if(data_size + PROTOCOL_SIZE > vexDeviceGenericRadioReceiveAvail(device->device_info)) {
-        errno = EBUSY;
+    link_state_s_t* state = _get_state(port - 1);
+    if(state == NULL) {
+        errno = ENOMEM;
         return_port(port - 1, PROS_ERR);
     }
-    uint8_t header_byte;
-    uint8_t received_size;
-    // process protocol
-    received_size = vexDeviceGenericRadioReceive(device->device_info, &header_byte, 1); // 0x33
-    if(START_BYTE != header_byte || received_size != 1) {
-        kprintf("[VEXLINK] Invalid Header Byte Received Port %d, header byte: %x", port, header_byte);
-        errno = EBADMSG;
+    _poll(device, state);
+    if(state->inbox_count == 0) {
+        errno = EAGAIN;
         return_port(port - 1, PROS_ERR);
     }
-    // datasize
-    uint16_t received_data_size;
-    received_size = vexDeviceGenericRadioReceive(device->device_info, (uint8_t*)&received_data_size, 2);
-    if(received_size != 2 || received_data_size != data_size) {
-        _clear_rx_buf(device);
-        kprintf("[VEXLINK] Invalid Data Size (Size: %d ) Received Port %d, flushing RX buffer!\n", received_data_size, port);
-        errno = EBADMSG;
+    uint16_t len = state->inbox[1] | (state->inbox[2] << 8);
+    bool fits = len <= data_size;
+    if(fits) {
+        if(type != NULL) {
+            *type = state->inbox[0];
+        }
+        memcpy(dest, state->inbox + 3, len);
+    }
+    // a message that doesn't fit is dropped too, so it can't hold up the ones
+    // behind it
+    state->inbox_count -= len + 3;
+    memmove(state->inbox, state->inbox + len + 3, state->inbox_count);
+    if(!fits) {
+        errno = EMSGSIZE;
         return_port(port - 1, PROS_ERR);
     }
-    // receive data
-    uint32_t rtv = vexDeviceGenericRadioReceive(device->device_info, (uint8_t*)dest, data_size);
-    if(rtv != data_size || received_data_size != data_size) {
-        kprintf("[VEXLINK] Invalid Data Received Port %d, flushing RX buffer!\n", port);
+    return_port(port - 1, len);
+}
+
+uint32_t link_transmit(uint8_t port, void* data, uint16_t data_size) {
+    if(data == NULL) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    return link_transmit_message(port, 0, data, data_size);
+}
+
+uint32_t link_receive(uint8_t port, void* dest, uint16_t data_size) {
+    if(dest == NULL) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    uint8_t buf[LINK_MAX_MESSAGE_SIZE];
+    uint32_t rtv = link_receive_message(port, NULL, buf, sizeof(buf));
+    if(rtv == PROS_ERR) {
+        if(errno == EAGAIN) {
+            errno = EBUSY;
+        }
+        return PROS_ERR;
+    }
+    if(rtv != data_size) {
+        kprintf("[VEXLINK] Invalid Data Size (Size: %d ) Received Port %d, dropping message!\n", rtv, port);
         errno = EBADMSG;
-        _clear_rx_buf(device);
+        return PROS_ERR;
+    }
+    memcpy(dest, buf, data_size);
+    return rtv;
+}
+
+uint32_t link_get_stats(uint8_t port, link_stats_s_t* stats) {
+    if(stats == NULL) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    if(registry_validate_binding(port - 1, E_DEVICE_SERIAL) != 0) {
+        return PROS_ERR;
+    }
+    if(!port_mutex_take(port - 1)) {
+        errno = EACCES;
+        return PROS_ERR;
+    }
+    link_state_s_t* state = link_states[port - 1];
+    if(state != NULL) {
+        *stats = state->stats;
+    } else {
+        memset(stats, 0, sizeof(*stats));
+    }
+    return_port(port - 1, PROS_SUCCESS);
+}
+
+uint32_t link_reliable_enable(uint8_t port) {
+    if(registry_validate_binding(port - 1, E_DEVICE_SERIAL) != 0) {
+        return PROS_ERR;
+    }
+    if(!port_mutex_take(port - 1)) {
+        errno = EACCES;
+        return PROS_ERR;
+    }
+    link_state_s_t* state = _get_state(port - 1);
+    if(state == NULL) {
+        errno = ENOMEM;
         return_port(port - 1, PROS_ERR);
     }
-    uint8_t received_checksum;
-    received_size = vexDeviceGenericRadioReceive(device->device_info, &received_checksum, 1);
-    // check checksum
-    uint8_t calculated_checksum = START_BYTE;
-    calculated_checksum ^= (data_size >> 8) & 0xff;
-    calculated_checksum ^= (data_size) & 0xff;
-    for(int i = 0; i < data_size; i++) {
-        calculated_checksum ^= ((uint8_t*)dest)[i];
+    if(state->reliable == NULL) {
+        link_reliable_s_t* rel = (link_reliable_s_t*)kmalloc(sizeof(link_reliable_s_t));
+        if(rel == NULL) {
+            errno = ENOMEM;
+            return_port(port - 1, PROS_ERR);
+        }
+        memset(rel, 0, sizeof(link_reliable_s_t));
+        rel->timeout = RELIABLE_INITIAL_TIMEOUT;
+        rel->session = _new_session(0);
+        state->reliable = rel;
     }
-    if(calculated_checksum != received_checksum || received_size != 1) {
-        kprintf("[VEXLINK] Checksum Mismatch Port %d!, Checksum: %x\n", port, received_checksum);
-        errno = EBADMSG;
+    if(link_daemon_task == NULL) {
+        link_daemon_task = task_create_static(link_daemon, NULL, TASK_PRIORITY_MAX - 3,
+                                              sizeof(link_daemon_stack) / sizeof(task_stack_t), "VEXlink Daemon (PROS)",
+                                              link_daemon_stack, &link_daemon_task_buffer);
+    }
+    return_port(port - 1, PROS_SUCCESS);
+}
+
+uint32_t link_reliable_send(uint8_t port, uint8_t type, const void* data, uint32_t data_size) {
+    if((data == NULL && data_size) || data_size > LINK_RELIABLE_MAX_MESSAGE_SIZE || !_is_user_type(type)) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    if(registry_validate_binding(port - 1, E_DEVICE_SERIAL) != 0) {
+        return PROS_ERR;
+    }
+    if(!port_mutex_take(port - 1)) {
+        errno = EACCES;
+        return PROS_ERR;
+    }
+    link_state_s_t* state = link_states[port - 1];
+    if(state == NULL || state->reliable == NULL) {
+        errno = EINVAL;
+        return_port(port - 1, PROS_ERR);
+    }
+    link_reliable_s_t* rel = state->reliable;
+    if(rel->send_count == RELIABLE_QUEUE_LENGTH) {
+        errno = EAGAIN;
+        return_port(port - 1, PROS_ERR);
+    }
+    link_message_s_t* message = (link_message_s_t*)kmalloc(sizeof(link_message_s_t) + data_size);
+    if(message == NULL) {
+        errno = ENOMEM;
+        return_port(port - 1, PROS_ERR);
+    }
+    message->type = type;
+    message->size = data_size;
+    message->unacked = _fragment_count(data_size);
+    if(data_size) {
+        memcpy(message->data, data, data_size);
+    }
+    rel->send_queue[(rel->send_head + rel->send_count) % RELIABLE_QUEUE_LENGTH] = message;
+    rel->send_count++;
+    return_port(port - 1, PROS_SUCCESS);
+}
+
+uint32_t link_reliable_receive(uint8_t port, uint8_t* type, void* dest, uint32_t data_size) {
+    if(dest == NULL && data_size) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    if(registry_validate_binding(port - 1, E_DEVICE_SERIAL) != 0) {
+        return PROS_ERR;
+    }
+    if(!port_mutex_take(port - 1)) {
+        errno = EACCES;
+        return PROS_ERR;
+    }
+    link_state_s_t* state = link_states[port - 1];
+    if(state == NULL || state->reliable == NULL) {
+        errno = EINVAL;
+        return_port(port - 1, PROS_ERR);
+    }
+    link_reliable_s_t* rel = state->reliable;
+    if(rel->rx_count == 0) {
+        errno = EAGAIN;
+        return_port(port - 1, PROS_ERR);
+    }
+    link_message_s_t* message = rel->rx_queue[rel->rx_head];
+    uint32_t rtv = message->size;
+    if(rtv <= data_size) {
+        if(type != NULL) {
+            *type = message->type;
+        }
+        memcpy(dest, message->data, message->size);
+    }
+    // a message that doesn't fit is dropped too, so it can't hold up the ones
+    // behind it
+    kfree(message);
+    rel->rx_head = (rel->rx_head + 1) % RELIABLE_QUEUE_LENGTH;
+    rel->rx_count--;
+    if(rtv > data_size) {
+        errno = EMSGSIZE;
+        return_port(port - 1, PROS_ERR);
+    }
+    return_port(port - 1, rtv);
+}
+
+uint32_t link_reliable_pending(uint8_t port) {
+    if(registry_validate_binding(port - 1, E_DEVICE_SERIAL) != 0) {
+        return PROS_ERR;
+    }
+    if(!port_mutex_take(port - 1)) {
+        errno = EACCES;
+        return PROS_ERR;
+    }
+    link_state_s_t* state = link_states[port - 1];
+    if(state == NULL || state->reliable == NULL) {
+        errno = EINVAL;
+        return_port(port - 1, PROS_ERR);
+    }
+    uint32_t rtv = state->reliable->send_count;
+    return_port(port - 1, rtv);
+}
+
+uint32_t link_state_register(uint8_t port, uint8_t id, uint32_t size) {
+    if(id >= LINK_STATE_MAX_IDS || size == 0 || size > LINK_STATE_MAX_SIZE) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    claim_port_i(port - 1, E_DEVICE_SERIAL);
+    link_state_s_t* state = link_states[port - 1];
+    if(state == NULL || state->reliable == NULL) {
+        errno = EINVAL;
+        return_port(port - 1, PROS_ERR);
+    }
+    if(state->shared[id] != NULL) {
+        if(state->shared[id]->size != size) {
+            errno = EEXIST;
+            return_port(port - 1, PROS_ERR);
+        }
+        return_port(port - 1, PROS_SUCCESS);
+    }
+    // The three copies of the state follow the struct
+    link_shared_s_t* shared = (link_shared_s_t*)kmalloc(sizeof(link_shared_s_t) + 3 * size);
+    if(shared == NULL) {
+        errno = ENOMEM;
+        return_port(port - 1, PROS_ERR);
+    }
+    memset(shared, 0, sizeof(link_shared_s_t) + 3 * size);
+    shared->size = size;
+    shared->local = (uint8_t*)(shared + 1);
+    shared->sent = shared->local + size;
+    shared->remote = shared->sent + size;
+    // The other robot may have been publishing the state already, or have
+    // copies of it from before this program started
+    shared->request_due = true;
+    state->shared[id] = shared;
+    return_port(port - 1, PROS_SUCCESS);
+}
+
+uint32_t link_state_publish(uint8_t port, uint8_t id, const void* data) {
+    if(data == NULL || id >= LINK_STATE_MAX_IDS) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    claim_port_i(port - 1, E_DEVICE_SERIAL);
+    link_state_s_t* state = link_states[port - 1];
+    if(state == NULL || state->shared[id] == NULL) {
+        errno = EINVAL;
+        return_port(port - 1, PROS_ERR);
+    }
+    memcpy(state->shared[id]->local, data, state->shared[id]->size);
+    state->shared[id]->dirty = true;
+    return_port(port - 1, PROS_SUCCESS);
+}
+
+uint32_t link_state_get(uint8_t port, uint8_t id, void* dest) {
+    if(dest == NULL || id >= LINK_STATE_MAX_IDS) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    claim_port_i(port - 1, E_DEVICE_SERIAL);
+    link_state_s_t* state = link_states[port - 1];
+    if(state == NULL || state->shared[id] == NULL) {
+        errno = EINVAL;
         return_port(port - 1, PROS_ERR);
     }
+    memcpy(dest, state->shared[id]->remote, state->shared[id]->size);
+    uint32_t rtv = state->shared[id]->remote_version;
     return_port(port - 1, rtv);
 }
 
 uint32_t link_clear_receive_buf(uint8_t port) {
     claim_port_i(port - 1, E_DEVICE_SERIAL);
-    uint32_t rtv = _clear_rx_buf(device);
+    uint32_t rtv = _clear_rx_buf(port - 1, device);
     return_port(port - 1, rtv);
 }
 
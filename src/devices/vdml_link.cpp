@@ -51,6 +51,36 @@ namespace pros {
         return pros::c::link_receive(_port, dest, data_size);
     }
 
+    std::uint32_t Link::transmit_message(std::uint8_t type, const void* data, std::uint16_t data_size) {
+        return pros::c::link_transmit_message(_port, type, data, data_size);
+    }
+
+    std::uint32_t Link::receive_message(std::uint8_t& type, void* dest, std::uint16_t data_size) {
+        return pros::c::link_receive_message(_port, &type, dest, data_size);
+    }
+
+    link_stats_s_t Link::get_stats() {
+        link_stats_s_t stats = {};
+        pros::c::link_get_stats(_port, &stats);
+        return stats;
+    }
+
+    std::uint32_t Link::reliable_enable() {
+        return pros::c::link_reliable_enable(_port);
+    }
+
+    std::uint32_t Link::reliable_send(std::uint8_t type, const void* data, std::uint32_t data_size) {
+        return pros::c::link_reliable_send(_port, type, data, data_size);
+    }
+
+    std::uint32_t Link::reliable_receive(std::uint8_t& type, void* dest, std::uint32_t data_size) {
+        return pros::c::link_reliable_receive(_port, &type, dest, data_size);
+    }
+
+    std::uint32_t Link::reliable_pending() {
+        return pros::c::link_reliable_pending(_port);
+    }
+
     std::uint32_t Link::clear_receive_buf() {
         return pros::c::link_clear_receive_buf(_port);
     }
@@ -45,20 +45,174 @@ static void set_vel_pid(uint8_t port, V5_DeviceMotorPid vel) {
 	data->vel_pid = vel;
 }
 
-// Movement functions
-
-int32_t motor_move(uint8_t port, int32_t voltage) {
+// Telemetry snapshots published by the system daemon. The buffer holding a
+// port's latest snapshot is selected by the low bit of its sequence number, so
+// the daemon always writes to the buffer that readers aren't using.
+static motor_snapshot_s_t motor_snapshots[NUM_V5_PORTS][2];
+static uint32_t motor_snapshot_seq[NUM_V5_PORTS];
+
+// Remaps a motor_move() voltage from [-127, 127] to [-12000, 12000] millivolts
+static int32_t scale_move_voltage(int32_t voltage) {
 	if (voltage > 127) {
 		voltage = 127;
 	} else if (voltage < -127) {
 		voltage = -127;
 	}
-
-	// Remap the input voltage range to the motor voltage
-	// scale to [-127, 127] -> [-12000, 12000]
 	int32_t command = (((voltage + MOTOR_MOVE_RANGE) * (MOTOR_VOLTAGE_RANGE)) / (MOTOR_MOVE_RANGE));
-	command -= MOTOR_VOLTAGE_RANGE;
-	return motor_move_voltage(port, command);
+	return command - MOTOR_VOLTAGE_RANGE;
+}
+
+static void read_fields(v5_smart_device_s_t* device, uint32_t fields, motor_snapshot_s_t* snapshot) {
+	if (fields & E_MOTOR_FIELD_POSITION) {
+		snapshot->position = vexDeviceMotorPositionGet(device->device_info);
+	}
+	if (fields & E_MOTOR_FIELD_RAW_POSITION) {
+		snapshot->raw_position = vexDeviceMotorPositionRawGet(device->device_info, &snapshot->raw_timestamp);
+	}
+	if (fields & E_MOTOR_FIELD_ACTUAL_VELOCITY) {
+		snapshot->actual_velocity = vexDeviceMotorActualVelocityGet(device->device_info);
+	}
+	if (fields & E_MOTOR_FIELD_CURRENT_DRAW) {
+		snapshot->current_draw = vexDeviceMotorCurrentGet(device->device_info);
+	}
+	if (fields & E_MOTOR_FIELD_VOLTAGE) {
+		snapshot->voltage = vexDeviceMotorVoltageGet(device->device_info);
+	}
+	if (fields & E_MOTOR_FIELD_POWER) {
+		snapshot->power = vexDeviceMotorPowerGet(device->device_info);
+	}
+	if (fields & E_MOTOR_FIELD_TORQUE) {
+		snapshot->torque = vexDeviceMotorTorqueGet(device->device_info);
+	}
+	if (fields & E_MOTOR_FIELD_EFFICIENCY) {
+		snapshot->efficiency = vexDeviceMotorEfficiencyGet(device->device_info);
+	}
+	if (fields & E_MOTOR_FIELD_TEMPERATURE) {
+		snapshot->temperature = vexDeviceMotorTemperatureGet(device->device_info);
+	}
+	if (fields & E_MOTOR_FIELD_DIRECTION) {
+		snapshot->direction = vexDeviceMotorDirectionGet(device->device_info);
+	}
+	if (fields & E_MOTOR_FIELD_FAULTS) {
+		snapshot->faults = vexDeviceMotorFaultsGet(device->device_info);
+	}
+	if (fields & E_MOTOR_FIELD_FLAGS) {
+		snapshot->flags = vexDeviceMotorFlagsGet(device->device_info);
+	}
+}
+
+void motor_snapshot_publish(uint8_t port, v5_smart_device_s_t* device) {
+	motor_snapshot_s_t* snapshot =
+	    vdml_snapshot_begin(&motor_snapshot_seq[port], motor_snapshots[port], sizeof(motor_snapshot_s_t));
+	snapshot->timestamp = millis();
+	snapshot->sequence = motor_snapshot_seq[port] + 1;
+	read_fields(device, E_MOTOR_FIELD_ALL, snapshot);
+	vdml_snapshot_publish(&motor_snapshot_seq[port]);
+}
+
+int32_t motor_get_snapshot(uint8_t port, motor_snapshot_s_t* const snapshot) {
+	if (registry_validate_binding(port - 1, E_DEVICE_MOTOR) != 0) {
+		return PROS_ERR;
+	}
+	if (!vdml_snapshot_read(&motor_snapshot_seq[port - 1], motor_snapshots[port - 1], sizeof(*snapshot), snapshot)) {
+		errno = EAGAIN;
+		return PROS_ERR;
+	}
+	return PROS_SUCCESS;
+}
+
+// Batch functions
+
+/**
+ * Validates every port in a batch and then claims all of them at once with
+ * port_mutex_take_set().
+ *
+ * \return The value to pass to batch_release(), or 0 if the batch is invalid,
+ * setting errno.
+ */
+static uint32_t batch_claim(const uint8_t* const ports, const size_t count) {
+	uint32_t claimed = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (registry_validate_binding(ports[i] - 1, E_DEVICE_MOTOR) != 0) {
+			return 0;
+		}
+		claimed |= 1U << (ports[i] - 1);
+	}
+	return port_mutex_take_set(claimed);
+}
+
+static void batch_release(const uint32_t claimed) {
+	port_mutex_give_set(claimed);
+}
+
+int32_t motor_batch_move(const uint8_t* const ports, const size_t count, const int32_t* const voltages) {
+	if (count == 0) {
+		return PROS_SUCCESS;
+	}
+	uint32_t claimed = batch_claim(ports, count);
+	if (!claimed) {
+		return PROS_ERR;
+	}
+	for (size_t i = 0; i < count; i++) {
+		vexDeviceMotorVoltageSet(registry_get_device(ports[i] - 1)->device_info, scale_move_voltage(voltages[i]));
+	}
+	batch_release(claimed);
+	return PROS_SUCCESS;
+}
+
+int32_t motor_batch_move_voltage(const uint8_t* const ports, const size_t count, const int32_t* const voltages) {
+	if (count == 0) {
+		return PROS_SUCCESS;
+	}
+	uint32_t claimed = batch_claim(ports, count);
+	if (!claimed) {
+		return PROS_ERR;
+	}
+	for (size_t i = 0; i < count; i++) {
+		vexDeviceMotorVoltageSet(registry_get_device(ports[i] - 1)->device_info, voltages[i]);
+	}
+	batch_release(claimed);
+	return PROS_SUCCESS;
+}
+
+int32_t motor_batch_move_velocity(const uint8_t* const ports, const size_t count, const int32_t* const velocities) {
+	if (count == 0) {
+		return PROS_SUCCESS;
+	}
+	uint32_t claimed = batch_claim(ports, count);
+	if (!claimed) {
+		return PROS_ERR;
+	}
+	for (size_t i = 0; i < count; i++) {
+		vexDeviceMotorVelocitySet(registry_get_device(ports[i] - 1)->device_info, velocities[i]);
+	}
+	batch_release(claimed);
+	return PROS_SUCCESS;
+}
+
+int32_t motor_batch_read(const uint8_t* const ports, const size_t count, const uint32_t fields,
+                         motor_snapshot_s_t* const out) {
+	if (count == 0) {
+		return PROS_SUCCESS;
+	}
+	uint32_t claimed = batch_claim(ports, count);
+	if (!claimed) {
+		return PROS_ERR;
+	}
+	uint32_t now = millis();
+	for (size_t i = 0; i < count; i++) {
+		out[i].timestamp = now;
+		out[i].sequence = __atomic_load_n(&motor_snapshot_seq[ports[i] - 1], __ATOMIC_ACQUIRE);
+		read_fields(registry_get_device(ports[i] - 1), fields, &out[i]);
+	}
+	batch_release(claimed);
+	return PROS_SUCCESS;
+}
+
+// Movement functions
+
+int32_t motor_move(uint8_t port, int32_t voltage) {
+	return motor_move_voltage(port, scale_move_voltage(voltage));
 }
 
 int32_t motor_brake(uint8_t port) {
@@ -11,6 +11,7 @@
  */
 
 #include <stdint.h>
+#include <algorithm>
 #include <vector>
 #include <cassert>
 
@@ -79,6 +80,37 @@
 namespace pros {
 using namespace pros::c;
 
+namespace {
+// The vector getters read telemetry this many motors at a time, since the
+// snapshots are kept on the stack
+constexpr std::size_t READ_CHUNK = 4;
+
+/**
+ * Reads one field of every motor's telemetry with motor_batch_read(),
+ * appending it to out.
+ *
+ * \return False if any of the motors couldn't be read, leaving out empty so
+ * that the caller can read the motors one at a time instead and report the
+ * error for just the failing ones.
+ */
+template <typename T>
+bool batch_read_field(const std::vector<std::uint8_t>& ports, const motor_field_e_t field,
+                      T motor_snapshot_s_t::*const member, std::vector<T>& out) {
+	motor_snapshot_s_t snapshots[READ_CHUNK];
+	for (std::size_t start = 0; start < ports.size(); start += READ_CHUNK) {
+		const std::size_t count = std::min(READ_CHUNK, ports.size() - start);
+		if (motor_batch_read(&ports[start], count, field, snapshots) == PROS_ERR) {
+			out.clear();
+			return false;
+		}
+		for (std::size_t i = 0; i < count; i++) {
+			out.push_back(snapshots[i].*member);
+		}
+	}
+	return true;
+}
+}  // namespace
+
 Motor::Motor(const std::int8_t port, const motor_gearset_e_t gearset, const bool reverse,
              const motor_encoder_units_e_t encoder_units)
     : _port(abs(port)) {
@@ -251,6 +283,14 @@ std::int32_t Motor::get_voltage(void) const {
 	return motor_get_voltage(_port);
 }
 
+motor_snapshot_s_t Motor::snapshot(void) const {
+	motor_snapshot_s_t rtn = {};
+	if (motor_get_snapshot(_port, &rtn) == PROS_ERR) {
+		rtn.sequence = 0;
+	}
+	return rtn;
+}
+
 std::int32_t Motor::get_voltage_limit(void) const {
 	return motor_get_voltage_limit(_port);
 }
@@ -337,30 +377,51 @@ std::int32_t Motor::set_voltage_limit(const std::int32_t limit) const {
 Motor_Group::Motor_Group(const std::initializer_list<Motor> motors)
     : _motors(motors), _motor_group_mutex(pros::Mutex()), _motor_count(motors.size()) {
     assert(_motor_count > 0);
+	_ports.reserve(_motor_count);
+	for (const Motor& motor : _motors) {
+		_ports.push_back(motor.get_port());
+	}
 }
 
 Motor_Group::Motor_Group(const std::vector<std::int8_t> motor_ports)
     : _motor_group_mutex(pros::Mutex()), _motor_count(motor_ports.size()) {
     assert(_motor_count > 0);
+	_motors.reserve(_motor_count);
+	_ports.reserve(_motor_count);
 	for (std::uint8_t i = 0; i < _motor_count; ++i) {
 		_motors.push_back(Motor(motor_ports[i]));
+		_ports.push_back(_motors.back().get_port());
 	}
 }
 
+std::int32_t Motor_Group::_batch_uniform(batch_fn_t batch_fn, const std::int32_t value) {
+	// Groups larger than the number of ports can only contain duplicates, so
+	// they don't get the same-frame guarantee and take the slow path instead
+	if (_motor_count > NUM_V5_PORTS) {
+		std::int32_t out = PROS_SUCCESS;
+		for (std::uint8_t i = 0; i < _motor_count; i++) {
+			if (batch_fn(&_ports[i], 1, &value) == PROS_ERR) {
+				out = PROS_ERR;
+			}
+		}
+		return out;
+	}
+	std::int32_t values[NUM_V5_PORTS];
+	for (std::uint8_t i = 0; i < _motor_count; i++) {
+		values[i] = value;
+	}
+	return batch_fn(_ports.data(), _motor_count, values);
+}
+
 std::int32_t Motor_Group::move(std::int32_t voltage) {
 	claim_mg_mutex(PROS_ERR);
-	std::int32_t out = PROS_SUCCESS;
-	mg_foreach(move(voltage), _motors, out);
+	std::int32_t out = _batch_uniform(motor_batch_move, voltage);
 	give_mg_mutex(PROS_ERR);
 	return out;
 }
 
 std::int32_t Motor_Group::operator=(std::int32_t voltage) {
-	claim_mg_mutex(PROS_ERR);
-	std::int32_t out = PROS_SUCCESS;
-	mg_foreach(move(voltage), _motors, out);
-	give_mg_mutex(PROS_ERR);
-	return out;
+	return move(voltage);
 }
 
 pros::Motor& Motor_Group::operator[](int i) {
@@ -398,20 +459,39 @@ std::int32_t Motor_Group::move_relative(const double position, const std::int32_
 
 std::int32_t Motor_Group::move_velocity(const std::int32_t velocity) {
 	claim_mg_mutex(PROS_ERR);
-	std::int32_t out = PROS_SUCCESS;
-	mg_foreach(move_velocity(velocity), _motors, out);
+	std::int32_t out = _batch_uniform(motor_batch_move_velocity, velocity);
 	give_mg_mutex(PROS_ERR);
 	return out;
 }
 
 std::int32_t Motor_Group::move_voltage(const std::int32_t voltage) {
 	claim_mg_mutex(PROS_ERR);
-	std::int32_t out = PROS_SUCCESS;
-	mg_foreach(move_voltage(voltage), _motors, out);
+	std::int32_t out = _batch_uniform(motor_batch_move_voltage, voltage);
+	give_mg_mutex(PROS_ERR);
+	return out;
+}
+
+std::int32_t Motor_Group::move_velocities(const std::int32_t* const velocities) {
+	claim_mg_mutex(PROS_ERR);
+	std::int32_t out = motor_batch_move_velocity(_ports.data(), _motor_count, velocities);
 	give_mg_mutex(PROS_ERR);
 	return out;
 }
 
+std::int32_t Motor_Group::move_voltages(const std::int32_t* const voltages) {
+	claim_mg_mutex(PROS_ERR);
+	std::int32_t out = motor_batch_move_voltage(_ports.data(), _motor_count, voltages);
+	give_mg_mutex(PROS_ERR);
+	return out;
+}
+
+std::int32_t Motor_Group::read(const std::uint32_t fields, motor_snapshot_s_t* const out) {
+	claim_mg_mutex(PROS_ERR);
+	std::int32_t rtn = motor_batch_read(_ports.data(), _motor_count, fields, out);
+	give_mg_mutex(PROS_ERR);
+	return rtn;
+}
+
 std::int32_t Motor_Group::brake(void) {
 	claim_mg_mutex(PROS_ERR);
 	std::int32_t out = PROS_SUCCESS;
@@ -477,8 +557,9 @@ std::int32_t Motor_Group::tare_position(void) {
 
 std::vector<double> Motor_Group::get_target_positions(void) {
 	std::vector<double> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR_F);
-	for (Motor motor : _motors) {
+	for (const Motor& motor : _motors) {
 		out.push_back(motor.get_target_position());
 	}
 	give_mg_mutex_vector(PROS_ERR_F);
@@ -487,9 +568,12 @@ std::vector<double> Motor_Group::get_target_positions(void) {
 
 std::vector<double> Motor_Group::get_positions(void) {
 	std::vector<double> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR_F);
-	for (Motor motor : _motors) {
-		out.push_back(motor.get_position());
+	if (!batch_read_field(_ports, E_MOTOR_FIELD_POSITION, &motor_snapshot_s_t::position, out)) {
+		for (const Motor& motor : _motors) {
+			out.push_back(motor.get_position());
+		}
 	}
 	give_mg_mutex_vector(PROS_ERR_F);
 	return out;
@@ -497,18 +581,24 @@ std::vector<double> Motor_Group::get_positions(void) {
 
 std::vector<double> Motor_Group::get_efficiencies(void) {
 	std::vector<double> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR_F);
-	for (Motor motor : _motors) {
-		out.push_back(motor.get_efficiency());
+	if (!batch_read_field(_ports, E_MOTOR_FIELD_EFFICIENCY, &motor_snapshot_s_t::efficiency, out)) {
+		for (const Motor& motor : _motors) {
+			out.push_back(motor.get_efficiency());
+		}
 	}
 	give_mg_mutex_vector(PROS_ERR_F);
 	return out;
 }
 std::vector<double> Motor_Group::get_actual_velocities(void) {
 	std::vector<double> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR_F);
-	for (Motor motor : _motors) {
-		out.push_back(motor.get_actual_velocity());
+	if (!batch_read_field(_ports, E_MOTOR_FIELD_ACTUAL_VELOCITY, &motor_snapshot_s_t::actual_velocity, out)) {
+		for (const Motor& motor : _motors) {
+			out.push_back(motor.get_actual_velocity());
+		}
 	}
 	give_mg_mutex_vector(PROS_ERR_F);
 	return out;
@@ -516,8 +606,9 @@ std::vector<double> Motor_Group::get_actual_velocities(void) {
 
 std::vector<pros::motor_brake_mode_e_t> Motor_Group::get_brake_modes(void) {
 	std::vector<pros::motor_brake_mode_e_t> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(E_MOTOR_BRAKE_INVALID);
-	for (Motor motor : _motors) {
+	for (const Motor& motor : _motors) {
 		out.push_back(motor.get_brake_mode());
 	}
 	give_mg_mutex_vector(E_MOTOR_BRAKE_INVALID);
@@ -526,8 +617,9 @@ std::vector<pros::motor_brake_mode_e_t> Motor_Group::get_brake_modes(void) {
 
 std::vector<std::int32_t> Motor_Group::are_over_current(void) {
 	std::vector<std::int32_t> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR);
-	for (Motor motor : _motors) {
+	for (const Motor& motor : _motors) {
 		out.push_back(motor.is_over_current());
 	}
 	give_mg_mutex_vector(PROS_ERR);
@@ -536,8 +628,9 @@ std::vector<std::int32_t> Motor_Group::are_over_current(void) {
 
 std::vector<motor_gearset_e_t> Motor_Group::get_gearing(void) {
 	std::vector<motor_gearset_e_t> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(E_MOTOR_GEARSET_INVALID);
-	for (Motor motor : _motors) {
+	for (const Motor& motor : _motors) {
 		out.push_back(motor.get_gearing());
 	}
 	give_mg_mutex_vector(E_MOTOR_GEARSET_INVALID);
@@ -546,9 +639,12 @@ std::vector<motor_gearset_e_t> Motor_Group::get_gearing(void) {
 
 std::vector<std::int32_t> Motor_Group::get_current_draws(void) {
 	std::vector<std::int32_t> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR);
-	for (Motor motor : _motors) {
-		out.push_back(motor.get_current_draw());
+	if (!batch_read_field(_ports, E_MOTOR_FIELD_CURRENT_DRAW, &motor_snapshot_s_t::current_draw, out)) {
+		for (const Motor& motor : _motors) {
+			out.push_back(motor.get_current_draw());
+		}
 	}
 	give_mg_mutex_vector(PROS_ERR);
 	return out;
@@ -556,8 +652,9 @@ std::vector<std::int32_t> Motor_Group::get_current_draws(void) {
 
 std::vector<std::int32_t> Motor_Group::get_current_limits(void) {
 	std::vector<std::int32_t> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR);
-	for (Motor motor : _motors) {
+	for (const Motor& motor : _motors) {
 		out.push_back(motor.get_current_limit());
 	}
 	give_mg_mutex_vector(PROS_ERR);
@@ -566,8 +663,9 @@ std::vector<std::int32_t> Motor_Group::get_current_limits(void) {
 
 std::vector<std::uint8_t> Motor_Group::get_ports(void) {
 	std::vector<std::uint8_t> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR_BYTE);
-	for (Motor motor : _motors) {
+	for (const Motor& motor : _motors) {
 		out.push_back(motor.get_port());
 	}
 	give_mg_mutex_vector(PROS_ERR_BYTE);
@@ -576,9 +674,12 @@ std::vector<std::uint8_t> Motor_Group::get_ports(void) {
 
 std::vector<std::int32_t> Motor_Group::get_directions(void) {
 	std::vector<std::int32_t> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR);
-	for (Motor motor : _motors) {
-		out.push_back(motor.get_direction());
+	if (!batch_read_field(_ports, E_MOTOR_FIELD_DIRECTION, &motor_snapshot_s_t::direction, out)) {
+		for (const Motor& motor : _motors) {
+			out.push_back(motor.get_direction());
+		}
 	}
 	give_mg_mutex_vector(PROS_ERR);
 	return out;
@@ -586,8 +687,9 @@ std::vector<std::int32_t> Motor_Group::get_directions(void) {
 
 std::vector<std::int32_t> Motor_Group::get_target_velocities(void) {
 	std::vector<std::int32_t> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR);
-	for (Motor motor : _motors) {
+	for (const Motor& motor : _motors) {
 		out.push_back(motor.get_target_velocity());
 	}
 	give_mg_mutex_vector(PROS_ERR);
@@ -596,8 +698,9 @@ std::vector<std::int32_t> Motor_Group::get_target_velocities(void) {
 
 std::vector<std::int32_t> Motor_Group::are_over_temp(void) {
 	std::vector<std::int32_t> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(PROS_ERR);
-	for (Motor motor : _motors) {
+	for (const Motor& motor : _motors) {
 		out.push_back(motor.is_over_temp());
 	}
 	give_mg_mutex_vector(PROS_ERR);
@@ -606,8 +709,9 @@ std::vector<std::int32_t> Motor_Group::are_over_temp(void) {
 
 std::vector<pros::motor_encoder_units_e_t> Motor_Group::get_encoder_units(void) {
 	std::vector<pros::motor_encoder_units_e_t> out;
+	out.reserve(_motor_count);
 	claim_mg_mutex_vector(E_MOTOR_ENCODER_INVALID);
-	for (Motor motor : _motors) {
+	for (const Motor& motor : _motors) {
 		out.push_back(motor.get_encoder_units());
 	}
 	give_mg_mutex_vector(E_MOTOR_ENCODER_INVALID);
@@ -0,0 +1,351 @@
+/**
+ * \file devices/vdml_odometry.c
+ *
+ * Contains the pose estimation service, which integrates the tracking wheels,
+ * Inertial Sensor and GPS Sensor from inside the system daemon.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <math.h>
+
+#include "kapi.h"
+#include "pros/imu.h"
+#include "pros/odometry.h"
+#include "v5_api.h"
+#include "vdml/registry.h"
+#include "vdml/vdml.h"
+
+#define DEGTORAD (M_PI / 180)
+#define METERS_TO_INCHES 39.3701
+
+// Indices of the tracking wheels in odometry_state_s_t
+#define PERPENDICULAR_WHEEL ODOMETRY_MAX_PARALLEL_WHEELS
+#define NUM_WHEELS (ODOMETRY_MAX_PARALLEL_WHEELS + 1)
+
+typedef struct odometry_state {
+	bool running;
+	bool primed;                    // Whether the last readings below are valid
+	odometry_config_s_t config;
+	double last_wheel[NUM_WHEELS];  // The last reading of each wheel, in degrees of the sensor
+	double last_imu;                // The last rotation of the Inertial Sensor
+	uint32_t last_gps;              // The timestamp of the last GPS reading used
+	double x, y, heading;
+} odometry_state_s_t;
+
+static odometry_state_s_t odometry;
+// Guards the state above. The daemon takes it before the sensors' ports.
+static mutex_t odometry_mutex;
+static static_sem_s_t odometry_mutex_buf;
+
+// The daemon writes pose [seq & 1] and then publishes seq, like motor snapshots
+static odometry_pose_s_t odometry_poses[2];
+static uint32_t odometry_seq;
+
+static const odometry_wheel_s_t* get_wheel(const odometry_config_s_t* config, int i) {
+	return i == PERPENDICULAR_WHEEL ? &config->perpendicular : &config->parallel[i];
+}
+
+static bool validate_wheel(const odometry_wheel_s_t* wheel) {
+	if (wheel->sensor == E_ODOMETRY_SENSOR_NONE) {
+		return true;
+	}
+	if (!VALIDATE_PORT_NO(wheel->port - 1)) {
+		errno = ENXIO;
+		return false;
+	}
+	if ((wheel->sensor != E_ODOMETRY_SENSOR_ROTATION && wheel->sensor != E_ODOMETRY_SENSOR_MOTOR) ||
+	    !(wheel->diameter > 0) || wheel->gear_ratio < 0) {
+		errno = EINVAL;
+		return false;
+	}
+	return true;
+}
+
+// Reads a wheel's sensor in degrees. Returns false if the sensor isn't there.
+static bool read_wheel(const odometry_wheel_s_t* wheel, double* degrees) {
+	v5_device_e_t type = wheel->sensor == E_ODOMETRY_SENSOR_MOTOR ? E_DEVICE_MOTOR : E_DEVICE_ROTATION;
+	v5_smart_device_s_t* device = registry_get_device(wheel->port - 1);
+	if (device->device_type != type) {
+		return false;
+	}
+	if (type == E_DEVICE_ROTATION) {
+		*degrees = vexDeviceAbsEncPositionGet(device->device_info) / 100.0;
+	} else {
+		double position = vexDeviceMotorPositionGet(device->device_info);
+		switch (vexDeviceMotorEncoderUnitsGet(device->device_info)) {
+			case kMotorEncoderRotations:
+				*degrees = position * 360;
+				break;
+			case kMotorEncoderCounts:
+				switch (vexDeviceMotorGearingGet(device->device_info)) {
+					case kMotorGearSet_36:
+						*degrees = position * 360 / 1800;
+						break;
+					case kMotorGearSet_06:
+						*degrees = position * 360 / 300;
+						break;
+					default:
+						*degrees = position * 360 / 900;
+						break;
+				}
+				break;
+			default:
+				*degrees = position;
+				break;
+		}
+	}
+	return true;
+}
+
+// Reads the Inertial Sensor's rotation. Returns false if it isn't there or is
+// calibrating.
+static bool read_imu(uint8_t port, double* rotation) {
+	v5_smart_device_s_t* device = registry_get_device(port - 1);
+	if (device->device_type != E_DEVICE_IMU ||
+	    (vexDeviceImuStatusGet(device->device_info) & E_IMU_STATUS_CALIBRATING)) {
+		return false;
+	}
+	*rotation = vexDeviceImuHeadingGet(device->device_info);
+	return true;
+}
+
+// Takes the readings that the next update will be measured from. Returns false
+// if one of the sensors couldn't be read.
+static bool odometry_prime(void) {
+	for (int i = 0; i < NUM_WHEELS; i++) {
+		const odometry_wheel_s_t* wheel = get_wheel(&odometry.config, i);
+		if (wheel->sensor != E_ODOMETRY_SENSOR_NONE && !read_wheel(wheel, &odometry.last_wheel[i])) {
+			return false;
+		}
+	}
+	if (odometry.config.imu_port && !read_imu(odometry.config.imu_port, &odometry.last_imu)) {
+		return false;
+	}
+	return true;
+}
+
+// Blends a new GPS reading into the pose. Returns true if there was one.
+static bool odometry_correct_gps(void) {
+	v5_smart_device_s_t* device = registry_get_device(odometry.config.gps_port - 1);
+	if (device->device_type != E_DEVICE_GPS) {
+		return false;
+	}
+	uint32_t timestamp = vexDeviceGetTimestamp(device->device_info);
+	if (timestamp == odometry.last_gps) {
+		return false;
+	}
+	odometry.last_gps = timestamp;
+	if (odometry.config.gps_max_error > 0 &&
+	    !(vexDeviceGpsErrorGet(device->device_info) <= odometry.config.gps_max_error)) {
+		return false;
+	}
+	V5_DeviceGpsAttitude attitude;
+	vexDeviceGpsAttitudeGet(device->device_info, &attitude, false);
+	double gain = odometry.config.gps_gain;
+	odometry.x += gain * (attitude.position_x * METERS_TO_INCHES - odometry.x);
+	odometry.y += gain * (attitude.position_y * METERS_TO_INCHES - odometry.y);
+	// The GPS heading is wrapped to a turn, so take the shortest way round
+	double error = remainder(vexDeviceGpsDegreesGet(device->device_info) - odometry.heading, 360);
+	odometry.heading += gain * error;
+	return true;
+}
+
+static void odometry_publish(uint32_t status) {
+	odometry_pose_s_t* pose = vdml_snapshot_begin(&odometry_seq, odometry_poses, sizeof(odometry_pose_s_t));
+	pose->timestamp = millis();
+	pose->sequence = odometry_seq + 1;
+	pose->x = odometry.x;
+	pose->y = odometry.y;
+	pose->heading = odometry.heading;
+	pose->status = status;
+	vdml_snapshot_publish(&odometry_seq);
+}
+
+// Bitmap of the V5 ports (0-indexed) of every sensor in a configuration
+static uint32_t odometry_ports(const odometry_config_s_t* config) {
+	uint32_t ports = 0;
+	for (int i = 0; i < NUM_WHEELS; i++) {
+		const odometry_wheel_s_t* wheel = get_wheel(config, i);
+		if (wheel->sensor != E_ODOMETRY_SENSOR_NONE) {
+			ports |= 1U << (wheel->port - 1);
+		}
+	}
+	if (config->imu_port) {
+		ports |= 1U << (config->imu_port - 1);
+	}
+	if (config->gps_port) {
+		ports |= 1U << (config->gps_port - 1);
+	}
+	return ports;
+}
+
+void odometry_init(void) {
+	odometry_mutex = mutex_create_static(&odometry_mutex_buf);
+}
+
+// Reads the sensors and moves the pose by what they measured since the last
+// update. Called with the state and the sensors' ports held.
+static void odometry_integrate(void) {
+	if (!odometry.primed) {
+		odometry.primed = odometry_prime();
+		odometry_publish(odometry.primed ? 0 : E_ODOMETRY_STATUS_SENSOR_ERROR);
+		return;
+	}
+
+	// Distance travelled by each wheel since the last update, in inches
+	double travel[NUM_WHEELS] = {0};
+	double readings[NUM_WHEELS] = {0};
+	for (int i = 0; i < NUM_WHEELS; i++) {
+		const odometry_wheel_s_t* wheel = get_wheel(&odometry.config, i);
+		if (wheel->sensor == E_ODOMETRY_SENSOR_NONE) {
+			continue;
+		}
+		if (!read_wheel(wheel, &readings[i])) {
+			// The motion while the sensor is missing is lost, so start over from
+			// wherever it is when it comes back
+			odometry.primed = false;
+			odometry_publish(E_ODOMETRY_STATUS_SENSOR_ERROR);
+			return;
+		}
+		double ratio = wheel->gear_ratio > 0 ? wheel->gear_ratio : 1;
+		travel[i] = (readings[i] - odometry.last_wheel[i]) * ratio * M_PI * wheel->diameter / 360;
+		if (wheel->reversed) {
+			travel[i] = -travel[i];
+		}
+	}
+
+	// Change in heading, in radians clockwise
+	double turn;
+	double imu = 0;
+	const odometry_wheel_s_t* parallel = odometry.config.parallel;
+	if (odometry.config.imu_port) {
+		if (!read_imu(odometry.config.imu_port, &imu)) {
+			odometry.primed = false;
+			odometry_publish(E_ODOMETRY_STATUS_SENSOR_ERROR);
+			return;
+		}
+		turn = (imu - odometry.last_imu) * DEGTORAD;
+	} else {
+		// A wheel at offset o travels d - o * turn when the center travels d
+		turn = (travel[0] - travel[1]) / (parallel[1].offset - parallel[0].offset);
+	}
+
+	// Forward and sideways travel of the tracking center
+	double forward = 0;
+	int count = 0;
+	for (int i = 0; i < ODOMETRY_MAX_PARALLEL_WHEELS; i++) {
+		if (parallel[i].sensor != E_ODOMETRY_SENSOR_NONE) {
+			forward += travel[i] + parallel[i].offset * turn;
+			count++;
+		}
+	}
+	forward /= count;
+	double sideways = 0;
+	if (odometry.config.perpendicular.sensor != E_ODOMETRY_SENSOR_NONE) {
+		sideways = travel[PERPENDICULAR_WHEEL] - odometry.config.perpendicular.offset * turn;
+	}
+
+	// Integrate along the average heading over the update
+	double heading = odometry.heading * DEGTORAD + turn / 2;
+	odometry.x += forward * sin(heading) + sideways * cos(heading);
+	odometry.y += forward * cos(heading) - sideways * sin(heading);
+	odometry.heading += turn / DEGTORAD;
+
+	for (int i = 0; i < NUM_WHEELS; i++) {
+		odometry.last_wheel[i] = readings[i];
+	}
+	odometry.last_imu = imu;
+
+	uint32_t status = 0;
+	if (odometry.config.gps_port && odometry_correct_gps()) {
+		status |= E_ODOMETRY_STATUS_GPS_CORRECTED;
+	}
+	odometry_publish(status);
+}
+
+void odometry_update(void) {
+	if (!odometry.running) {
+		return;
+	}
+	mutex_take(odometry_mutex, TIMEOUT_MAX);
+	if (odometry.running) {
+		uint32_t claimed = port_mutex_take_set(odometry_ports(&odometry.config));
+		odometry_integrate();
+		port_mutex_give_set(claimed);
+	}
+	mutex_give(odometry_mutex);
+}
+
+int32_t odometry_start(const odometry_config_s_t* const config) {
+	if (config == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	for (int i = 0; i < NUM_WHEELS; i++) {
+		if (!validate_wheel(get_wheel(config, i))) {
+			return PROS_ERR;
+		}
+	}
+	if ((config->imu_port && !VALIDATE_PORT_NO(config->imu_port - 1)) ||
+	    (config->gps_port && !VALIDATE_PORT_NO(config->gps_port - 1))) {
+		errno = ENXIO;
+		return PROS_ERR;
+	}
+	bool has_parallel = false;
+	bool has_both = true;
+	for (int i = 0; i < ODOMETRY_MAX_PARALLEL_WHEELS; i++) {
+		if (config->parallel[i].sensor != E_ODOMETRY_SENSOR_NONE) {
+			has_parallel = true;
+		} else {
+			has_both = false;
+		}
+	}
+	// Two parallel wheels only give the heading if they are apart
+	bool has_heading = config->imu_port || (has_both && config->parallel[0].offset != config->parallel[1].offset);
+	if (!has_parallel || !has_heading || (config->gps_port && !(config->gps_gain >= 0 && config->gps_gain <= 1))) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+
+	mutex_take(odometry_mutex, TIMEOUT_MAX);
+	odometry.config = *config;
+	odometry.primed = false;
+	odometry.last_gps = 0;
+	odometry.running = true;
+	mutex_give(odometry_mutex);
+	return PROS_SUCCESS;
+}
+
+int32_t odometry_stop(void) {
+	odometry.running = false;
+	return PROS_SUCCESS;
+}
+
+int32_t odometry_set_pose(double x, double y, double heading) {
+	mutex_take(odometry_mutex, TIMEOUT_MAX);
+	odometry.x = x;
+	odometry.y = y;
+	odometry.heading = heading;
+	odometry_publish(0);
+	mutex_give(odometry_mutex);
+	return PROS_SUCCESS;
+}
+
+int32_t odometry_get_pose(odometry_pose_s_t* const pose) {
+	if (pose == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	if (!vdml_snapshot_read(&odometry_seq, odometry_poses, sizeof(*pose), pose)) {
+		errno = EAGAIN;
+		return PROS_ERR;
+	}
+	return PROS_SUCCESS;
+}
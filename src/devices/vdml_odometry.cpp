@@ -0,0 +1,41 @@
+/**
+ * \file devices/vdml_odometry.cpp
+ *
+ * Contains the C++ interface to the pose estimation service.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "kapi.h"
+#include "pros/odometry.hpp"
+
+namespace pros {
+namespace odometry {
+using namespace pros::c;
+
+std::int32_t start(const odometry_config_s_t& config) {
+	return odometry_start(&config);
+}
+
+std::int32_t stop(void) {
+	return odometry_stop();
+}
+
+std::int32_t set_pose(double x, double y, double heading) {
+	return odometry_set_pose(x, y, heading);
+}
+
+odometry_pose_s_t get_pose(void) {
+	odometry_pose_s_t pose;
+	if (odometry_get_pose(&pose) != PROS_SUCCESS) {
+		pose = {0, 0, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, 0};
+	}
+	return pose;
+}
+}  // namespace odometry
+}  // namespace pros
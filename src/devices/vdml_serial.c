@@ -20,6 +20,147 @@
 #include "vdml/registry.h"
 #include "vdml/vdml.h"
 
+/**
+ * A port's read buffer. The system daemon moves every byte that VEXos has
+ * received into it once per cycle, so the small VEXos buffer can't overflow
+ * between two reads, and gives the semaphore to wake a blocked reader.
+ *
+ * The buffer is only touched with the port claimed, including by the daemon
+ * when it publishes the port's data.
+ */
+typedef struct serial_buffer {
+	sem_t data;
+	uint32_t waiters;  // Readers blocked on data, which keep the buffer from being freed
+	uint32_t size;
+	uint32_t head;  // The index of the oldest byte
+	uint32_t count;
+	uint8_t bytes[];
+} serial_buffer_s_t;
+
+static serial_buffer_s_t* serial_buffers[NUM_V5_PORTS];
+
+// Returned by the take functions below when they have to wait for more bytes
+#define SERIAL_NOT_READY -1
+
+static uint8_t serial_buffer_at(serial_buffer_s_t* buffer, uint32_t index) {
+	return buffer->bytes[(buffer->head + index) % buffer->size];
+}
+
+// Copies count bytes from the start of the buffer, skipping offset bytes, and
+// then removes discard bytes
+static void serial_buffer_take(serial_buffer_s_t* buffer, uint32_t offset, uint8_t* out, uint32_t count,
+                               uint32_t discard) {
+	for (uint32_t i = 0; i < count; i++) {
+		out[i] = serial_buffer_at(buffer, offset + i);
+	}
+	buffer->head = (buffer->head + discard) % buffer->size;
+	buffer->count -= discard;
+}
+
+// Moves as many bytes as fit from VEXos into the buffer. Returns the number
+// moved.
+static uint32_t serial_buffer_fill(v5_smart_device_s_t* device, serial_buffer_s_t* buffer) {
+	uint32_t total = 0;
+	while (buffer->count < buffer->size) {
+		uint32_t tail = (buffer->head + buffer->count) % buffer->size;
+		uint32_t space = tail >= buffer->head ? buffer->size - tail : buffer->head - tail;
+		int32_t received = vexDeviceGenericSerialReceive(device->device_info, &buffer->bytes[tail], space);
+		if (received <= 0) {
+			break;
+		}
+		buffer->count += received;
+		total += received;
+		if ((uint32_t)received < space) {
+			break;
+		}
+	}
+	return total;
+}
+
+void serial_buffer_update(uint8_t port, v5_smart_device_s_t* device) {
+	serial_buffer_s_t* buffer = serial_buffers[port];
+	if (buffer != NULL && serial_buffer_fill(device, buffer)) {
+		sem_post(buffer->data);
+	}
+}
+
+typedef int32_t (*serial_take_fn_t)(serial_buffer_s_t* buffer, uint8_t* out, int32_t length, int32_t arg);
+
+// Runs take on the port's buffer until it has something, waiting for the
+// daemon to receive more bytes in between
+static int32_t serial_read_blocking(uint8_t port, serial_take_fn_t take, uint8_t* out, int32_t length, int32_t arg,
+                                    uint32_t timeout) {
+	uint32_t start = millis();
+	while (true) {
+		claim_port_i(port - 1, E_DEVICE_SERIAL);
+		serial_buffer_s_t* buffer = serial_buffers[port - 1];
+		if (buffer == NULL) {
+			errno = ENOBUFS;
+			return_port(port - 1, PROS_ERR);
+		}
+		serial_buffer_fill(device, buffer);
+		int32_t rtn = take(buffer, out, length, arg);
+		if (rtn != SERIAL_NOT_READY) {
+			return_port(port - 1, rtn);
+		}
+		uint32_t elapsed = millis() - start;
+		if (timeout != TIMEOUT_MAX && elapsed >= timeout) {
+			errno = EAGAIN;
+			return_port(port - 1, PROS_ERR);
+		}
+		// The buffer may be removed once the port is released, but it isn't
+		// freed until every waiting reader has woken up
+		__atomic_add_fetch(&buffer->waiters, 1, __ATOMIC_RELAXED);
+		port_mutex_give(port - 1);
+		sem_wait(buffer->data, timeout == TIMEOUT_MAX ? TIMEOUT_MAX : timeout - elapsed);
+		__atomic_sub_fetch(&buffer->waiters, 1, __ATOMIC_RELEASE);
+	}
+}
+
+static int32_t serial_take_any(serial_buffer_s_t* buffer, uint8_t* out, int32_t length, int32_t arg) {
+	if (buffer->count == 0) {
+		return SERIAL_NOT_READY;
+	}
+	uint32_t count = buffer->count < (uint32_t)length ? buffer->count : (uint32_t)length;
+	serial_buffer_take(buffer, 0, out, count, count);
+	return count;
+}
+
+static int32_t serial_take_until(serial_buffer_s_t* buffer, uint8_t* out, int32_t length, int32_t delimiter) {
+	for (uint32_t i = 0; i < buffer->count; i++) {
+		if (serial_buffer_at(buffer, i) == delimiter) {
+			if (i > (uint32_t)length) {
+				errno = EMSGSIZE;
+				return PROS_ERR;
+			}
+			serial_buffer_take(buffer, 0, out, i, i + 1);
+			return i;
+		}
+	}
+	if (buffer->count == buffer->size) {
+		// The frame can never fit
+		errno = EMSGSIZE;
+		return PROS_ERR;
+	}
+	return SERIAL_NOT_READY;
+}
+
+static int32_t serial_take_frame(serial_buffer_s_t* buffer, uint8_t* out, int32_t length, int32_t arg) {
+	if (buffer->count < SERIAL_FRAME_PREFIX_SIZE) {
+		return SERIAL_NOT_READY;
+	}
+	uint32_t size = serial_buffer_at(buffer, 0) | (serial_buffer_at(buffer, 1) << 8);
+	if (size > (uint32_t)length || size + SERIAL_FRAME_PREFIX_SIZE > buffer->size) {
+		errno = EMSGSIZE;
+		return PROS_ERR;
+	}
+	if (buffer->count < size + SERIAL_FRAME_PREFIX_SIZE) {
+		return SERIAL_NOT_READY;
+	}
+	serial_buffer_take(buffer, SERIAL_FRAME_PREFIX_SIZE, out, size, size + SERIAL_FRAME_PREFIX_SIZE);
+	return size;
+}
+
 // Control function
 
 int32_t serial_enable(uint8_t port) {
@@ -51,6 +192,58 @@ int32_t serial_set_baudrate(uint8_t port, int32_t baudrate) {
 int32_t serial_flush(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_SERIAL);
 	vexDeviceGenericSerialFlush(device->device_info);
+	if (serial_buffers[port - 1] != NULL) {
+		serial_buffers[port - 1]->count = 0;
+	}
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+int32_t serial_set_read_buffer(uint8_t port, uint32_t size) {
+	if (registry_validate_binding(port - 1, E_DEVICE_SERIAL) != 0) {
+		return PROS_ERR;
+	}
+	if (!port_mutex_take(port - 1)) {
+		errno = EACCES;
+		return PROS_ERR;
+	}
+	serial_buffer_s_t* buffer = serial_buffers[port - 1];
+	if (size == 0) {
+		serial_buffers[port - 1] = NULL;
+		port_mutex_give(port - 1);
+		if (buffer != NULL) {
+			// Wake the blocked readers, which find that the port has no buffer
+			while (__atomic_load_n(&buffer->waiters, __ATOMIC_ACQUIRE)) {
+				sem_post(buffer->data);
+				task_delay(1);
+			}
+			sem_delete(buffer->data);
+			kfree(buffer);
+		}
+		return PROS_SUCCESS;
+	}
+	if (buffer != NULL) {
+		if (buffer->size != size) {
+			errno = EBUSY;
+			return_port(port - 1, PROS_ERR);
+		}
+		return_port(port - 1, PROS_SUCCESS);
+	}
+	buffer = (serial_buffer_s_t*)kmalloc(sizeof(serial_buffer_s_t) + size);
+	if (buffer == NULL) {
+		errno = ENOMEM;
+		return_port(port - 1, PROS_ERR);
+	}
+	buffer->data = sem_binary_create();
+	if (buffer->data == NULL) {
+		kfree(buffer);
+		errno = ENOMEM;
+		return_port(port - 1, PROS_ERR);
+	}
+	buffer->waiters = 0;
+	buffer->size = size;
+	buffer->head = 0;
+	buffer->count = 0;
+	serial_buffers[port - 1] = buffer;
 	return_port(port - 1, PROS_SUCCESS);
 }
 
@@ -58,6 +251,11 @@ int32_t serial_flush(uint8_t port) {
 
 int32_t serial_get_read_avail(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_SERIAL);
+	serial_buffer_s_t* buffer = serial_buffers[port - 1];
+	if (buffer != NULL) {
+		serial_buffer_fill(device, buffer);
+		return_port(port - 1, buffer->count);
+	}
 	int32_t rtn = vexDeviceGenericSerialReceiveAvail(device->device_info);
 	return_port(port - 1, rtn);
 }
@@ -72,22 +270,63 @@ int32_t serial_get_write_free(uint8_t port) {
 
 int32_t serial_peek_byte(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_SERIAL);
+	serial_buffer_s_t* buffer = serial_buffers[port - 1];
+	if (buffer != NULL) {
+		serial_buffer_fill(device, buffer);
+		return_port(port - 1, buffer->count ? serial_buffer_at(buffer, 0) : -1);
+	}
 	int32_t rtn = vexDeviceGenericSerialPeekChar(device->device_info);
 	return_port(port - 1, rtn);
 }
 
 int32_t serial_read_byte(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_SERIAL);
+	serial_buffer_s_t* buffer = serial_buffers[port - 1];
+	if (buffer != NULL) {
+		uint8_t byte;
+		serial_buffer_fill(device, buffer);
+		return_port(port - 1, serial_take_any(buffer, &byte, 1, 0) == 1 ? byte : -1);
+	}
 	int32_t rtn = vexDeviceGenericSerialReadChar(device->device_info);
 	return_port(port - 1, rtn);
 }
 
 int32_t serial_read(uint8_t port, uint8_t* buffer, int32_t length) {
 	claim_port_i(port - 1, E_DEVICE_SERIAL);
+	serial_buffer_s_t* read_buffer = serial_buffers[port - 1];
+	if (read_buffer != NULL) {
+		serial_buffer_fill(device, read_buffer);
+		int32_t rtn = serial_take_any(read_buffer, buffer, length, 0);
+		return_port(port - 1, rtn == SERIAL_NOT_READY ? 0 : rtn);
+	}
 	int32_t rtn = vexDeviceGenericSerialReceive(device->device_info, buffer, length);
 	return_port(port - 1, rtn);
 }
 
+int32_t serial_read_timeout(uint8_t port, uint8_t* buffer, int32_t length, uint32_t timeout) {
+	if (buffer == NULL || length <= 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	return serial_read_blocking(port, serial_take_any, buffer, length, 0, timeout);
+}
+
+int32_t serial_read_until(uint8_t port, uint8_t* buffer, int32_t length, uint8_t delimiter, uint32_t timeout) {
+	if (buffer == NULL || length < 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	return serial_read_blocking(port, serial_take_until, buffer, length, delimiter, timeout);
+}
+
+int32_t serial_read_frame(uint8_t port, uint8_t* buffer, int32_t length, uint32_t timeout) {
+	if (buffer == NULL || length < 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	return serial_read_blocking(port, serial_take_frame, buffer, length, 0, timeout);
+}
+
 // Write functions
 
 int32_t serial_write_byte(uint8_t port, uint8_t buffer) {
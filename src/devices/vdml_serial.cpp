@@ -57,6 +57,23 @@ std::int32_t Serial::read(std::uint8_t* buffer, std::int32_t length) const {
 	return serial_read(_port, buffer, length);
 }
 
+std::int32_t Serial::set_read_buffer(std::uint32_t size) const {
+	return serial_set_read_buffer(_port, size);
+}
+
+std::int32_t Serial::read(std::uint8_t* buffer, std::int32_t length, std::uint32_t timeout) const {
+	return serial_read_timeout(_port, buffer, length, timeout);
+}
+
+std::int32_t Serial::read_until(std::uint8_t* buffer, std::int32_t length, std::uint8_t delimiter,
+                                std::uint32_t timeout) const {
+	return serial_read_until(_port, buffer, length, delimiter, timeout);
+}
+
+std::int32_t Serial::read_frame(std::uint8_t* buffer, std::int32_t length, std::uint32_t timeout) const {
+	return serial_read_frame(_port, buffer, length, timeout);
+}
+
 std::int32_t Serial::write_byte(std::uint8_t buffer) const {
 	return serial_write_byte(_port, buffer);
 }
@@ -10,16 +10,44 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <string.h>
+
 #include "kapi.h"
 #include "v5_api.h"
 #include "v5_apitypes.h"
 #include "vdml/registry.h"
 #include "vdml/vdml.h"
 
+// The most objects that the sensor reports in one frame
+#define VISION_MAX_OBJECTS 16
+
 typedef struct vision_data {
 	vision_zero_e_t zero_point;
 } vision_data_s_t;
 
+// The objects of one signature or color code in a vision cache
+typedef struct vision_bucket {
+	uint16_t sig;
+	uint8_t first;  // index of the bucket's largest object in by_sig
+	uint8_t count;
+} vision_bucket_s_t;
+
+// The objects of the sensor's latest frame, with their coordinates transformed
+typedef struct vision_cache {
+	bool valid;
+	uint32_t timestamp;  // device timestamp of the frame
+	uint32_t sequence;   // number of frames read so far
+	uint8_t object_count;
+	uint8_t bucket_count;
+	uint8_t sig_buckets[8];                          // bucket of each signature, or VISION_MAX_OBJECTS if none
+	vision_object_s_t objects[VISION_MAX_OBJECTS];   // in size order
+	vision_object_s_t by_sig[VISION_MAX_OBJECTS];    // grouped by bucket, in size order within each bucket
+	vision_bucket_s_t buckets[VISION_MAX_OBJECTS];
+} vision_cache_s_t;
+
+// Only used while holding the port
+static vision_cache_s_t vision_caches[NUM_V5_PORTS];
+
 static vision_zero_e_t get_zero_point(uint8_t port) {
 	return ((vision_data_s_t*)registry_get_device(port)->pad)->zero_point;
 }
@@ -42,33 +70,111 @@ static void _vision_transform_coords(uint8_t port, vision_object_s_t* object_ptr
 	object_ptr->y_middle_coord = object_ptr->top_coord - (object_ptr->height / 2);
 }
 
+static vision_bucket_s_t* _vision_find_bucket(vision_cache_s_t* cache, uint32_t sig_id) {
+	if (sig_id < 8) {
+		return cache->sig_buckets[sig_id] < cache->bucket_count ? &cache->buckets[cache->sig_buckets[sig_id]] : NULL;
+	}
+	// Color codes can have any id, but there are only ever a few in a frame
+	for (uint8_t i = 0; i < cache->bucket_count; i++) {
+		if (cache->buckets[i].sig == sig_id) {
+			return &cache->buckets[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Gets the objects of the sensor's latest frame, reading them from the sensor
+ * if a new frame has arrived since they were last read.
+ *
+ * The port must be held.
+ */
+static vision_cache_s_t* _vision_get_cache(uint8_t port, v5_smart_device_s_t* device) {
+	vision_cache_s_t* cache = &vision_caches[port];
+
+	uint32_t timestamp = vexDeviceGetTimestamp(device->device_info);
+	if (cache->valid && cache->timestamp == timestamp) {
+		return cache;
+	}
+
+	int32_t count = vexDeviceVisionObjectCountGet(device->device_info);
+	if (count > VISION_MAX_OBJECTS) {
+		count = VISION_MAX_OBJECTS;
+	} else if (count < 0) {
+		count = 0;
+	}
+
+	// Sort the objects into buckets, counting how many each bucket gets
+	cache->valid = false;
+	cache->bucket_count = 0;
+	memset(cache->sig_buckets, VISION_MAX_OBJECTS, sizeof(cache->sig_buckets));
+	uint8_t object_buckets[VISION_MAX_OBJECTS];
+	for (int32_t i = 0; i < count; i++) {
+		vision_object_s_t* object = &cache->objects[i];
+		if (!vexDeviceVisionObjectGet(device->device_info, i, (V5_DeviceVisionObject*)object)) {
+			errno = EAGAIN;
+			return NULL;
+		}
+		_vision_transform_coords(port, object);
+
+		vision_bucket_s_t* bucket = _vision_find_bucket(cache, object->signature);
+		if (bucket == NULL) {
+			bucket = &cache->buckets[cache->bucket_count];
+			bucket->sig = object->signature;
+			bucket->count = 0;
+			if (object->signature < 8) {
+				cache->sig_buckets[object->signature] = cache->bucket_count;
+			}
+			cache->bucket_count++;
+		}
+		bucket->count++;
+		object_buckets[i] = bucket - cache->buckets;
+	}
+
+	// Then lay the buckets out one after another. The sensor reports objects
+	// largest first, so each bucket stays in size order.
+	uint8_t next[VISION_MAX_OBJECTS];
+	uint8_t first = 0;
+	for (uint8_t i = 0; i < cache->bucket_count; i++) {
+		cache->buckets[i].first = first;
+		next[i] = first;
+		first += cache->buckets[i].count;
+	}
+	for (int32_t i = 0; i < count; i++) {
+		cache->by_sig[next[object_buckets[i]]++] = cache->objects[i];
+	}
+
+	cache->object_count = count;
+	cache->timestamp = timestamp;
+	cache->sequence++;
+	cache->valid = true;
+	return cache;
+}
+
 int32_t vision_get_object_count(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_VISION);
-	int32_t rtn = vexDeviceVisionObjectCountGet(device->device_info);
-	return_port(port - 1, rtn);
+	vision_cache_s_t* cache = _vision_get_cache(port - 1, device);
+	return_port(port - 1, cache->object_count);
+}
+
+int32_t vision_get_frame_sequence(uint8_t port) {
+	claim_port_i(port - 1, E_DEVICE_VISION);
+	vision_cache_s_t* cache = _vision_get_cache(port - 1, device);
+	return_port(port - 1, (int32_t)cache->sequence);
 }
 
 vision_object_s_t vision_get_by_size(uint8_t port, const uint32_t size_id) {
 	vision_object_s_t rtn;
-	v5_smart_device_s_t* device;
+	rtn.signature = VISION_OBJECT_ERR_SIG;
 	if (!claim_port_try(port - 1, E_DEVICE_VISION)) {
-		rtn.signature = VISION_OBJECT_ERR_SIG;
 		return rtn;
 	}
-	device = registry_get_device(port - 1);
-	if ((uint32_t)vexDeviceVisionObjectCountGet(device->device_info) <= size_id) {
+	vision_cache_s_t* cache = _vision_get_cache(port - 1, registry_get_device(port - 1));
+	if (size_id < cache->object_count) {
+		rtn = cache->objects[size_id];
+	} else {
 		errno = EDOM;
-		rtn.signature = VISION_OBJECT_ERR_SIG;
-		goto leave;
 	}
-	if (vexDeviceVisionObjectGet(device->device_info, size_id, (V5_DeviceVisionObject*)&rtn) == 0) {
-		errno = EAGAIN;
-		rtn.signature = VISION_OBJECT_ERR_SIG;
-		goto leave;
-	}
-	_vision_transform_coords(port - 1, &rtn);
-
-leave:
 	port_mutex_give(port - 1);
 	return rtn;
 }
@@ -76,44 +182,17 @@ leave:
 vision_object_s_t _vision_get_by_sig(uint8_t port, const uint32_t size_id, const uint32_t sig_id) {
 	vision_object_s_t rtn;
 	rtn.signature = VISION_OBJECT_ERR_SIG;
-	v5_smart_device_s_t* device;
-	uint8_t count = 0;
-	int32_t object_count = 0;
-
 	if (!claim_port_try(port - 1, E_DEVICE_VISION)) {
-		goto err_return_no_mutex;
-	}
-
-	device = registry_get_device(port - 1);
-	object_count = vexDeviceVisionObjectCountGet(device->device_info);
-	if ((uint32_t)object_count <= size_id) {
-		errno = EDOM;
-		goto err_return;
+		return rtn;
 	}
-
-	for (uint8_t i = 0; i <= object_count; i++) {
-		vision_object_s_t check;
-		if (vexDeviceVisionObjectGet(device->device_info, i, (V5_DeviceVisionObject*)&check) == PROS_ERR) {
-			errno = EAGAIN;
-			rtn = check;
-			goto err_return;
-		}
-		if (check.signature == sig_id) {
-			if (count == size_id) {
-				rtn = check;
-				_vision_transform_coords(port - 1, &rtn);
-				port_mutex_give(port - 1);
-				return rtn;
-			}
-			count++;
-		}
+	vision_cache_s_t* cache = _vision_get_cache(port - 1, registry_get_device(port - 1));
+	vision_bucket_s_t* bucket = _vision_find_bucket(cache, sig_id);
+	if (bucket != NULL && size_id < bucket->count) {
+		rtn = cache->by_sig[bucket->first + size_id];
+	} else {
+		errno = EDOM;  // there aren't size_id objects matching sig_id
 	}
-	errno = EDOM;  // we read through all the objects and none matched sig_id and size_id
-
-err_return:
 	port_mutex_give(port - 1);
-err_return_no_mutex:
-	rtn.signature = VISION_OBJECT_ERR_SIG;
 	return rtn;
 }
 
@@ -131,71 +210,56 @@ vision_object_s_t vision_get_by_code(uint8_t port, const uint32_t size_id, const
 	return _vision_get_by_sig(port, size_id, color_code);
 }
 
+// Copies count objects from the cache, or as many as there are, and marks the
+// rest of object_arr as missing
+static int32_t _vision_copy_objects(const vision_object_s_t* objects, uint32_t count, uint32_t object_count,
+                                    vision_object_s_t* const object_arr) {
+	if (count >= object_count) {
+		count = object_count;
+	} else {
+		errno = EDOM;  // fewer objects than were asked for
+	}
+	memcpy(object_arr, objects, count * sizeof(vision_object_s_t));
+	for (uint32_t i = count; i < object_count; i++) {
+		object_arr[i].signature = VISION_OBJECT_ERR_SIG;
+	}
+	return count;
+}
+
 int32_t vision_read_by_size(uint8_t port, const uint32_t size_id, const uint32_t object_count,
                             vision_object_s_t* const object_arr) {
-	claim_port_i(port - 1, E_DEVICE_VISION);
-	for (uint8_t i = 0; i < object_count; i++) {
+	for (uint32_t i = 0; i < object_count; i++) {
 		object_arr[i].signature = VISION_OBJECT_ERR_SIG;
 	}
-	uint32_t c = vexDeviceVisionObjectCountGet(device->device_info);
-	if (c <= size_id) {
-		port_mutex_give(port - 1);
+	claim_port_i(port - 1, E_DEVICE_VISION);
+	vision_cache_s_t* cache = _vision_get_cache(port - 1, device);
+	if (cache->object_count <= size_id) {
 		errno = EDOM;
-		return PROS_ERR;
-	} else if (c > object_count + size_id) {
-		c = object_count + size_id;
-	}
-
-	for (uint32_t i = size_id; i < c; i++) {
-		if (!vexDeviceVisionObjectGet(device->device_info, i, (V5_DeviceVisionObject*)(object_arr + i))) {
-			errno = EAGAIN;
-			object_arr[i].signature = VISION_OBJECT_ERR_SIG;
-			break;
-		}
-		_vision_transform_coords(port - 1, &object_arr[i]);
+		return_port(port - 1, PROS_ERR);
 	}
-	return_port(port - 1, c);
+	int32_t rtn = _vision_copy_objects(cache->objects + size_id, cache->object_count - size_id, object_count, object_arr);
+	return_port(port - 1, rtn);
 }
 
 int32_t _vision_read_by_sig(uint8_t port, const uint32_t size_id, const uint32_t sig_id, const uint32_t object_count,
                             vision_object_s_t* const object_arr) {
-	claim_port_i(port - 1, E_DEVICE_VISION);
-	for (uint8_t i = 0; i < object_count; i++) {
+	for (uint32_t i = 0; i < object_count; i++) {
 		object_arr[i].signature = VISION_OBJECT_ERR_SIG;
 	}
-	uint32_t c = vexDeviceVisionObjectCountGet(device->device_info);
-	if (c <= size_id) {
+	claim_port_i(port - 1, E_DEVICE_VISION);
+	vision_cache_s_t* cache = _vision_get_cache(port - 1, device);
+	if (cache->object_count <= size_id) {
 		errno = EDOM;
-		port_mutex_give(port - 1);
-		return PROS_ERR;
+		return_port(port - 1, PROS_ERR);
 	}
-	if (c > object_count) {
-		c = object_count;
+	vision_bucket_s_t* bucket = _vision_find_bucket(cache, sig_id);
+	if (bucket == NULL || bucket->count <= size_id) {
+		errno = EDOM;  // no objects matching sig_id from size_id on
+		return_port(port - 1, 0);
 	}
-
-	uint32_t j = 0;                    // track how many objects we've placed into object_arr
-	uint32_t seen = 0;                 // track how many objects we've seen matching sig_id
-	for (uint8_t i = 0; i < c; i++) {  // loop through all objects on sensor
-		// place i-th object on vision sensor on j-th position in object_arr
-		if (!vexDeviceVisionObjectGet(device->device_info, i, (V5_DeviceVisionObject*)(object_arr + j))) {
-			errno = EAGAIN;
-			object_arr[i].signature = VISION_OBJECT_ERR_SIG;
-			goto rtn;
-		}
-		// check if this (j-th) object matches sig_id
-		if (object_arr[j].signature == sig_id) {
-			seen++;
-			if (seen >= size_id) {  // have we seen enough objects to start adding to object_arr?
-				// if so, transform the coords and "commit" it by incrementing j
-				_vision_transform_coords(port - 1, &object_arr[j]);
-				j++;
-				if (j == object_count) goto rtn;
-			}
-		}
-	}
-	errno = EDOM;  // read through all objects and couldn't find enough objects matching filter parameters
-rtn:
-	return_port(port - 1, j);
+	int32_t rtn = _vision_copy_objects(cache->by_sig + bucket->first + size_id, bucket->count - size_id, object_count,
+	                                   object_arr);
+	return_port(port - 1, rtn);
 }
 
 int32_t vision_read_by_sig(uint8_t port, const uint32_t size_id, const uint32_t sig_id, const uint32_t object_count,
@@ -356,6 +420,8 @@ int32_t vision_set_zero_point(uint8_t port, vision_zero_e_t zero_point) {
 		return PROS_ERR;
 	}
 	set_zero_point(port - 1, zero_point);
+	// The cached objects were transformed for the old zero point
+	vision_caches[port - 1].valid = false;
 	return_port(port - 1, PROS_SUCCESS);
 }
 
@@ -53,6 +53,10 @@ int32_t Vision::get_exposure(void) const {
 	return vision_get_exposure(_port);
 }
 
+int32_t Vision::get_frame_sequence(void) const {
+	return vision_get_frame_sequence(_port);
+}
+
 int32_t Vision::get_object_count(void) const {
 	return vision_get_object_count(_port);
 }
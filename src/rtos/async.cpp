@@ -0,0 +1,179 @@
+/**
+ * \file rtos/async.cpp
+ *
+ * Contains the executor that runs pros::async routines.
+ *
+ * The executor is a loop on one task: it resumes every ready routine, moves
+ * routines whose delays have expired or whose waits have succeeded back to the
+ * ready queue, and otherwise sleeps in task_notify_take() until the next of
+ * those can happen.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "pros/async.hpp"
+
+#include <algorithm>
+
+#include "kapi.h"
+#include "system/system_daemon.h"
+
+namespace pros {
+namespace async {
+using namespace pros::c;
+
+namespace {
+// Whether tick a comes after tick b, allowing for the tick count wrapping
+bool after(std::uint32_t a, std::uint32_t b) {
+	return static_cast<std::int32_t>(a - b) > 0;
+}
+
+// Orders the timer heap so that the earliest timer is at the front
+template <class Timer>
+bool later(const Timer& a, const Timer& b) {
+	return after(a.time, b.time);
+}
+}  // namespace
+
+namespace detail {
+std::uint32_t deadline_after(std::uint32_t timeout) {
+	return timeout == TIMEOUT_MAX ? TIMEOUT_MAX : millis() + timeout;
+}
+
+bool try_receive(void* queue, void* buffer) {
+	return queue_recv(static_cast<queue_t>(queue), buffer, 0);
+}
+}  // namespace detail
+
+std::uint32_t next_cycle_time() {
+	std::uint32_t now = millis();
+	// the daemon's release may be slightly in the past or the future
+	std::int32_t to_release = static_cast<std::int32_t>(system_daemon_get_release() - now) % SYSTEM_DAEMON_PERIOD;
+	if (to_release <= 0) {
+		to_release += SYSTEM_DAEMON_PERIOD;
+	}
+	return now + to_release;
+}
+
+void Executor::spawn(Routine<void> routine) {
+	std::coroutine_handle<Routine<void>::promise_type> handle = routine.take();
+	handle.promise().executor = this;
+	handle.promise().detached = true;
+	schedule(handle);
+}
+
+void Executor::schedule(std::coroutine_handle<> routine) {
+	ready.push_back(routine);
+}
+
+void Executor::schedule_at(std::coroutine_handle<> routine, std::uint32_t time) {
+	if (!after(time, millis())) {
+		schedule(routine);
+		return;
+	}
+	timers.push_back({time, routine});
+	std::push_heap(timers.begin(), timers.end(), later<Timer>);
+}
+
+void Executor::add_poller(detail::Poller* poller) {
+	pollers.push_back(poller);
+}
+
+bool Executor::add_notification_waiter(detail::NotificationWaiter* waiter) {
+	if (notifications) {
+		waiter->count = std::exchange(notifications, 0);
+		return false;
+	}
+	notification_waiters.push_back(waiter);
+	return true;
+}
+
+void Executor::wake_timers(std::uint32_t now) {
+	while (!timers.empty() && !after(timers.front().time, now)) {
+		std::pop_heap(timers.begin(), timers.end(), later<Timer>);
+		schedule(timers.back().routine);
+		timers.pop_back();
+	}
+}
+
+void Executor::wake_pollers(std::uint32_t now) {
+	// pollers are checked in the order in which they started waiting, so the
+	// first routine to wait for a mutex is the first to get it
+	std::size_t waiting = 0;
+	for (detail::Poller* poller : pollers) {
+		poller->result = poller->poll();
+		if (poller->result || (poller->deadline != TIMEOUT_MAX && !after(poller->deadline, now))) {
+			schedule(poller->routine);
+		} else {
+			pollers[waiting++] = poller;
+		}
+	}
+	pollers.resize(waiting);
+}
+
+void Executor::wake_notification_waiters(std::uint32_t now) {
+	if (notifications && !notification_waiters.empty()) {
+		detail::NotificationWaiter* waiter = notification_waiters.front();
+		notification_waiters.pop_front();
+		waiter->count = std::exchange(notifications, 0);
+		schedule(waiter->routine);
+	}
+	std::size_t waiting = 0;
+	for (detail::NotificationWaiter* waiter : notification_waiters) {
+		if (waiter->deadline != TIMEOUT_MAX && !after(waiter->deadline, now)) {
+			waiter->count = 0;
+			schedule(waiter->routine);
+		} else {
+			notification_waiters[waiting++] = waiter;
+		}
+	}
+	notification_waiters.resize(waiting);
+}
+
+std::uint32_t Executor::sleep_time(std::uint32_t now) const {
+	// pollers have to be checked on every tick
+	if (!pollers.empty()) {
+		return 1;
+	}
+	std::uint32_t wake = TIMEOUT_MAX;
+	if (!timers.empty()) {
+		wake = timers.front().time;
+	}
+	for (const detail::NotificationWaiter* waiter : notification_waiters) {
+		if (waiter->deadline != TIMEOUT_MAX && (wake == TIMEOUT_MAX || after(wake, waiter->deadline))) {
+			wake = waiter->deadline;
+		}
+	}
+	return wake == TIMEOUT_MAX ? TIMEOUT_MAX : wake - now;
+}
+
+void Executor::run() {
+	task = task_get_current();
+	while (true) {
+		while (!ready.empty()) {
+			std::coroutine_handle<> routine = ready.front();
+			ready.pop_front();
+			routine.resume();
+		}
+
+		std::uint32_t now = millis();
+		wake_timers(now);
+		wake_pollers(now);
+		wake_notification_waiters(now);
+		if (!ready.empty()) {
+			continue;
+		}
+		if (timers.empty() && pollers.empty() && notification_waiters.empty()) {
+			break;
+		}
+		notifications += task_notify_take(true, sleep_time(now));
+	}
+	task = nullptr;
+}
+}  // namespace async
+}  // namespace pros
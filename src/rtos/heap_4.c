@@ -94,6 +94,8 @@ static BlockLink_t xStart, *pxEnd = NULL;
 fragmentation. */
 static size_t xFreeBytesRemaining = 0U;
 static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
 
 /* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
 member of an BlockLink_t structure is set then the block belongs to the
@@ -103,7 +105,7 @@ static size_t xBlockAllocatedBit = 0;
 
 /*-----------------------------------------------------------*/
 
-void *kmalloc( size_t xWantedSize )
+void *heap_malloc( size_t xWantedSize )
 {
 BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
 void *pvReturn = NULL;
@@ -200,6 +202,7 @@ void *pvReturn = NULL;
 					}
 
 					xFreeBytesRemaining -= pxBlock->xBlockSize;
+					xNumberOfSuccessfulAllocations++;
 
 					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
 					{
@@ -253,7 +256,7 @@ void *pvReturn = NULL;
 }
 /*-----------------------------------------------------------*/
 
-void kfree( void *pv )
+void heap_free( void *pv )
 {
 uint8_t *puc = ( uint8_t * ) pv;
 BlockLink_t *pxLink;
@@ -283,6 +286,7 @@ BlockLink_t *pxLink;
 				{
 					/* Add this block to the list of free blocks. */
 					xFreeBytesRemaining += pxLink->xBlockSize;
+					xNumberOfSuccessfulFrees++;
 					traceFREE( pv, pxLink->xBlockSize );
 					prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
 				}
@@ -313,6 +317,78 @@ size_t xPortGetMinimumEverFreeHeapSize( void )
 }
 /*-----------------------------------------------------------*/
 
+void vPortGetHeapStatsFromCritical( HeapStats_t *pxHeapStats )
+{
+BlockLink_t *pxBlock;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY;
+size_t xBucket;
+
+	for( xBucket = 0; xBucket < heapHISTOGRAM_BUCKETS; xBucket++ )
+	{
+		pxHeapStats->xFreeBlockHistogram[ xBucket ] = 0;
+	}
+
+	{
+		pxBlock = xStart.pxNextFreeBlock;
+
+		/* pxBlock will be NULL if the heap has not been initialised. */
+		if( pxBlock != NULL )
+		{
+			do
+			{
+				/* Increment the number of blocks and record the largest and
+				smallest block sizes. */
+				xBlocks++;
+
+				if( pxBlock->xBlockSize > xMaxSize )
+				{
+					xMaxSize = pxBlock->xBlockSize;
+				}
+
+				if( pxBlock->xBlockSize < xMinSize )
+				{
+					xMinSize = pxBlock->xBlockSize;
+				}
+
+				/* Bucket i holds blocks smaller than
+				heapHISTOGRAM_SMALLEST_BUCKET << i, and the last bucket holds
+				everything else. */
+				for( xBucket = 0; xBucket < heapHISTOGRAM_BUCKETS - 1; xBucket++ )
+				{
+					if( pxBlock->xBlockSize < ( heapHISTOGRAM_SMALLEST_BUCKET << xBucket ) )
+					{
+						break;
+					}
+				}
+				pxHeapStats->xFreeBlockHistogram[ xBucket ]++;
+
+				/* Move to the next block in the chain until the last block is
+				reached. */
+				pxBlock = pxBlock->pxNextFreeBlock;
+			} while( pxBlock != pxEnd );
+		}
+
+		pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+		pxHeapStats->xSizeOfSmallestFreeBlockInBytes = ( xBlocks > 0 ) ? xMinSize : 0;
+		pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+	rtos_suspend_all();
+	{
+		vPortGetHeapStatsFromCritical( pxHeapStats );
+	}
+	( void ) rtos_resume_all();
+}
+/*-----------------------------------------------------------*/
+
 void vPortInitialiseBlocks( void )
 {
 	/* This just exists to keep the linker quiet. */
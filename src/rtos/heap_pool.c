@@ -0,0 +1,409 @@
+/**
+ * \file rtos/heap_pool.c
+ *
+ * Size-class pools for small kernel allocations
+ *
+ * kmalloc() used to walk heap_4's first-fit free list with the scheduler
+ * suspended for every allocation, so the time that every other task (including
+ * the system daemon) was locked out grew with the length of the free list.
+ * Most kernel allocations are small and short lived (LVGL objects, linked list
+ * nodes, file arguments), so those are now served from per-size-class free
+ * lists which are popped and pushed in a short critical section. The pools get
+ * memory from heap_4 a slab at a time, so the scheduler is only suspended when
+ * a pool runs dry. Larger allocations go straight to heap_4.
+ *
+ * Every allocation has a small header which records where it came from (a
+ * size class or heap_4), the size that was requested and the task that made
+ * the request, so that kfree() can return it to the right place and keep the
+ * statistics below up to date.
+ *
+ * Slabs are never returned to heap_4: the pools settle at the peak number of
+ * objects needed in each class, which the statistics below make visible.
+ *
+ * Live allocations are attributed to the task that made them. Each task is
+ * given an owner slot on its first allocation. When the task is deleted, the
+ * slot keeps counting whatever the task leaked until it is all freed, and only
+ * then is the slot reused. Slot 0 collects allocations made outside of a task
+ * or after all other slots have been taken.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "rtos/tcb.h"
+#include "system/dev/ser.h"
+#include "v5_api.h"
+
+// Each class's slab is sized to hold several objects of its largest size
+#define SLAB_SIZE 2048
+
+// An allocation's tag holds a marker in the top byte, the owner slot in the
+// next byte and the size class (or HEAP_CLASS) in the low byte
+#define TAG_MARKER 0x50000000
+#define TAG_MARKER_MASK 0xff000000
+#define HEAP_CLASS 0xff
+#define MAKE_TAG(owner, class) (TAG_MARKER | ((owner) << 16) | (class))
+#define TAG_OWNER(tag) (((tag) >> 16) & 0xff)
+#define TAG_CLASS(tag) ((tag)&0xff)
+
+typedef struct pool_header {
+	union {
+		struct pool_header* next;  // while on a free list
+		size_t requested;          // while allocated, for statistics
+	};
+	size_t tag;
+} pool_header_s_t;
+
+#define HEADER_SIZE ((sizeof(pool_header_s_t) + portBYTE_ALIGNMENT - 1) & ~((size_t)portBYTE_ALIGNMENT_MASK))
+
+static const uint16_t class_sizes[KMALLOC_POOL_CLASSES] = {16, 32, 48, 64, 96, 128, 192, 256};
+
+typedef struct pool {
+	pool_header_s_t* free_list;
+	kmalloc_pool_stats_s_t stats;
+} pool_s_t;
+
+typedef struct owner {
+	task_t task;  // NULL if the slot is free or the task has been deleted
+	kmalloc_task_stats_s_t stats;
+} owner_s_t;
+
+static pool_s_t pools[KMALLOC_POOL_CLASSES];
+static kmalloc_stats_s_t heap_stats;
+static owner_s_t owners[KMALLOC_TRACKED_TASKS];
+
+// Allocation trace ring, allocated by kmalloc_trace_start()
+static kmalloc_trace_entry_s_t* trace_ring;
+static size_t trace_size;
+static uint32_t trace_count;
+
+static inline uint8_t size_to_class(size_t size) {
+	for (uint8_t i = 0; i < KMALLOC_POOL_CLASSES; i++) {
+		if (size <= class_sizes[i]) {
+			return i;
+		}
+	}
+	return KMALLOC_POOL_CLASSES;
+}
+
+// Must be called in a critical section
+static uint8_t current_owner(void) {
+	TCB_t* tcb = pxCurrentTCB;
+	if (!tcb) {
+		return 0;
+	}
+	if (tcb->ucHeapOwner) {
+		return tcb->ucHeapOwner;
+	}
+	for (uint8_t i = 1; i < KMALLOC_TRACKED_TASKS; i++) {
+		if (!owners[i].task && !owners[i].stats.live_allocs) {
+			owners[i].task = tcb;
+			memset(&owners[i].stats, 0, sizeof(owners[i].stats));
+			owners[i].stats.task = tcb;
+			strncpy(owners[i].stats.name, tcb->pcTaskName, TASK_NAME_MAX_LEN - 1);
+			tcb->ucHeapOwner = i;
+			return i;
+		}
+	}
+	return 0;
+}
+
+void kmalloc_task_deleted(task_t task) {
+	const uint8_t owner = ((TCB_t*)task)->ucHeapOwner;
+	if (owner) {
+		portENTER_CRITICAL();
+		owners[owner].task = NULL;
+		owners[owner].stats.task = NULL;
+		portEXIT_CRITICAL();
+	}
+}
+
+// Must be called in a critical section
+static void account(uint8_t owner, size_t size, uint8_t op, void* ptr) {
+	kmalloc_task_stats_s_t* stats = &owners[owner].stats;
+	if (op == E_KMALLOC_TRACE_ALLOC) {
+		stats->live_allocs++;
+		stats->live_bytes += size;
+		if (stats->live_bytes > stats->peak_bytes) {
+			stats->peak_bytes = stats->live_bytes;
+		}
+	} else if (op == E_KMALLOC_TRACE_FREE) {
+		stats->live_allocs--;
+		stats->live_bytes -= size;
+	}
+
+	if (trace_ring) {
+		kmalloc_trace_entry_s_t* entry = &trace_ring[trace_count++ % trace_size];
+		entry->timestamp = vexSystemHighResTimeGet();
+		entry->address = (uint32_t)(uintptr_t)ptr;
+		entry->size = size;
+		entry->op = op;
+		entry->owner = owner;
+	}
+}
+
+// Tracks how long a call into heap_4 took. heap_4 suspends the scheduler for
+// most of that time
+static void record_heap_latency(uint64_t start) {
+	uint32_t elapsed = vexSystemHighResTimeGet() - start;
+	portENTER_CRITICAL();
+	heap_stats.heap_total_us += elapsed;
+	if (elapsed > heap_stats.heap_max_us) {
+		heap_stats.heap_max_us = elapsed;
+	}
+	portEXIT_CRITICAL();
+}
+
+static void* timed_heap_malloc(size_t size) {
+	uint64_t start = vexSystemHighResTimeGet();
+	void* ptr = heap_malloc(size);
+	record_heap_latency(start);
+	return ptr;
+}
+
+// Carves a new slab from heap_4 into objects for the given class
+static bool pool_refill(uint8_t class) {
+	const size_t object_size = HEADER_SIZE + class_sizes[class];
+	const size_t count = SLAB_SIZE / object_size;
+	uint8_t* slab = timed_heap_malloc(count * object_size);
+	if (!slab) {
+		return false;
+	}
+
+	// link the objects together before publishing them to the pool
+	pool_header_s_t* first = (pool_header_s_t*)slab;
+	pool_header_s_t* last = first;
+	for (size_t i = 0; i < count; i++) {
+		pool_header_s_t* header = (pool_header_s_t*)(slab + i * object_size);
+		header->tag = MAKE_TAG(0, class);
+		header->next = (i + 1 < count) ? (pool_header_s_t*)(slab + (i + 1) * object_size) : NULL;
+		last = header;
+	}
+
+	pool_s_t* pool = &pools[class];
+	portENTER_CRITICAL();
+	last->next = pool->free_list;
+	pool->free_list = first;
+	pool->stats.slabs++;
+	pool->stats.capacity += count;
+	heap_stats.refills++;
+	portEXIT_CRITICAL();
+	return true;
+}
+
+void* kmalloc(size_t size) {
+	const uint8_t class = size_to_class(size);
+	pool_header_s_t* header;
+
+	if (size == 0 || class == KMALLOC_POOL_CLASSES) {
+		header = timed_heap_malloc(HEADER_SIZE + size);
+		portENTER_CRITICAL();
+		const uint8_t owner = current_owner();
+		if (header) {
+			heap_stats.heap_allocs++;
+			header->tag = MAKE_TAG(owner, HEAP_CLASS);
+		}
+		account(owner, size, header ? E_KMALLOC_TRACE_ALLOC : E_KMALLOC_TRACE_FAIL, header);
+		portEXIT_CRITICAL();
+	} else {
+		pool_s_t* pool = &pools[class];
+		do {
+			portENTER_CRITICAL();
+			header = pool->free_list;
+			if (header) {
+				pool->free_list = header->next;
+				pool->stats.in_use++;
+				pool->stats.requested_bytes += size;
+				pool->stats.allocs++;
+				if (pool->stats.in_use > pool->stats.peak_in_use) {
+					pool->stats.peak_in_use = pool->stats.in_use;
+				}
+				const uint8_t owner = current_owner();
+				header->tag = MAKE_TAG(owner, class);
+				account(owner, size, E_KMALLOC_TRACE_ALLOC, header);
+			}
+			portEXIT_CRITICAL();
+		} while (!header && pool_refill(class));
+
+		if (!header) {
+			portENTER_CRITICAL();
+			account(current_owner(), size, E_KMALLOC_TRACE_FAIL, NULL);
+			portEXIT_CRITICAL();
+		}
+	}
+
+	if (!header) {
+		return NULL;
+	}
+	header->requested = size;
+	return (uint8_t*)header + HEADER_SIZE;
+}
+
+void kfree(void* ptr) {
+	if (!ptr) {
+		return;
+	}
+
+	pool_header_s_t* header = (pool_header_s_t*)((uint8_t*)ptr - HEADER_SIZE);
+	configASSERT((header->tag & TAG_MARKER_MASK) == TAG_MARKER);
+	const uint8_t class = TAG_CLASS(header->tag);
+	const uint8_t owner = TAG_OWNER(header->tag);
+
+	if (class == HEAP_CLASS) {
+		portENTER_CRITICAL();
+		account(owner, header->requested, E_KMALLOC_TRACE_FREE, header);
+		portEXIT_CRITICAL();
+
+		uint64_t start = vexSystemHighResTimeGet();
+		heap_free(header);
+		record_heap_latency(start);
+		return;
+	}
+
+	configASSERT(class < KMALLOC_POOL_CLASSES);
+	pool_s_t* pool = &pools[class];
+
+	portENTER_CRITICAL();
+	account(owner, header->requested, E_KMALLOC_TRACE_FREE, header);
+	pool->stats.in_use--;
+	pool->stats.requested_bytes -= header->requested;
+	header->next = pool->free_list;
+	pool->free_list = header;
+	portEXIT_CRITICAL();
+}
+
+int32_t kmalloc_get_pool_stats(uint8_t size_class, kmalloc_pool_stats_s_t* const stats) {
+	if (size_class >= KMALLOC_POOL_CLASSES || !stats) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	portENTER_CRITICAL();
+	*stats = pools[size_class].stats;
+	portEXIT_CRITICAL();
+	stats->object_size = class_sizes[size_class];
+	return 1;
+}
+
+int32_t kmalloc_get_stats(kmalloc_stats_s_t* const stats) {
+	if (!stats) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	portENTER_CRITICAL();
+	*stats = heap_stats;
+	portEXIT_CRITICAL();
+	return 1;
+}
+
+int32_t kmalloc_get_heap_info(kmalloc_heap_info_s_t* const info) {
+	if (!info) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	HeapStats_t heap;
+	vPortGetHeapStats(&heap);
+	info->free_bytes = heap.xAvailableHeapSpaceInBytes;
+	info->largest_free_block = heap.xSizeOfLargestFreeBlockInBytes;
+	info->min_ever_free_bytes = heap.xMinimumEverFreeBytesRemaining;
+	info->free_blocks = heap.xNumberOfFreeBlocks;
+	for (size_t i = 0; i < KMALLOC_HISTOGRAM_BUCKETS; i++) {
+		info->free_block_histogram[i] = heap.xFreeBlockHistogram[i];
+	}
+	return 1;
+}
+
+int32_t kmalloc_get_task_stats(kmalloc_task_stats_s_t* const stats, const size_t count) {
+	if (!stats) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	size_t found = 0;
+	portENTER_CRITICAL();
+	for (size_t i = 0; i < KMALLOC_TRACKED_TASKS && found < count; i++) {
+		if (i == 0 || owners[i].task || owners[i].stats.live_allocs) {
+			stats[found++] = owners[i].stats;
+		}
+	}
+	portEXIT_CRITICAL();
+	return found;
+}
+
+int32_t kmalloc_trace_start(const size_t entries) {
+	if (entries == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	kmalloc_trace_stop();
+	// the ring comes straight from heap_4 so that it doesn't trace itself
+	kmalloc_trace_entry_s_t* ring = heap_malloc(entries * sizeof(*ring));
+	if (!ring) {
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	portENTER_CRITICAL();
+	trace_size = entries;
+	trace_count = 0;
+	trace_ring = ring;
+	portEXIT_CRITICAL();
+	return 1;
+}
+
+void kmalloc_trace_stop(void) {
+	portENTER_CRITICAL();
+	kmalloc_trace_entry_s_t* ring = trace_ring;
+	trace_ring = NULL;
+	portEXIT_CRITICAL();
+	heap_free(ring);
+}
+
+int32_t kmalloc_trace_dump(void) {
+	if (!ser_stream_enabled(KMALLOC_TRACE_STREAM_ID)) {
+		errno = EACCES;
+		return PROS_ERR;
+	}
+
+	// entries are copied out a frame at a time so that the ring is never held
+	// for longer than it takes to copy one frame
+	kmalloc_trace_entry_s_t frame[512 / sizeof(kmalloc_trace_entry_s_t)];
+	const size_t frame_entries = sizeof(frame) / sizeof(*frame);
+	// only what was recorded before the dump started is sent, so that a busy
+	// system can't keep the dump going forever
+	portENTER_CRITICAL();
+	const uint32_t end = trace_count;
+	uint32_t next = end > trace_size ? end - trace_size : 0;
+	portEXIT_CRITICAL();
+
+	int32_t sent = 0;
+	while (true) {
+		size_t n = 0;
+		portENTER_CRITICAL();
+		if (trace_ring) {
+			// skip anything that was overwritten since the last frame
+			if (trace_count - next > trace_size) {
+				next = trace_count - trace_size;
+			}
+			while (n < frame_entries && (int32_t)(end - next) > 0) {
+				frame[n++] = trace_ring[next++ % trace_size];
+			}
+		}
+		portEXIT_CRITICAL();
+
+		if (n == 0) {
+			break;
+		}
+		if (!ser_output_write_frame(KMALLOC_TRACE_STREAM_ID, (uint8_t*)frame, n * sizeof(*frame), TIMEOUT_MAX)) {
+			errno = EIO;
+			return PROS_ERR;
+		}
+		sent += n;
+	}
+	return sent;
+}
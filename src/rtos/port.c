@@ -31,6 +31,7 @@
 /* Scheduler includes. */
 #include "FreeRTOS.h"
 #include "task.h"
+#include "system/profiler.h"
 
 #ifndef configINTERRUPT_CONTROLLER_BASE_ADDRESS
 	#error configINTERRUPT_CONTROLLER_BASE_ADDRESS must be defined.  See http://www.freertos.org/Using-FreeRTOS-on-Cortex-A-Embedded-Processors.html
@@ -205,6 +206,12 @@ volatile uint32_t ulPortYieldRequired = pdFALSE;
 if the nesting depth is 0. */
 volatile uint32_t ulPortInterruptNesting = 0UL;
 
+/* The address that the latest interrupt of task code returns to and the link
+register of that code, saved by FreeRTOS_IRQ_Handler while
+ulPortProfilerEnabled is set.  Nested interrupts don't save them. */
+volatile uint32_t ulPortInterruptedContext[ 2 ] = { 0UL, 0UL };
+volatile uint32_t ulPortProfilerEnabled = pdFALSE;
+
 /* Used in the asm file. */
 __attribute__(( used )) const uint32_t ulICCIAR = portICCIAR_INTERRUPT_ACKNOWLEDGE_REGISTER_ADDRESS;
 __attribute__(( used )) const uint32_t ulICCEOIR = portICCEOIR_END_OF_INTERRUPT_REGISTER_ADDRESS;
@@ -458,6 +465,11 @@ void vPortExitCritical( void )
 
 void FreeRTOS_Tick_Handler( void )
 {
+	/* Sample the task code that was interrupted.  If the tick nested inside
+	another interrupt, this is the task code that the outer interrupt
+	interrupted, since nested interrupts don't save their context. */
+	profiler_sample( ulPortInterruptedContext[ 0 ], ulPortInterruptedContext[ 1 ] );
+
 	/* Set interrupt mask before altering scheduler structures.   The tick
 	handler runs at the lowest priority, so interrupts cannot already be masked,
 	so there is no need to save and restore the current mask value.  It is
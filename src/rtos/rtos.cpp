@@ -100,6 +100,43 @@ std::uint32_t Task::get_count() {
 	return task_get_count();
 }
 
+task_stats_s_t Task::stats() {
+	task_stats_s_t stats{};
+	task_get_stats(task, &stats);
+	return stats;
+}
+
+std::vector<task_stats_s_t> Task::all_stats() {
+	// leave room for tasks created in the meantime
+	std::vector<task_stats_s_t> stats(task_get_count() + 4);
+	stats.resize(task_get_all_stats(stats.data(), stats.size()));
+	return stats;
+}
+
+task_system_stats_s_t Task::system_stats() {
+	task_system_stats_s_t stats{};
+	task_get_system_stats(&stats);
+	return stats;
+}
+
+PeriodicTask::PeriodicTask(task_fn_t function, void* parameters, std::uint32_t period, std::uint32_t deadline,
+                           bool align, std::uint32_t prio, std::uint16_t stack_depth, const char* name)
+    : Task(task_create_periodic(function, parameters, period, deadline, align, prio, stack_depth, name)) {}
+
+PeriodicTask::PeriodicTask(std::unique_ptr<std::function<void()>> function, std::uint32_t period,
+                           std::uint32_t deadline, bool align, std::uint32_t prio, std::uint16_t stack_depth,
+                           const char* name)
+    : Task(task_create_periodic_owned(
+          [](void* parameters) { (*static_cast<std::function<void()>*>(parameters))(); }, function.release(),
+          [](void* parameters) { delete static_cast<std::function<void()>*>(parameters); }, period, deadline, align,
+          prio, stack_depth, name)) {}
+
+task_periodic_stats_s_t PeriodicTask::get_periodic_stats() {
+	task_periodic_stats_s_t stats{};
+	task_get_periodic_stats(static_cast<task_t>(*this), &stats);
+	return stats;
+}
+
 Mutex::Mutex() : mutex(mutex_create(), mutex_delete) {}
 
 Clock::time_point Clock::now() {
@@ -585,6 +585,157 @@ TimeOut_t xTimeOut;
 }
 /*-----------------------------------------------------------*/
 
+size_t stream_buf_reserve( stream_buf_t xStreamBuffer,
+						   size_t xDataLengthBytes,
+						   uint8_t **ppucFirst,
+						   size_t *pxFirstLength,
+						   uint8_t **ppucSecond,
+						   uint32_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as stream_buf_t is opaque Streambuffer_t. */
+size_t xSpace = 0;
+TimeOut_t xTimeOut;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( ppucFirst );
+	configASSERT( pxFirstLength );
+	configASSERT( ppucSecond );
+
+	/* Message buffers need the length written ahead of the data, so a region
+	can only be reserved in a stream buffer. */
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	if( xDataLengthBytes >= pxStreamBuffer->xLength )
+	{
+		/* The region could never fit, even in an empty buffer. */
+		return 0;
+	}
+
+	if( xTicksToWait != ( uint32_t ) 0 )
+	{
+		vTaskSetTimeOutState( &xTimeOut );
+
+		do
+		{
+			/* Same wait as stream_buf_send(). */
+			taskENTER_CRITICAL();
+			{
+				xSpace = stream_buf_get_unused( pxStreamBuffer );
+
+				if( xSpace < xDataLengthBytes )
+				{
+					( void ) task_notify_clear( NULL );
+
+					configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+					pxStreamBuffer->xTaskWaitingToSend = task_get_current();
+				}
+				else
+				{
+					taskEXIT_CRITICAL();
+					break;
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
+			( void ) task_notify_wait( ( uint32_t ) 0, UINT32_MAX, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToSend = NULL;
+
+		} while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+	}
+	else
+	{
+		xSpace = stream_buf_get_unused( pxStreamBuffer );
+	}
+
+	if( xSpace < xDataLengthBytes )
+	{
+		traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
+		return 0;
+	}
+
+	/* The reader never moves past the head, so the free space past the head
+	belongs to the (single) writer until it commits. */
+	*ppucFirst = &( pxStreamBuffer->pucBuffer[ pxStreamBuffer->xHead ] );
+	*pxFirstLength = configMIN( pxStreamBuffer->xLength - pxStreamBuffer->xHead, xDataLengthBytes );
+	*ppucSecond = pxStreamBuffer->pucBuffer;
+
+	return xDataLengthBytes;
+}
+/*-----------------------------------------------------------*/
+
+void stream_buf_commit( stream_buf_t xStreamBuffer, size_t xDataLengthBytes )
+{
+StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as stream_buf_t is opaque Streambuffer_t. */
+size_t xNextHead;
+
+	configASSERT( pxStreamBuffer );
+
+	if( xDataLengthBytes == ( size_t ) 0 )
+	{
+		return;
+	}
+
+	xNextHead = pxStreamBuffer->xHead + xDataLengthBytes;
+	if( xNextHead >= pxStreamBuffer->xLength )
+	{
+		xNextHead -= pxStreamBuffer->xLength;
+	}
+
+	pxStreamBuffer->xHead = xNextHead;
+	traceSTREAM_BUFFER_SEND( xStreamBuffer, xDataLengthBytes );
+
+	if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+	{
+		sbSEND_COMPLETED( pxStreamBuffer );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t stream_buf_peek( stream_buf_t xStreamBuffer, uint8_t **ppucData )
+{
+StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as stream_buf_t is opaque Streambuffer_t. */
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( ppucData );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	*ppucData = &( pxStreamBuffer->pucBuffer[ pxStreamBuffer->xTail ] );
+
+	/* Only the bytes up to the end of the storage area are contiguous. */
+	return configMIN( prvBytesInBuffer( pxStreamBuffer ), pxStreamBuffer->xLength - pxStreamBuffer->xTail );
+}
+/*-----------------------------------------------------------*/
+
+void stream_buf_consume( stream_buf_t xStreamBuffer, size_t xDataLengthBytes )
+{
+StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as stream_buf_t is opaque Streambuffer_t. */
+size_t xNextTail;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( xDataLengthBytes <= prvBytesInBuffer( pxStreamBuffer ) );
+
+	if( xDataLengthBytes == ( size_t ) 0 )
+	{
+		return;
+	}
+
+	xNextTail = pxStreamBuffer->xTail + xDataLengthBytes;
+	if( xNextTail >= pxStreamBuffer->xLength )
+	{
+		xNextTail -= pxStreamBuffer->xLength;
+	}
+
+	pxStreamBuffer->xTail = xNextTail;
+	traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xDataLengthBytes );
+	sbRECEIVE_COMPLETED( pxStreamBuffer );
+}
+/*-----------------------------------------------------------*/
+
 size_t xStreamBufferSendFromISR( stream_buf_t xStreamBuffer,
 								 const void *pvTxData,
 								 size_t xDataLengthBytes,
@@ -29,6 +29,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "pros/error.h"
+#include "system/system_daemon.h"
 #include "v5_api.h"
 
 /* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
@@ -76,25 +78,8 @@ functions but without including stdio.h here. */
  * is used purely for checking the high water mark for tasks.
  */
 #define tskSTACK_FILL_BYTE	( 0xa5U )
+#define tskSTACK_FILL_WORD	( 0xa5a5a5a5UL )
 
-/* Sometimes the FreeRTOSConfig.h settings only allow a task to be created using
-dynamically allocated RAM, in which case when any task is deleted it is known
-that both the task's stack and TCB need to be freed.  Sometimes the
-FreeRTOSConfig.h settings only allow a task to be created using statically
-allocated RAM, in which case when any task is deleted it is known that neither
-the task's stack or TCB should be freed.  Sometimes the FreeRTOSConfig.h
-settings allow a task to be created using either statically or dynamically
-allocated RAM, in which case a member of the TCB is used to record whether the
-stack and/or TCB were allocated statically or dynamically, so when a task is
-deleted the RAM that was allocated dynamically is freed again and no attempt is
-made to free the RAM that was allocated statically.
-tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE is only true if it is possible for a
-task to be created using either statically or dynamically allocated RAM.  Note
-that if portUSING_MPU_WRAPPERS is 1 then a protected task can be created with
-a statically allocated stack and a dynamically allocated TCB.
-!!!NOTE!!! If the definition of tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE is
-changed then the definition of static_task_s_t must also be updated. */
-#define tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE	( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 #define tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB 		( ( uint8_t ) 0 )
 #define tskSTATICALLY_ALLOCATED_STACK_ONLY 			( ( uint8_t ) 1 )
 #define tskSTATICALLY_ALLOCATED_STACK_AND_TCB		( ( uint8_t ) 2 )
@@ -315,8 +300,41 @@ static volatile uint32_t uxSchedulerSuspended	= ( uint32_t ) pdFALSE;
 
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
-	static uint32_t ulTaskSwitchedInTime = 0UL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
-	static uint32_t ulTotalRunTime = 0UL;		/*< Holds the total amount of execution time as defined by the run time counter clock. */
+	static uint64_t ullTaskSwitchedInTime = 0ULL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
+	static uint64_t ullTotalRunTime = 0ULL;		/*< Holds the total amount of execution time as defined by the run time counter clock. */
+	static uint32_t ulTotalSwitchCount = 0UL;	/*< The number of times a different task has been switched in. */
+
+	/* Time is divided into slots of configRUN_TIME_STATS_SLOT_LENGTH.  Each
+	task keeps its run time in the current slot and in the
+	configRUN_TIME_STATS_WINDOW_SLOTS before it, which are summed to give its
+	run time in the window. */
+	static uint32_t ulStatsSlot = 0UL;			/*< The slot that contains the latest run time counter value. */
+	static uint64_t ullStatsSlotStart = 0ULL;	/*< The run time counter value at which ulStatsSlot started. */
+
+	#define taskSTATS_SLOTS ( configRUN_TIME_STATS_WINDOW_SLOTS + 1 )
+
+#endif
+
+#if ( configUSE_PERIODIC_TASKS == 1 )
+
+	/* The release bookkeeping of a task created by task_create_periodic(). */
+	typedef struct xPERIODIC_TASK
+	{
+		task_fn_t pxJobCode;				/*< The function called for each job. */
+		void *pvParameters;					/*< Passed to pxJobCode. */
+		task_fn_t pxCleanup;				/*< Called with pvParameters when the task is deleted, or NULL. */
+		uint32_t xNextRelease;				/*< The tick at which the next job is released. */
+		task_periodic_stats_s_t xStats;		/*< The timing of the jobs run so far. */
+	} PeriodicTask_t;
+
+	/* The high resolution time, in microseconds, at which xTickCount last
+	changed.  Job releases are measured from here.  It is only kept up to date
+	while uxPeriodicTasks is non-zero, so that programs without periodic tasks
+	don't read the timer on every tick. */
+	static volatile uint64_t ullTickTime = 0ULL;
+	static volatile uint32_t uxPeriodicTasks = 0U;
+
+	#define taskMICROSECONDS_PER_TICK ( ( uint64_t ) 1000000ULL / configTICK_RATE_HZ )
 
 #endif
 
@@ -415,6 +433,16 @@ static void prvAddCurrentTaskToDelayedList( uint32_t timeout, const int32_t xCan
 
 #endif
 
+/*
+ * Adds the time between ullStart and ullEnd to the run time of pxTCB, splitting
+ * it between the run time stats slots that it spans.
+ */
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+	static void prvAddRunTime( TCB_t *pxTCB, uint64_t ullStart, uint64_t ullEnd ) ;
+
+#endif
+
 /*
  * Searches pxList for a task with name name - returning a handle to
  * the task if it is found, or NULL if the task is not found.
@@ -436,6 +464,19 @@ static void prvAddCurrentTaskToDelayedList( uint32_t timeout, const int32_t xCan
 
 #endif
 
+/*
+ * Returns the stack high water mark of pxTCB, or 0 if it is no longer in any
+ * of the task lists or is a newer task that reused its memory.  ulTaskNumber is
+ * the value uxTaskNumber had when pxTCB was listed.  The scheduler is only
+ * suspended for the one scan, so that reporting on every task does not hold it
+ * suspended while every stack is scanned.
+ */
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	static uint32_t prvGetListedStackHighWater( TCB_t *pxTCB, uint32_t ulTaskNumber ) ;
+
+#endif
+
 /*
  * Return the amount of time, in ticks, that will pass before the kernel will
  * next move a task from the Blocked state to the Running state.
@@ -557,6 +598,20 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) ;
 		return xReturn;
 	}
 
+	_Static_assert( sizeof( static_task_s_t ) <= sizeof( task_buffer_s_t ), "TASK_BUFFER_SIZE is too small for a TCB" );
+	_Static_assert( _Alignof( static_task_s_t ) <= _Alignof( task_buffer_s_t ), "task_buffer_s_t is not aligned for a TCB" );
+
+	task_t task_create_from_buffers( task_fn_t pxTaskCode, void * const pvParameters, uint32_t uxPriority, const uint16_t usStackDepth, const char * const pcName, uint32_t * const puxStackBuffer, task_buffer_s_t * const pxTaskBuffer )
+	{
+		if( ( puxStackBuffer == NULL ) || ( pxTaskBuffer == NULL ) )
+		{
+			errno = EINVAL;
+			return NULL;
+		}
+
+		return task_create_static( pxTaskCode, pvParameters, uxPriority, usStackDepth, pcName, ( task_stack_t * ) puxStackBuffer, ( static_task_s_t * ) pxTaskBuffer );
+	}
+
 #endif /* SUPPORT_STATIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 /*-----------------------------------------------------------*/
@@ -773,7 +828,11 @@ uint32_t x;
 
 	#if ( configGENERATE_RUN_TIME_STATS == 1 )
 	{
-		pxNewTCB->ulRunTimeCounter = 0UL;
+		pxNewTCB->ullRunTimeCounter = 0ULL;
+		pxNewTCB->ulSwitchCount = 0UL;
+		pxNewTCB->ulPreemptCount = 0UL;
+		pxNewTCB->ulStatsSlot = ulStatsSlot;
+		( void ) memset( pxNewTCB->ulSlotRunTime, 0x00, sizeof( pxNewTCB->ulSlotRunTime ) );
 	}
 	#endif /* configGENERATE_RUN_TIME_STATS */
 
@@ -806,6 +865,14 @@ uint32_t x;
 	}
 	#endif
 
+	pxNewTCB->ucHeapOwner = 0;
+
+	#if ( configUSE_PERIODIC_TASKS == 1 )
+	{
+		pxNewTCB->pxPeriodic = NULL;
+	}
+	#endif
+
 	/* Initialize the TCB stack to look as if the task was already running,
 	but had been interrupted by the scheduler.  The return address is set
 	to the start of the task function. Once the stack has been initialised
@@ -916,6 +983,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 		void task_notify_when_deleting_hook(task_t);
 		task_notify_when_deleting_hook(task);
+		void kmalloc_task_deleted(task_t);
 
 		taskENTER_CRITICAL();
 		{
@@ -923,6 +991,9 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			being deleted. */
 			pxTCB = prvGetTCBFromHandle( task );
 
+			/* Anything the task still has allocated is now a leak. */
+			kmalloc_task_deleted( pxTCB );
+
 			/* Remove task from the ready list. */
 			if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( uint32_t ) 0 )
 			{
@@ -1116,6 +1187,227 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 #endif /* INCLUDE_vTaskDelayUntil */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_PERIODIC_TASKS == 1 )
+
+	static void prvPeriodicTask( void *pvParameters )
+	{
+	PeriodicTask_t * const pxPeriodic = ( PeriodicTask_t * ) pvParameters;
+	task_periodic_stats_s_t * const pxStats = &( pxPeriodic->xStats );
+	const uint32_t xPeriodTicks = pdMS_TO_TICKS( pxStats->period );
+	const uint64_t ullDeadline = ( uint64_t ) pdMS_TO_TICKS( pxStats->deadline ) * taskMICROSECONDS_PER_TICK;
+	uint32_t xTicksLate;
+	uint64_t ullRelease, ullStart, ullEnd;
+	int32_t xAlreadyYielded;
+
+		for( ;; )
+		{
+			rtos_suspend_all();
+			{
+				const uint32_t xConstTickCount = xTickCount;
+
+				/* A job that ran past the next release delays that job, but any
+				further releases that passed while it ran are dropped so that
+				the task stays on its grid rather than running back to back. */
+				while( ( int32_t ) ( xConstTickCount - pxPeriodic->xNextRelease ) >= ( int32_t ) xPeriodTicks )
+				{
+					pxPeriodic->xNextRelease += xPeriodTicks;
+					pxStats->skipped++;
+				}
+
+				if( ( int32_t ) ( pxPeriodic->xNextRelease - xConstTickCount ) > 0 )
+				{
+					prvAddCurrentTaskToDelayedList( pxPeriodic->xNextRelease - xConstTickCount, pdFALSE );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			xAlreadyYielded = rtos_resume_all();
+
+			if( xAlreadyYielded == pdFALSE )
+			{
+				portYIELD_WITHIN_API();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Work out when the release happened from the time of the latest
+			tick.  The tick count and its time must be read together. */
+			taskENTER_CRITICAL();
+			{
+				xTicksLate = xTickCount - pxPeriodic->xNextRelease;
+				ullRelease = ullTickTime - ( uint64_t ) xTicksLate * taskMICROSECONDS_PER_TICK;
+			}
+			taskEXIT_CRITICAL();
+
+			ullStart = vexSystemHighResTimeGet();
+			pxPeriodic->pxJobCode( pxPeriodic->pvParameters );
+			ullEnd = vexSystemHighResTimeGet();
+
+			rtos_suspend_all();
+			{
+				/* The tick may be stamped a little after the job started. */
+				pxStats->jitter = ( ullStart > ullRelease ) ? ( uint32_t ) ( ullStart - ullRelease ) : 0U;
+				pxStats->exec_time = ( uint32_t ) ( ullEnd - ullStart );
+				pxStats->response_time = ( ullEnd > ullRelease ) ? ( uint32_t ) ( ullEnd - ullRelease ) : 0U;
+
+				if( pxStats->jitter > pxStats->max_jitter )
+				{
+					pxStats->max_jitter = pxStats->jitter;
+				}
+				if( pxStats->exec_time > pxStats->max_exec_time )
+				{
+					pxStats->max_exec_time = pxStats->exec_time;
+				}
+				if( pxStats->response_time > pxStats->max_response_time )
+				{
+					pxStats->max_response_time = pxStats->response_time;
+				}
+				if( pxStats->response_time > ullDeadline )
+				{
+					pxStats->overruns++;
+				}
+
+				pxStats->releases++;
+				pxPeriodic->xNextRelease += xPeriodTicks;
+			}
+			( void ) rtos_resume_all();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static task_t prvCreatePeriodicTask( task_fn_t pxJobCode, void * const pvParameters, task_fn_t pxCleanup, const uint32_t xPeriod, const uint32_t xDeadline, const bool xAlign, uint32_t uxPriority, const uint16_t usStackDepth, const char * const pcName )
+	{
+	PeriodicTask_t *pxPeriodic;
+	task_t xReturn;
+	int32_t xToDaemon;
+	const uint32_t xDeadlineOrPeriod = ( xDeadline == 0U ) ? xPeriod : xDeadline;
+
+		if( ( pdMS_TO_TICKS( xPeriod ) == 0U ) || ( xDeadlineOrPeriod > xPeriod ) ||
+			( ( xAlign != pdFALSE ) && ( ( xPeriod % SYSTEM_DAEMON_PERIOD ) != 0U ) ) )
+		{
+			errno = EINVAL;
+			return NULL;
+		}
+
+		pxPeriodic = ( PeriodicTask_t * ) kmalloc( sizeof( PeriodicTask_t ) );
+		if( pxPeriodic == NULL )
+		{
+			errno = ENOMEM;
+			return NULL;
+		}
+
+		memset( pxPeriodic, 0, sizeof( PeriodicTask_t ) );
+		pxPeriodic->pxJobCode = pxJobCode;
+		pxPeriodic->pvParameters = pvParameters;
+		pxPeriodic->pxCleanup = pxCleanup;
+		pxPeriodic->xStats.period = xPeriod;
+		pxPeriodic->xStats.deadline = xDeadlineOrPeriod;
+
+		/* The scheduler is suspended so that the task cannot run, or be
+		deleted, before it has been given its bookkeeping. */
+		rtos_suspend_all();
+		{
+			pxPeriodic->xNextRelease = xTickCount;
+
+			if( xAlign != pdFALSE )
+			{
+				/* Move the first release onto one of the daemon's ticks.  The
+				daemon's release may be slightly in the past or the future. */
+				xToDaemon = ( int32_t ) ( system_daemon_get_release() - pxPeriodic->xNextRelease ) % SYSTEM_DAEMON_PERIOD;
+				if( xToDaemon < 0 )
+				{
+					xToDaemon += SYSTEM_DAEMON_PERIOD;
+				}
+				pxPeriodic->xNextRelease += ( uint32_t ) xToDaemon;
+			}
+
+			xReturn = task_create( prvPeriodicTask, pxPeriodic, uxPriority, usStackDepth, pcName );
+			if( xReturn != NULL )
+			{
+				( ( TCB_t * ) xReturn )->pxPeriodic = pxPeriodic;
+
+				/* The tick doesn't stamp itself while the scheduler is
+				suspended, so the first periodic task stamps it here for any
+				job that is released before the next tick. */
+				if( uxPeriodicTasks++ == 0U )
+				{
+					ullTickTime = vexSystemHighResTimeGet();
+				}
+			}
+		}
+		( void ) rtos_resume_all();
+
+		if( xReturn == NULL )
+		{
+			/* task_create() has set errno. */
+			kfree( pxPeriodic );
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	task_t task_create_periodic( task_fn_t pxJobCode, void * const pvParameters, const uint32_t xPeriod, const uint32_t xDeadline, const bool xAlign, uint32_t uxPriority, const uint16_t usStackDepth, const char * const pcName )
+	{
+		return prvCreatePeriodicTask( pxJobCode, pvParameters, NULL, xPeriod, xDeadline, xAlign, uxPriority, usStackDepth, pcName );
+	}
+	/*-----------------------------------------------------------*/
+
+	task_t task_create_periodic_owned( task_fn_t pxJobCode, void * const pvParameters, task_fn_t pxCleanup, const uint32_t xPeriod, const uint32_t xDeadline, const bool xAlign, uint32_t uxPriority, const uint16_t usStackDepth, const char * const pcName )
+	{
+	task_t xReturn;
+
+		xReturn = prvCreatePeriodicTask( pxJobCode, pvParameters, pxCleanup, xPeriod, xDeadline, xAlign, uxPriority, usStackDepth, pcName );
+
+		/* The parameters belong to the task from here on, so if there is no
+		task to clean them up when it is deleted they are cleaned up now. */
+		if( xReturn == NULL )
+		{
+			pxCleanup( pvParameters );
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	int32_t task_get_periodic_stats( task_t xTask, task_periodic_stats_s_t * const pxStats )
+	{
+	TCB_t *pxTCB;
+	int32_t xReturn = 1;
+
+		if( pxStats == NULL )
+		{
+			errno = EINVAL;
+			return PROS_ERR;
+		}
+
+		pxTCB = prvGetTCBFromHandle( xTask );
+
+		/* The stats are only written with the scheduler suspended. */
+		rtos_suspend_all();
+		{
+			if( pxTCB->pxPeriodic != NULL )
+			{
+				*pxStats = pxTCB->pxPeriodic->xStats;
+			}
+			else
+			{
+				errno = EINVAL;
+				xReturn = PROS_ERR;
+			}
+		}
+		( void ) rtos_resume_all();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_PERIODIC_TASKS */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskDelay == 1 )
 
 	void task_delay(const uint32_t milliseconds)
@@ -2248,12 +2540,14 @@ TCB_t *pxTCB;
 
 #if ( configUSE_TRACE_FACILITY == 1 )
 
-	uint32_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const uint32_t uxArraySize, uint32_t * const pulTotalRunTime )
+	uint32_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const uint32_t uxArraySize, uint64_t * const pullTotalRunTime )
 	{
-	uint32_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
+	uint32_t uxTask = 0, uxQueue = configMAX_PRIORITIES, ulTaskNumber, x;
 
 		rtos_suspend_all();
 		{
+			ulTaskNumber = uxTaskNumber;
+
 			/* Is there a space in the array for each task in the system? */
 			if( uxArraySize >= uxCurrentNumberOfTasks )
 			{
@@ -2289,20 +2583,20 @@ TCB_t *pxTCB;
 
 				#if ( configGENERATE_RUN_TIME_STATS == 1)
 				{
-					if( pulTotalRunTime != NULL )
+					if( pullTotalRunTime != NULL )
 					{
 						#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
-							portALT_GET_RUN_TIME_COUNTER_VALUE( ( *pulTotalRunTime ) );
+							portALT_GET_RUN_TIME_COUNTER_VALUE( ( *pullTotalRunTime ) );
 						#else
-							*pulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
+							*pullTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
 						#endif
 					}
 				}
 				#else
 				{
-					if( pulTotalRunTime != NULL )
+					if( pullTotalRunTime != NULL )
 					{
-						*pulTotalRunTime = 0;
+						*pullTotalRunTime = 0;
 					}
 				}
 				#endif
@@ -2314,12 +2608,245 @@ TCB_t *pxTCB;
 		}
 		( void ) rtos_resume_all();
 
+		/* The stacks are scanned one at a time once the lists are copied. */
+		for( x = 0; x < uxTask; x++ )
+		{
+			pxTaskStatusArray[ x ].usStackHighWaterMark = ( uint16_t ) prvGetListedStackHighWater( ( TCB_t * ) pxTaskStatusArray[ x ].xHandle, ulTaskNumber );
+		}
+
 		return uxTask;
 	}
 
 #endif /* configUSE_TRACE_FACILITY */
 /*----------------------------------------------------------*/
 
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+	/* Moves ulStatsSlot forward to the slot that contains ullNow. */
+	static void prvAdvanceStatsSlot( uint64_t ullNow )
+	{
+		if( ullNow - ullStatsSlotStart >= ( uint64_t ) configRUN_TIME_STATS_SLOT_LENGTH )
+		{
+			ulStatsSlot = ( uint32_t ) ( ullNow / configRUN_TIME_STATS_SLOT_LENGTH );
+			ullStatsSlotStart = ( uint64_t ) ulStatsSlot * configRUN_TIME_STATS_SLOT_LENGTH;
+		}
+	}
+
+	/* Clears the slots of pxTCB that have started since it last ran, so that
+	its slots hold ulStatsSlot and the slots before it. */
+	static void prvUpdateTaskStatsSlot( TCB_t *pxTCB )
+	{
+	uint32_t ulElapsed = ulStatsSlot - pxTCB->ulStatsSlot;
+
+		if( ulElapsed >= ( uint32_t ) taskSTATS_SLOTS )
+		{
+			( void ) memset( pxTCB->ulSlotRunTime, 0x00, sizeof( pxTCB->ulSlotRunTime ) );
+		}
+		else
+		{
+			while( ulElapsed > 0UL )
+			{
+				pxTCB->ulSlotRunTime[ ( ulStatsSlot - ulElapsed + 1UL ) % taskSTATS_SLOTS ] = 0UL;
+				ulElapsed--;
+			}
+		}
+		pxTCB->ulStatsSlot = ulStatsSlot;
+	}
+
+	static void prvAddRunTime( TCB_t *pxTCB, uint64_t ullStart, uint64_t ullEnd )
+	{
+	uint64_t ullSlotStart;
+	uint32_t ulSlot, ulSlots;
+
+		pxTCB->ullRunTimeCounter += ullEnd - ullStart;
+
+		prvAdvanceStatsSlot( ullEnd );
+		prvUpdateTaskStatsSlot( pxTCB );
+
+		/* Fill the slots from the latest back.  A task that ran for longer
+		than all of the slots just fills every one of them. */
+		ullSlotStart = ullStatsSlotStart;
+		ulSlot = ulStatsSlot;
+		for( ulSlots = 0UL; ( ulSlots < ( uint32_t ) taskSTATS_SLOTS ) && ( ullEnd > ullStart ); ulSlots++ )
+		{
+			uint64_t ullFrom = ( ullStart > ullSlotStart ) ? ullStart : ullSlotStart;
+
+			pxTCB->ulSlotRunTime[ ulSlot % taskSTATS_SLOTS ] += ( uint32_t ) ( ullEnd - ullFrom );
+			ullEnd = ullFrom;
+			ullSlotStart -= configRUN_TIME_STATS_SLOT_LENGTH;
+			ulSlot--;
+		}
+	}
+
+	/* Adds the time that the calling task has been running since it was
+	switched in, so that its statistics are up to date.  Must be called with
+	the scheduler suspended. */
+	static void prvUpdateCurrentRunTime( void )
+	{
+	uint64_t ullNow = portGET_RUN_TIME_COUNTER_VALUE();
+
+		prvAdvanceStatsSlot( ullNow );
+		if( ullNow > ullTaskSwitchedInTime )
+		{
+			prvAddRunTime( pxCurrentTCB, ullTaskSwitchedInTime, ullNow );
+			ullTaskSwitchedInTime = ullNow;
+		}
+	}
+
+	/* The length of the window, which is shorter until the scheduler has been
+	running for a whole window. */
+	static uint32_t prvGetStatsWindow( void )
+	{
+		if( ulStatsSlot < ( uint32_t ) configRUN_TIME_STATS_WINDOW_SLOTS )
+		{
+			return ulStatsSlot * configRUN_TIME_STATS_SLOT_LENGTH;
+		}
+		return configRUN_TIME_STATS_WINDOW_SLOTS * configRUN_TIME_STATS_SLOT_LENGTH;
+	}
+
+	/* The time pxTCB ran in the slots before ulStatsSlot. */
+	static uint32_t prvGetWindowRunTime( TCB_t *pxTCB )
+	{
+	uint32_t ulRunTime = 0UL, ulSlot;
+
+		prvUpdateTaskStatsSlot( pxTCB );
+		for( ulSlot = 1UL; ulSlot <= ( uint32_t ) configRUN_TIME_STATS_WINDOW_SLOTS; ulSlot++ )
+		{
+			ulRunTime += pxTCB->ulSlotRunTime[ ( ulStatsSlot - ulSlot ) % taskSTATS_SLOTS ];
+		}
+		return ulRunTime;
+	}
+
+	static void prvGetTaskStats( TCB_t *pxTCB, task_stats_s_t * const pxStats )
+	{
+	uint32_t ulWindow = prvGetStatsWindow();
+
+		pxStats->task = ( task_t ) pxTCB;
+		( void ) strncpy( pxStats->name, pxTCB->pcTaskName, configMAX_TASK_NAME_LEN );
+		pxStats->priority = pxTCB->uxPriority;
+		pxStats->state = task_get_state( ( task_t ) pxTCB );
+		pxStats->run_time = pxTCB->ullRunTimeCounter;
+		pxStats->window_run_time = prvGetWindowRunTime( pxTCB );
+		pxStats->usage = ( ulWindow > 0UL ) ? ( 100.0f * pxStats->window_run_time ) / ulWindow : 0.0f;
+		pxStats->switches = pxTCB->ulSwitchCount;
+		pxStats->preemptions = pxTCB->ulPreemptCount;
+		pxStats->stack_high_water = 0UL;
+	}
+
+	static uint32_t prvListTaskStatsWithinSingleList( task_stats_s_t *pxStats, uint32_t ulCount, List_t *pxList )
+	{
+	configLIST_VOLATILE TCB_t *pxNextTCB, *pxFirstTCB;
+	uint32_t ulTask = 0;
+
+		if( ( listCURRENT_LIST_LENGTH( pxList ) > ( uint32_t ) 0 ) && ( ulCount > 0UL ) )
+		{
+			listGET_OWNER_OF_NEXT_ENTRY( pxFirstTCB, pxList );
+
+			do
+			{
+				listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList );
+				prvGetTaskStats( ( TCB_t * ) pxNextTCB, &( pxStats[ ulTask ] ) );
+				ulTask++;
+			} while( ( pxNextTCB != pxFirstTCB ) && ( ulTask < ulCount ) );
+		}
+
+		return ulTask;
+	}
+
+	int32_t task_get_stats( task_t xTask, task_stats_s_t * const pxStats )
+	{
+		if( pxStats == NULL )
+		{
+			errno = EINVAL;
+			return PROS_ERR;
+		}
+
+		rtos_suspend_all();
+		{
+			prvUpdateCurrentRunTime();
+			prvGetTaskStats( prvGetTCBFromHandle( xTask ), pxStats );
+		}
+		( void ) rtos_resume_all();
+
+		pxStats->stack_high_water = ( uint32_t ) uxTaskGetStackHighWaterMark( pxStats->task );
+
+		return 1;
+	}
+
+	int32_t task_get_all_stats( task_stats_s_t * const pxStats, const size_t xCount )
+	{
+	uint32_t ulTask = 0, uxQueue = configMAX_PRIORITIES, ulTaskNumber, x;
+
+		if( pxStats == NULL )
+		{
+			errno = EINVAL;
+			return PROS_ERR;
+		}
+
+		rtos_suspend_all();
+		{
+			prvUpdateCurrentRunTime();
+			ulTaskNumber = uxTaskNumber;
+
+			/* The same lists that uxTaskGetSystemState() walks. */
+			do
+			{
+				uxQueue--;
+				ulTask += prvListTaskStatsWithinSingleList( &( pxStats[ ulTask ] ), xCount - ulTask, &( pxReadyTasksLists[ uxQueue ] ) );
+			} while( uxQueue > ( uint32_t ) tskIDLE_PRIORITY );
+
+			ulTask += prvListTaskStatsWithinSingleList( &( pxStats[ ulTask ] ), xCount - ulTask, ( List_t * ) pxDelayedTaskList );
+			ulTask += prvListTaskStatsWithinSingleList( &( pxStats[ ulTask ] ), xCount - ulTask, ( List_t * ) pxOverflowDelayedTaskList );
+
+			#if( INCLUDE_vTaskDelete == 1 )
+			{
+				ulTask += prvListTaskStatsWithinSingleList( &( pxStats[ ulTask ] ), xCount - ulTask, &xTasksWaitingTermination );
+			}
+			#endif
+
+			#if ( INCLUDE_vTaskSuspend == 1 )
+			{
+				ulTask += prvListTaskStatsWithinSingleList( &( pxStats[ ulTask ] ), xCount - ulTask, &xSuspendedTaskList );
+			}
+			#endif
+		}
+		( void ) rtos_resume_all();
+
+		/* The stacks are scanned one at a time once the lists are copied. */
+		for( x = 0; x < ulTask; x++ )
+		{
+			pxStats[ x ].stack_high_water = prvGetListedStackHighWater( ( TCB_t * ) pxStats[ x ].task, ulTaskNumber );
+		}
+
+		return ( int32_t ) ulTask;
+	}
+
+	int32_t task_get_system_stats( task_system_stats_s_t * const pxStats )
+	{
+		if( pxStats == NULL )
+		{
+			errno = EINVAL;
+			return PROS_ERR;
+		}
+
+		rtos_suspend_all();
+		{
+			prvUpdateCurrentRunTime();
+			pxStats->run_time = ullTaskSwitchedInTime;
+			pxStats->window = prvGetStatsWindow();
+			pxStats->idle_time = ( xIdleTaskHandle != NULL ) ? prvGetWindowRunTime( ( TCB_t * ) xIdleTaskHandle ) : 0UL;
+			pxStats->idle_usage = ( pxStats->window > 0UL ) ? ( 100.0f * pxStats->idle_time ) / pxStats->window : 0.0f;
+			pxStats->task_count = uxCurrentNumberOfTasks;
+			pxStats->switches = ulTotalSwitchCount;
+		}
+		( void ) rtos_resume_all();
+
+		return 1;
+	}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*----------------------------------------------------------*/
+
 #if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
 
 	task_t xTaskGetIdleTaskHandle( void )
@@ -2448,6 +2975,18 @@ int32_t xSwitchRequired = pdFALSE;
 		delayed lists if it wraps to 0. */
 		xTickCount = xConstTickCount;
 
+		#if ( configUSE_PERIODIC_TASKS == 1 )
+		{
+			/* Ticks that were held pending while the scheduler was suspended
+			are stamped when they are processed, as that is when the tasks
+			they release become ready. */
+			if( uxPeriodicTasks != 0U )
+			{
+				ullTickTime = vexSystemHighResTimeGet();
+			}
+		}
+		#endif
+
 		if( xConstTickCount == ( uint32_t ) 0U ) /*lint !e774 'if' does not always evaluate to false as it is looking for an overflow. */
 		{
 			taskSWITCH_DELAYED_LISTS();
@@ -2700,33 +3239,34 @@ void vTaskSwitchContext( void )
 	}
 	else
 	{
+	TCB_t * const pxOutgoingTCB = pxCurrentTCB;
+
 		xYieldPending = pdFALSE;
 		traceTASK_SWITCHED_OUT();
 
 		#if ( configGENERATE_RUN_TIME_STATS == 1 )
 		{
 				#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
-					portALT_GET_RUN_TIME_COUNTER_VALUE( ulTotalRunTime );
+					portALT_GET_RUN_TIME_COUNTER_VALUE( ullTotalRunTime );
 				#else
-					ulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
+					ullTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
 				#endif
 
 				/* Add the amount of time the task has been running to the
 				accumulated time so far.  The time the task started running was
-				stored in ulTaskSwitchedInTime.  Note that there is no overflow
-				protection here so count values are only valid until the timer
-				overflows.  The guard against negative values is to protect
-				against suspect run time stat counter implementations - which
-				are provided by the application, not the kernel. */
-				if( ulTotalRunTime > ulTaskSwitchedInTime )
+				stored in ullTaskSwitchedInTime.  The guard against negative
+				values is to protect against suspect run time stat counter
+				implementations - which are provided by the application, not
+				the kernel. */
+				if( ullTotalRunTime > ullTaskSwitchedInTime )
 				{
-					pxCurrentTCB->ulRunTimeCounter += ( ulTotalRunTime - ulTaskSwitchedInTime );
+					prvAddRunTime( pxCurrentTCB, ullTaskSwitchedInTime, ullTotalRunTime );
 				}
 				else
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
-				ulTaskSwitchedInTime = ulTotalRunTime;
+				ullTaskSwitchedInTime = ullTotalRunTime;
 		}
 		#endif /* configGENERATE_RUN_TIME_STATS */
 
@@ -2738,6 +3278,27 @@ void vTaskSwitchContext( void )
 		taskSELECT_HIGHEST_PRIORITY_TASK();
 		traceTASK_SWITCHED_IN();
 
+		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+			if( pxCurrentTCB != pxOutgoingTCB )
+			{
+				pxCurrentTCB->ulSwitchCount++;
+				ulTotalSwitchCount++;
+
+				/* A task that blocked or was suspended has already been
+				removed from its ready list. */
+				if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxOutgoingTCB->uxPriority ] ), &( pxOutgoingTCB->xStateListItem ) ) != pdFALSE )
+				{
+					pxOutgoingTCB->ulPreemptCount++;
+				}
+			}
+		}
+		#else
+		{
+			( void ) pxOutgoingTCB;
+		}
+		#endif /* configGENERATE_RUN_TIME_STATS */
+
 		#if ( configUSE_NEWLIB_REENTRANT == 1 )
 		{
 			/* Switch Newlib's _impure_ptr variable to point to the _reent
@@ -3347,11 +3908,11 @@ static void prvCheckTasksWaitingTermination( void )
 
 		#if ( configGENERATE_RUN_TIME_STATS == 1 )
 		{
-			pxTaskStatus->ulRunTimeCounter = pxTCB->ulRunTimeCounter;
+			pxTaskStatus->ullRunTimeCounter = pxTCB->ullRunTimeCounter;
 		}
 		#else
 		{
-			pxTaskStatus->ulRunTimeCounter = 0;
+			pxTaskStatus->ullRunTimeCounter = 0;
 		}
 		#endif
 
@@ -3434,7 +3995,7 @@ static void prvCheckTasksWaitingTermination( void )
 			do
 			{
 				listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList );
-				vTaskGetInfo( ( task_t ) pxNextTCB, &( pxTaskStatusArray[ uxTask ] ), pdTRUE, eState );
+				vTaskGetInfo( ( task_t ) pxNextTCB, &( pxTaskStatusArray[ uxTask ] ), pdFALSE, eState );
 				uxTask++;
 			} while( pxNextTCB != pxFirstTCB );
 		}
@@ -3455,6 +4016,21 @@ static void prvCheckTasksWaitingTermination( void )
 	{
 	uint32_t ulCount = 0U;
 
+		#if ( portSTACK_GROWTH < 0 )
+		{
+			/* The bottom of the stack is aligned, so most of the unused stack
+			can be checked a word at a time. */
+			const uint32_t *pulStackWord = ( const uint32_t * ) pucStackByte;
+
+			while( *pulStackWord == tskSTACK_FILL_WORD )
+			{
+				pulStackWord++;
+				ulCount += ( uint32_t ) sizeof( uint32_t );
+			}
+			pucStackByte = ( const uint8_t * ) pulStackWord;
+		}
+		#endif
+
 		while( *pucStackByte == ( uint8_t ) tskSTACK_FILL_BYTE )
 		{
 			pucStackByte -= portSTACK_GROWTH;
@@ -3469,6 +4045,82 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	static int32_t prvListContainsTask( List_t *pxList, TCB_t *pxTCB )
+	{
+	list_item_t *pxItem;
+
+		for( pxItem = listGET_HEAD_ENTRY( pxList ); pxItem != listGET_END_MARKER( pxList ); pxItem = listGET_NEXT( pxItem ) )
+		{
+			if( listGET_LIST_ITEM_OWNER( pxItem ) == pxTCB )
+			{
+				return pdTRUE;
+			}
+		}
+
+		return pdFALSE;
+	}
+
+	static uint32_t prvGetListedStackHighWater( TCB_t *pxTCB, uint32_t ulTaskNumber )
+	{
+	uint32_t uxQueue = configMAX_PRIORITIES, ulHighWater = 0UL;
+	int32_t xListed = pdFALSE;
+
+		rtos_suspend_all();
+		{
+			/* The task may have been deleted, and even freed by the idle task,
+			since it was listed, so its TCB is only read once it is found. */
+			while( ( xListed == pdFALSE ) && ( uxQueue > ( uint32_t ) tskIDLE_PRIORITY ) )
+			{
+				uxQueue--;
+				xListed = prvListContainsTask( &( pxReadyTasksLists[ uxQueue ] ), pxTCB );
+			}
+
+			if( xListed == pdFALSE )
+			{
+				xListed = prvListContainsTask( ( List_t * ) pxDelayedTaskList, pxTCB ) || prvListContainsTask( ( List_t * ) pxOverflowDelayedTaskList, pxTCB );
+			}
+
+			#if( INCLUDE_vTaskDelete == 1 )
+			{
+				if( xListed == pdFALSE )
+				{
+					xListed = prvListContainsTask( &xTasksWaitingTermination, pxTCB );
+				}
+			}
+			#endif
+
+			#if ( INCLUDE_vTaskSuspend == 1 )
+			{
+				if( xListed == pdFALSE )
+				{
+					xListed = prvListContainsTask( &xSuspendedTaskList, pxTCB );
+				}
+			}
+			#endif
+
+			if( ( xListed != pdFALSE ) && ( pxTCB->uxTCBNumber <= ulTaskNumber ) )
+			{
+				#if ( portSTACK_GROWTH > 0 )
+				{
+					ulHighWater = ( uint32_t ) prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxEndOfStack );
+				}
+				#else
+				{
+					ulHighWater = ( uint32_t ) prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxStack );
+				}
+				#endif
+			}
+		}
+		( void ) rtos_resume_all();
+
+		return ulHighWater;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
 
 	uint32_t uxTaskGetStackHighWaterMark( task_t task )
@@ -3514,6 +4166,25 @@ static void prvCheckTasksWaitingTermination( void )
 		}
 		#endif /* configUSE_NEWLIB_REENTRANT */
 
+		#if ( configUSE_PERIODIC_TASKS == 1 )
+		{
+			if( pxTCB->pxPeriodic != NULL )
+			{
+				taskENTER_CRITICAL();
+				{
+					uxPeriodicTasks--;
+				}
+				taskEXIT_CRITICAL();
+
+				if( pxTCB->pxPeriodic->pxCleanup != NULL )
+				{
+					pxTCB->pxPeriodic->pxCleanup( pxTCB->pxPeriodic->pvParameters );
+				}
+				kfree( pxTCB->pxPeriodic );
+			}
+		}
+		#endif /* configUSE_PERIODIC_TASKS */
+
 		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ))
 		{
 			/* The task can only have been allocated dynamically - free both
@@ -4084,7 +4755,8 @@ TCB_t *pxTCB;
 	{
 	TaskStatus_t *pxTaskStatusArray;
 	volatile uint32_t uxArraySize, x;
-	uint32_t ulTotalTime, ulStatsAsPercentage;
+	uint64_t ullTotalTime;
+	uint32_t ulStatsAsPercentage;
 
 		#if( configUSE_TRACE_FACILITY != 1 )
 		{
@@ -4132,13 +4804,13 @@ TCB_t *pxTCB;
 		if( pxTaskStatusArray != NULL )
 		{
 			/* Generate the (binary) data. */
-			uxArraySize = uxTaskGetSystemState( pxTaskStatusArray, uxArraySize, &ulTotalTime );
+			uxArraySize = uxTaskGetSystemState( pxTaskStatusArray, uxArraySize, &ullTotalTime );
 
 			/* For percentage calculations. */
-			ulTotalTime /= 100UL;
+			ullTotalTime /= 100ULL;
 
 			/* Avoid divide by zero errors. */
-			if( ulTotalTime > 0 )
+			if( ullTotalTime > 0 )
 			{
 				/* Create a human readable table from the binary data. */
 				for( x = 0; x < uxArraySize; x++ )
@@ -4146,42 +4818,24 @@ TCB_t *pxTCB;
 					/* What percentage of the total run time has the task used?
 					This will always be rounded down to the nearest integer.
 					ulTotalRunTimeDiv100 has already been divided by 100. */
-					ulStatsAsPercentage = pxTaskStatusArray[ x ].ulRunTimeCounter / ulTotalTime;
+					ulStatsAsPercentage = ( uint32_t ) ( pxTaskStatusArray[ x ].ullRunTimeCounter / ullTotalTime );
 
 					/* Write the task name to the string, padding with
 					spaces so it can be printed in tabular form more
 					easily. */
 					pcWriteBuffer = prvWriteNameToBuffer( pcWriteBuffer, pxTaskStatusArray[ x ].pcTaskName );
 
+					/* The run time counter is 64 bits wide so that it doesn't
+					wrap, which neither %u nor %lu can print. */
 					if( ulStatsAsPercentage > 0UL )
 					{
-						#ifdef portLU_PRINTF_SPECIFIER_REQUIRED
-						{
-							sprintf( pcWriteBuffer, "\t%lu\t\t%lu%%\r\n", pxTaskStatusArray[ x ].ulRunTimeCounter, ulStatsAsPercentage );
-						}
-						#else
-						{
-							/* sizeof( int ) == sizeof( long ) so a smaller
-							printf() library can be used. */
-							sprintf( pcWriteBuffer, "\t%u\t\t%u%%\r\n", ( unsigned int ) pxTaskStatusArray[ x ].ulRunTimeCounter, ( unsigned int ) ulStatsAsPercentage );
-						}
-						#endif
+						sprintf( pcWriteBuffer, "\t%llu\t\t%u%%\r\n", ( unsigned long long ) pxTaskStatusArray[ x ].ullRunTimeCounter, ( unsigned int ) ulStatsAsPercentage );
 					}
 					else
 					{
 						/* If the percentage is zero here then the task has
 						consumed less than 1% of the total run time. */
-						#ifdef portLU_PRINTF_SPECIFIER_REQUIRED
-						{
-							sprintf( pcWriteBuffer, "\t%lu\t\t<1%%\r\n", pxTaskStatusArray[ x ].ulRunTimeCounter );
-						}
-						#else
-						{
-							/* sizeof( int ) == sizeof( long ) so a smaller
-							printf() library can be used. */
-							sprintf( pcWriteBuffer, "\t%u\t\t<1%%\r\n", ( unsigned int ) pxTaskStatusArray[ x ].ulRunTimeCounter );
-						}
-						#endif
+						sprintf( pcWriteBuffer, "\t%llu\t\t<1%%\r\n", ( unsigned long long ) pxTaskStatusArray[ x ].ullRunTimeCounter );
 					}
 
 					pcWriteBuffer += strlen( pcWriteBuffer );
@@ -39,23 +39,17 @@ typedef struct dev_file_arg {
 /******************************************************************************/
 /**                         newlib driver functions                          **/
 /******************************************************************************/
-int dev_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
+ssize_t dev_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
 	dev_file_arg_t* file_arg = (dev_file_arg_t*)arg;
-	uint32_t port = file_arg->port;
-	int32_t recv = 0;
-	while (true) {
-		recv = serial_read(port, (uint8_t*)(buffer + recv), len - recv);
-		if (recv == PROS_ERR) {
-			return 0;
-		}
-		if (file_arg->flags & O_NONBLOCK || recv >= 1) {
-			break;
-		}
-		task_delay(2);
+	uint32_t timeout = file_arg->flags & O_NONBLOCK ? 0 : TIMEOUT_MAX;
+	int32_t recv = serial_read_timeout(file_arg->port, buffer, len, timeout);
+	if (recv == PROS_ERR && errno == ENOBUFS &&
+	    serial_set_read_buffer(file_arg->port, SERIAL_DEV_READ_BUFFER_SIZE) != PROS_ERR) {
+		recv = serial_read_timeout(file_arg->port, buffer, len, timeout);
 	}
-	if (recv == 0) {
-		errno = EAGAIN;
-		return 0;
+	if (recv == PROS_ERR) {
+		r->_errno = errno;
+		return -1;
 	}
 	return recv;
 }
@@ -63,10 +57,14 @@ int dev_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t
 int dev_write_r(struct _reent* r, void* const arg, const uint8_t* buf, const size_t len) {
 	dev_file_arg_t* file_arg = (dev_file_arg_t*)arg;
 	uint32_t port = file_arg->port;
-	int32_t wrtn = 0;
+	size_t wrtn = 0;
 	while (true) {
 		int32_t w = serial_write(port, (uint8_t*)(buf + wrtn), len - wrtn);
 		if (w == PROS_ERR) {
+			if (wrtn == 0) {
+				r->_errno = errno;
+				return -1;
+			}
 			return wrtn;
 		}
 		wrtn += w;
@@ -76,8 +74,8 @@ int dev_write_r(struct _reent* r, void* const arg, const uint8_t* buf, const siz
 		task_delay(2);
 	}
 	if (wrtn == 0) {
-		errno = EAGAIN;
-		return 0;
+		r->_errno = EAGAIN;
+		return -1;
 	}
 	return wrtn;
 }
@@ -160,6 +158,10 @@ int dev_open_r(struct _reent* r, const char* path, int flags, int mode) {
 		port = path[0] - ASCII_ZERO;
 	}
 	serial_enable(port);
+	// Reads come from the kernel's buffer so bytes aren't lost between them. The
+	// port may not show up as generic serial until the next device update, in
+	// which case the first read adds the buffer.
+	serial_set_read_buffer(port, SERIAL_DEV_READ_BUFFER_SIZE);
 
 	dev_file_arg_t* arg = (dev_file_arg_t*)kmalloc(sizeof(dev_file_arg_t));
 	arg->port = port;
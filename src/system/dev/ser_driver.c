@@ -27,6 +27,10 @@
 
 #define VEX_SERIAL_BUFFER_SIZE 2047
 
+// Writes larger than this are split into multiple COBS frames so that a single
+// write never needs to reserve most of the output buffer at once
+#define SER_COBS_CHUNK_SIZE SER_MAX_FRAME_SIZE
+
 // ser_file_arg is 2 words (64 bits). The first word is the stream_id
 // (i.e. sout/serr/jinx/kdbg) and is exactly 4 characters. The second word
 // contains flags for serial driver operation
@@ -63,7 +67,6 @@ static mutex_t write_mtx;  // ensures that only one write is happening at a time
 // Write buffer as a stream buffer. Initialized below in ser_driver_initialize
 static static_stream_buf_s_t write_stream_buf;
 static uint8_t write_buf[VEX_SERIAL_BUFFER_SIZE + 1];
-static uint8_t write_scratch_buf[VEX_SERIAL_BUFFER_SIZE];  // scratch buffer
 static stream_buf_t write_stream;
 
 // We maintain a set of streams which should actually be sent over the serial
@@ -95,15 +98,32 @@ extern int32_t inp_buffer_read(uint32_t timeout);
 /**                                                                          **/
 /** vexSerialWriteBuffer doesn't seem to be very thread safe, so the system  **/
 /** daemon flushes an intermediary buffer once before vexBackgroundProcessing**/
-/** calls to write add to the queue. Flushing is optimized because we have   **/
-/** underlying access to the write buffer, as opposed to calling queue_recv  **/
-/** a bunch of times                                                         **/
+/** calls to write add to the queue. Writers encode straight into the stream **/
+/** buffer and the flush hands the buffer's storage directly to the SDK, so  **/
+/** data is never copied through a scratch buffer on either side            **/
 /******************************************************************************/
 void ser_output_flush(void) {
-	size_t len = stream_buf_recv(write_stream, write_scratch_buf, vexSerialWriteFree(1), 0);
-	uint32_t ret = vexSerialWriteBuffer(1, write_scratch_buf, len);
-	if (ret != len) {
-		display_error("WARNING: some serial data has been dropped");
+	size_t budget = vexSerialWriteFree(1);
+	uint8_t* data;
+	size_t len;
+
+	// the data may wrap around the end of the buffer, so this takes two passes
+	for (int i = 0; i < 2 && budget > 0; i++) {
+		len = stream_buf_peek(write_stream, &data);
+		if (len > budget) {
+			len = budget;
+		}
+		if (len == 0) {
+			break;
+		}
+
+		uint32_t ret = vexSerialWriteBuffer(1, data, len);
+		stream_buf_consume(write_stream, len);
+		budget -= len;
+		if (ret != len) {
+			display_error("WARNING: some serial data has been dropped");
+			break;
+		}
 	}
 }
 
@@ -111,10 +131,54 @@ bool ser_output_write(const uint8_t* buffer, size_t size, bool noblock) {
 	return stream_buf_send(write_stream, buffer, size, noblock ? 0 : TIMEOUT_MAX);
 }
 
+// Encodes buffer as a single COBS frame directly into the output buffer:
+// reserve the worst case frame size, then commit only what the encoder actually
+// wrote. The caller must hold write_mtx
+static bool output_write_cobs_frame(uint32_t stream_id, const uint8_t* buffer, size_t size, uint32_t timeout) {
+	const size_t max_len = COBS_ENCODE_MEASURE_MAX(size + sizeof(stream_id)) + 1;
+	uint8_t* first;
+	uint8_t* second;
+	size_t first_len;
+
+	if (!stream_buf_reserve(write_stream, max_len, &first, &first_len, &second, timeout)) {
+		return false;
+	}
+
+	size_t cobs_len = cobs_encode_wrapped(first, first_len, second, buffer, size, stream_id);
+	// frame delimiter
+	if (cobs_len < first_len) {
+		first[cobs_len] = 0;
+	} else {
+		second[cobs_len - first_len] = 0;
+	}
+	stream_buf_commit(write_stream, cobs_len + 1);
+	return true;
+}
+
+bool ser_output_write_frame(uint32_t stream_id, const uint8_t* buffer, size_t size, uint32_t timeout) {
+	// raw binary frames would be indistinguishable from text without COBS
+	if (!(ser_driver_runtime_config & E_COBS_ENABLED) || size > SER_MAX_FRAME_SIZE) {
+		return false;
+	}
+	// the same timeout covers waiting for other writers, so a caller that can't
+	// wait isn't held up behind a long blocking write
+	if (!mutex_take(write_mtx, timeout)) {
+		return false;
+	}
+	bool ret = output_write_cobs_frame(stream_id, buffer, size, timeout);
+	mutex_give(write_mtx);
+	return ret;
+}
+
+bool ser_stream_enabled(uint32_t stream_id) {
+	return list_contains(guaranteed_delivery_streams, guaranteed_delivery_streams_size, stream_id) ||
+	       set_contains(&enabled_streams_set, stream_id);
+}
+
 /******************************************************************************/
 /**                         newlib driver functions                          **/
 /******************************************************************************/
-int ser_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
+ssize_t ser_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
 	// arg isn't used since serial reads aren't stream-based
 	size_t read = 0;
 	int32_t c;
@@ -149,33 +213,33 @@ int ser_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t
 int ser_write_r(struct _reent* r, void* const arg, const uint8_t* buf, const size_t len) {
 	const ser_file_s_t file = *(ser_file_s_t*)arg;
 
-	if (!list_contains(guaranteed_delivery_streams, guaranteed_delivery_streams_size, file.stream_id) &&
-	    !set_contains(&enabled_streams_set, file.stream_id)) {
+	if (!ser_stream_enabled(file.stream_id)) {
 		// the stream isn't a guaranteed delivery or hasn't been enabled so just
 		// pretend like the data was shipped just fine
 		return len;
 	}
 
 	if (ser_driver_runtime_config &= E_COBS_ENABLED) {
-		// allocate stack space for the buffer to be cobs encoded
-		const size_t cobs_len = cobs_encode_measure(buf, len, file.stream_id);
-		uint8_t cobs_buf[cobs_len + 1];
+		const uint32_t timeout = (file.flags & E_NOBLK_WRITE) ? 0 : TIMEOUT_MAX;
 
 		// need to guarantee writes are in order
-		if (!mutex_take(write_mtx, (file.flags & E_NOBLK_WRITE) ? 0 : TIMEOUT_MAX)) {
+		if (!mutex_take(write_mtx, timeout)) {
 			r->_errno = EACCES;
 			return 0;
 		}
-		cobs_encode(cobs_buf, buf, len, file.stream_id);
-		cobs_buf[cobs_len] = 0;
 
-		bool ret = ser_output_write(cobs_buf, cobs_len + 1, file.flags & E_NOBLK_WRITE);
-		mutex_give(write_mtx);
+		size_t written = 0;
+		do {
+			const size_t chunk_len = (len - written) > SER_COBS_CHUNK_SIZE ? SER_COBS_CHUNK_SIZE : (len - written);
+			if (!output_write_cobs_frame(file.stream_id, buf + written, chunk_len, timeout)) {
+				mutex_give(write_mtx);
+				r->_errno = EIO;
+				return written;
+			}
+			written += chunk_len;
+		} while (written < len);
 
-		if (!ret) {
-			r->_errno = EIO;
-			return 0;
-		}
+		mutex_give(write_mtx);
 		return len;
 	} else {
 		// need to guarantee writes are in order
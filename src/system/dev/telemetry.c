@@ -0,0 +1,255 @@
+/**
+ * \file system/dev/telemetry.c
+ *
+ * Binary telemetry stream
+ *
+ * Frames fixed-layout samples and sends them over the serial line on the
+ * 'tlmy' stream. Samples go straight from the caller's structure into a COBS
+ * frame in the serial output queue, so logging a sample costs a copy of the
+ * sample rather than a round of printf formatting. See pros/telemetry.h for the
+ * wire format.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "system/dev/ser.h"
+
+// How often each channel's schema is re-sent, so that a host which connects
+// late can still decode the channel
+#define SCHEMA_INTERVAL_US 1000000
+
+typedef struct __attribute__((packed)) telemetry_header {
+	uint8_t type;
+	uint8_t channel;
+	uint16_t length;
+	uint32_t sequence;
+	uint64_t timestamp;
+} telemetry_header_s_t;
+
+typedef enum { E_CHANNEL_FREE = 0, E_CHANNEL_CLAIMED, E_CHANNEL_READY } channel_state_e_t;
+
+typedef struct telemetry_channel {
+	uint32_t state;  // channel_state_e_t, accessed atomically
+	uint32_t sequence;
+	uint32_t dropped;
+	uint16_t size;
+	// The schema frame, built when the channel is announced. name, format and
+	// fields point into it.
+	uint8_t* schema;
+	size_t schema_len;
+	const char* name;
+	const char* format;
+	const char* fields;
+	// Held while sending the schema, and guards the schema's header and
+	// last_schema
+	mutex_t lock;
+	static_sem_s_t lock_buffer;
+	uint64_t last_schema;
+} telemetry_channel_s_t;
+
+static telemetry_channel_s_t channels[TELEMETRY_MAX_CHANNELS];
+
+// Returns the size of a sample described by format, or 0 if the format is
+// invalid
+static size_t format_size(const char* format) {
+	size_t size = 0;
+	while (*format) {
+		size_t count = 0;
+		while (*format >= '0' && *format <= '9') {
+			count = count * 10 + (*format++ - '0');
+		}
+		if (count == 0) {
+			count = 1;
+		}
+
+		size_t code_size;
+		switch (*format++) {
+			case 'x':
+			case '?':
+			case 'b':
+			case 'B':
+				code_size = 1;
+				break;
+			case 'h':
+			case 'H':
+				code_size = 2;
+				break;
+			case 'i':
+			case 'I':
+			case 'f':
+				code_size = 4;
+				break;
+			case 'q':
+			case 'Q':
+			case 'd':
+				code_size = 8;
+				break;
+			default:
+				return 0;
+		}
+		size += count * code_size;
+		if (size > TELEMETRY_MAX_SAMPLE_SIZE) {
+			return 0;
+		}
+	}
+	return size;
+}
+
+// Builds the channel's schema frame, leaving the sequence number and timestamp
+// to be filled in each time it is sent. Returns false if it couldn't be
+// allocated.
+static bool build_schema(uint8_t channel_id, telemetry_channel_s_t* channel, const char* name, const char* format,
+                         const char* fields) {
+	const char* strings[] = {name, format, fields};
+	size_t len = sizeof(telemetry_header_s_t) + sizeof(channel->size);
+	for (size_t i = 0; i < sizeof(strings) / sizeof(*strings); i++) {
+		len += strlen(strings[i]) + 1;
+	}
+	uint8_t* frame = (uint8_t*)kmalloc(len);
+	if (!frame) {
+		return false;
+	}
+
+	telemetry_header_s_t* header = (telemetry_header_s_t*)frame;
+	header->type = E_TELEMETRY_FRAME_SCHEMA;
+	header->channel = channel_id;
+	header->length = len - sizeof(*header);
+	size_t offset = sizeof(*header);
+	memcpy(frame + offset, &channel->size, sizeof(channel->size));
+	offset += sizeof(channel->size);
+	const char** copies[] = {&channel->name, &channel->format, &channel->fields};
+	for (size_t i = 0; i < sizeof(strings) / sizeof(*strings); i++) {
+		size_t str_len = strlen(strings[i]) + 1;
+		memcpy(frame + offset, strings[i], str_len);
+		*copies[i] = (const char*)frame + offset;
+		offset += str_len;
+	}
+
+	channel->schema = frame;
+	channel->schema_len = len;
+	return true;
+}
+
+// Sends the schema if it hasn't been sent yet or is due to be sent again. The
+// channel's lock must be held.
+static void send_schema(telemetry_channel_s_t* channel, uint64_t now) {
+	if (channel->last_schema != 0 && now - channel->last_schema < SCHEMA_INTERVAL_US) {
+		return;
+	}
+	telemetry_header_s_t* header = (telemetry_header_s_t*)channel->schema;
+	header->sequence = __atomic_load_n(&channel->sequence, __ATOMIC_RELAXED);
+	header->timestamp = now;
+	if (ser_output_write_frame(TELEMETRY_STREAM_ID, channel->schema, channel->schema_len, 0)) {
+		channel->last_schema = now;
+	}
+}
+
+int32_t telemetry_announce(uint8_t channel_id, const char* name, const char* format, const char* fields, size_t size) {
+	if (channel_id >= TELEMETRY_MAX_CHANNELS || !name || !format || !fields || size == 0 ||
+	    format_size(format) != size) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	if (sizeof(telemetry_header_s_t) + sizeof(uint16_t) + strlen(name) + strlen(format) + strlen(fields) + 3 >
+	    SER_MAX_FRAME_SIZE) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+
+	telemetry_channel_s_t* channel = &channels[channel_id];
+	uint32_t expected = E_CHANNEL_FREE;
+	if (!__atomic_compare_exchange_n(&channel->state, &expected, E_CHANNEL_CLAIMED, false, __ATOMIC_ACQUIRE,
+	                                 __ATOMIC_ACQUIRE)) {
+		// another task is announcing this channel right now, so wait for it to finish
+		while (expected == E_CHANNEL_CLAIMED) {
+			task_delay(1);
+			expected = __atomic_load_n(&channel->state, __ATOMIC_ACQUIRE);
+		}
+		if (expected == E_CHANNEL_READY && channel->size == size && !strcmp(channel->name, name) &&
+		    !strcmp(channel->format, format) && !strcmp(channel->fields, fields)) {
+			return 1;
+		}
+		errno = EEXIST;
+		return PROS_ERR;
+	}
+
+	channel->size = size;
+	if (!build_schema(channel_id, channel, name, format, fields)) {
+		__atomic_store_n(&channel->state, E_CHANNEL_FREE, __ATOMIC_RELEASE);
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	channel->lock = mutex_create_static(&channel->lock_buffer);
+	channel->sequence = 0;
+	channel->dropped = 0;
+	channel->last_schema = 0;
+	__atomic_store_n(&channel->state, E_CHANNEL_READY, __ATOMIC_RELEASE);
+
+	if (ser_stream_enabled(TELEMETRY_STREAM_ID)) {
+		mutex_take(channel->lock, TIMEOUT_MAX);
+		send_schema(channel, micros());
+		mutex_give(channel->lock);
+	}
+	return 1;
+}
+
+int32_t telemetry_log(uint8_t channel_id, const void* data, size_t size) {
+	if (channel_id >= TELEMETRY_MAX_CHANNELS) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	telemetry_channel_s_t* channel = &channels[channel_id];
+	if (__atomic_load_n(&channel->state, __ATOMIC_ACQUIRE) != E_CHANNEL_READY || size != channel->size) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+
+	// the sequence number advances even when the sample isn't sent so that the
+	// host can tell that samples went missing
+	const uint32_t sequence = __atomic_fetch_add(&channel->sequence, 1, __ATOMIC_RELAXED);
+	if (!ser_stream_enabled(TELEMETRY_STREAM_ID)) {
+		return 1;
+	}
+
+	const uint64_t now = micros();
+	// a task that finds the lock taken skips the check, as the schema is being
+	// sent already
+	if (mutex_take(channel->lock, 0)) {
+		send_schema(channel, now);
+		mutex_give(channel->lock);
+	}
+
+	uint8_t frame[sizeof(telemetry_header_s_t) + TELEMETRY_MAX_SAMPLE_SIZE];
+	telemetry_header_s_t* header = (telemetry_header_s_t*)frame;
+	header->type = E_TELEMETRY_FRAME_SAMPLE;
+	header->channel = channel_id;
+	header->length = size;
+	header->sequence = sequence;
+	header->timestamp = now;
+	memcpy(frame + sizeof(*header), data, size);
+
+	if (!ser_output_write_frame(TELEMETRY_STREAM_ID, frame, sizeof(*header) + size, 0)) {
+		__atomic_fetch_add(&channel->dropped, 1, __ATOMIC_RELAXED);
+		errno = ENOBUFS;
+		return PROS_ERR;
+	}
+	return 1;
+}
+
+int32_t telemetry_get_dropped(uint8_t channel_id) {
+	if (channel_id >= TELEMETRY_MAX_CHANNELS ||
+	    __atomic_load_n(&channels[channel_id].state, __ATOMIC_ACQUIRE) != E_CHANNEL_READY) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	return __atomic_load_n(&channels[channel_id].dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,135 @@
+/**
+ * \file system/profiler.c
+ *
+ * Statistical profiler
+ *
+ * The RTOS tick interrupts whatever is running once every millisecond. While
+ * the profiler runs, the tick handler records the interrupted address, the
+ * interrupted link register and the running task into a ring of samples. The
+ * more often a function shows up, the more of the CPU it uses. The samples are
+ * symbolized on the host against the ELFs that were uploaded, so the brain
+ * never needs a symbol table.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "rtos/tcb.h"
+#include "system/dev/ser.h"
+#include "system/profiler.h"
+#include "system/trace.h"
+
+#define PROFILER_FRAME_SAMPLE_COUNT ((SER_MAX_FRAME_SIZE - 1) / sizeof(profiler_sample_s_t))
+
+static profiler_sample_s_t* profiler_ring;
+static uint32_t profiler_size;
+// the next sample goes in profiler_ring[profiler_head]
+static uint32_t profiler_head;
+// the number of samples recorded since the profiler was started
+static uint32_t profiler_count;
+// counts calls to profiler_start() so that a dump notices a restart
+static uint32_t profiler_generation;
+
+void profiler_sample(uint32_t pc, uint32_t lr) {
+	if (!ulPortProfilerEnabled) {
+		return;
+	}
+	profiler_sample_s_t* sample = &profiler_ring[profiler_head];
+	sample->pc = pc;
+	sample->lr = lr;
+	sample->task = pxCurrentTCB ? (uint16_t)pxCurrentTCB->uxTCBNumber : 0;
+	sample->reserved = 0;
+	if (++profiler_head == profiler_size) {
+		profiler_head = 0;
+	}
+	profiler_count++;
+}
+
+int32_t profiler_start(const size_t samples) {
+	if (samples == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	profiler_sample_s_t* ring = kmalloc(samples * sizeof(*ring));
+	if (!ring) {
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+
+	// the tick can't run while the ring is swapped
+	portENTER_CRITICAL();
+	profiler_sample_s_t* old = profiler_ring;
+	profiler_ring = ring;
+	profiler_size = samples;
+	profiler_head = 0;
+	profiler_count = 0;
+	profiler_generation++;
+	ulPortProfilerEnabled = true;
+	portEXIT_CRITICAL();
+
+	kfree(old);
+	return PROS_SUCCESS;
+}
+
+void profiler_stop(void) {
+	ulPortProfilerEnabled = false;
+}
+
+int32_t profiler_dump(void) {
+	if (!ser_stream_enabled(PROFILER_STREAM_ID)) {
+		errno = EACCES;
+		return PROS_ERR;
+	}
+	if (trace_send_task_names(PROFILER_STREAM_ID) != PROS_SUCCESS) {
+		return PROS_ERR;
+	}
+
+	// samples are copied out a frame at a time so that the tick is never held
+	// off for longer than it takes to copy one frame. Only what was recorded
+	// before the dump started is sent.
+	uint8_t frame[SER_MAX_FRAME_SIZE];
+	frame[0] = TRACE_FRAME_ENTRIES;
+	portENTER_CRITICAL();
+	const uint32_t generation = profiler_generation;
+	const uint32_t end = profiler_count;
+	uint32_t next = end > profiler_size ? end - profiler_size : 0;
+	portEXIT_CRITICAL();
+
+	int32_t sent = 0;
+	while (true) {
+		size_t n = 0;
+		portENTER_CRITICAL();
+		// stop if the profiler was restarted, and skip anything that was
+		// overwritten since the last frame. If the ring lapped while the last
+		// frame was being sent, that can skip past the end of the dump.
+		if (profiler_generation == generation) {
+			if (profiler_count - next > profiler_size) {
+				next = profiler_count - profiler_size;
+			}
+			// profiler_head is always profiler_count modulo the size
+			while (n < PROFILER_FRAME_SAMPLE_COUNT && (int32_t)(end - next) > 0) {
+				memcpy(frame + 1 + n++ * sizeof(profiler_sample_s_t), &profiler_ring[next++ % profiler_size],
+				       sizeof(profiler_sample_s_t));
+			}
+		}
+		portEXIT_CRITICAL();
+
+		if (n == 0) {
+			break;
+		}
+		if (!ser_output_write_frame(PROFILER_STREAM_ID, frame, 1 + n * sizeof(profiler_sample_s_t), TIMEOUT_MAX)) {
+			errno = EIO;
+			return PROS_ERR;
+		}
+		sent += n;
+	}
+	return sent;
+}
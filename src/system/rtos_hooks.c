@@ -14,6 +14,12 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <string.h>
+#ifdef PROS_HOST
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
 #include "rtos/FreeRTOS.h"
 #include "rtos/semphr.h"
 #include "rtos/task.h"
@@ -22,6 +28,7 @@
 #include "v5_api.h"
 #include "v5_color.h"
 
+#ifndef PROS_HOST
 // Fast interrupt handler
 void FIQInterrupt() {
 	vexSystemFIQInterrupt();
@@ -48,6 +55,7 @@ void PrefetchAbortInterrupt() {
 void _boot() {
 	vexSystemBoot();
 }
+#endif
 
 extern void vPortInstallFreeRTOSVectorTable(void);
 void rtos_initialize() {
@@ -71,14 +79,28 @@ void rtos_tick_interrupt_clear() {
 	vexSystemTimerClearInterrupt();
 }
 
+#ifndef PROS_HOST
 void vApplicationFPUSafeIRQHandler(uint32_t ulICCIAR) {
 	vexSystemApplicationIRQHandler(ulICCIAR);
 }
+#endif
 
 void vInitialiseTimerForRunTimeStats(void) {
 	vexSystemWatchdogReinitRtos();
 }
 
+// Writes a number straight to the serial line without going through newlib,
+// which may not be usable when this is called
+static void write_number(size_t n) {
+	uint8_t buf[10];
+	size_t i = sizeof(buf);
+	do {
+		buf[--i] = '0' + n % 10;
+		n /= 10;
+	} while (n && i);
+	vexSerialWriteBuffer(1, buf + i, sizeof(buf) - i);
+}
+
 void vApplicationMallocFailedHook(void) {
 	// Called if a call to kmalloc() fails because there is insufficient free
 	// memory available in the FreeRTOS heap.  kmalloc() is called internally by
@@ -87,8 +109,23 @@ void vApplicationMallocFailedHook(void) {
 	// configTOTAL_HEAP_SIZE configuration constant in FreeRTOSConfig.h.
 	taskDISABLE_INTERRUPTS();
 
-	for (;;)
-		;
+	// Report who ran out and how fragmented the heap was, since there's no way to
+	// find out afterwards. The scheduler can't be suspended with interrupts
+	// masked, but nothing can touch the heap now either.
+	HeapStats_t stats;
+	vPortGetHeapStatsFromCritical(&stats);
+	vexSerialWriteBuffer(1, (uint8_t*)"FATAL ERROR!! Task ", 19);
+	vexSerialWriteBuffer(1, (uint8_t*)pxCurrentTCB->pcTaskName, strlen(pxCurrentTCB->pcTaskName));
+	vexSerialWriteBuffer(1, (uint8_t*)" ran out of kernel heap! Free bytes: ", 37);
+	write_number(stats.xAvailableHeapSpaceInBytes);
+	vexSerialWriteBuffer(1, (uint8_t*)", largest free block: ", 22);
+	write_number(stats.xSizeOfLargestFreeBlockInBytes);
+	vexSerialWriteBuffer(1, (uint8_t*)"\n", 1);
+
+#ifdef PROS_HOST
+	abort();
+#endif
+	for (;;) vexBackgroundProcessing();
 }
 
 void vApplicationStackOverflowHook(task_t pxTask, char* pcTaskName) {
@@ -103,6 +140,9 @@ void vApplicationStackOverflowHook(task_t pxTask, char* pcTaskName) {
 	// configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2.  This hook function is
 	// called if a stack overflow is detected.
 	taskDISABLE_INTERRUPTS();
+#ifdef PROS_HOST
+	abort();
+#endif
 	for (;;) vexBackgroundProcessing();
 	;
 }
@@ -129,6 +169,12 @@ void vAssertCalled(const char* pcFile, unsigned long ulLine) {
 	(void)pcFile;
 	(void)ulLine;
 
+#ifdef PROS_HOST
+	// There's no debugger to step out with, so fail loudly instead of hanging
+	fprintf(stderr, "Assertion failed: %s:%lu\n", pcFile, ulLine);
+	abort();
+#endif
+
 	taskENTER_CRITICAL();
 	{
 		// Set ul to a non-zero value using the debugger to step out of
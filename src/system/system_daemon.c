@@ -13,10 +13,15 @@
 
 #include "kapi.h"
 #include "system/optimizers.h"
+#include "system/system_daemon.h"
 #include "system/user_functions.h"
 #include "v5_api.h"
 
 extern void vdml_background_processing();
+extern void vdml_update_window_open();
+extern void vdml_update_window_close();
+extern void vdml_publish_snapshots();
+extern void controller_screen_update(void);
 
 extern void port_mutex_take_all();
 extern void port_mutex_give_all();
@@ -37,6 +42,9 @@ static void _competition_initialize_task(void* ign);
 static void _initialize_task(void* ign);
 static void _system_daemon_task(void* ign);
 
+// The tick of the daemon's next release, see system_daemon_get_release()
+static uint32_t daemon_time;
+
 enum state_task { E_OPCONTROL_TASK = 0, E_AUTON_TASK, E_DISABLED_TASK, E_COMP_INIT_TASK };
 
 char task_names[4][32] = {"User Operator Control (PROS)", "User Autonomous (PROS)", "User Disabled (PROS)",
@@ -47,17 +55,17 @@ extern void ser_output_flush(void);
 
 // does the basic background operations that need to occur every 2ms
 static inline void do_background_operations() {
-	port_mutex_take_all();
 	ser_output_flush();
-	rtos_suspend_all();
+	vdml_update_window_open();
 	vexBackgroundProcessing();
-	rtos_resume_all();
+	vdml_update_window_close();
+	vdml_publish_snapshots();
+	controller_screen_update();
 	vdml_background_processing();
-	port_mutex_give_all();
 }
 
 static void _system_daemon_task(void* ign) {
-	uint32_t time = millis();
+	daemon_time = millis();
 	// Initialize status to an invalid state to force an update the first loop
 	uint32_t status = (uint32_t)(1 << 8);
 	uint32_t task_state;
@@ -76,8 +84,8 @@ static void _system_daemon_task(void* ign) {
 	competition_task = task_create_static(_initialize_task, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT,
 	                                      "User Initialization (PROS)", competition_task_stack, &competition_task_buffer);
 
-	time = millis();
-	while (!task_notify_take(true, 2)) {
+	daemon_time = millis();
+	while (!task_notify_take(true, SYSTEM_DAEMON_PERIOD)) {
 		// wait for initialize to finish
 		do_background_operations();
 	}
@@ -118,10 +126,14 @@ static void _system_daemon_task(void* ign) {
 			                                      task_names[state], competition_task_stack, &competition_task_buffer);
 		}
 
-		task_delay_until(&time, 2);
+		task_delay_until(&daemon_time, SYSTEM_DAEMON_PERIOD);
 	}
 }
 
+uint32_t system_daemon_get_release(void) {
+	return daemon_time;
+}
+
 void system_daemon_initialize() {
 	system_daemon_task = task_create_static(_system_daemon_task, NULL, TASK_PRIORITY_MAX - 2, TASK_STACK_DEPTH_DEFAULT,
 	                                        "PROS System Daemon", system_daemon_task_stack, &system_daemon_task_buffer);
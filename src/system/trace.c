@@ -0,0 +1,139 @@
+/**
+ * \file system/trace.c
+ *
+ * Always-on scheduler trace
+ *
+ * The FreeRTOS trace hooks defined in system/trace.h record task switches,
+ * blocking on queues and mutexes and priority inheritance into a fixed ring of
+ * entries. Recording an entry only claims a slot with an atomic increment and
+ * fills it in, so it costs a few dozen cycles and is safe in the scheduler and
+ * in interrupts. The ring is statically allocated so that the trace works
+ * before the heap does and can't fail when memory runs out, which is often
+ * exactly when the trace is wanted.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "rtos/tcb.h"
+#include "system/dev/ser.h"
+#include "system/trace.h"
+#include "v5_api.h"
+
+#define TRACE_FRAME_ENTRY_COUNT ((SER_MAX_FRAME_SIZE - 1) / sizeof(trace_entry_s_t))
+#define TRACE_FRAME_NAME_COUNT ((SER_MAX_FRAME_SIZE - 1) / sizeof(trace_task_name_s_t))
+
+_Static_assert(sizeof(trace_entry_s_t) == 16, "trace entries must stay 16 bytes for the host converter");
+_Static_assert((TRACE_BUFFER_ENTRIES & (TRACE_BUFFER_ENTRIES - 1)) == 0, "TRACE_BUFFER_ENTRIES must be a power of 2");
+
+static trace_entry_s_t trace_entries[TRACE_BUFFER_ENTRIES];
+// the total number of entries ever claimed; the next entry goes in
+// trace_entries[trace_head % TRACE_BUFFER_ENTRIES]
+static uint32_t trace_head;
+static bool trace_enabled = true;
+
+void trace_record(uint8_t event, uint32_t object, uint32_t value) {
+	if (!__atomic_load_n(&trace_enabled, __ATOMIC_RELAXED)) {
+		return;
+	}
+	uint32_t slot = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED) % TRACE_BUFFER_ENTRIES;
+	trace_entry_s_t* entry = &trace_entries[slot];
+	entry->timestamp = (uint32_t)vexSystemHighResTimeGet();
+	entry->object = object;
+	entry->value = value;
+	entry->task = pxCurrentTCB ? (uint16_t)pxCurrentTCB->uxTCBNumber : 0;
+	entry->event = event;
+	entry->reserved = 0;
+}
+
+void trace_mark(uint32_t id, uint32_t value) {
+	trace_record(E_TRACE_MARK, id, value);
+}
+
+void trace_begin(uint32_t id) {
+	trace_record(E_TRACE_BEGIN, id, 0);
+}
+
+void trace_end(uint32_t id) {
+	trace_record(E_TRACE_END, id, 0);
+}
+
+void trace_set_enabled(bool enabled) {
+	__atomic_store_n(&trace_enabled, enabled, __ATOMIC_RELAXED);
+}
+
+int32_t trace_send_task_names(uint32_t stream_id) {
+	uint32_t capacity = task_get_count() + 4;
+	uint16_t* numbers = kmalloc(capacity * sizeof(*numbers));
+	char(*task_names)[configMAX_TASK_NAME_LEN] = kmalloc(capacity * sizeof(*task_names));
+	uint32_t count = numbers && task_names ? trace_get_task_names(numbers, task_names, capacity) : 0;
+	trace_task_name_s_t* names = count ? kmalloc(count * sizeof(*names)) : NULL;
+	if (names) {
+		for (uint32_t i = 0; i < count; i++) {
+			names[i].task = numbers[i];
+			memcpy(names[i].name, task_names[i], TASK_NAME_MAX_LEN);
+		}
+	}
+	kfree(numbers);
+	kfree(task_names);
+	if (!names) {
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+
+	uint8_t frame[SER_MAX_FRAME_SIZE];
+	frame[0] = TRACE_FRAME_TASK_NAMES;
+	for (uint32_t i = 0; i < count; i += TRACE_FRAME_NAME_COUNT) {
+		uint32_t n = count - i < TRACE_FRAME_NAME_COUNT ? count - i : TRACE_FRAME_NAME_COUNT;
+		memcpy(frame + 1, &names[i], n * sizeof(*names));
+		if (!ser_output_write_frame(stream_id, frame, 1 + n * sizeof(*names), TIMEOUT_MAX)) {
+			kfree(names);
+			errno = EIO;
+			return PROS_ERR;
+		}
+	}
+	kfree(names);
+	return PROS_SUCCESS;
+}
+
+int32_t trace_dump(void) {
+	if (!ser_stream_enabled(TRACE_STREAM_ID)) {
+		errno = EACCES;
+		return PROS_ERR;
+	}
+
+	// sending the trace blocks on the serial queues, which would otherwise
+	// record over the oldest entries while they are being sent
+	bool was_enabled = __atomic_exchange_n(&trace_enabled, false, __ATOMIC_RELAXED);
+	int32_t sent = trace_send_task_names(TRACE_STREAM_ID);
+	if (sent == PROS_SUCCESS) {
+		sent = 0;
+		const uint32_t end = __atomic_load_n(&trace_head, __ATOMIC_RELAXED);
+		uint32_t next = end > TRACE_BUFFER_ENTRIES ? end - TRACE_BUFFER_ENTRIES : 0;
+		uint8_t frame[SER_MAX_FRAME_SIZE];
+		frame[0] = TRACE_FRAME_ENTRIES;
+		while (next != end) {
+			size_t n = 0;
+			while (n < TRACE_FRAME_ENTRY_COUNT && next != end) {
+				memcpy(frame + 1 + n++ * sizeof(trace_entry_s_t), &trace_entries[next++ % TRACE_BUFFER_ENTRIES],
+				       sizeof(trace_entry_s_t));
+			}
+			if (!ser_output_write_frame(TRACE_STREAM_ID, frame, 1 + n * sizeof(trace_entry_s_t), TIMEOUT_MAX)) {
+				errno = EIO;
+				sent = PROS_ERR;
+				break;
+			}
+			sent += n;
+		}
+	}
+	trace_set_enabled(was_enabled);
+	return sent;
+}
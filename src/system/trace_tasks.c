@@ -0,0 +1,42 @@
+/**
+ * \file system/trace_tasks.c
+ *
+ * Task names for the scheduler trace
+ *
+ * uxTaskGetSystemState() and TaskStatus_t are only declared in rtos/task.h,
+ * which can't be included alongside the public headers that system/trace.c
+ * needs, so the task names for a trace dump are collected here.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+
+#include "rtos/FreeRTOS.h"
+#include "rtos/portable.h"
+#include "rtos/task.h"
+
+uint32_t trace_get_task_names(uint16_t* numbers, char (*names)[configMAX_TASK_NAME_LEN], uint32_t capacity) {
+	TaskStatus_t* tasks = kmalloc(capacity * sizeof(*tasks));
+	if (!tasks) {
+		return 0;
+	}
+
+	// deleted tasks are only freed by the idle task, so the names stay valid
+	// until the scheduler is resumed
+	rtos_suspend_all();
+	uint32_t count = uxTaskGetSystemState(tasks, capacity, NULL);
+	for (uint32_t i = 0; i < count; i++) {
+		numbers[i] = (uint16_t)tasks[i].xTaskNumber;
+		strncpy(names[i], tasks[i].pcTaskName, configMAX_TASK_NAME_LEN);
+	}
+	rtos_resume_all();
+
+	kfree(tasks);
+	return count;
+}
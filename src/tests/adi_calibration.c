@@ -0,0 +1,71 @@
+/**
+ * \file tests/adi_calibration.c
+ *
+ * Calibrates six line trackers at once and checks that the other ports keep
+ * working while they calibrate.
+ *
+ * Line trackers go in ADI ports A-F. All six calibrations are started with
+ * adi_analog_calibrate_async(), and a task times how long it waits on smart
+ * port 1 in the meantime. The calibrations should all finish in about half a
+ * second, and the port should never be held up for more than a couple of
+ * milliseconds.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+
+#define NUM_TRACKERS 6
+
+static volatile bool calibrating = true;
+static uint32_t worst_wait_us;
+
+static void port_user(void* ign) {
+	while (calibrating) {
+		uint64_t start = micros();
+		motor_get_position(1);
+		uint32_t wait = (uint32_t)(micros() - start);
+		if (wait > worst_wait_us) {
+			worst_wait_us = wait;
+		}
+		task_delay(1);
+	}
+}
+
+void initialize() {
+	task_create(port_user, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "port user");
+
+	uint32_t start = millis();
+	for (uint8_t port = 'A'; port < 'A' + NUM_TRACKERS; port++) {
+		adi_port_set_config(port, E_ADI_ANALOG_IN);
+		if (adi_analog_calibrate_async(port) != 1) {
+			printf("%c: could not start calibrating (errno %d)\n", port, errno);
+		}
+	}
+	printf("started %d calibrations in %lu ms\n", NUM_TRACKERS, (unsigned long)(millis() - start));
+
+	for (uint8_t port = 'A'; port < 'A' + NUM_TRACKERS; port++) {
+		int32_t value = adi_analog_calibrate_wait(port, 1000);
+		printf("%c: %ld after %lu ms\n", port, (long)value, (unsigned long)(millis() - start));
+	}
+
+	calibrating = false;
+	task_delay(10);
+	printf("worst wait on port 1: %lu us\n", (unsigned long)worst_wait_us);
+
+	// a port that was never calibrated, and a poll that should come back at once
+	adi_port_set_config('H', E_ADI_ANALOG_IN);
+	int32_t value = adi_analog_calibrate_wait('H', 0);
+	printf("H: %ld (errno %d, should be EINVAL)\n", (long)value, errno);
+	adi_analog_calibrate_async('H');
+	value = adi_analog_calibrate_wait('H', 0);
+	printf("H: %ld (errno %d, should be EAGAIN)\n", (long)value, errno);
+	printf("H: %ld in a blocking calibration\n", (long)adi_analog_calibrate('H'));
+}
@@ -0,0 +1,185 @@
+/**
+ * \file tests/async.cpp
+ *
+ * Runs a tree of pros::async routines on one task.
+ *
+ * Fifty routines tick on delay_until() alongside a routine that awaits a value
+ * from a child, one that runs children with all(), two that contend for a
+ * mutex, one that receives from a queue fed by another task and one that waits
+ * for that task's notifications. Everything should finish with the expected
+ * counts, and the executor should be the only task involved besides the
+ * feeder.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "kapi.h"
+#include "pros/async.hpp"
+
+using namespace pros::async;
+
+#define TICKERS 50
+#define TICKS 20
+
+static std::uint32_t ticks[TICKERS];
+static std::uint32_t late_ticks;
+static bool failed;
+
+static void check(bool condition, const char* what) {
+	if (!condition) {
+		printf("FAIL: %s\n", what);
+		failed = true;
+	}
+}
+
+static Routine<> ticker(int index) {
+	std::uint32_t now = pros::millis();
+	for (int i = 0; i < TICKS; i++) {
+		co_await delay_until(&now, 10);
+		if (pros::millis() - now > 1) {
+			late_ticks++;
+		}
+		ticks[index]++;
+	}
+}
+
+static Routine<int> add_later(int a, int b) {
+	co_await delay(20);
+	co_return a + b;
+}
+
+static Routine<> awaits_value() {
+	int sum = co_await add_later(20, 22);
+	check(sum == 42, "awaited value");
+	Routine<int> started = add_later(1, 2);
+	co_await spawn(started);
+	co_await delay(50);
+	check(started.done(), "spawned routine finished on its own");
+	check(co_await started == 3, "spawned routine's value");
+}
+
+static Routine<> step(std::uint32_t milliseconds, int* order, int* next) {
+	co_await delay(milliseconds);
+	*order = (*next)++;
+}
+
+static Routine<> runs_all() {
+	int next = 0, a = -1, b = -1, c = -1;
+	std::uint32_t start = pros::millis();
+	co_await all(step(30, &a, &next), step(10, &b, &next), step(20, &c, &next));
+	std::uint32_t elapsed = pros::millis() - start;
+	check(b == 0 && c == 1 && a == 2, "all() ran its routines concurrently");
+	check(elapsed >= 30 && elapsed <= 32, "all() waited for the slowest routine");
+}
+
+static pros::Mutex* mutex;
+static int in_section;
+
+static Routine<> contender(std::uint32_t hold) {
+	for (int i = 0; i < 5; i++) {
+		check(co_await take(*mutex), "took the mutex");
+		in_section++;
+		check(in_section == 1, "one routine at a time holds the mutex");
+		co_await delay(hold);
+		in_section--;
+		mutex->give();
+		co_await delay(0);
+	}
+}
+
+static Routine<> times_out() {
+	co_await delay(5);
+	std::uint32_t start = pros::millis();
+	bool taken = co_await take(*mutex, 3);
+	if (taken) {
+		mutex->give();
+	} else {
+		check(pros::millis() - start >= 3, "take() waited for its timeout");
+	}
+}
+
+static queue_t queue;
+
+static Routine<> receiver() {
+	std::uint32_t sum = 0;
+	for (int i = 0; i < 10; i++) {
+		std::uint32_t item;
+		check(co_await receive(queue, &item), "received an item");
+		sum += item;
+	}
+	check(sum == 55, "received every item");
+	std::uint32_t item;
+	check(!co_await receive(queue, &item, 20), "receive() timed out on an empty queue");
+}
+
+static Routine<> listener() {
+	std::uint32_t total = 0;
+	while (total < 5) {
+		total += co_await notified();
+	}
+	check(co_await notified(10) == 0, "notified() timed out");
+}
+
+static Routine<> follows_daemon() {
+	std::uint32_t last = pros::millis();
+	int even = 0;
+	for (int i = 0; i < 20; i++) {
+		co_await next_cycle();
+		std::uint32_t now = pros::millis();
+		if (now - last == 2 || i == 0) {
+			even++;
+		}
+		last = now;
+	}
+	check(even == 20, "next_cycle() resumed every 2 ms");
+}
+
+static pros::task_t executor_task;
+
+static void feeder(void* ignore) {
+	pros::delay(50);
+	for (std::uint32_t i = 1; i <= 10; i++) {
+		pros::c::queue_append(queue, &i, TIMEOUT_MAX);
+		pros::delay(3);
+	}
+	for (int i = 0; i < 5; i++) {
+		pros::c::task_notify(executor_task);
+		pros::delay(3);
+	}
+}
+
+void opcontrol() {
+	pros::Mutex contended;
+	mutex = &contended;
+	queue = pros::c::queue_create(4, sizeof(std::uint32_t));
+	executor_task = pros::c::task_get_current();
+	pros::c::task_create(feeder, nullptr, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Feeder");
+
+	Executor executor;
+	for (int i = 0; i < TICKERS; i++) {
+		executor.spawn(ticker(i));
+	}
+	executor.spawn(awaits_value());
+	executor.spawn(runs_all());
+	executor.spawn(contender(2));
+	executor.spawn(contender(3));
+	executor.spawn(times_out());
+	executor.spawn(receiver());
+	executor.spawn(listener());
+	executor.spawn(follows_daemon());
+	std::uint32_t start = pros::millis();
+	executor.run();
+	std::uint32_t elapsed = pros::millis() - start;
+
+	for (int i = 0; i < TICKERS; i++) {
+		check(ticks[i] == TICKS, "every ticker ran to the end");
+	}
+	printf("ran for %lu ms, %lu of %d ticks late\n", (unsigned long)elapsed, (unsigned long)late_ticks,
+	       TICKERS * TICKS);
+	printf("%s\n", failed ? "FAIL" : "PASS");
+}
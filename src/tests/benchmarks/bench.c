@@ -0,0 +1,101 @@
+/**
+ * \file tests/benchmarks/bench.c
+ *
+ * Runs the kernel benchmark suite.
+ *
+ * Build this directory as the user program (on the V5, copy it into src/ in
+ * place of main.cpp; on Linux, run `make host-bench`). The device benchmarks
+ * expect motors in ports 1-4, which the host build simulates. Results are
+ * printed to stdout as JSON lines, see bench.h. Compare two runs with
+ *
+ *   python3 src/tests/benchmarks/compare.py before.jsonl after.jsonl
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "kapi.h"
+#include "system/cycles.h"
+
+#ifdef PROS_HOST
+#include "sim.h"
+#include "v5_api.h"
+#define BENCH_PLATFORM "host"
+#else
+#define BENCH_PLATFORM "v5"
+#endif
+
+static uint32_t samples[BENCH_SAMPLES];
+
+static int compare_samples(const void* a, const void* b) {
+	uint32_t x = *(const uint32_t*)a;
+	uint32_t y = *(const uint32_t*)b;
+	return (x > y) - (x < y);
+}
+
+void bench_begin(void) {
+	cycles_initialize();
+	printf("{\"suite\":\"pros\",\"version\":\"%s\",\"platform\":\"%s\",\"unit\":\"%s\",\"cycles_per_us\":%u}\n",
+	       PROS_VERSION_STRING, BENCH_PLATFORM, CYCLES_UNIT, CYCLES_PER_US);
+}
+
+void bench_run(const char* name, bench_fn_t fn, void* arg, uint32_t batch) {
+	// one untimed batch to warm the caches and take any first-call paths
+	for (uint32_t i = 0; i < batch; i++) {
+		fn(arg);
+	}
+
+	for (size_t s = 0; s < BENCH_SAMPLES; s++) {
+		uint32_t start = cycles_get();
+		for (uint32_t i = 0; i < batch; i++) {
+			fn(arg);
+		}
+		samples[s] = cycles_get() - start;
+	}
+	bench_report(name, samples, BENCH_SAMPLES, batch);
+}
+
+void bench_report(const char* name, uint32_t* samples, size_t count, uint32_t batch) {
+	uint64_t total = 0;
+	for (size_t s = 0; s < count; s++) {
+		total += samples[s];
+	}
+	qsort(samples, count, sizeof(*samples), compare_samples);
+
+	const double median = (samples[(count - 1) / 2] + samples[count / 2]) / 2.0 / batch;
+	printf(
+	    "{\"name\":\"%s\",\"unit\":\"%s\",\"batch\":%u,\"samples\":%u,\"min\":%.1f,\"median\":%.1f,\"mean\":%.1f,"
+	    "\"max\":%.1f,\"median_ns\":%u}\n",
+	    name, CYCLES_UNIT, (unsigned)batch, (unsigned)count, (double)samples[0] / batch, median,
+	    (double)total / count / batch, (double)samples[count - 1] / batch, (unsigned)(median * 1000 / CYCLES_PER_US));
+}
+
+void initialize() {
+#ifdef PROS_HOST
+	for (uint8_t port = 1; port <= 4; port++) {
+		sim_set_device(port, kDeviceTypeMotorSensor);
+	}
+#endif
+	// let the system daemon register the devices
+	task_delay(50);
+
+	bench_begin();
+	bench_common();
+	bench_rtos();
+	bench_devices();
+	bench_motor_group();
+	bench_display();
+	fflush(stdout);
+
+#ifdef PROS_HOST
+	vexSystemExitRequest();
+#endif
+}
@@ -0,0 +1,82 @@
+/**
+ * \file tests/benchmarks/bench.h
+ *
+ * Harness for the kernel benchmark suite
+ *
+ * Each benchmark is a function that performs one operation. bench_run() times
+ * a number of samples, each of which runs the operation `batch` times back to
+ * back, and prints one JSON object per line describing the per-operation cost:
+ *
+ * {"name":"set_contains/16","unit":"cycles","batch":64,"samples":64,
+ *  "min":21.0,"median":22.5,"mean":23.1,"max":40.2,"median_ns":33}
+ *
+ * Lines that don't start with '{' are commentary and are ignored by compare.py.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The number of timed samples taken for each benchmark
+#define BENCH_SAMPLES 64
+
+typedef void (*bench_fn_t)(void* arg);
+
+/**
+ * Times fn and prints the result.
+ *
+ * \param name
+ *        The name of the benchmark, conventionally "operation/variant"
+ * \param fn
+ *        Performs the operation being measured
+ * \param arg
+ *        Passed to fn
+ * \param batch
+ *        The number of times fn is called per sample. Cheap operations should
+ *        use a large batch so that the cost of reading the counter disappears.
+ */
+void bench_run(const char* name, bench_fn_t fn, void* arg, uint32_t batch);
+
+/**
+ * Prints the result for samples that were timed some other way than with
+ * bench_run(), for instance by several tasks at once.
+ *
+ * \param name
+ *        The name of the benchmark, conventionally "operation/variant"
+ * \param samples
+ *        The time taken by each sample, in cycles. The array is sorted.
+ * \param count
+ *        The number of samples
+ * \param batch
+ *        The number of operations that each sample timed
+ */
+void bench_report(const char* name, uint32_t* samples, size_t count, uint32_t batch);
+
+/**
+ * Prints the line that starts a set of results, identifying the platform and
+ * kernel version.
+ */
+void bench_begin(void);
+
+// The benchmark groups, each in its own file
+void bench_common(void);
+void bench_rtos(void);
+void bench_devices(void);
+void bench_motor_group(void);
+void bench_display(void);
+
+#ifdef __cplusplus
+}
+#endif
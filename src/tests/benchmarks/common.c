@@ -0,0 +1,89 @@
+/**
+ * \file tests/benchmarks/common.c
+ *
+ * Benchmarks for the common facilities and the kernel heap: COBS encoding,
+ * gid allocation, set lookups, and kmalloc()/kfree().
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "common/cobs.h"
+#include "common/gid.h"
+#include "common/set.h"
+#include "kapi.h"
+
+#define MAX_PAYLOAD 1024
+#define NUM_GIDS 64
+#define NUM_SET_ITEMS 16
+
+struct cobs_arg {
+	size_t size;
+};
+
+static uint8_t payload[MAX_PAYLOAD];
+static uint8_t encoded[COBS_ENCODE_MEASURE_MAX(MAX_PAYLOAD + 4)];
+
+static uint32_t gid_bitmap[gid_size_to_words(NUM_GIDS)];
+static struct gid_metadata gids = {.bitmap = gid_bitmap,
+                                   .max = NUM_GIDS,
+                                   .reserved = 1,
+                                   .bitmap_size = gid_size_to_words(NUM_GIDS)};
+
+static struct set set;
+
+static void cobs_encode_op(void* arg) {
+	cobs_encode(encoded, payload, ((struct cobs_arg*)arg)->size, 0x74756f73);
+}
+
+static void gid_alloc_free_op(void* ign) {
+	gid_free(&gids, gid_alloc(&gids));
+}
+
+static void set_contains_op(void* arg) {
+	// the last item added is the worst case for the linear search
+	set_contains(&set, (uint32_t)(uintptr_t)arg);
+}
+
+static void kmalloc_kfree_op(void* arg) {
+	kfree(kmalloc((size_t)(uintptr_t)arg));
+}
+
+void bench_common(void) {
+	char name[32];
+
+	for (size_t i = 0; i < sizeof(payload); i++) {
+		payload[i] = rand();
+	}
+	static struct cobs_arg cobs_args[] = {{16}, {64}, {256}, {1024}};
+	for (size_t i = 0; i < sizeof(cobs_args) / sizeof(*cobs_args); i++) {
+		snprintf(name, sizeof(name), "cobs_encode/%u", (unsigned)cobs_args[i].size);
+		bench_run(name, cobs_encode_op, &cobs_args[i], cobs_args[i].size > 256 ? 4 : 16);
+	}
+
+	gid_init(&gids);
+	// leave half of the ids allocated so that gid_alloc has to search
+	for (size_t i = 0; i < NUM_GIDS / 2; i++) {
+		gid_alloc(&gids);
+	}
+	bench_run("gid_alloc_free", gid_alloc_free_op, NULL, 64);
+
+	set_initialize(&set);
+	for (uint32_t i = 0; i < NUM_SET_ITEMS; i++) {
+		set_add(&set, i);
+	}
+	bench_run("set_contains/hit", set_contains_op, (void*)(uintptr_t)(NUM_SET_ITEMS - 1), 64);
+	bench_run("set_contains/miss", set_contains_op, (void*)(uintptr_t)NUM_SET_ITEMS, 64);
+
+	// 40 bytes is served by a size-class pool, 1000 bytes by the general heap
+	bench_run("kmalloc_kfree/40", kmalloc_kfree_op, (void*)40, 64);
+	bench_run("kmalloc_kfree/1000", kmalloc_kfree_op, (void*)1000, 64);
+}
@@ -0,0 +1,71 @@
+"""
+Compares two runs of the kernel benchmark suite.
+
+Each file holds the suite's output, one JSON object per line; any other lines
+are ignored. The median cost of every benchmark in both runs is printed along
+with the change, and the exit status is 1 if any benchmark got slower by more
+than the threshold.
+
+    python3 compare.py before.jsonl after.jsonl [--threshold PERCENT]
+"""
+import argparse
+import json
+import sys
+
+
+def load(path):
+    header = {}
+    results = {}
+    with open(path, errors='replace') as f:
+        for line in f:
+            # stdout is shared with the COBS-framed serial streams, so a
+            # result can follow the NUL that ends a frame
+            line = line.strip().lstrip('\0')
+            if not line.startswith('{'):
+                continue
+            try:
+                obj = json.loads(line)
+            except ValueError:
+                continue
+            if 'suite' in obj:
+                header = obj
+            elif 'name' in obj:
+                results[obj['name']] = obj
+    return header, results
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare two benchmark runs')
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='percent slowdown that counts as a regression (default 10)')
+    args = parser.parse_args()
+
+    base_header, base = load(args.baseline)
+    cur_header, cur = load(args.current)
+    if base_header.get('platform') != cur_header.get('platform'):
+        print('warning: comparing {} results against {} results'.format(
+            base_header.get('platform'), cur_header.get('platform')), file=sys.stderr)
+
+    regressions = 0
+    print('{:<32} {:>12} {:>12} {:>8}'.format('benchmark', 'baseline', 'current', 'change'))
+    for name in sorted(set(base) | set(cur)):
+        if name not in base or name not in cur:
+            print('{:<32} {:>12} {:>12}'.format(name, base[name]['median'] if name in base else '-',
+                                                 cur[name]['median'] if name in cur else '-'))
+            continue
+        before = base[name]['median']
+        after = cur[name]['median']
+        change = (after - before) * 100.0 / before if before else 0.0
+        flag = ''
+        if change > args.threshold:
+            flag = '  REGRESSION'
+            regressions += 1
+        print('{:<32} {:>12.1f} {:>12.1f} {:>+7.1f}%{}'.format(name, before, after, change, flag))
+
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,102 @@
+/**
+ * \file tests/benchmarks/devices.c
+ *
+ * Benchmarks for VDML and the serial driver: claiming a smart port, how long
+ * tasks busy with their own ports wait for them while the system daemon runs,
+ * the motor getters, and writing to stdout through the VFS and ser_write_r().
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "kapi.h"
+#include "system/cycles.h"
+#include "vdml/registry.h"
+#include "vdml/vdml.h"
+
+#define MOTOR_PORT 1
+#define WRITE_SIZE 64
+// Tasks that each take the mutex of their own port (2-7) this many times
+// for port_wait/contended
+#define CONTENDERS 6
+#define CONTENDED_SAMPLES 256
+
+// the VFS's write, which dispatches to ser_write_r() for stdout
+extern ssize_t _write(int file, const void* buf, size_t len);
+
+// What every VDML accessor does around its SDK call
+static int32_t claim_return(uint8_t port) {
+	claim_port_i(port, E_DEVICE_MOTOR);
+	return_port(port, 1);
+}
+
+static void claim_return_op(void* ign) {
+	claim_return(MOTOR_PORT - 1);
+}
+
+static uint32_t contended_waits[CONTENDERS][CONTENDED_SAMPLES];
+
+// Times how long it takes to get the mutex of its own port, once per tick so
+// that the samples are spread over many runs of the system daemon
+static void contender(void* index) {
+	const uint8_t port = MOTOR_PORT + (uintptr_t)index;
+	for (size_t s = 0; s < CONTENDED_SAMPLES; s++) {
+		uint32_t start = cycles_get();
+		port_mutex_take(port);
+		contended_waits[(uintptr_t)index][s] = cycles_get() - start;
+		port_mutex_give(port);
+		task_delay(1);
+	}
+}
+
+static void contended_port_wait(void) {
+	for (uintptr_t i = 0; i < CONTENDERS; i++) {
+		task_create(contender, (void*)i, task_get_priority(NULL) + 1, TASK_STACK_DEPTH_MIN, "contender");
+	}
+	task_delay(CONTENDED_SAMPLES + 10);
+	bench_report("port_wait/contended", &contended_waits[0][0], CONTENDERS * CONTENDED_SAMPLES, 1);
+}
+
+static void motor_get_position_op(void* ign) {
+	motor_get_position(MOTOR_PORT);
+}
+
+static void motor_get_actual_velocity_op(void* ign) {
+	motor_get_actual_velocity(MOTOR_PORT);
+}
+
+static void motor_get_current_draw_op(void* ign) {
+	motor_get_current_draw(MOTOR_PORT);
+}
+
+static void motor_move_velocity_op(void* ign) {
+	motor_move_velocity(MOTOR_PORT, 0);
+}
+
+static void ser_write_op(void* arg) {
+	_write(STDOUT_FILENO, arg, WRITE_SIZE);
+}
+
+void bench_devices(void) {
+	bench_run("claim_return_port", claim_return_op, NULL, 64);
+	contended_port_wait();
+	bench_run("motor_get_position", motor_get_position_op, NULL, 64);
+	bench_run("motor_get_actual_velocity", motor_get_actual_velocity_op, NULL, 64);
+	bench_run("motor_get_current_draw", motor_get_current_draw_op, NULL, 64);
+	bench_run("motor_move_velocity", motor_move_velocity_op, NULL, 64);
+
+	// Written as a comment line so that the output stays parseable
+	static char line[WRITE_SIZE];
+	memset(line, '.', sizeof(line));
+	memcpy(line, "# ser_write_r ", 14);
+	line[WRITE_SIZE - 1] = '\n';
+	bench_run("ser_write_r/64", ser_write_op, line, 1);
+}
@@ -0,0 +1,70 @@
+/**
+ * \file tests/benchmarks/display.c
+ *
+ * Benchmarks for LVGL: a pass of lv_task_handler() with nothing to do, and a
+ * full-screen redraw of a screen with a few widgets on it.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "bench.h"
+#include "display/lvgl.h"
+#include "kapi.h"
+
+static void task_handler_op(void* ign) {
+	lv_task_handler();
+}
+
+static void full_frame_op(void* ign) {
+	lv_obj_invalidate(lv_scr_act());
+	lv_refr_now();
+}
+
+// LVGL isn't reentrant, so the display daemon is suspended while it's waiting
+// for its next frame rather than while it might be drawing one
+static task_t pause_display_daemon(void) {
+	task_t daemon = task_get_by_name("Display Daemon (PROS)");
+	while (daemon) {
+		rtos_suspend_all();
+		bool idle = task_get_state(daemon) == E_TASK_STATE_BLOCKED;
+		if (idle) {
+			task_suspend(daemon);
+		}
+		rtos_resume_all();
+		if (idle) {
+			break;
+		}
+		task_delay(1);
+	}
+	return daemon;
+}
+
+void bench_display(void) {
+	task_t daemon = pause_display_daemon();
+
+	lv_obj_t* screen = lv_obj_create(NULL, NULL);
+	lv_obj_t* old_screen = lv_scr_act();
+	lv_scr_load(screen);
+	for (int i = 0; i < 4; i++) {
+		lv_obj_t* button = lv_btn_create(screen, NULL);
+		lv_obj_set_pos(button, 10 + 115 * i, 20);
+		lv_obj_set_size(button, 100, 60);
+		lv_label_set_text(lv_label_create(button, NULL), "Button");
+	}
+	lv_label_set_text(lv_label_create(screen, NULL), "PROS kernel benchmark");
+	lv_refr_now();
+
+	bench_run("lv_task_handler/idle", task_handler_op, NULL, 16);
+	bench_run("lv_task_handler/full_frame", full_frame_op, NULL, 1);
+
+	lv_scr_load(old_screen);
+	lv_obj_del(screen);
+	if (daemon) {
+		task_resume(daemon);
+	}
+}
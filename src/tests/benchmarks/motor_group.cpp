@@ -0,0 +1,46 @@
+/**
+ * \file tests/benchmarks/motor_group.cpp
+ *
+ * Benchmarks for Motor_Group fan-out over the motors in ports 1-4, next to the
+ * same work done one motor at a time.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "bench.h"
+#include "main.h"
+
+static void group_move_velocity_op(void* arg) {
+	static_cast<pros::Motor_Group*>(arg)->move_velocity(0);
+}
+
+static void group_get_positions_op(void* arg) {
+	static_cast<pros::Motor_Group*>(arg)->get_positions();
+}
+
+static void single_move_velocity_op(void* arg) {
+	for (pros::Motor& motor : *static_cast<std::vector<pros::Motor>*>(arg)) {
+		motor.move_velocity(0);
+	}
+}
+
+static void single_get_position_op(void* arg) {
+	for (pros::Motor& motor : *static_cast<std::vector<pros::Motor>*>(arg)) {
+		motor.get_position();
+	}
+}
+
+void bench_motor_group(void) {
+	pros::Motor_Group group({1, 2, 3, 4});
+	std::vector<pros::Motor> motors{pros::Motor(1), pros::Motor(2), pros::Motor(3), pros::Motor(4)};
+
+	bench_run("motor_group_move_velocity/4", group_move_velocity_op, &group, 16);
+	bench_run("motor_loop_move_velocity/4", single_move_velocity_op, &motors, 16);
+	bench_run("motor_group_get_positions/4", group_get_positions_op, &group, 16);
+	bench_run("motor_loop_get_position/4", single_get_position_op, &motors, 16);
+}
@@ -0,0 +1,95 @@
+/**
+ * \file tests/benchmarks/rtos.c
+ *
+ * Benchmarks for the RTOS primitives: stream buffers, and queue and mutex
+ * round trips between two tasks.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "bench.h"
+#include "kapi.h"
+
+#define STREAM_BUF_SIZE 256
+#define STREAM_MSG_SIZE 64
+
+static stream_buf_t stream;
+static queue_t ping_queue;
+static queue_t pong_queue;
+static mutex_t mutex;
+static task_t bench_task;
+
+static void stream_buf_op(void* ign) {
+	static uint8_t msg[STREAM_MSG_SIZE];
+	stream_buf_send(stream, msg, sizeof(msg), 0);
+	stream_buf_recv(stream, msg, sizeof(msg), 0);
+}
+
+static void queue_partner(void* ign) {
+	uint32_t value;
+	for (;;) {
+		queue_recv(ping_queue, &value, TIMEOUT_MAX);
+		queue_append(pong_queue, &value, TIMEOUT_MAX);
+	}
+}
+
+static void queue_ping_pong_op(void* ign) {
+	uint32_t value = 0;
+	queue_append(ping_queue, &value, TIMEOUT_MAX);
+	queue_recv(pong_queue, &value, TIMEOUT_MAX);
+}
+
+static void mutex_take_give_op(void* ign) {
+	mutex_take(mutex, TIMEOUT_MAX);
+	mutex_give(mutex);
+}
+
+static void mutex_partner(void* ign) {
+	for (;;) {
+		task_notify_take(true, TIMEOUT_MAX);
+		mutex_take(mutex, TIMEOUT_MAX);
+		mutex_give(mutex);
+		task_notify(bench_task);
+	}
+}
+
+// The bench task holds the mutex and the partner blocks on it, so every round
+// trip hands the mutex over while the partner is waiting.
+static void mutex_ping_pong_op(void* arg) {
+	task_notify((task_t)arg);
+	mutex_give(mutex);
+	task_notify_take(true, TIMEOUT_MAX);
+	mutex_take(mutex, TIMEOUT_MAX);
+}
+
+void bench_rtos(void) {
+	bench_task = task_get_current();
+	const uint32_t prio = task_get_priority(bench_task);
+
+	stream = stream_buf_create(STREAM_BUF_SIZE, 1);
+	bench_run("stream_buf_send_recv/64", stream_buf_op, NULL, 16);
+	vStreamBufferDelete(stream);
+
+	ping_queue = queue_create(1, sizeof(uint32_t));
+	pong_queue = queue_create(1, sizeof(uint32_t));
+	task_t partner = task_create(queue_partner, NULL, prio, TASK_STACK_DEPTH_MIN, "queue partner");
+	bench_run("queue_ping_pong", queue_ping_pong_op, NULL, 16);
+	task_delete(partner);
+	queue_delete(ping_queue);
+	queue_delete(pong_queue);
+
+	mutex = mutex_create();
+	bench_run("mutex_take_give", mutex_take_give_op, NULL, 64);
+
+	partner = task_create(mutex_partner, NULL, prio + 1, TASK_STACK_DEPTH_MIN, "mutex partner");
+	mutex_take(mutex, TIMEOUT_MAX);
+	bench_run("mutex_ping_pong", mutex_ping_pong_op, partner, 16);
+	mutex_give(mutex);
+	task_delete(partner);
+	mutex_delete(mutex);
+}
@@ -0,0 +1,88 @@
+/**
+ * \file tests/cobs_benchmark.c
+ *
+ * Measures COBS encoding throughput and the cost of a framed serial write.
+ *
+ * cobs_encode() and cobs_encode_wrapped() are run over payloads of a few sizes,
+ * both with no zero bytes (worst case for code byte insertion) and with random
+ * data. The wrapped encoder is run with the split in the middle of the output
+ * so that the slow path is measured. Finally, fwrite() to a COBS stream is
+ * timed to show the full cost of getting a frame into the output buffer.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/cobs.h"
+#include "kapi.h"
+
+#define ITERATIONS 1000
+#define MAX_PAYLOAD 1024
+
+static const size_t payload_sizes[] = {16, 64, 256, 1024};
+
+static uint8_t payload[MAX_PAYLOAD];
+static uint8_t encoded[COBS_ENCODE_MEASURE_MAX(MAX_PAYLOAD + 4)];
+
+// Returns the throughput in kB/s for the given payload size and elapsed time
+static uint32_t throughput(size_t size, uint64_t elapsed_us) {
+	if (elapsed_us == 0) {
+		return 0;
+	}
+	return (uint32_t)(((uint64_t)size * ITERATIONS * 1000) / elapsed_us);
+}
+
+static void run(const char* name) {
+	printf("%-8s  %7s  %14s  %14s\n", name, "bytes", "encode (kB/s)", "wrapped (kB/s)");
+	for (size_t i = 0; i < sizeof(payload_sizes) / sizeof(payload_sizes[0]); i++) {
+		const size_t size = payload_sizes[i];
+		const size_t half = COBS_ENCODE_MEASURE_MAX(size + 4) / 2;
+
+		uint64_t start = micros();
+		for (int j = 0; j < ITERATIONS; j++) {
+			cobs_encode(encoded, payload, size, 0x74756f73);
+		}
+		uint64_t linear = micros() - start;
+
+		start = micros();
+		for (int j = 0; j < ITERATIONS; j++) {
+			cobs_encode_wrapped(encoded, half, encoded + half, payload, size, 0x74756f73);
+		}
+		uint64_t wrapped = micros() - start;
+
+		printf("%-8s  %7u  %14lu  %14lu\n", "", (unsigned)size, (unsigned long)throughput(size, linear),
+		       (unsigned long)throughput(size, wrapped));
+	}
+}
+
+void opcontrol() {
+	memset(payload, 0x55, sizeof(payload));
+	run("no zeros");
+
+	for (size_t i = 0; i < sizeof(payload); i++) {
+		payload[i] = rand();
+	}
+	run("random");
+
+	// time the whole write path, letting the daemon drain between writes
+	printf("fwrite  bytes  avg (us)\n");
+	for (size_t i = 0; i < sizeof(payload_sizes) / sizeof(payload_sizes[0]); i++) {
+		uint64_t total = 0;
+		for (int j = 0; j < 100; j++) {
+			uint64_t start = micros();
+			fwrite(payload, 1, payload_sizes[i], stdout);
+			fflush(stdout);
+			total += micros() - start;
+			task_delay(10);
+		}
+		printf("\n%6s  %5u  %8lu\n", "", (unsigned)payload_sizes[i], (unsigned long)(total / 100));
+	}
+}
@@ -0,0 +1,118 @@
+/**
+ * \file tests/controller_callbacks.cpp
+ *
+ * Removes controller event subscribers while they are in use.
+ *
+ * A task waiting forever for events must be woken with EINVAL when its
+ * subscriber is removed, and the slot must be usable again afterwards. Then
+ * callbacks registered with Controller::on_press() must all run on one task,
+ * stop once they are unsubscribed, and be able to unsubscribe themselves.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "kapi.h"
+#include "sim.h"
+
+using namespace pros;
+using namespace pros::c;
+
+static bool failed;
+
+static void check(bool condition, const char* what) {
+	if (!condition) {
+		printf("FAIL: %s\n", what);
+		failed = true;
+	}
+}
+
+static void tap(V5_ControllerIndex button) {
+	sim_set_controller(kControllerMaster, button, 1);
+	task_delay(6);
+	sim_set_controller(kControllerMaster, button, 0);
+	task_delay(14);
+}
+
+static volatile bool waiting;
+static volatile std::int32_t wait_result;
+static volatile int wait_errno;
+
+static void waiter(void* handle) {
+	controller_event_s_t event;
+	waiting = true;
+	wait_result = controller_wait_event((std::int32_t)(std::intptr_t)handle, &event, TIMEOUT_MAX);
+	wait_errno = errno;
+	waiting = false;
+}
+
+static void unsubscribe_while_waiting() {
+	controller_event_filter_s_t filter = {};
+	filter.buttons = CONTROLLER_BUTTON_BIT(E_CONTROLLER_DIGITAL_X);
+	std::int32_t handle = controller_events_subscribe(E_CONTROLLER_MASTER, &filter, 4);
+	task_create(waiter, (void*)(std::intptr_t)handle, TASK_PRIORITY_DEFAULT - 1, TASK_STACK_DEPTH_DEFAULT,
+	            "Waiter");
+	while (!waiting) {
+		task_delay(1);
+	}
+	task_delay(10);
+	check(controller_events_unsubscribe(handle) == 1, "removed a subscriber that a task was waiting on");
+	task_delay(10);
+	check(!waiting && wait_result == PROS_ERR && wait_errno == EINVAL, "the waiting task was woken with EINVAL");
+	check(controller_events_unsubscribe(handle) == PROS_ERR, "a subscriber can only be removed once");
+
+	std::int32_t again = controller_events_subscribe(E_CONTROLLER_MASTER, &filter, 4);
+	tap(ButtonX);
+	controller_event_s_t event;
+	check(controller_wait_event(again, &event, 0) == 1 && event.type == E_CONTROLLER_EVENT_PRESSED,
+	      "a new subscriber gets events after one was removed");
+	controller_events_unsubscribe(again);
+}
+
+static task_t callback_tasks[2];
+static int presses[3];
+static std::int32_t self_handle;
+
+static void callbacks() {
+	Controller master(E_CONTROLLER_MASTER);
+	std::int32_t a = master.on_press(E_CONTROLLER_DIGITAL_A, [] {
+		callback_tasks[0] = task_get_current();
+		presses[0]++;
+	});
+	std::int32_t b = master.on_press(E_CONTROLLER_DIGITAL_B, [] {
+		callback_tasks[1] = task_get_current();
+		presses[1]++;
+	});
+	self_handle = master.on_press(E_CONTROLLER_DIGITAL_Y, [] {
+		presses[2]++;
+		Controller(E_CONTROLLER_MASTER).unsubscribe(self_handle);
+	});
+	check(a >= 0 && b >= 0 && self_handle >= 0, "registered the callbacks");
+
+	tap(ButtonA);
+	tap(ButtonB);
+	tap(ButtonY);
+	tap(ButtonY);
+	check(presses[0] == 1 && presses[1] == 1, "each callback ran once per press");
+	check(callback_tasks[0] != nullptr && callback_tasks[0] == callback_tasks[1], "the callbacks ran on one task");
+	check(callback_tasks[0] != task_get_current(), "the callbacks didn't run on the caller's task");
+	check(presses[2] == 1, "a callback that unsubscribed itself wasn't called again");
+
+	check(master.unsubscribe(a) == 1, "unsubscribed the first callback");
+	check(master.unsubscribe(a) == PROS_ERR && errno == EINVAL, "a callback can only be unsubscribed once");
+	tap(ButtonA);
+	tap(ButtonB);
+	check(presses[0] == 1 && presses[1] == 2, "only the unsubscribed callback stopped");
+	master.unsubscribe(b);
+}
+
+void opcontrol() {
+	task_delay(10);
+	unsubscribe_while_waiting();
+	callbacks();
+	printf("%s\n", failed ? "FAIL" : "PASS");
+}
@@ -0,0 +1,77 @@
+/**
+ * \file tests/controller_events.c
+ *
+ * Taps buttons on the simulated master controller faster than a slow loop
+ * polls them.
+ *
+ * Each tap holds A for 6 ms while the reading task only loops every 50 ms, so
+ * controller_get_digital() misses most of them. The subscriber should still see
+ * every press and release, with the stick's threshold crossings in between,
+ * and controller_get_digital_new_press() should report one press per loop.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+#include "sim.h"
+
+#define TAPS 10
+
+static void tapper(void* ignore) {
+	for (int i = 0; i < TAPS; i++) {
+		sim_set_controller(kControllerMaster, ButtonA, 1);
+		sim_set_controller(kControllerMaster, AnaLeftY, i % 2 ? -100 : 100);
+		delay(6);
+		sim_set_controller(kControllerMaster, ButtonA, 0);
+		sim_set_controller(kControllerMaster, AnaLeftY, 0);
+		delay(44);
+	}
+}
+
+void opcontrol() {
+	controller_event_filter_s_t filter = {.buttons = CONTROLLER_BUTTON_BIT(E_CONTROLLER_DIGITAL_A),
+	                                      .axes = 1 << E_CONTROLLER_ANALOG_LEFT_Y,
+	                                      .thresholds = {[E_CONTROLLER_ANALOG_LEFT_Y] = 50}};
+	int32_t handle = controller_events_subscribe(E_CONTROLLER_MASTER, &filter, 64);
+	controller_get_digital_new_press(E_CONTROLLER_MASTER, E_CONTROLLER_DIGITAL_A);
+	delay(10);
+	task_create(tapper, NULL, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Tapper");
+
+	int polled = 0;
+	int new_presses = 0;
+	for (int i = 0; i < TAPS; i++) {
+		delay(25);
+		polled += controller_get_digital(E_CONTROLLER_MASTER, E_CONTROLLER_DIGITAL_A);
+		delay(25);
+		new_presses += controller_get_digital_new_press(E_CONTROLLER_MASTER, E_CONTROLLER_DIGITAL_A);
+	}
+
+	int counts[4] = {0};
+	uint32_t last = 0;
+	int ordered = 1;
+	controller_event_s_t event;
+	while (controller_wait_event(handle, &event, 0) == 1) {
+		counts[event.type]++;
+		ordered &= event.timestamp >= last;
+		last = event.timestamp;
+	}
+	controller_snapshot_s_t snapshot;
+	controller_get_snapshot(E_CONTROLLER_MASTER, &snapshot);
+
+	printf("polled %d, new presses %d\n", polled, new_presses);
+	printf("pressed %d, released %d, rise %d, fall %d, ordered %d\n", counts[0], counts[1], counts[2], counts[3],
+	       ordered);
+	printf("snapshot %lu: connected %d, buttons %x\n", snapshot.sequence, snapshot.connected, snapshot.buttons);
+	printf("%s\n", counts[0] == TAPS && counts[1] == TAPS && counts[2] == TAPS / 2 && counts[3] == TAPS / 2 &&
+	                       new_presses == TAPS
+	                   ? "PASS"
+	                   : "FAIL");
+	controller_events_unsubscribe(handle);
+}
@@ -0,0 +1,51 @@
+/**
+ * \file tests/controller_screen.c
+ *
+ * Prints to the master controller's screen far faster than VEXos accepts text.
+ *
+ * One line shows a counter that changes every 5 ms, another is rewritten with
+ * the same text every loop, and a rumble is queued halfway through. None of
+ * the calls should block or fail, and once the printing stops the controller
+ * should end up showing exactly the last text of every line.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "sim.h"
+
+#define TEST_DURATION_MS 1000
+
+void opcontrol() {
+	uint32_t failures = 0;
+	uint32_t slowest = 0;
+	controller_clear(E_CONTROLLER_MASTER);
+	for (int i = 0; i < TEST_DURATION_MS / 5; i++) {
+		uint32_t start = millis();
+		failures += controller_print(E_CONTROLLER_MASTER, 0, 0, "count %d", i) != 1;
+		failures += controller_set_text(E_CONTROLLER_MASTER, 2, 4, "steady") != 1;
+		if (i == TEST_DURATION_MS / 10) {
+			failures += controller_rumble(E_CONTROLLER_MASTER, ".-.") != 1;
+		}
+		if (millis() - start > slowest) {
+			slowest = millis() - start;
+		}
+		delay(5);
+	}
+	delay(500);
+
+	printf("failures %lu, slowest call %lu ms\n", failures, slowest);
+	printf("line 1 [%s]\n", sim_get_controller_text(E_CONTROLLER_MASTER, 1));
+	printf("line 2 [%s]\n", sim_get_controller_text(E_CONTROLLER_MASTER, 2));
+	printf("line 3 [%s]\n", sim_get_controller_text(E_CONTROLLER_MASTER, 3));
+	printf("rumble [%s]\n", sim_get_controller_text(E_CONTROLLER_MASTER, 4));
+	printf("%s\n", strcmp(sim_get_controller_text(E_CONTROLLER_MASTER, 1), "count 199          ") ? "FAIL" : "PASS");
+}
@@ -0,0 +1,74 @@
+/**
+ * \file tests/imu_stream.c
+ *
+ * Streams an Inertial Sensor in port 1 at 5 ms and reads it from three tasks.
+ *
+ * Each task reads the samples recorded since its last loop and checks that the
+ * sequence numbers have no gaps. The tasks loop at different rates, but none
+ * of them should miss a sample, and each should see about 200 samples a
+ * second. Taring the sensor should show up in the latest sample at once.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+
+#define IMU_PORT 1
+#define NUM_CONSUMERS 3
+#define TEST_DURATION_MS 1000
+
+typedef struct consumer {
+	uint32_t period;
+	uint32_t samples;
+	uint32_t gaps;
+} consumer_s_t;
+
+static consumer_s_t consumers[NUM_CONSUMERS] = {{.period = 10}, {.period = 20}, {.period = 50}};
+
+static void consumer_task(void* param) {
+	consumer_s_t* consumer = (consumer_s_t*)param;
+	imu_sample_s_t samples[16];
+	uint32_t cursor = 0;
+	uint32_t last = 0;
+	uint32_t start = millis();
+	while (millis() - start < TEST_DURATION_MS) {
+		int32_t read = imu_read_samples(IMU_PORT, &cursor, samples, 16);
+		for (int32_t i = 0; i < read && read != PROS_ERR; i++) {
+			if (last && samples[i].sequence != last + 1) {
+				consumer->gaps++;
+			}
+			last = samples[i].sequence;
+			consumer->samples++;
+		}
+		task_delay(consumer->period);
+	}
+}
+
+void opcontrol() {
+	imu_set_data_rate(IMU_PORT, 5);
+	if (imu_stream_enable(IMU_PORT, 32) != 1) {
+		printf("could not stream port %d (errno %d)\n", IMU_PORT, errno);
+		return;
+	}
+	for (int i = 0; i < NUM_CONSUMERS; i++) {
+		task_create(consumer_task, &consumers[i], TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "imu consumer");
+	}
+	task_delay(TEST_DURATION_MS + 100);
+	for (int i = 0; i < NUM_CONSUMERS; i++) {
+		printf("every %lu ms: %lu samples, %lu gaps\n", (unsigned long)consumers[i].period,
+		       (unsigned long)consumers[i].samples, (unsigned long)consumers[i].gaps);
+	}
+
+	imu_sample_s_t before, after;
+	imu_get_sample(IMU_PORT, &before);
+	imu_set_heading(IMU_PORT, 90);
+	imu_get_sample(IMU_PORT, &after);
+	printf("heading %f -> %f (getter %f)\n", before.heading, after.heading, imu_get_heading(IMU_PORT));
+}
@@ -0,0 +1,63 @@
+/**
+ * \file tests/kmalloc_stats.c
+ *
+ * Exercises the kernel heap statistics.
+ *
+ * A worker task allocates a mix of pooled and heap-sized blocks, frees some of
+ * them, and then is deleted while still holding the rest. The per-task stats
+ * should show the leak under a deleted task, and the trace should contain the
+ * worker's allocations.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+
+#define NUM_BLOCKS 16
+
+static void leaky_task(void* ignore) {
+	void* blocks[NUM_BLOCKS];
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		blocks[i] = kmalloc(i % 2 ? 40 : 1000);
+	}
+	// free only the even blocks
+	for (int i = 0; i < NUM_BLOCKS; i += 2) {
+		kfree(blocks[i]);
+	}
+	task_delay(TIMEOUT_MAX);
+}
+
+void opcontrol() {
+	kmalloc_trace_start(64);
+
+	task_t task = task_create(leaky_task, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Leaky");
+	task_delay(100);
+	task_delete(task);
+	task_delay(100);
+
+	kmalloc_heap_info_s_t info;
+	kmalloc_get_heap_info(&info);
+	printf("free %lu, largest %lu, min ever %lu, blocks %lu\n", (unsigned long)info.free_bytes,
+	       (unsigned long)info.largest_free_block, (unsigned long)info.min_ever_free_bytes,
+	       (unsigned long)info.free_blocks);
+
+	// expect an entry with a NULL task and 8 live allocations of 40 bytes
+	kmalloc_task_stats_s_t stats[KMALLOC_TRACKED_TASKS];
+	int32_t count = kmalloc_get_task_stats(stats, KMALLOC_TRACKED_TASKS);
+	for (int32_t i = 0; i < count; i++) {
+		printf("%-32s %s live %lu bytes in %lu allocs, peak %lu\n", stats[i].name, stats[i].task ? "" : "(deleted)",
+		       (unsigned long)stats[i].live_bytes, (unsigned long)stats[i].live_allocs,
+		       (unsigned long)stats[i].peak_bytes);
+	}
+
+	serctl(SERCTL_ACTIVATE, (void*)KMALLOC_TRACE_STREAM_ID);
+	printf("sent %ld trace entries\n", (long)kmalloc_trace_dump());
+	kmalloc_trace_stop();
+}
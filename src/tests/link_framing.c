@@ -0,0 +1,84 @@
+/**
+ * \file tests/link_framing.c
+ *
+ * Sends framed messages over a radio in port 1 and corrupts some on the way.
+ *
+ * The test expects the radio to hear its own transmissions, which the host
+ * simulator does. A corrupted frame, and junk that contains start bytes, are
+ * put between good messages. The first good message is read with a buffer that
+ * is too small and should be dropped. Every other good message should still be
+ * received, in order and with its type, and the stats should show one CRC
+ * error. A message with a type reserved for the reliable mode must not be sent.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "kapi.h"
+
+#define RADIO_PORT 1
+
+static void send(uint8_t type, const char* text) {
+	if (link_transmit_message(RADIO_PORT, type, text, strlen(text)) == PROS_ERR) {
+		printf("could not send \"%s\" (errno %d)\n", text, errno);
+	}
+}
+
+void opcontrol() {
+	link_init(RADIO_PORT, "framing", E_LINK_TX);
+	task_delay(10);
+
+	// a message whose payload is corrupted on the way
+	uint8_t frame[64];
+	send(1, "this one is corrupted");
+	uint32_t size = link_receive_raw(RADIO_PORT, frame, link_raw_receivable_size(RADIO_PORT));
+	frame[10] ^= 0x40;
+
+	send(1, "first");
+	link_transmit_raw(RADIO_PORT, frame, size);
+	send(2, "second");
+	uint8_t junk[] = {0x33, 0x00, 0x33, 0xff, 0xff, 0x12, 0x33};
+	link_transmit_raw(RADIO_PORT, junk, sizeof(junk));
+	send(3, "third, which is long enough that it has to be received with a bigger buffer");
+	send(4, "");
+	// types past LINK_MAX_MESSAGE_TYPE belong to the reliable mode
+	uint32_t sent = link_transmit_message(RADIO_PORT, LINK_MAX_MESSAGE_TYPE + 1, "reserved", 8);
+	int reserved_err = errno;
+	printf("reserved type: %ld (errno %d, should be EINVAL)\n", (long)sent, reserved_err);
+
+	char text[LINK_MAX_MESSAGE_SIZE + 1];
+	uint8_t type;
+	uint32_t len = link_receive_message(RADIO_PORT, &type, text, 4);
+	int err = errno;
+	printf("small buffer: %ld (errno %d, should be EMSGSIZE, and \"first\" is dropped)\n", (long)len, err);
+	while ((len = link_receive_message(RADIO_PORT, &type, text, LINK_MAX_MESSAGE_SIZE)) != PROS_ERR) {
+		text[len] = '\0';
+		printf("type %d: \"%s\"\n", type, text);
+	}
+	err = errno;
+	printf("then errno %d (should be EAGAIN)\n", err);
+
+	link_stats_s_t stats;
+	link_get_stats(RADIO_PORT, &stats);
+	printf("%lu sent, %lu received, %lu crc errors, %lu bytes dropped\n", (unsigned long)stats.frames_sent,
+	       (unsigned long)stats.frames_received, (unsigned long)stats.crc_errors, (unsigned long)stats.bytes_dropped);
+
+	// the old fixed-size calls still work, and a wrong size only drops one message
+	int32_t value = 42;
+	link_transmit(RADIO_PORT, &value, sizeof(value));
+	link_transmit(RADIO_PORT, &value, sizeof(value));
+	int16_t wrong;
+	int32_t right = 0;
+	len = link_receive(RADIO_PORT, &wrong, sizeof(wrong));
+	err = errno;
+	printf("wrong size: %ld (errno %d, should be EBADMSG)\n", (long)len, err);
+	len = link_receive(RADIO_PORT, &right, sizeof(right));
+	printf("right size: %ld, value %ld\n", (long)len, (long)right);
+}
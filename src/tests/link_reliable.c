@@ -0,0 +1,147 @@
+/**
+ * \file tests/link_reliable.c
+ *
+ * Sends large messages over a lossy link in the reliable mode.
+ *
+ * The test uses a radio in port 1 that hears its own transmissions, as in the
+ * host simulator, so the same link both sends and acknowledges fragments. A
+ * task steals a byte from the radio at random, corrupting whichever frame it
+ * lands in. Every message should still arrive intact and in order, with
+ * the stats showing the retransmissions that made up for the lost frames.
+ *
+ * Then a robot that restarted its program is imitated by injecting fragments
+ * from sessions the link hasn't seen. A fragment from the middle of a session
+ * must be dropped, and so must a later first fragment of that session, since
+ * the link asked for it to start over. A new session whose first fragment
+ * arrives after its second must be delivered without another reset, and a
+ * message sent after that must still arrive once the link has started its own
+ * session over.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/crc.h"
+#include "kapi.h"
+
+#define RADIO_PORT 1
+#define NUM_MESSAGES 4
+#define MESSAGE_SIZE 3000
+
+static volatile bool sending = true;
+
+// Frames a fragment the way a robot running another session would send it
+static void inject_fragment(uint16_t session, uint16_t seq, uint8_t type, uint8_t flags, const char* text) {
+	uint16_t size = 6 + strlen(text);
+	uint8_t frame[64] = {0x33, 0x80, size & 0xff, size >> 8};
+	frame[4] = crc16_update(CRC16_INIT, frame + 1, 3) & 0xff;
+	uint8_t header[6] = {seq & 0xff, seq >> 8, type, flags, session & 0xff, session >> 8};
+	memcpy(frame + 5, header, sizeof(header));
+	memcpy(frame + 11, text, strlen(text));
+	uint16_t crc = crc16_update(CRC16_INIT, frame + 1, size + 4);
+	frame[5 + size] = crc & 0xff;
+	frame[6 + size] = crc >> 8;
+	link_transmit_raw(RADIO_PORT, frame, size + 7);
+}
+
+static void restart() {
+	// first and last fragment, with and without the flag that starts a session
+	inject_fragment(0x1234, 5, 9, 0x03, "middle");
+	task_delay(50);
+	inject_fragment(0x1234, 0, 9, 0x07, "refused");
+	task_delay(50);
+	// a new session whose first fragment was delayed
+	inject_fragment(0x2345, 1, 9, 0x06, "started");
+	task_delay(50);
+	inject_fragment(0x2345, 0, 9, 0x05, "re");
+	task_delay(50);
+	link_reliable_send(RADIO_PORT, 10, "after", 5);
+
+	uint32_t start = millis();
+	int received = 0;
+	while (received < 2 && millis() - start < 2000) {
+		uint8_t type;
+		char text[16] = {0};
+		if (link_reliable_receive(RADIO_PORT, &type, text, sizeof(text) - 1) == PROS_ERR) {
+			task_delay(10);
+			continue;
+		}
+		printf("after restart: message %d \"%s\" after %lu ms\n", type, text, (unsigned long)(millis() - start));
+		received++;
+	}
+	while (link_reliable_pending(RADIO_PORT) > 0 && millis() - start < 2000) {
+		task_delay(10);
+	}
+}
+
+static void byte_thief(void* ign) {
+	while (sending) {
+		uint8_t byte;
+		if (rand() % 8 == 0 && link_raw_receivable_size(RADIO_PORT) > 0) {
+			link_receive_raw(RADIO_PORT, &byte, 1);
+		}
+		task_delay(3);
+	}
+}
+
+void opcontrol() {
+	link_init(RADIO_PORT, "reliable", E_LINK_TX);
+	task_delay(10);
+	if (link_reliable_enable(RADIO_PORT) != 1) {
+		printf("could not enable the reliable mode (errno %d)\n", errno);
+		return;
+	}
+	task_create(byte_thief, NULL, TASK_PRIORITY_MAX - 1, TASK_STACK_DEPTH_DEFAULT, "byte thief");
+
+	static uint8_t message[MESSAGE_SIZE];
+	uint32_t start = millis();
+	for (int i = 0; i < NUM_MESSAGES; i++) {
+		for (int j = 0; j < MESSAGE_SIZE; j++) {
+			message[j] = (uint8_t)(i * 31 + j);
+		}
+		if (link_reliable_send(RADIO_PORT, i, message, MESSAGE_SIZE) != 1) {
+			printf("could not queue message %d (errno %d)\n", i, errno);
+		}
+	}
+	printf("queued %d messages in %lu ms\n", NUM_MESSAGES, (unsigned long)(millis() - start));
+
+	int received = 0;
+	while (received < NUM_MESSAGES && millis() - start < 20000) {
+		uint8_t type;
+		uint32_t size = link_reliable_receive(RADIO_PORT, &type, message, MESSAGE_SIZE);
+		if (size == PROS_ERR) {
+			task_delay(10);
+			continue;
+		}
+		int errors = 0;
+		for (uint32_t j = 0; j < size; j++) {
+			errors += message[j] != (uint8_t)(type * 31 + j);
+		}
+		printf("message %d: %lu bytes, %d wrong, after %lu ms\n", type, (unsigned long)size, errors,
+		       (unsigned long)(millis() - start));
+		received++;
+	}
+	sending = false;
+	while (link_reliable_pending(RADIO_PORT) > 0 && millis() - start < 20000) {
+		task_delay(10);
+	}
+
+	link_stats_s_t stats;
+	link_get_stats(RADIO_PORT, &stats);
+	printf("%lu frames sent, %lu received, %lu crc errors, %lu retransmissions, %lu pending\n",
+	       (unsigned long)stats.frames_sent, (unsigned long)stats.frames_received, (unsigned long)stats.crc_errors,
+	       (unsigned long)stats.retransmissions, (unsigned long)link_reliable_pending(RADIO_PORT));
+
+	restart();
+	link_get_stats(RADIO_PORT, &stats);
+	printf("%lu session resets, %lu pending\n", (unsigned long)stats.session_resets,
+	       (unsigned long)link_reliable_pending(RADIO_PORT));
+}
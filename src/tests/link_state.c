@@ -0,0 +1,115 @@
+/**
+ * \file tests/link_state.c
+ *
+ * Shares a 1 KB field map over a link and changes a few cells every loop.
+ *
+ * The test uses a radio in port 1 that hears its own transmissions, as in the
+ * host simulator, so the state that is published comes back as the other
+ * robot's. After two seconds of publishing every 10 ms, the received map
+ * should match the last one published, and far fewer bytes should have been
+ * sent than resending the whole map every loop would take.
+ *
+ * Then deltas from another robot are injected. One that has a run outside the
+ * map must be dropped without changing any of the map, and one made for a
+ * version this robot doesn't have must make it ask for a keyframe, which
+ * brings the map back to the last one published.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "common/crc.h"
+#include "kapi.h"
+
+#define RADIO_PORT 1
+#define MAP_ID 3
+
+typedef struct field_map {
+	uint8_t cells[1000];
+	float target_x, target_y;
+	uint32_t loop;
+} field_map_s_t;
+
+// Sends a delta as the only fragment of a new session of the other robot
+static void inject_delta(uint16_t session, uint32_t base, const uint8_t* runs, uint16_t runs_size) {
+	uint8_t frame[64] = {0x33, 0x80};
+	uint16_t size = 6 + 10 + runs_size;
+	frame[2] = size & 0xff;
+	frame[3] = size >> 8;
+	frame[4] = crc16_update(CRC16_INIT, frame + 1, 3) & 0xff;
+	// sequence number 0, state message, first and last fragment of a new session
+	uint8_t header[16] = {0, 0, 0x80, 0x07, session & 0xff, session >> 8, MAP_ID, 0};
+	memcpy(header + 8, &base, 4);
+	base++;
+	memcpy(header + 12, &base, 4);
+	memcpy(frame + 5, header, sizeof(header));
+	memcpy(frame + 21, runs, runs_size);
+	uint16_t crc = crc16_update(CRC16_INIT, frame + 1, size + 4);
+	frame[5 + size] = crc & 0xff;
+	frame[6 + size] = crc >> 8;
+	link_transmit_raw(RADIO_PORT, frame, size + 7);
+}
+
+static void inject(const field_map_s_t* map) {
+	static field_map_s_t received;
+	uint32_t version = link_state_get(RADIO_PORT, MAP_ID, &received);
+
+	// a valid run flipping cell 0, then a run past the end of the map
+	const uint8_t malformed[] = {0, 0, 1, 0xff, 0xd0, 0x07, 2, 1, 1};
+	inject_delta(0x1111, version, malformed, sizeof(malformed));
+	task_delay(100);
+	uint32_t after = link_state_get(RADIO_PORT, MAP_ID, &received);
+	printf("malformed delta: map %s, version %s\n", memcmp(map, &received, sizeof(*map)) ? "differs" : "matches",
+	       after == version ? "unchanged" : "changed");
+
+	const uint8_t stale[] = {0, 0, 1, 0xff};
+	inject_delta(0x2222, version + 5, stale, sizeof(stale));
+	task_delay(200);
+	after = link_state_get(RADIO_PORT, MAP_ID, &received);
+	printf("stale delta: map %s, version %lu after %lu\n", memcmp(map, &received, sizeof(*map)) ? "differs" : "matches",
+	       (unsigned long)after, (unsigned long)version);
+}
+
+void opcontrol() {
+	link_init(RADIO_PORT, "state", E_LINK_TX);
+	task_delay(10);
+	link_reliable_enable(RADIO_PORT);
+	if (link_state_register(RADIO_PORT, MAP_ID, sizeof(field_map_s_t)) != 1) {
+		printf("could not register the map (errno %d)\n", errno);
+		return;
+	}
+	errno = 0;
+	if (link_state_register(RADIO_PORT, MAP_ID, 16) != PROS_ERR || errno != EEXIST) {
+		printf("the map was registered again with another size\n");
+	}
+
+	static field_map_s_t map, received;
+	uint32_t loops = 0;
+	uint32_t time = millis();
+	for (; loops < 200; loops++) {
+		map.cells[(loops * 37) % sizeof(map.cells)] ^= 1;
+		map.cells[(loops * 101) % sizeof(map.cells)] += 3;
+		map.target_x = loops * 0.5f;
+		map.loop = loops;
+		link_state_publish(RADIO_PORT, MAP_ID, &map);
+		task_delay_until(&time, 10);
+	}
+	task_delay(200);
+
+	uint32_t version = link_state_get(RADIO_PORT, MAP_ID, &received);
+	link_stats_s_t stats;
+	link_get_stats(RADIO_PORT, &stats);
+	printf("version %lu after %lu publishes, map %s, loop %lu\n", (unsigned long)version, (unsigned long)loops,
+	       memcmp(&map, &received, sizeof(map)) ? "differs" : "matches", (unsigned long)received.loop);
+	printf("%lu bytes of updates, %lu to resend the whole map\n", (unsigned long)stats.state_bytes_sent,
+	       (unsigned long)(loops * sizeof(map)));
+
+	inject(&map);
+}
@@ -0,0 +1,223 @@
+/**
+ * \file tests/motor_batch.cpp
+ *
+ * Exercises the batched motor API and the Motor_Group paths built on it.
+ *
+ * Run with PROS_HOST_DEVICES=1:motor,2:motor,3:motor,4:motor. Port 5 is left
+ * empty. Commands and reads are checked against the single-motor functions,
+ * invalid batches must fail without moving any motor, and a batch has to wait
+ * for a task that is using one of its ports. Finally, tasks that hold pairs of
+ * ports across several device frames run alongside batches and the system
+ * daemon for a while, which deadlocked when the daemon waited on ports out of
+ * order.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstdlib>
+
+#include "kapi.h"
+
+extern "C" int port_mutex_take(std::uint8_t port);
+extern "C" int port_mutex_give(std::uint8_t port);
+
+using namespace pros;
+using namespace pros::c;
+
+#define EMPTY_PORT 5
+#define HOLD_MS 20
+#define STRESS_MS 2000
+
+static bool failed;
+
+static void check(bool condition, const char* what) {
+	if (!condition) {
+		printf("FAIL: %s\n", what);
+		failed = true;
+	}
+}
+
+// The simulator derives the voltage it reports from the motor's velocity, so
+// it can be a millivolt off from the command
+static bool voltage_is(std::uint8_t port, std::int32_t voltage) {
+	return std::abs(motor_get_voltage(port) - voltage) <= 1;
+}
+
+static void commands() {
+	const std::uint8_t ports[] = {3, 1, 2};
+	const std::int32_t voltages[] = {-6000, 3000, 12000};
+	check(motor_batch_move_voltage(ports, 3, voltages) == 1, "motor_batch_move_voltage() succeeded");
+	check(voltage_is(3, -6000) && voltage_is(1, 3000) && voltage_is(2, 12000), "every motor got its own voltage");
+
+	const std::int32_t moves[] = {64, -200, 127};
+	check(motor_batch_move(ports, 3, moves) == 1, "motor_batch_move() succeeded");
+	motor_move(4, 64);
+	check(voltage_is(3, motor_get_voltage(4)), "motor_batch_move() scales like motor_move()");
+	check(voltage_is(1, -12000) && voltage_is(2, 12000), "motor_batch_move() clamps to [-127, 127]");
+
+	const std::int32_t velocities[] = {50, -100, 150};
+	check(motor_batch_move_velocity(ports, 3, velocities) == 1, "motor_batch_move_velocity() succeeded");
+	check(motor_get_target_velocity(3) == 50 && motor_get_target_velocity(1) == -100 &&
+	          motor_get_target_velocity(2) == 150,
+	      "every motor got its own velocity");
+
+	const std::uint8_t duplicates[] = {1, 1};
+	const std::int32_t twice[] = {10, 20};
+	check(motor_batch_move_velocity(duplicates, 2, twice) == 1, "a port can appear twice in a batch");
+	check(motor_get_target_velocity(1) == 20, "the last command to a repeated port wins");
+	check(motor_batch_move_velocity(ports, 0, velocities) == 1, "an empty batch succeeds");
+}
+
+static void reads() {
+	const std::uint8_t ports[] = {2, 4};
+	const std::int32_t velocities[] = {80, -40};
+	motor_batch_move_velocity(ports, 2, velocities);
+	task_delay(20);
+
+	motor_snapshot_s_t out[2];
+	out[0].power = out[1].power = -1;
+	const std::uint32_t fields = E_MOTOR_FIELD_POSITION | E_MOTOR_FIELD_ACTUAL_VELOCITY;
+	check(motor_batch_read(ports, 2, fields, out) == 1, "motor_batch_read() succeeded");
+	check(out[0].actual_velocity == 80 && out[1].actual_velocity == -40, "read every motor's velocity");
+	check(out[0].position > 0 && out[1].position < 0, "read every motor's position");
+	check(out[0].power == -1 && out[1].power == -1, "fields that weren't requested are untouched");
+	check(out[0].timestamp == out[1].timestamp, "every motor was read at once");
+}
+
+static void invalid() {
+	const std::int32_t velocities[] = {100, 100};
+	motor_move_velocity(1, 0);
+
+	const std::uint8_t out_of_range[] = {1, 0};
+	errno = 0;
+	check(motor_batch_move_velocity(out_of_range, 2, velocities) == PROS_ERR && errno == ENXIO,
+	      "a batch with port 0 fails with ENXIO");
+
+	const std::uint8_t empty[] = {1, EMPTY_PORT};
+	errno = 0;
+	check(motor_batch_move_velocity(empty, 2, velocities) == PROS_ERR && errno == ENODEV,
+	      "a batch with an empty port fails with ENODEV");
+	check(motor_get_target_velocity(1) == 0, "an invalid batch doesn't move any motor");
+
+	motor_snapshot_s_t out[2];
+	errno = 0;
+	check(motor_batch_read(empty, 2, E_MOTOR_FIELD_ALL, out) == PROS_ERR && errno == ENODEV,
+	      "a read with an empty port fails with ENODEV");
+}
+
+static volatile bool holding;
+
+static void holder(void* port) {
+	port_mutex_take((std::uint8_t)(std::uintptr_t)port - 1);
+	holding = true;
+	task_delay(HOLD_MS);
+	holding = false;
+	port_mutex_give((std::uint8_t)(std::uintptr_t)port - 1);
+}
+
+static void waits_for_ports() {
+	holding = false;
+	task_create(holder, (void*)2, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Holder");
+	while (!holding) {
+		task_delay(1);
+	}
+	const std::uint8_t ports[] = {1, 2};
+	const std::int32_t velocities[] = {30, 30};
+	std::uint32_t start = millis();
+	check(motor_batch_move_velocity(ports, 2, velocities) == 1, "a batch on a busy port succeeded");
+	check(!holding && millis() - start >= HOLD_MS - 2, "the batch waited for the busy port");
+	check(motor_get_target_velocity(2) == 30, "the busy port got the batch's command");
+}
+
+#define PAIR_HOLDERS 3
+
+static volatile bool stressing;
+static volatile std::uint32_t rounds[PAIR_HOLDERS + 1];
+
+// Port 3 is the higher port of one pair and the lower port of another, so the
+// daemon can end up waiting on it while port 1 is held by a task that wants it
+static const std::uint8_t pairs[PAIR_HOLDERS][2] = {{1, 3}, {3, 4}, {2, 4}};
+
+// Holds two ports at once, lowest first, across device frames
+static void pair_holder(void* index) {
+	const std::uint8_t* pair = pairs[(std::uintptr_t)index];
+	while (stressing) {
+		port_mutex_take(pair[0] - 1);
+		task_delay(1);
+		port_mutex_take(pair[1] - 1);
+		task_delay(1);
+		port_mutex_give(pair[1] - 1);
+		port_mutex_give(pair[0] - 1);
+		rounds[(std::uintptr_t)index] = rounds[(std::uintptr_t)index] + 1;
+		task_delay(1);
+	}
+}
+
+static void batcher(void* ign) {
+	const std::uint8_t ports[] = {4, 1, 3, 2};
+	const std::int32_t velocities[] = {10, 10, 10, 10};
+	while (stressing) {
+		motor_batch_move_velocity(ports, 4, velocities);
+		rounds[PAIR_HOLDERS] = rounds[PAIR_HOLDERS] + 1;
+		task_delay(1);
+	}
+}
+
+static void survives_contention() {
+	stressing = true;
+	for (std::uintptr_t i = 0; i < PAIR_HOLDERS; i++) {
+		task_create(pair_holder, (void*)i, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Pair Holder");
+	}
+	task_create(batcher, nullptr, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Batcher");
+	std::uint32_t last[PAIR_HOLDERS + 1] = {};
+	bool progressed = true;
+	for (int i = 0; i < STRESS_MS / 100; i++) {
+		task_delay(100);
+		for (int j = 0; j <= PAIR_HOLDERS; j++) {
+			progressed = progressed && rounds[j] != last[j];
+			last[j] = rounds[j];
+		}
+	}
+	stressing = false;
+	task_delay(20);
+	check(progressed, "every task holding several ports kept making progress");
+}
+
+static void motor_group() {
+	pros::Motor_Group group({1, 2, 3});
+	check(group.move(127) == 1, "Motor_Group::move() succeeded");
+	check(voltage_is(1, 12000) && voltage_is(2, 12000) && voltage_is(3, 12000), "Motor_Group::move() scaled");
+
+	const std::int32_t velocities[] = {20, 40, 60};
+	check(group.move_velocities(velocities) == 1, "Motor_Group::move_velocities() succeeded");
+	task_delay(10);
+	std::vector<double> group_velocities = group.get_actual_velocities();
+	check(group_velocities.size() == 3 && group_velocities[0] == 20 && group_velocities[1] == 40 &&
+	          group_velocities[2] == 60,
+	      "Motor_Group::get_actual_velocities() matches the commands");
+
+	std::vector<double> positions = group.get_positions();
+	check(positions.size() == 3 && positions[0] > 0, "Motor_Group::get_positions() read the motors");
+
+	// The batch fails because of the empty port, so the getter falls back to
+	// reading the motors one at a time
+	pros::Motor_Group with_empty({1, EMPTY_PORT});
+	positions = with_empty.get_positions();
+	check(positions.size() == 2 && positions[0] != PROS_ERR_F && positions[1] == PROS_ERR_F,
+	      "only the empty port reads as an error");
+}
+
+void opcontrol() {
+	commands();
+	reads();
+	invalid();
+	waits_for_ports();
+	survives_contention();
+	motor_group();
+	printf("%s\n", failed ? "FAIL" : "PASS");
+}
@@ -0,0 +1,73 @@
+/**
+ * \file tests/odometry.c
+ *
+ * Tracks a drivetrain with the pose estimation service.
+ *
+ * Motors in ports 1 and 2 are used as the left and right tracking wheels,
+ * 10 inches apart, with a circumference of 4 inches. Driving both forward at
+ * 100 rpm for a second should move the pose about 6.7 inches along y, and
+ * spinning in place for a second should then turn it about 76 degrees
+ * clockwise without moving it. The right motor reports counts, so both paths
+ * of the unit conversion are checked.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+
+#define LEFT_PORT 1
+#define RIGHT_PORT 2
+
+static void print_pose(const char* when) {
+	odometry_pose_s_t pose;
+	if (odometry_get_pose(&pose) != 1) {
+		printf("%s: no pose (errno %d)\n", when, errno);
+		return;
+	}
+	printf("%s: (%.2f, %.2f) at %.2f degrees, pose %lu at %lu ms, status %lu\n", when, pose.x, pose.y, pose.heading,
+	       (unsigned long)pose.sequence, (unsigned long)pose.timestamp, (unsigned long)pose.status);
+}
+
+void opcontrol() {
+	print_pose("before starting");
+	motor_set_encoder_units(RIGHT_PORT, E_MOTOR_ENCODER_COUNTS);
+
+	odometry_config_s_t config = {
+	    .parallel = {{.sensor = E_ODOMETRY_SENSOR_MOTOR, .port = LEFT_PORT, .diameter = 4 / M_PI, .offset = -5},
+	                 {.sensor = E_ODOMETRY_SENSOR_MOTOR, .port = RIGHT_PORT, .diameter = 4 / M_PI, .offset = 5}}};
+	odometry_config_s_t no_heading = config;
+	no_heading.parallel[1].sensor = E_ODOMETRY_SENSOR_NONE;
+	errno = 0;
+	if (odometry_start(&no_heading) != PROS_ERR || errno != EINVAL) {
+		printf("a configuration without a heading was accepted\n");
+	}
+	if (odometry_start(&config) != 1) {
+		printf("could not start (errno %d)\n", errno);
+		return;
+	}
+	task_delay(10);
+	print_pose("started");
+
+	motor_move_velocity(LEFT_PORT, 100);
+	motor_move_velocity(RIGHT_PORT, 100);
+	task_delay(1000);
+	motor_move_velocity(LEFT_PORT, 100);
+	motor_move_velocity(RIGHT_PORT, -100);
+	print_pose("driven forward");
+	task_delay(1000);
+	motor_brake(LEFT_PORT);
+	motor_brake(RIGHT_PORT);
+	task_delay(10);
+	print_pose("turned");
+
+	odometry_set_pose(24, -24, 180);
+	print_pose("moved");
+	odometry_stop();
+}
@@ -0,0 +1,105 @@
+/**
+ * \file tests/periodic_tasks.c
+ *
+ * Exercises periodic tasks.
+ *
+ * A 10 ms task aligned to the system daemon and a 5 ms task whose every fourth
+ * job overruns are run for a second. The first should report about 100 jobs
+ * with no overruns, and the second should report the overruns and the
+ * releases it had to skip. A task with an invalid period must not be created.
+ * A task that owns its parameters must clean them up exactly once, whether it
+ * is deleted or couldn't be created.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+
+static uint32_t releases[2];
+
+static void control_loop(void* ign) {
+	releases[0]++;
+}
+
+static void overrunning_loop(void* ign) {
+	// busy wait, so that the job runs past its next release
+	if (++releases[1] % 4 == 0) {
+		uint32_t start = millis();
+		while (millis() - start < 12)
+			;
+	}
+}
+
+static uint32_t cleanups;
+
+static void cleanup(void* ign) {
+	cleanups++;
+}
+
+static void check_cleanup() {
+	task_t owner = task_create_periodic_owned(control_loop, NULL, cleanup, 10, 0, false, TASK_PRIORITY_DEFAULT,
+	                                          TASK_STACK_DEPTH_DEFAULT, "owner");
+	task_delay(20);
+	if (cleanups != 0) {
+		printf("parameters were cleaned up while the task was running\n");
+	}
+	task_delete(owner);
+	// the idle task frees deleted tasks
+	task_delay(10);
+	if (cleanups != 1) {
+		printf("deleting the task cleaned up its parameters %lu times\n", (unsigned long)cleanups);
+	}
+
+	if (task_create_periodic_owned(control_loop, NULL, cleanup, 0, 0, false, TASK_PRIORITY_DEFAULT,
+	                               TASK_STACK_DEPTH_DEFAULT, "invalid") != NULL ||
+	    cleanups != 2) {
+		printf("a task that wasn't created didn't clean up its parameters\n");
+	}
+}
+
+static void print_stats(task_t task) {
+	task_periodic_stats_s_t stats;
+	if (task_get_periodic_stats(task, &stats) != 1) {
+		printf("%s: no stats (errno %d)\n", task_get_name(task), errno);
+		return;
+	}
+	printf("%s: %lu ms period, %lu releases, %lu overruns, %lu skipped\n", task_get_name(task),
+	       (unsigned long)stats.period, (unsigned long)stats.releases, (unsigned long)stats.overruns,
+	       (unsigned long)stats.skipped);
+	printf("  jitter %lu us (max %lu), exec %lu us (max %lu), response %lu us (max %lu)\n",
+	       (unsigned long)stats.jitter, (unsigned long)stats.max_jitter, (unsigned long)stats.exec_time,
+	       (unsigned long)stats.max_exec_time, (unsigned long)stats.response_time,
+	       (unsigned long)stats.max_response_time);
+}
+
+void opcontrol() {
+	task_t control = task_create_periodic(control_loop, NULL, 10, 0, true, TASK_PRIORITY_DEFAULT + 2,
+	                                      TASK_STACK_DEPTH_DEFAULT, "control loop");
+	task_t overrunning = task_create_periodic(overrunning_loop, NULL, 5, 4, false, TASK_PRIORITY_DEFAULT + 1,
+	                                          TASK_STACK_DEPTH_DEFAULT, "overrunning loop");
+
+	errno = 0;
+	if (task_create_periodic(control_loop, NULL, 5, 0, true, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT,
+	                         "misaligned") != NULL ||
+	    errno != EINVAL) {
+		printf("an odd aligned period was accepted\n");
+	}
+
+	task_delay(1000);
+	print_stats(control);
+	print_stats(overrunning);
+	print_stats(CURRENT_TASK);
+
+	task_delete(control);
+	task_delete(overrunning);
+
+	check_cleanup();
+	printf("done\n");
+}
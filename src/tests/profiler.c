@@ -0,0 +1,56 @@
+/**
+ * \file tests/profiler.c
+ *
+ * Profiles two functions that burn CPU in a 3:1 ratio.
+ *
+ * Symbolize the output with
+ *     python3 tools/profile_symbolize.py capture.bin bin/host/pros --nm nm
+ * and heavy_work should get about three times the samples of light_work.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+
+static volatile uint32_t sink;
+
+// each burns CPU in its own loop, so samples land in it rather than in a
+// shared helper
+__attribute__((noinline)) static void heavy_work(void) {
+	uint32_t start = millis();
+	while (millis() - start < 3) {
+		sink++;
+	}
+}
+
+__attribute__((noinline)) static void light_work(void) {
+	uint32_t start = millis();
+	while (millis() - start < 1) {
+		sink++;
+	}
+}
+
+static void worker(void* ignore) {
+	while (true) {
+		heavy_work();
+		light_work();
+		delay(4);
+	}
+}
+
+void opcontrol() {
+	profiler_start(4000);
+	task_create(worker, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Worker");
+	delay(2000);
+	profiler_stop();
+
+	serctl(SERCTL_ACTIVATE, (void*)PROFILER_STREAM_ID);
+	printf("sent %ld samples\n", (long)profiler_dump());
+}
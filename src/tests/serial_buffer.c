@@ -0,0 +1,139 @@
+/**
+ * \file tests/serial_buffer.c
+ *
+ * Reads frames from a generic serial port that loops back to itself.
+ *
+ * Run with PROS_HOST_DEVICES=1:serial. A writer task sends newline-delimited
+ * lines, then length-prefixed frames, a few bytes at a time, while the reader
+ * blocks for each frame in turn. A frame that is too big for the reader's
+ * buffer should be reported and left in place. Removing the buffer should
+ * wake a reader that is blocked on the port, and /dev/1 should read back what
+ * was written to it.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "kapi.h"
+
+#define PORT 1
+#define LINES 20
+#define FRAMES 20
+
+// The VFS's system calls, used directly because open() is the C library's own
+// on the host
+int _open(const char* file, int flags, int mode);
+ssize_t _write(int file, const void* buf, size_t len);
+ssize_t _read(int file, void* buf, size_t len);
+int _close(int file);
+
+// Writes in small pieces so that frames arrive over several daemon cycles
+static void write_slowly(const uint8_t* data, size_t length) {
+	while (length) {
+		size_t piece = length < 3 ? length : 3;
+		serial_write(PORT, (uint8_t*)data, piece);
+		data += piece;
+		length -= piece;
+		delay(1);
+	}
+}
+
+static void writer(void* ignore) {
+	char line[32];
+	for (int i = 0; i < LINES; i++) {
+		snprintf(line, sizeof(line), "line %d\n", i);
+		write_slowly((uint8_t*)line, strlen(line));
+	}
+	uint8_t frame[64];
+	for (int i = 0; i < FRAMES; i++) {
+		uint16_t size = i + 1;
+		frame[0] = size & 0xff;
+		frame[1] = size >> 8;
+		memset(frame + 2, i, size);
+		write_slowly(frame, size + 2);
+	}
+}
+
+static volatile bool blocked;
+static volatile int blocked_errno;
+
+static void blocked_reader(void* ign) {
+	uint8_t byte;
+	blocked = true;
+	if (serial_read_timeout(PORT, &byte, 1, TIMEOUT_MAX) == PROS_ERR) {
+		blocked_errno = errno;
+	}
+	blocked = false;
+}
+
+void opcontrol() {
+	serial_enable(PORT);
+	serial_set_read_buffer(PORT, 256);
+	task_create(writer, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Writer");
+
+	int good_lines = 0;
+	char line[32];
+	char expected[32];
+	for (int i = 0; i < LINES; i++) {
+		int32_t length = serial_read_until(PORT, (uint8_t*)line, sizeof(line) - 1, '\n', 1000);
+		if (length == PROS_ERR) {
+			printf("line %d: errno %d\n", i, errno);
+			break;
+		}
+		line[length] = '\0';
+		snprintf(expected, sizeof(expected), "line %d", i);
+		good_lines += !strcmp(line, expected);
+	}
+
+	int good_frames = 0;
+	int too_big = 0;
+	uint8_t frame[64];
+	for (int i = 0; i < FRAMES; i++) {
+		// Frames longer than 10 bytes don't fit until the buffer is made bigger
+		int32_t length = serial_read_frame(PORT, frame, i < 15 ? 10 : sizeof(frame), 1000);
+		if (length == PROS_ERR && errno == EMSGSIZE) {
+			too_big++;
+			length = serial_read_frame(PORT, frame, sizeof(frame), 1000);
+		}
+		if (length == PROS_ERR) {
+			printf("frame %d: errno %d\n", i, errno);
+			break;
+		}
+		int good = length == i + 1;
+		for (int j = 0; j < length; j++) {
+			good &= frame[j] == i;
+		}
+		good_frames += good;
+	}
+	uint32_t start = millis();
+	int32_t timed_out = serial_read_timeout(PORT, frame, sizeof(frame), 50) == PROS_ERR && errno == EAGAIN;
+	uint32_t waited = millis() - start;
+
+	task_create(blocked_reader, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Blocked Reader");
+	task_delay(20);
+	serial_set_read_buffer(PORT, 0);
+	task_delay(10);
+	int woken = !blocked && blocked_errno == ENOBUFS;
+
+	int fd = _open("/dev/1", O_RDWR, 0);
+	_write(fd, "hello", 5);
+	char echo[8] = {0};
+	ssize_t echoed = _read(fd, echo, sizeof(echo) - 1);
+	_close(fd);
+
+	printf("lines %d/%d, frames %d/%d (%d too big), timed out %d after %lu ms, blocked reader woken %d, /dev/1 read "
+	       "%d [%s]\n",
+	       good_lines, LINES, good_frames, FRAMES, too_big, timed_out, waited, woken, (int)echoed, echo);
+	printf("%s\n", good_lines == LINES && good_frames == FRAMES && too_big == 5 && timed_out && woken && echoed == 5
+	                   ? "PASS"
+	                   : "FAIL");
+}
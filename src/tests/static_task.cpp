@@ -0,0 +1,72 @@
+/**
+ * \file tests/static_task.cpp
+ *
+ * Creates pros::StaticTasks from lambdas and checks that the heap is untouched.
+ *
+ * One task is declared at namespace scope and counts for as long as the
+ * program runs. Another is created in opcontrol() from a lambda with captures,
+ * returns, and should delete itself and destroy its lambda. The free heap
+ * should be the same before and after.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "kapi.h"
+#include "pros/rtos.hpp"
+
+static volatile uint32_t ticks;
+static pros::StaticTask<> counter{[] {
+	                                  while (true) {
+		                                  ticks = ticks + 1;
+		                                  pros::delay(10);
+	                                  }
+                                  },
+                                  "Counter"};
+
+// Sets a flag when destroyed. Only the last object it was moved into sets it,
+// so the temporaries made while the lambda is moved into the task don't count.
+struct DestroyFlag {
+	bool* destroyed;
+	explicit DestroyFlag(bool* destroyed) : destroyed(destroyed) {}
+	DestroyFlag(DestroyFlag&& other) : destroyed(other.destroyed) {
+		other.destroyed = nullptr;
+	}
+	DestroyFlag(const DestroyFlag&) = delete;
+	~DestroyFlag() {
+		if (destroyed) {
+			*destroyed = true;
+		}
+	}
+};
+
+static std::uint32_t free_heap() {
+	pros::c::kmalloc_heap_info_s_t info;
+	pros::c::kmalloc_get_heap_info(&info);
+	return info.free_bytes;
+}
+
+void opcontrol() {
+	std::uint32_t before = free_heap();
+
+	bool destroyed = false;
+	int result = 0;
+	int a = 20, b = 22;
+	{
+		static pros::StaticTask<512> adder{[&result, a, b, flag = DestroyFlag{&destroyed}] { result = a + b; },
+		                                   "Adder"};
+		pros::delay(50);
+		printf("adder state %lu, result %d, lambda destroyed %d\n", (unsigned long)adder.get_state(), result, destroyed);
+	}
+
+	std::uint32_t ticks_before = ticks;
+	pros::delay(100);
+	std::uint32_t after = free_heap();
+	printf("counter ran %lu times in 100 ms\n", (unsigned long)(ticks - ticks_before));
+	printf("free heap before %lu, after %lu\n", (unsigned long)before, (unsigned long)after);
+	printf("%s\n", result == 42 && destroyed && before == after && ticks != ticks_before ? "PASS" : "FAIL");
+}
@@ -0,0 +1,59 @@
+/**
+ * \file tests/task_stats.c
+ *
+ * Prints a top-style table of CPU usage.
+ *
+ * "Half Busy" spins for 5 ms and sleeps for 5 ms, so it should use about half
+ * of the CPU in the window. "Preemptor" wakes every 3 ms at a higher priority,
+ * so Half Busy should be preempted often while it spins.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+
+static void half_busy(void* ignore) {
+	while (true) {
+		uint32_t start = millis();
+		while (millis() - start < 5) {
+		}
+		delay(5);
+	}
+}
+
+static void preemptor(void* ignore) {
+	while (true) {
+		delay(3);
+	}
+}
+
+void opcontrol() {
+	task_t busy = task_create(half_busy, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Half Busy");
+	task_create(preemptor, NULL, TASK_PRIORITY_DEFAULT + 2, TASK_STACK_DEPTH_MIN, "Preemptor");
+	delay(2500);
+
+	task_stats_s_t stats[16];
+	int32_t count = task_get_all_stats(stats, 16);
+	printf("%-32s %5s %10s %7s %8s %8s %6s\n", "task", "prio", "run (us)", "cpu %", "switches", "preempts", "stack");
+	for (int32_t i = 0; i < count; i++) {
+		printf("%-32s %5lu %10llu %7.1f %8lu %8lu %6lu\n", stats[i].name, (unsigned long)stats[i].priority,
+		       (unsigned long long)stats[i].run_time, stats[i].usage, (unsigned long)stats[i].switches,
+		       (unsigned long)stats[i].preemptions, (unsigned long)stats[i].stack_high_water);
+	}
+
+	task_system_stats_s_t system;
+	task_get_system_stats(&system);
+	printf("idle %.1f%% of %lu us, %lu tasks, %lu switches\n", system.idle_usage, (unsigned long)system.window,
+	       (unsigned long)system.task_count, (unsigned long)system.switches);
+
+	task_stats_s_t mine;
+	task_get_stats(busy, &mine);
+	printf("%s: %s\n", mine.name, mine.usage > 40 && mine.usage < 60 && mine.preemptions > 0 ? "PASS" : "FAIL");
+}
@@ -0,0 +1,90 @@
+/**
+ * \file tests/telemetry.c
+ *
+ * Logs telemetry samples for tools/telemetry_decode.py to decode.
+ *
+ * The "steady" channel logs 100 samples slowly enough that none are dropped,
+ * and each sample's fields are derived from its index so the decoded values
+ * can be checked. The "burst" channel logs samples back to back until the
+ * serial output queue fills up, then logs one more sample once it has drained
+ * so the decoder can see the gap. Run it as
+ *
+ *     PROS_HOST_DEVICES= timeout 5 bin/host/pros | python3 tools/telemetry_decode.py - --csv out
+ *
+ * out/steady.csv should have indices 0 to 99 with triple = 3 * index and
+ * quarter = index / 4, and the decoder should report as many burst samples
+ * missing as this program reports dropped.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+
+#define STEADY_CHANNEL 0
+#define BURST_CHANNEL 1
+#define STEADY_SAMPLES 100
+#define BURST_SAMPLES 1000
+
+typedef struct __attribute__((packed)) steady_sample {
+	uint32_t index;
+	int32_t triple;
+	float quarter;
+} steady_sample_s_t;
+
+typedef struct __attribute__((packed)) burst_sample {
+	uint32_t index;
+	uint8_t padding[60];
+} burst_sample_s_t;
+
+static bool failed;
+
+static void check(bool condition, const char* what) {
+	if (!condition) {
+		printf("FAIL: %s\n", what);
+		failed = true;
+	}
+}
+
+void opcontrol() {
+	serctl(SERCTL_ACTIVATE, (void*)TELEMETRY_STREAM_ID);
+	check(telemetry_announce(STEADY_CHANNEL, "steady", "Iif", "index,triple,quarter", sizeof(steady_sample_s_t)) ==
+	          1,
+	      "announced the steady channel");
+	check(telemetry_announce(BURST_CHANNEL, "burst", "I60x", "index", sizeof(burst_sample_s_t)) == 1,
+	      "announced the burst channel");
+	errno = 0;
+	check(telemetry_get_dropped(BURST_CHANNEL + 1) == PROS_ERR && errno == EINVAL,
+	      "an unannounced channel has no drop count");
+
+	for (uint32_t i = 0; i < STEADY_SAMPLES; i++) {
+		steady_sample_s_t sample = {.index = i, .triple = 3 * (int32_t)i, .quarter = i / 4.0f};
+		check(telemetry_log(STEADY_CHANNEL, &sample, sizeof(sample)) == 1, "logged a steady sample");
+		delay(1);
+	}
+	check(telemetry_get_dropped(STEADY_CHANNEL) == 0, "no steady samples were dropped");
+
+	burst_sample_s_t sample = {0};
+	for (sample.index = 0; sample.index < BURST_SAMPLES; sample.index++) {
+		errno = 0;
+		if (telemetry_log(BURST_CHANNEL, &sample, sizeof(sample)) != 1) {
+			check(errno == ENOBUFS, "a dropped sample sets ENOBUFS");
+		}
+	}
+	int32_t dropped = telemetry_get_dropped(BURST_CHANNEL);
+	check(dropped > 0, "the burst filled up the output queue");
+	// once the queue has drained, a sample goes through and marks the end of
+	// the gap
+	delay(20);
+	check(telemetry_log(BURST_CHANNEL, &sample, sizeof(sample)) == 1, "logged a sample after the burst");
+	check(telemetry_get_dropped(BURST_CHANNEL) == dropped, "the sample after the burst wasn't dropped");
+
+	printf("burst dropped %ld samples\n", (long)dropped);
+	printf("%s\n", failed ? "FAIL" : "PASS");
+}
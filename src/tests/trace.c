@@ -0,0 +1,56 @@
+/**
+ * \file tests/trace.c
+ *
+ * Causes a priority inversion and dumps the scheduler trace.
+ *
+ * A low priority task holds a mutex while a high priority task waits for it,
+ * so the holder should inherit the waiter's priority until it gives the mutex
+ * back. Convert the output with tools/trace_to_chrome.py and look for the
+ * inherit and disinherit events on the holder's track, inside span 1.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+
+static mutex_t lock;
+
+static void holder(void* ignore) {
+	mutex_take(lock, TIMEOUT_MAX);
+	trace_begin(1);
+	// spin rather than delay so that the holder keeps running at its inherited
+	// priority
+	uint32_t start = millis();
+	while (millis() - start < 20) {
+	}
+	trace_end(1);
+	mutex_give(lock);
+	// the dump only names the tasks that still exist
+	task_suspend(NULL);
+}
+
+static void waiter(void* ignore) {
+	trace_mark(2, 0);
+	mutex_take(lock, TIMEOUT_MAX);
+	trace_mark(2, 1);
+	mutex_give(lock);
+	task_suspend(NULL);
+}
+
+void opcontrol() {
+	lock = mutex_create();
+	task_create(holder, NULL, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Holder");
+	delay(5);
+	task_create(waiter, NULL, TASK_PRIORITY_MAX - 2, TASK_STACK_DEPTH_DEFAULT, "Waiter");
+	delay(50);
+
+	serctl(SERCTL_ACTIVATE, (void*)TRACE_STREAM_ID);
+	printf("sent %ld trace entries\n", (long)trace_dump());
+}
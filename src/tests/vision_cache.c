@@ -0,0 +1,100 @@
+/**
+ * \file tests/vision_cache.c
+ *
+ * Queries a simulated vision sensor many times per frame.
+ *
+ * Run with PROS_HOST_DEVICES=3:vision. The sensor sees two objects of
+ * signature 1, one of signature 2 and a color code. Each frame's objects should
+ * be read from the sensor once, however many queries are made, and the queries
+ * by signature should return each signature's objects from largest to
+ * smallest. Changing the zero point should apply to the current frame, new
+ * objects should show up with the next frame, and a port without a sensor
+ * should report ENODEV.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+
+#include "kapi.h"
+#include "sim.h"
+
+#define PORT 3
+#define EMPTY_PORT 4
+#define QUERIES 100
+// Signatures 1 and 2 together, in the sensor's octal notation
+#define CODE 012
+
+static bool failed;
+
+static void check(bool condition, const char* what) {
+	if (!condition) {
+		printf("FAIL: %s\n", what);
+		failed = true;
+	}
+}
+
+static const V5_DeviceVisionObject objects[] = {
+    {.signature = 1, .type = kVisionTypeNormal, .xoffset = 10, .yoffset = 20, .width = 80, .height = 60},
+    {.signature = 2, .type = kVisionTypeNormal, .xoffset = 100, .yoffset = 20, .width = 60, .height = 40},
+    {.signature = CODE, .type = kVisionTypeColorCode, .xoffset = 200, .yoffset = 50, .width = 40, .height = 30},
+    {.signature = 1, .type = kVisionTypeNormal, .xoffset = 150, .yoffset = 100, .width = 20, .height = 10}};
+
+void opcontrol() {
+	sim_set_vision_objects(PORT, objects, sizeof(objects) / sizeof(*objects));
+	delay(20);
+
+	int32_t sequence = vision_get_frame_sequence(PORT);
+	uint32_t reads = sim_get_vision_reads(PORT);
+	bool consistent = true;
+	for (int i = 0; i < QUERIES; i++) {
+		consistent &= vision_get_object_count(PORT) == 4;
+		consistent &= vision_get_by_size(PORT, 0).width == 80;
+		consistent &= vision_get_by_sig(PORT, 0, 1).width == 80;
+		consistent &= vision_get_by_sig(PORT, 1, 1).width == 20;
+		consistent &= vision_get_by_sig(PORT, 0, 2).width == 60;
+		consistent &= vision_get_by_code(PORT, 0, CODE).width == 40;
+	}
+	// a frame may have arrived during the queries, but each one is read once
+	int32_t frames = vision_get_frame_sequence(PORT) - sequence;
+	check(consistent, "every query returned the right object");
+	check(sim_get_vision_reads(PORT) - reads == 4 * (uint32_t)frames, "each frame was read from the sensor once");
+	check(frames < 2, "the queries took less than two frames");
+
+	vision_object_s_t by_sig[4];
+	check(vision_read_by_sig(PORT, 0, 1, 4, by_sig) == 2, "read both objects of signature 1");
+	check(by_sig[0].x_middle_coord == 50 && by_sig[1].x_middle_coord == 160, "signature 1 is in size order");
+	check(by_sig[2].signature == VISION_OBJECT_ERR_SIG, "the rest of the array is marked missing");
+
+	errno = 0;
+	check(vision_get_by_sig(PORT, 2, 1).signature == VISION_OBJECT_ERR_SIG && errno == EDOM,
+	      "there is no third object of signature 1");
+	errno = 0;
+	check(vision_get_by_sig(PORT, 0, 3).signature == VISION_OBJECT_ERR_SIG && errno == EDOM,
+	      "there is no object of signature 3");
+
+	vision_set_zero_point(PORT, E_VISION_ZERO_CENTER);
+	check(vision_get_by_size(PORT, 0).x_middle_coord == 50 - VISION_FOV_WIDTH / 2,
+	      "changing the zero point moves the cached objects");
+	vision_set_zero_point(PORT, E_VISION_ZERO_TOPLEFT);
+
+	sequence = vision_get_frame_sequence(PORT);
+	sim_set_vision_objects(PORT, &objects[1], 1);
+	delay(20);
+	check(vision_get_frame_sequence(PORT) > sequence, "a new frame arrived");
+	check(vision_get_object_count(PORT) == 1, "the new frame has one object");
+	errno = 0;
+	check(vision_get_by_sig(PORT, 0, 1).signature == VISION_OBJECT_ERR_SIG && errno == EDOM,
+	      "signature 1 is gone from the new frame");
+	check(vision_get_by_sig(PORT, 0, 2).width == 60, "signature 2 is still there");
+
+	errno = 0;
+	check(vision_get_object_count(EMPTY_PORT) == PROS_ERR && errno == ENODEV, "an empty port has no sensor");
+
+	printf("%s\n", failed ? "FAIL" : "PASS");
+}
@@ -0,0 +1,151 @@
+"""
+Symbolizes the samples sent by profiler_dump().
+
+The input is a capture of the brain's serial output taken while
+profiler_dump() ran. Each sample is looked up in the ELFs that were uploaded:
+bin/cold.package.elf (the kernel) and bin/hot.package.elf (the project) for a
+hot/cold build, or bin/monolith.elf otherwise. These are HOT_ELF, COLD_ELF and
+MONOLITH_ELF in common.mk.
+
+The report lists the functions that were running most often, and the callers
+they were called from according to the sampled link register. The link
+register is only certain to point into the caller while a function hasn't
+called anything else itself, so the caller column is a guide rather than a
+call graph.
+
+    python3 profile_symbolize.py capture.bin [ELF ...] [--by-task] [--folded stacks.txt]
+
+--folded writes "task;caller;function count" lines, which flamegraph.pl and
+https://speedscope.app can draw.
+"""
+import argparse
+import bisect
+import collections
+import os
+import struct
+import subprocess
+import sys
+
+from trace_to_chrome import FRAME_ENTRIES, FRAME_TASK_NAMES, TASK_NAME, read_frames
+
+PROFILER_STREAM_ID = 0x666f7270
+SAMPLE = struct.Struct('<IIHH')
+
+DEFAULT_ELFS = [['bin/cold.package.elf', 'bin/hot.package.elf'], ['bin/monolith.elf']]
+
+
+def parse(capture):
+    names = {}
+    samples = []
+    for frame in read_frames(capture, PROFILER_STREAM_ID):
+        kind, body = frame[0], frame[1:]
+        if kind == FRAME_TASK_NAMES:
+            for task, name in TASK_NAME.iter_unpack(body[:len(body) - len(body) % TASK_NAME.size]):
+                names[task] = name.split(b'\0', 1)[0].decode(errors='replace')
+        elif kind == FRAME_ENTRIES:
+            samples.extend(SAMPLE.iter_unpack(body[:len(body) - len(body) % SAMPLE.size]))
+    return names, samples
+
+
+class Symbols:
+    """The functions of one or more ELFs, sorted by address."""
+
+    def __init__(self, nm, elfs):
+        symbols = []
+        for elf in elfs:
+            label = os.path.basename(elf).split('.')[0]
+            out = subprocess.run([nm, '--defined-only', '-n', '-S', '-C', elf], check=True, capture_output=True,
+                                 text=True).stdout
+            for line in out.splitlines():
+                fields = line.split(None, 3)
+                # functions have a size; anything without one can't be matched
+                if len(fields) == 4 and fields[2] in 'tTwW':
+                    start, size = int(fields[0], 16), int(fields[1], 16)
+                    symbols.append((start, start + size, fields[3], label))
+        symbols.sort()
+        self.starts = [s[0] for s in symbols]
+        self.symbols = symbols
+
+    def lookup(self, address):
+        i = bisect.bisect_right(self.starts, address) - 1
+        if i >= 0 and address < self.symbols[i][1]:
+            return self.symbols[i][2], self.symbols[i][3]
+        return '{:#x}'.format(address), None
+
+
+def report(title, counter, total, limit, labels, column='function'):
+    print(title)
+    print('{:>7} {:>7}  {}'.format('samples', '%', column))
+    for name, count in counter.most_common(limit):
+        label = labels.get(name)
+        print('{:>7} {:>6.1f}%  {}{}'.format(count, 100.0 * count / total, name, ' [{}]'.format(label) if label else ''))
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', help='the captured serial output, or - for stdin')
+    parser.add_argument('elfs', nargs='*', help='the ELFs to look samples up in')
+    parser.add_argument('--nm', default='arm-none-eabi-nm', help='the nm to read the ELFs with')
+    parser.add_argument('--top', type=int, default=25, help='how many functions to list')
+    parser.add_argument('--by-task', action='store_true', help='list the functions of each task separately')
+    parser.add_argument('--folded', help='where to write folded stacks')
+    args = parser.parse_args()
+
+    elfs = args.elfs
+    if not elfs:
+        elfs = next((group for group in DEFAULT_ELFS if all(os.path.exists(elf) for elf in group)), None)
+        if not elfs:
+            print('no ELFs given and none found in bin/', file=sys.stderr)
+            return 1
+
+    if args.capture == '-':
+        capture = sys.stdin.buffer.read()
+    else:
+        with open(args.capture, 'rb') as f:
+            capture = f.read()
+    names, samples = parse(capture)
+    if not samples:
+        print('no profiler samples found', file=sys.stderr)
+        return 1
+
+    symbols = Symbols(args.nm, elfs)
+    labels = {}
+    functions = collections.Counter()
+    callers = collections.Counter()
+    tasks = collections.Counter()
+    per_task = collections.defaultdict(collections.Counter)
+    stacks = collections.Counter()
+    for pc, lr, task, _ in samples:
+        function, label = symbols.lookup(pc)
+        labels[function] = label
+        caller = symbols.lookup(lr)[0] if lr else None
+        task_name = names.get(task, 'task {}'.format(task))
+        functions[function] += 1
+        if caller and caller != function:
+            callers['{} <- {}'.format(function, caller)] += 1
+        tasks[task_name] += 1
+        per_task[task_name][function] += 1
+        stacks[(task_name, caller, function)] += 1
+
+    total = len(samples)
+    print('{} samples ({:.1f} s of CPU time)\n'.format(total, total / 1000.0))
+    report('Tasks', tasks, total, args.top, {}, 'task')
+    report('Functions', functions, total, args.top, labels)
+    # the simulator can't sample the link register on every host
+    if callers:
+        report('Functions and their callers', callers, total, args.top, {})
+    if args.by_task:
+        for task_name, _ in tasks.most_common():
+            report('Functions in ' + task_name, per_task[task_name], tasks[task_name], args.top, labels)
+
+    if args.folded:
+        with open(args.folded, 'w') as f:
+            for (task_name, caller, function), count in stacks.items():
+                frames = [task_name, function] if caller in (None, function) else [task_name, caller, function]
+                f.write('{} {}\n'.format(';'.join(frame.replace(';', ':') for frame in frames), count))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,127 @@
+"""
+Decodes the samples sent by telemetry_log().
+
+The input is a capture of the brain's serial output taken while the 'tlmy'
+stream was active. Each channel's samples are decoded with the schema that the
+brain sends when the channel is announced and once a second after that, so
+samples logged before the first schema in the capture are skipped. Gaps in a
+channel's sequence numbers, which is how dropped samples show up, are reported
+on stderr.
+
+By default every sample is written to stdout as a line of JSON. With --csv,
+each channel is written to <directory>/<channel name>.csv instead.
+
+    python3 telemetry_decode.py capture.bin [--csv directory]
+"""
+import argparse
+import csv
+import json
+import os
+import struct
+import sys
+
+from trace_to_chrome import read_frames
+
+TELEMETRY_STREAM_ID = 0x796d6c74
+FRAME_SAMPLE = 0
+FRAME_SCHEMA = 1
+
+HEADER = struct.Struct('<BBHIQ')
+SAMPLE_SIZE = struct.Struct('<H')
+
+
+class Channel:
+    def __init__(self, body):
+        size, = SAMPLE_SIZE.unpack_from(body)
+        name, fmt, fields = body[SAMPLE_SIZE.size:].split(b'\0')[:3]
+        self.name = name.decode(errors='replace')
+        self.format = fmt.decode(errors='replace')
+        self.sample = struct.Struct('<' + self.format)
+        if self.sample.size != size:
+            raise ValueError('channel {} has a {} byte format for {} byte samples'.format(
+                self.name, self.sample.size, size))
+        self.fields = fields.decode(errors='replace').split(',') if fields else []
+        # a repeat count like "3f" gives several values for one name, so fall
+        # back to numbered fields when the names don't line up with the values
+        values = len(self.sample.unpack(bytes(size)))
+        if len(self.fields) != values:
+            self.fields = ['field{}'.format(i) for i in range(values)]
+        self.next_sequence = None
+        self.missing = 0
+
+
+def decode(capture):
+    """Yields (channel, sequence, timestamp, values) for every sample that can be decoded."""
+    channels = {}
+    skipped = 0
+    for frame in read_frames(capture, TELEMETRY_STREAM_ID):
+        if len(frame) < HEADER.size:
+            continue
+        kind, channel_id, length, sequence, timestamp = HEADER.unpack_from(frame)
+        body = frame[HEADER.size:HEADER.size + length]
+        if kind == FRAME_SCHEMA:
+            channel = channels.get(channel_id)
+            if channel is None:
+                channel = channels[channel_id] = Channel(body)
+            # the schema carries the sequence number of the next sample, so the
+            # first schema of a channel sets where its samples should start
+            if channel.next_sequence is None:
+                channel.next_sequence = sequence
+        elif kind == FRAME_SAMPLE:
+            channel = channels.get(channel_id)
+            if channel is None or len(body) != channel.sample.size:
+                skipped += 1
+                continue
+            gap = (sequence - channel.next_sequence) & 0xffffffff
+            # a sample from before the schema was resent isn't a gap
+            if gap < 1 << 31:
+                channel.missing += gap
+            channel.next_sequence = (sequence + 1) & 0xffffffff
+            yield channel, sequence, timestamp, channel.sample.unpack(body)
+    for channel in channels.values():
+        if channel.missing:
+            print('{}: {} samples missing'.format(channel.name, channel.missing), file=sys.stderr)
+    if skipped:
+        print('skipped {} samples logged before their schema'.format(skipped), file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', help='the captured serial output, or - for stdin')
+    parser.add_argument('--csv', metavar='directory', help='write a CSV file per channel into this directory')
+    args = parser.parse_args()
+
+    if args.capture == '-':
+        capture = sys.stdin.buffer.read()
+    else:
+        with open(args.capture, 'rb') as f:
+            capture = f.read()
+
+    files = {}
+    writers = {}
+    count = 0
+    for channel, sequence, timestamp, values in decode(capture):
+        count += 1
+        if args.csv is None:
+            sample = {'channel': channel.name, 'sequence': sequence, 'timestamp': timestamp}
+            sample.update(zip(channel.fields, values))
+            print(json.dumps(sample))
+            continue
+        if channel.name not in writers:
+            os.makedirs(args.csv, exist_ok=True)
+            files[channel.name] = open(os.path.join(args.csv, channel.name + '.csv'), 'w', newline='')
+            writers[channel.name] = csv.writer(files[channel.name])
+            writers[channel.name].writerow(['sequence', 'timestamp'] + channel.fields)
+        writers[channel.name].writerow([sequence, timestamp] + list(values))
+    for f in files.values():
+        f.close()
+
+    if count == 0:
+        print('no telemetry samples found', file=sys.stderr)
+        return 1
+    print('decoded {} samples'.format(count), file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,175 @@
+"""
+Converts a scheduler trace dump into a Chrome trace.
+
+The input is a capture of the brain's serial output taken while trace_dump()
+ran. Frames on other streams are ignored. The output can be opened in
+chrome://tracing or https://ui.perfetto.dev and shows when each task ran, where
+tasks blocked on queues and mutexes, priority inheritance, interrupts giving
+to queues and the spans and markers recorded with trace_begin(), trace_end()
+and trace_mark().
+
+    python3 trace_to_chrome.py capture.bin trace.json
+"""
+import argparse
+import json
+import struct
+import sys
+
+TRACE_STREAM_ID = 0x65637274
+FRAME_TASK_NAMES = 0
+FRAME_ENTRIES = 1
+
+TASK_NAME = struct.Struct('<H32s')
+ENTRY = struct.Struct('<IIIHBB')
+
+(SWITCHED_IN, SWITCHED_OUT, TASK_CREATE, TASK_DELETE, TASK_DELAY, PRIORITY_INHERIT, PRIORITY_DISINHERIT,
+ QUEUE_BLOCK_RECEIVE, QUEUE_BLOCK_SEND, QUEUE_RECEIVE, QUEUE_SEND, QUEUE_RECEIVE_FROM_ISR, QUEUE_SEND_FROM_ISR,
+ NOTIFY_FROM_ISR, MARK, BEGIN, END) = range(17)
+
+QUEUE_TYPES = ['queue', 'mutex', 'counting semaphore', 'binary semaphore', 'recursive mutex']
+MUTEX_TYPES = (1, 4)
+
+# interrupts get a track of their own, numbered past any task
+ISR_TRACK = 0x10000
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xff and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def read_frames(capture, stream_id=TRACE_STREAM_ID):
+    """Yields the payload of every frame on a stream."""
+    for chunk in capture.split(b'\0'):
+        # text written before the serial driver started framing its output
+        # runs straight into the next frame, so look for where that frame starts
+        for start in range(len(chunk)):
+            frame = cobs_decode(chunk[start:])
+            if frame is not None and len(frame) > 4 and struct.unpack_from('<I', frame)[0] == stream_id:
+                yield frame[4:]
+                break
+
+
+def parse(capture):
+    names = {}
+    entries = []
+    for frame in read_frames(capture):
+        kind, body = frame[0], frame[1:]
+        if kind == FRAME_TASK_NAMES:
+            for task, name in TASK_NAME.iter_unpack(body[:len(body) - len(body) % TASK_NAME.size]):
+                names[task] = name.split(b'\0', 1)[0].decode(errors='replace')
+        elif kind == FRAME_ENTRIES:
+            entries.extend(ENTRY.iter_unpack(body[:len(body) - len(body) % ENTRY.size]))
+    return names, entries
+
+
+def unwrap(entries):
+    """Extends the 32-bit microsecond timestamps, which wrap every 71 minutes."""
+    offset = 0
+    last = None
+    for timestamp, obj, value, task, event, _ in entries:
+        if last is not None and timestamp + offset < last - (1 << 31):
+            offset += 1 << 32
+        last = timestamp + offset
+        yield last, obj, value, task, event
+
+
+def queue_name(obj, kind):
+    return '{} {:#x}'.format(QUEUE_TYPES[kind] if kind < len(QUEUE_TYPES) else 'queue', obj)
+
+
+def convert(names, entries):
+    events = []
+    running = {}
+
+    def instant(ts, tid, name, **args):
+        events.append({'name': name, 'ph': 'i', 's': 't', 'ts': ts, 'pid': 0, 'tid': tid, 'args': args})
+
+    for ts, obj, value, task, event in unwrap(entries):
+        names.setdefault(task, 'task {}'.format(task))
+        if event == SWITCHED_IN:
+            running[task] = ts
+        elif event == SWITCHED_OUT:
+            # the first switch out in the dump may have no matching switch in
+            if task in running:
+                start = running.pop(task)
+                events.append({'name': names[task], 'ph': 'X', 'ts': start, 'dur': ts - start, 'pid': 0,
+                               'tid': task})
+        elif event == TASK_CREATE:
+            instant(ts, task, 'create task {}'.format(obj), task=obj, priority=value)
+        elif event == TASK_DELETE:
+            instant(ts, task, 'delete task {}'.format(obj), task=obj)
+        elif event == TASK_DELAY:
+            instant(ts, task, 'delay')
+        elif event in (PRIORITY_INHERIT, PRIORITY_DISINHERIT):
+            what = 'inherit' if event == PRIORITY_INHERIT else 'disinherit'
+            instant(ts, obj, '{} priority {}'.format(what, value), priority=value, by=task)
+        elif event in (QUEUE_BLOCK_RECEIVE, QUEUE_BLOCK_SEND):
+            if value in MUTEX_TYPES:
+                name = 'wait for ' + queue_name(obj, value)
+            else:
+                what = 'receive from' if event == QUEUE_BLOCK_RECEIVE else 'send to'
+                name = 'block to {} {}'.format(what, queue_name(obj, value))
+            instant(ts, task, name, queue=hex(obj))
+        elif event in (QUEUE_RECEIVE, QUEUE_SEND):
+            if value in MUTEX_TYPES:
+                what = 'take' if event == QUEUE_RECEIVE else 'give'
+            else:
+                what = 'receive from' if event == QUEUE_RECEIVE else 'send to'
+            instant(ts, task, '{} {}'.format(what, queue_name(obj, value)), queue=hex(obj))
+        elif event in (QUEUE_RECEIVE_FROM_ISR, QUEUE_SEND_FROM_ISR):
+            what = 'receive from' if event == QUEUE_RECEIVE_FROM_ISR else 'send to'
+            instant(ts, ISR_TRACK, '{} {}'.format(what, queue_name(obj, value)), queue=hex(obj), interrupted=task)
+        elif event == NOTIFY_FROM_ISR:
+            instant(ts, ISR_TRACK, 'notify task {}'.format(obj), task=obj, interrupted=task)
+        elif event == MARK:
+            instant(ts, task, 'mark {}'.format(obj), value=value)
+        elif event == BEGIN:
+            events.append({'name': 'span {}'.format(obj), 'ph': 'B', 'ts': ts, 'pid': 0, 'tid': task})
+        elif event == END:
+            events.append({'name': 'span {}'.format(obj), 'ph': 'E', 'ts': ts, 'pid': 0, 'tid': task})
+
+    names[ISR_TRACK] = 'Interrupts'
+    for tid, name in names.items():
+        events.append({'name': 'thread_name', 'ph': 'M', 'pid': 0, 'tid': tid, 'args': {'name': name}})
+    events.append({'name': 'process_name', 'ph': 'M', 'pid': 0, 'args': {'name': 'V5 Brain'}})
+    return {'traceEvents': events, 'displayTimeUnit': 'ms'}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', help='the captured serial output, or - for stdin')
+    parser.add_argument('output', nargs='?', default='-', help='where to write the trace, or - for stdout')
+    args = parser.parse_args()
+
+    if args.capture == '-':
+        capture = sys.stdin.buffer.read()
+    else:
+        with open(args.capture, 'rb') as f:
+            capture = f.read()
+    names, entries = parse(capture)
+    if not entries:
+        print('no trace entries found', file=sys.stderr)
+        return 1
+
+    trace = convert(names, entries)
+    if args.output == '-':
+        json.dump(trace, sys.stdout)
+    else:
+        with open(args.output, 'w') as f:
+            json.dump(trace, f)
+    print('converted {} entries from {} tasks'.format(len(entries), len(names) - 1), file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())